@@ -3,9 +3,88 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <cmath>
+#include <string>
 
-bool Application::Initialize()
+namespace {
+
+// Logic of the scene, at the fixed simulation tick: the emitter circles
+// around the origin while the camera slowly orbits it
+void StepScene(SceneState& state, [[maybe_unused]] double step, double time)
+{
+    constexpr double kTwoPi = 6.283185307179586;
+    double const emitter_angle = kTwoPi * time / 8.0;
+    state.emitter[0] = float(std::cos(emitter_angle));
+    state.emitter[1] = float(0.5 * std::sin(2.0 * emitter_angle));
+    state.emitter[2] = float(std::sin(emitter_angle));
+
+    double const camera_angle = kTwoPi * time / 40.0;
+    state.camera_eye[0] = float(-6.0 * std::sin(camera_angle));
+    state.camera_eye[2] = float(-6.0 * std::cos(camera_angle));
+}
+
+Application* GetApplication(GLFWwindow* window)
+{
+    return static_cast<Application*>(glfwGetWindowUserPointer(window));
+}
+
+void OnFramebufferResized(GLFWwindow* window, int width, int height)
+{
+    WindowEvent event;
+    event.type = WindowEvent::Type::FramebufferResized;
+    event.window = window;
+    event.width = width;
+    event.height = height;
+    GetApplication(window)->PostWindowEvent(event);
+}
+
+void OnWindowClose(GLFWwindow* window)
+{
+    WindowEvent event;
+    event.type = WindowEvent::Type::CloseRequested;
+    event.window = window;
+    GetApplication(window)->PostWindowEvent(event);
+}
+
+#ifndef __EMSCRIPTEN__
+void OnVisibilityChanged(GLFWwindow* window, int visibility)
 {
+    WindowEvent event;
+    event.type = WindowEvent::Type::VisibilityChanged;
+    event.window = window;
+    event.visibility = visibility;
+    GetApplication(window)->PostWindowEvent(event);
+}
+
+void OnFrameRequested(GLFWwindow* window)
+{
+    WindowEvent event;
+    event.type = WindowEvent::Type::FrameRequested;
+    event.window = window;
+    GetApplication(window)->PostWindowEvent(event);
+}
+
+void OnFramePresented(GLFWwindow* window, GLFWpresentation const* presentation)
+{
+    WindowEvent event;
+    event.type = WindowEvent::Type::FramePresented;
+    event.window = window;
+    event.presented = presentation->presented;
+    event.time = presentation->time;
+    event.refresh_interval = presentation->refreshInterval;
+    // GLFW asks for the feedback of the next present once this returns
+    event.feedback_request_time = glfwGetTime();
+    GetApplication(window)->PostWindowEvent(event);
+}
+#endif // !__EMSCRIPTEN__
+
+} // namespace
+
+bool Application::Initialize(bool exclusive_fullscreen, int window_count)
+{
+    // Until StartThreads(), the calling thread renders
+    m_device_thread = std::this_thread::get_id();
+
     // GLFW Initialize
     if (!glfwInit())
     {
@@ -13,15 +92,32 @@ bool Application::Initialize()
         return false;
     }
 
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); // <-- extra info for glfwCreateWindow
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
-    m_window = glfwCreateWindow(640, 480, "Learn WebGPU", nullptr, nullptr);
-
-    if (!m_window)
+    for (int i = 0; i < window_count; ++i)
     {
-        std::cerr << "Could not open window!" << std::endl;
-        glfwTerminate();
-        return false;
+        std::string title = i == 0 ? "Learn WebGPU" : "Learn WebGPU (" + std::to_string(i + 1) + ")";
+        GLFWwindow* window = m_windows.OpenWindow(640, 480, title.c_str(), exclusive_fullscreen && i == 0);
+        if (!window)
+        {
+            std::cerr << "Could not open window!" << std::endl;
+            m_windows.Terminate();
+            glfwTerminate();
+            return false;
+        }
+        ++m_open_windows;
+
+        // Window events all go through the event queue, so that they reach
+        // the renderer the same way whether it has a thread of its own or not
+        glfwSetWindowUserPointer(window, this);
+        glfwSetFramebufferSizeCallback(window, OnFramebufferResized);
+        glfwSetWindowCloseCallback(window, OnWindowClose);
+#ifndef __EMSCRIPTEN__
+        glfwSetWindowVisibilityCallback(window, OnVisibilityChanged);
+        if (glfwGetPlatform() == GLFW_PLATFORM_WAYLAND)
+        {
+            glfwSetWindowFrameCallback(window, OnFrameRequested);
+            glfwSetWindowPresentCallback(window, OnFramePresented);
+        }
+#endif // !__EMSCRIPTEN__
     }
 
     // WEBGPU Initialize
@@ -62,14 +158,11 @@ bool Application::Initialize()
     // Create the adapter
     std::cout << "Requesting adapter..." << std::endl;
 
-    m_surface = glfwGetWGPUSurface(instance, m_window);
-
     WGPURequestAdapterOptions adapter_options = {};
     adapter_options.nextInChain = nullptr;
     WGPUAdapter adapter = requestAdapterSync(instance, &adapter_options);
 
     std::cout << "Got adapter: " << adapter << std::endl;
-    wgpuInstanceRelease(instance);
 
     inspectAdapter(adapter);
 
@@ -81,7 +174,15 @@ bool Application::Initialize()
     WGPUDeviceDescriptor device_descriptor = {};
     device_descriptor.nextInChain = nullptr;
     device_descriptor.label = "My Device";
-    device_descriptor.requiredFeatureCount = 0;
+    // Timestamps let the dynamic resolution time the GPU passes, but are optional
+    // (and not used with wgpu-native, see ResolutionScaler::Initialize)
+    std::vector<WGPUFeatureName> required_features;
+#ifndef WEBGPU_BACKEND_WGPU
+    if (wgpuAdapterHasFeature(adapter, WGPUFeatureName_TimestampQuery))
+        required_features.push_back(WGPUFeatureName_TimestampQuery);
+#endif // !WEBGPU_BACKEND_WGPU
+    device_descriptor.requiredFeatureCount = required_features.size();
+    device_descriptor.requiredFeatures = required_features.data();
     device_descriptor.requiredLimits = nullptr;
     device_descriptor.defaultQueue.nextInChain = nullptr;
     device_descriptor.defaultQueue.label = "The default queue";
@@ -118,20 +219,27 @@ bool Application::Initialize()
         };
     wgpuQueueOnSubmittedWorkDone(m_queue, onQueueWorkDone, nullptr /* user_data */);
 
-    WGPUTextureFormat surface_format = wgpuSurfaceGetPreferredFormat(m_surface, adapter);
-    WGPUSurfaceConfiguration config = {};
-    config.nextInChain = nullptr;
-    config.width = 640;
-    config.height = 480;
-    config.format = surface_format;
-    config.viewFormatCount = 0;
-    config.viewFormats = nullptr;
-    config.usage = WGPUTextureUsage_RenderAttachment;
-    config.device = m_device;
-    config.presentMode = WGPUPresentMode_Fifo;
-    config.alphaMode = WGPUCompositeAlphaMode_Auto;
-
-    wgpuSurfaceConfigure(m_surface, &config);
+    if (!m_compute.Initialize(m_device, m_queue))
+        return false;
+
+    if (!m_primitives.Initialize(m_compute))
+        return false;
+
+    if (!m_mipmaps.Initialize(m_compute))
+        return false;
+
+    bool windows_ready = m_windows.Initialize(instance, adapter, m_device, m_queue);
+    wgpuInstanceRelease(instance);
+    if (!windows_ready)
+        return false;
+
+    // The scene has the aspect ratio of the first window, and is stretched on the others
+    float aspect_ratio = float(m_windows.GetMainWidth()) / float(m_windows.GetMainHeight());
+    if (!m_particles.Initialize(m_compute, m_primitives, m_windows.GetSurfaceFormat(), 1 << 20, aspect_ratio))
+        return false;
+
+    m_simulation.Initialize(kSimulationTickRate, SceneState{}, StepScene);
+    m_last_frame_time = glfwGetTime();
 
     wgpuAdapterRelease(adapter);
 
@@ -141,50 +249,134 @@ bool Application::Initialize()
 void Application::Terminate()
 {
     // Move all the release/destroy/terminate calls here
+    m_windows.Terminate();
+    m_particles.Terminate();
+    m_primitives.Terminate();
+    m_mipmaps.Terminate();
+    m_compute.Terminate();
     wgpuQueueRelease(m_queue);
-    wgpuSurfaceUnconfigure(m_surface);
-    wgpuSurfaceRelease(m_surface);
     wgpuDeviceRelease(m_device);
-    glfwDestroyWindow(m_window);
     glfwTerminate();
 }
 
 void Application::MainLoop()
 {
     glfwPollEvents();
+    m_simulation.RunDueTicks(glfwGetTimerValue());
+    RenderFrame();
+    DestroyReleasedWindows();
+}
+
+void Application::StartThreads()
+{
+    m_simulation.StartThread();
+
+    m_threaded = true;
+    // No thread owns the device until the render thread has started
+    m_device_thread = std::thread::id();
+    m_render_thread = std::thread([this]()
+        {
+            m_device_thread = std::this_thread::get_id();
+            while (m_windows.GetWindowCount() > 0)
+                RenderFrame();
+        });
+}
+
+void Application::ProcessEvents()
+{
+    // The renderer posts an empty event when it releases a window
+    glfwWaitEvents();
+    DestroyReleasedWindows();
+}
+
+void Application::StopThreads()
+{
+    if (m_render_thread.joinable())
+        m_render_thread.join();
+    m_threaded = false;
+    m_device_thread = std::this_thread::get_id();
+
+    m_simulation.StopThread();
+
+    // Windows released while the loop of the main thread was ending
+    DestroyReleasedWindows();
+}
+
+ComputeContext& Application::GetCompute()
+{
+    assert(m_device_thread == std::this_thread::get_id());
+    return m_compute;
+}
+
+MipmapGenerator& Application::GetMipmaps()
+{
+    assert(m_device_thread == std::this_thread::get_id());
+    return m_mipmaps;
+}
+
+void Application::PostWindowEvent(WindowEvent const& event)
+{
+    // The renderer drains the queue every frame, it is only ever full if a
+    // frame takes very long
+    while (!m_window_events.Push(event))
+        std::this_thread::yield();
+}
 
-    WGPUTextureView target_view = GetNextSurfaceViewData();
-    
-    if (!target_view)
+void Application::RenderFrame()
+{
+    HandleWindowEvents();
+    if (m_windows.GetWindowCount() == 0)
+        return;
+
+    double wait = 0.0;
+    if (!m_windows.GetTimeUntilFrame(wait))
+    {
+        // No window can be seen, resume the simulation where it was left
+        // once one comes back
+        WaitForWindowEvents(wait);
+        m_last_frame_time = glfwGetTime();
+        return;
+    }
+
+    // Wait for the compositor to ask for a frame, so that the frame is
+    // recorded just in time and not at all while the windows are occluded
+    if (wait > 0.0)
+    {
+        WaitForWindowEvents(wait);
+        HandleWindowEvents();
+        if (m_windows.GetWindowCount() == 0)
+            return;
+    }
+
+    // Draw the scene as it is at the time of the frame, between two ticks
+    SceneState const scene = m_simulation.Sample(glfwGetTimerValue());
+    m_particles.SetEmitter(scene.emitter);
+    m_particles.SetCamera(scene.camera_eye, scene.camera_look_at);
+
+    double now = glfwGetTime();
+    m_particles.Update(float(now - m_last_frame_time));
+    m_last_frame_time = now;
+
+    if (m_windows.AcquireTargets() == 0)
+    {
+        // Keep the simulation running even when there is nothing to draw to
+        m_compute.Flush();
         return;
+    }
 
     WGPUCommandEncoderDescriptor encoder_descriptor = {};
     encoder_descriptor.nextInChain = nullptr;
     encoder_descriptor.label = "My command encoder";
     WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(m_device, &encoder_descriptor);
 
-    WGPURenderPassDescriptor render_pass_descriptor = {};
-    render_pass_descriptor.nextInChain = nullptr;
+    // All the compute work of the frame goes in one pass ahead of rendering
+    m_compute.Encode(encoder);
 
-    WGPURenderPassColorAttachment render_pass_color_attachment = {};
-    render_pass_color_attachment.view = target_view;
-    render_pass_color_attachment.resolveTarget = nullptr;
-    render_pass_color_attachment.loadOp = WGPULoadOp_Clear;
-    render_pass_color_attachment.storeOp = WGPUStoreOp_Store;
-    render_pass_color_attachment.clearValue = WGPUColor{ 0.9, 0.1, 0.2, 1.0 };
-#ifndef WEBGPU_BACKEND_WGPU
-    render_pass_color_attachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
-#endif // !WEBGPU_BACKEND_WGPU
-
-    render_pass_descriptor.colorAttachmentCount = 1;
-    render_pass_descriptor.colorAttachments = &render_pass_color_attachment;
-    render_pass_descriptor.depthStencilAttachment = nullptr;
-    render_pass_descriptor.timestampWrites = nullptr;
-
-    WGPURenderPassEncoder render_pass = wgpuCommandEncoderBeginRenderPass(encoder, &render_pass_descriptor);
-
-    wgpuRenderPassEncoderEnd(render_pass);
-    wgpuRenderPassEncoderRelease(render_pass);
+    // Then every window, so that the whole frame is a single submission
+    m_windows.RecordFrame(encoder, [this](WGPUCommandEncoder window_encoder, ResolutionScaler& scaler)
+        {
+            RenderScene(window_encoder, scaler);
+        });
 
     WGPUCommandBufferDescriptor command_buffer_descriptor = {};
     command_buffer_descriptor.nextInChain = nullptr;
@@ -193,16 +385,11 @@ void Application::MainLoop()
     wgpuCommandEncoderRelease(encoder);
 
     // Submit the command queue
-    std::cout << "Submitting Command..." << std::endl;
     wgpuQueueSubmit(m_queue, 1, &command);
     wgpuCommandBufferRelease(command);
-    std::cout << "Command submitted." << std::endl;
 
-
-    wgpuTextureViewRelease(target_view);
-#ifndef __EMSCRIPTEN__
-    wgpuSurfacePresent(m_surface);
-#endif // !__EMSCRIPTEN__
+    m_compute.MapReadbacks();
+    m_windows.Present();
 
 #if defined(WEBGPU_BACKEND_DAWN)
     wgpuDeviceTick(m_device);
@@ -213,36 +400,85 @@ void Application::MainLoop()
 
 bool Application::IsRunning()
 {
-    return !glfwWindowShouldClose(m_window);
+    return m_open_windows > 0;
 }
 
-WGPUTextureView Application::GetNextSurfaceViewData()
+void Application::HandleWindowEvents()
 {
-    WGPUSurfaceTexture surface_texture;
-    wgpuSurfaceGetCurrentTexture(m_surface, &surface_texture);
+    WindowEvent event;
+    while (m_window_events.Pop(event))
+    {
+        switch (event.type)
+        {
+        case WindowEvent::Type::FramebufferResized:
+            m_windows.OnFramebufferResized(event.window, event.width, event.height);
+            break;
+        case WindowEvent::Type::VisibilityChanged:
+            m_windows.OnVisibilityChanged(event.window, event.visibility);
+            break;
+        case WindowEvent::Type::FrameRequested:
+            m_windows.OnFrameRequested(event.window);
+            break;
+        case WindowEvent::Type::FramePresented:
+            m_windows.OnFramePresented(event.window, event.presented, event.time, event.refresh_interval, event.feedback_request_time);
+            break;
+        case WindowEvent::Type::CloseRequested:
+            // The window may only be destroyed once its surface is released
+            if (m_windows.ReleaseWindow(event.window))
+            {
+                while (!m_released_windows.Push(event.window))
+                    std::this_thread::yield();
+                if (m_threaded)
+                    glfwPostEmptyEvent();
+            }
+            break;
+        }
+    }
+}
+
+void Application::WaitForWindowEvents(double seconds)
+{
+    if (m_threaded)
+        m_window_events.Wait(seconds);
+    else
+        glfwWaitEventsTimeout(seconds);
+}
 
-    if (surface_texture.status != WGPUSurfaceGetCurrentTextureStatus_Success)
+void Application::DestroyReleasedWindows()
+{
+    GLFWwindow* window = nullptr;
+    while (m_released_windows.Pop(window))
     {
-        return nullptr;
+        glfwDestroyWindow(window);
+        --m_open_windows;
     }
+}
+
+void Application::RenderScene(WGPUCommandEncoder encoder, ResolutionScaler& scaler)
+{
+    WGPURenderPassDescriptor render_pass_descriptor = {};
+    render_pass_descriptor.nextInChain = nullptr;
+
+    WGPURenderPassColorAttachment render_pass_color_attachment = {};
+    render_pass_color_attachment.view = scaler.GetSceneView();
+    render_pass_color_attachment.resolveTarget = nullptr;
+    render_pass_color_attachment.loadOp = WGPULoadOp_Clear;
+    render_pass_color_attachment.storeOp = WGPUStoreOp_Store;
+    render_pass_color_attachment.clearValue = WGPUColor{ 0.9, 0.1, 0.2, 1.0 };
+#ifndef WEBGPU_BACKEND_WGPU
+    render_pass_color_attachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+#endif // !WEBGPU_BACKEND_WGPU
 
-    WGPUTextureViewDescriptor view_descriptor;
-    view_descriptor.nextInChain = nullptr;
-    view_descriptor.label = "Surface texture view";
-    view_descriptor.format = wgpuTextureGetFormat(surface_texture.texture);
-    view_descriptor.dimension = WGPUTextureViewDimension_2D;
-    view_descriptor.baseMipLevel = 0;
-    view_descriptor.mipLevelCount = 1;
-    view_descriptor.baseArrayLayer = 0;
-    view_descriptor.arrayLayerCount = 1;
-    view_descriptor.aspect = WGPUTextureAspect_All;
-    WGPUTextureView target_view = wgpuTextureCreateView(surface_texture.texture, &view_descriptor);
-
-    #ifndef WEBGPU_BACKEND_WGPU
-    // We no longer need the texture, only its view
-    // (NB: with wgpu-native, surface textures must be release after the call to wgpuSurfacePresent)
-    wgpuTextureRelease(surface_texture.texture);
-    #endif // WEBGPU_BACKEND_WGPU
-
-    return target_view;
-}
\ No newline at end of file
+    render_pass_descriptor.colorAttachmentCount = 1;
+    render_pass_descriptor.colorAttachments = &render_pass_color_attachment;
+    render_pass_descriptor.depthStencilAttachment = nullptr;
+    render_pass_descriptor.timestampWrites = scaler.GetSceneTimestampWrites();
+
+    WGPURenderPassEncoder render_pass = wgpuCommandEncoderBeginRenderPass(encoder, &render_pass_descriptor);
+
+    scaler.SetSceneViewport(render_pass);
+    m_particles.Draw(render_pass);
+
+    wgpuRenderPassEncoderEnd(render_pass);
+    wgpuRenderPassEncoderRelease(render_pass);
+}
@@ -3,6 +3,17 @@
 
 #include <webgpu/webgpu.h>
 #include "webgpu-utils.h"
+#include "compute.h"
+#include "gpu-primitives.h"
+#include "particles.h"
+#include "mipmaps.h"
+#include "resolution-scaler.h"
+#include "window-manager.h"
+#include "message-queue.h"
+#include "simulation.h"
+
+#include <atomic>
+#include <thread>
 
 #ifdef WEBGPU_BACKEND_WGPU
 #include <webgpu/wgpu.h>
@@ -12,27 +23,109 @@
 #  include <emscripten.h>
 #endif // __EMSCRIPTEN__
 
+/**
+ * A window event, as forwarded from the main thread to the renderer.
+ */
+struct WindowEvent
+{
+    enum class Type
+    {
+        FramebufferResized,
+        VisibilityChanged,
+        FrameRequested,
+        FramePresented,
+        CloseRequested,
+    };
+
+    Type type = Type::FrameRequested;
+    GLFWwindow* window = nullptr;
+    int width = 0;
+    int height = 0;
+    int visibility = 0;
+    bool presented = false;
+    double time = 0.0;
+    double refresh_interval = 0.0;
+    // When the feedback of the next present was requested
+    double feedback_request_time = 0.0;
+};
+
 class Application
 {
 public:
     // Initialize everything and return true if it went all right
-    bool Initialize();
+    // All the windows show the same scene with a single device. An exclusive
+    // full screen first window trades tear-free output for latency: it bypasses
+    // the compositor and presents immediately when the surface allows.
+    bool Initialize(bool exclusive_fullscreen = false, int window_count = 1);
 
     // Uninitialize everything that was initialized
     void Terminate();
 
-    // Draw a frame and handle events
+    // Draw a frame and handle events, both on the calling thread
     void MainLoop();
 
+    // Simulate and render on threads of their own, the render thread owning
+    // the device from then on. The main thread only waits for window events in
+    // ProcessEvents() and forwards them, so that input never waits on a frame
+    // and a frame never waits on a burst of events.
+    void StartThreads();
+    void ProcessEvents();
+    void StopThreads();
+
+    // Compute work queued here is submitted together with the next frame.
+    // Only the thread that renders may use it: the calling thread with
+    // MainLoop(), the render thread between StartThreads() and StopThreads().
+    ComputeContext& GetCompute();
+
+    // Mip chains are generated with the compute work of the next frame, with
+    // the same threading rule as GetCompute()
+    MipmapGenerator& GetMipmaps();
+
     // Return true as long as the main loop should keep on running
     bool IsRunning();
 
+    // Called from the GLFW callbacks, on the main thread
+    void PostWindowEvent(WindowEvent const& event);
+
 private:
-    WGPUTextureView GetNextSurfaceViewData();
+    void RenderFrame();
+    void HandleWindowEvents();
+    void WaitForWindowEvents(double seconds);
+    void DestroyReleasedWindows();
+
+    // Render the scene of one window, at the resolution its scaler picked
+    void RenderScene(WGPUCommandEncoder encoder, ResolutionScaler& scaler);
 
     // We put here all the variables that are shared between init and main loop
-    GLFWwindow* m_window;
     WGPUDevice  m_device;
     WGPUQueue   m_queue;
-    WGPUSurface m_surface;
+
+    ComputeContext  m_compute;
+    GpuPrimitives   m_primitives;
+    ParticleSystem  m_particles;
+    MipmapGenerator m_mipmaps;
+
+    // Each window has its own surface, and renders the scene at a dynamic
+    // resolution before upscaling it
+    WindowManager m_windows;
+
+    // The scene logic runs at a fixed tick, and each frame draws its state
+    // interpolated at the time of the frame
+    static constexpr double kSimulationTickRate = 50.0;
+    SimulationScheduler m_simulation;
+
+    // Time of the previous frame, to advance the particles
+    double m_last_frame_time = 0.0;
+
+    // Window events go from the main thread to the renderer, and windows whose
+    // surface is released go back to the main thread to be destroyed
+    MessageQueue<WindowEvent, 1024> m_window_events;
+    MessageQueue<GLFWwindow*, 256> m_released_windows;
+    // Windows not destroyed yet, only used by the main thread
+    size_t m_open_windows = 0;
+
+    std::thread m_render_thread;
+    bool m_threaded = false;
+    // Thread that renders and owns the device, checked by the accessors
+    std::atomic<std::thread::id> m_device_thread;
 };
\ No newline at end of file
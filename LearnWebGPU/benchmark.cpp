@@ -0,0 +1,297 @@
+// Throughput benchmark of the GPU primitives. Every result is checked against
+// the CPU reference before it is timed.
+
+#include "gpu-primitives.h"
+#include "webgpu-utils.h"
+
+#include <webgpu/webgpu.h>
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <vector>
+
+namespace
+{
+    WGPUBuffer createStorageBuffer(WGPUDevice device, WGPUQueue queue, std::vector<uint32_t> const& data)
+    {
+        WGPUBufferDescriptor buffer_descriptor = {};
+        buffer_descriptor.nextInChain = nullptr;
+        buffer_descriptor.label = "Benchmark buffer";
+        buffer_descriptor.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopySrc | WGPUBufferUsage_CopyDst;
+        buffer_descriptor.size = std::max<uint64_t>(data.size() * sizeof(uint32_t), 16);
+        buffer_descriptor.mappedAtCreation = false;
+        WGPUBuffer buffer = wgpuDeviceCreateBuffer(device, &buffer_descriptor);
+
+        if (!data.empty())
+            wgpuQueueWriteBuffer(queue, buffer, 0, data.data(), data.size() * sizeof(uint32_t));
+
+        return buffer;
+    }
+
+    // Run `work` a few times and return the best throughput in elements per second
+    double measure(ComputeContext& compute, uint32_t element_count, std::function<void()> const& work)
+    {
+        constexpr int kRuns = 10;
+        double best_seconds = 0.0;
+
+        for (int run = 0; run < kRuns; ++run)
+        {
+            compute.Finish();
+            auto start = std::chrono::steady_clock::now();
+            work();
+            compute.Finish();
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (run == 0 || elapsed.count() < best_seconds)
+                best_seconds = elapsed.count();
+        }
+
+        return element_count / best_seconds;
+    }
+
+    void report(char const* name, uint32_t element_count, bool valid, double elements_per_second)
+    {
+        std::cout << name << " (" << element_count << " elements): ";
+        if (!valid)
+        {
+            std::cout << "MISMATCH with CPU reference" << std::endl;
+            return;
+        }
+        std::cout << elements_per_second / 1e6 << " Mkeys/s" << std::endl;
+    }
+
+    bool benchmarkScan(ComputeContext& compute, GpuPrimitives& primitives, std::vector<uint32_t> const& values)
+    {
+        uint32_t count = static_cast<uint32_t>(values.size());
+        WGPUBuffer buffer = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), values);
+
+        primitives.ExclusiveScan(buffer, count);
+        auto result = compute.ReadBuffer<uint32_t>(buffer, 0, count);
+        std::vector<uint32_t> expected = values;
+        cpuExclusiveScan(expected);
+        bool valid = compute.Wait(result) == expected;
+
+        double throughput = measure(compute, count, [&]() { primitives.ExclusiveScan(buffer, count); });
+        report("Exclusive scan", count, valid, throughput);
+
+        wgpuBufferRelease(buffer);
+        return valid;
+    }
+
+    bool benchmarkRadixSort(ComputeContext& compute, GpuPrimitives& primitives, std::vector<uint32_t> const& keys, SortKeyWidth key_width)
+    {
+        uint32_t key_words = static_cast<uint32_t>(key_width);
+        uint32_t count = static_cast<uint32_t>(keys.size() / key_words);
+
+        std::vector<uint32_t> payload(count);
+        for (uint32_t i = 0; i < count; ++i)
+            payload[i] = i;
+
+        WGPUBuffer key_buffer = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), keys);
+        WGPUBuffer payload_buffer = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), payload);
+
+        primitives.RadixSort(key_buffer, payload_buffer, count, key_width);
+        auto sorted_keys = compute.ReadBuffer<uint32_t>(key_buffer, 0, keys.size());
+        auto sorted_payload = compute.ReadBuffer<uint32_t>(payload_buffer, 0, count);
+
+        std::vector<uint32_t> expected_keys = keys;
+        std::vector<uint32_t> expected_payload = payload;
+        cpuRadixSort(expected_keys, &expected_payload, key_width);
+        bool valid = compute.Wait(sorted_keys) == expected_keys && compute.Wait(sorted_payload) == expected_payload;
+
+        double throughput = measure(compute, count, [&]() { primitives.RadixSort(key_buffer, payload_buffer, count, key_width); });
+        report(key_width == SortKeyWidth::Bits32 ? "Radix sort, 32-bit keys + payload" : "Radix sort, 64-bit keys + payload", count, valid, throughput);
+
+        wgpuBufferRelease(key_buffer);
+        wgpuBufferRelease(payload_buffer);
+        return valid;
+    }
+
+    bool benchmarkCompact(ComputeContext& compute, GpuPrimitives& primitives, std::vector<uint32_t> const& values)
+    {
+        uint32_t count = static_cast<uint32_t>(values.size());
+        std::vector<uint32_t> flags(count);
+        for (uint32_t i = 0; i < count; ++i)
+            flags[i] = values[i] & 1;
+
+        WGPUBuffer input = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), values);
+        WGPUBuffer flag_buffer = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), flags);
+        WGPUBuffer output = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), std::vector<uint32_t>(count, 0));
+        WGPUBuffer output_count = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), { 0 });
+
+        primitives.Compact(input, flag_buffer, count, output, output_count);
+        auto kept = compute.ReadBuffer<uint32_t>(output_count, 0, 1);
+        auto compacted = compute.ReadBuffer<uint32_t>(output, 0, count);
+
+        std::vector<uint32_t> expected = cpuCompact(values, flags);
+        std::vector<uint32_t> result = compute.Wait(compacted);
+        bool valid = compute.Wait(kept)[0] == expected.size()
+            && std::equal(expected.begin(), expected.end(), result.begin());
+
+        double throughput = measure(compute, count, [&]() { primitives.Compact(input, flag_buffer, count, output, output_count); });
+        report("Stream compaction", count, valid, throughput);
+
+        for (WGPUBuffer buffer : { input, flag_buffer, output, output_count })
+            wgpuBufferRelease(buffer);
+        return valid;
+    }
+
+    bool benchmarkHistogram(ComputeContext& compute, GpuPrimitives& primitives, std::vector<uint32_t> const& values)
+    {
+        constexpr uint32_t kBinCount = 256;
+        uint32_t count = static_cast<uint32_t>(values.size());
+
+        WGPUBuffer input = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), values);
+        WGPUBuffer bins = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), std::vector<uint32_t>(kBinCount, 0));
+
+        primitives.Histogram(input, count, bins, kBinCount, 8);
+        auto result = compute.ReadBuffer<uint32_t>(bins, 0, kBinCount);
+        bool valid = compute.Wait(result) == cpuHistogram(values, kBinCount, 8);
+
+        double throughput = measure(compute, count, [&]() { primitives.Histogram(input, count, bins, kBinCount, 8); });
+        report("Histogram, 256 bins", count, valid, throughput);
+
+        wgpuBufferRelease(input);
+        wgpuBufferRelease(bins);
+        return valid;
+    }
+
+    // Queue primitives on both sides of an Encode() and submit them together,
+    // as the render loop does, so that the later ones cannot reuse parameter
+    // buffers the encoded ones still read
+    bool checkSharedSubmit(ComputeContext& compute, GpuPrimitives& primitives, std::vector<uint32_t> const& values)
+    {
+        constexpr uint32_t kBinCount = 16;
+        uint32_t count = static_cast<uint32_t>(values.size());
+
+        WGPUBuffer scanned = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), values);
+        WGPUBuffer input = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), values);
+        WGPUBuffer bins = createStorageBuffer(compute.GetDevice(), compute.GetQueue(), std::vector<uint32_t>(kBinCount, 0));
+
+        WGPUCommandEncoderDescriptor encoder_descriptor = {};
+        encoder_descriptor.nextInChain = nullptr;
+        encoder_descriptor.label = "Shared submit command encoder";
+        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(compute.GetDevice(), &encoder_descriptor);
+
+        primitives.ExclusiveScan(scanned, count);
+        compute.Encode(encoder);
+        primitives.Histogram(input, count, bins, kBinCount, 4);
+        auto scan_result = compute.ReadBuffer<uint32_t>(scanned, 0, count);
+        auto bin_result = compute.ReadBuffer<uint32_t>(bins, 0, kBinCount);
+        compute.Encode(encoder);
+
+        WGPUCommandBufferDescriptor command_buffer_descriptor = {};
+        command_buffer_descriptor.nextInChain = nullptr;
+        command_buffer_descriptor.label = "Shared submit command buffer";
+        WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &command_buffer_descriptor);
+        wgpuCommandEncoderRelease(encoder);
+        wgpuQueueSubmit(compute.GetQueue(), 1, &command);
+        wgpuCommandBufferRelease(command);
+        compute.MapReadbacks();
+
+        std::vector<uint32_t> expected = values;
+        cpuExclusiveScan(expected);
+        bool valid = compute.Wait(scan_result) == expected
+            && compute.Wait(bin_result) == cpuHistogram(values, kBinCount, 4);
+
+        std::cout << "Scan and histogram in one submit (" << count << " elements): "
+                  << (valid ? "OK" : "MISMATCH with CPU reference") << std::endl;
+
+        for (WGPUBuffer buffer : { scanned, input, bins })
+            wgpuBufferRelease(buffer);
+        return valid;
+    }
+}
+
+int main()
+{
+    WGPUInstanceDescriptor desc = {};
+    desc.nextInChain = nullptr;
+    WGPUInstance instance = wgpuCreateInstance(&desc);
+    if (!instance)
+    {
+        std::cerr << "Could not initialize WebGPU." << std::endl;
+        return 1;
+    }
+
+    // No surface: the benchmark runs headless
+    WGPURequestAdapterOptions adapter_options = {};
+    adapter_options.nextInChain = nullptr;
+    WGPUAdapter adapter = requestAdapterSync(instance, &adapter_options);
+    wgpuInstanceRelease(instance);
+    if (!adapter)
+        return 1;
+
+    WGPUDeviceDescriptor device_descriptor = {};
+    device_descriptor.nextInChain = nullptr;
+    device_descriptor.label = "Benchmark device";
+    device_descriptor.requiredFeatureCount = 0;
+    device_descriptor.requiredLimits = nullptr;
+    device_descriptor.defaultQueue.nextInChain = nullptr;
+    device_descriptor.defaultQueue.label = "Benchmark queue";
+    device_descriptor.deviceLostCallback = nullptr;
+    WGPUDevice device = requestDeviceSync(adapter, &device_descriptor);
+    wgpuAdapterRelease(adapter);
+    if (!device)
+        return 1;
+
+    auto onDeviceError = [](WGPUErrorType type, const char* message, [[maybe_unused]] void* user_data)
+        {
+            std::cout << "Uncaptured device error: type " << type;
+            if (message)
+                std::cout << " (" << message << ")";
+            std::cout << std::endl;
+        };
+    wgpuDeviceSetUncapturedErrorCallback(device, onDeviceError, nullptr /*user_data*/);
+
+    WGPUQueue queue = wgpuDeviceGetQueue(device);
+
+    ComputeContext compute;
+    GpuPrimitives primitives;
+    if (!compute.Initialize(device, queue) || !primitives.Initialize(compute))
+        return 1;
+
+    uint64_t const max_binding_size = compute.GetLimits().maxStorageBufferBindingSize;
+    std::mt19937 random(1234);
+    bool all_valid = true;
+
+    {
+        std::vector<uint32_t> values(1u << 16);
+        for (uint32_t& value : values)
+            value = random() & 0xff;
+        all_valid &= checkSharedSubmit(compute, primitives, values);
+    }
+
+    for (uint32_t count : { 1u << 16, 1u << 20, 1u << 22, 1u << 24 })
+    {
+        std::vector<uint32_t> values(count);
+        for (uint32_t& value : values)
+            value = random();
+
+        std::vector<uint32_t> small_values(count);
+        for (uint32_t& value : small_values)
+            value = random() & 0xff;
+
+        all_valid &= benchmarkScan(compute, primitives, small_values);
+        all_valid &= benchmarkRadixSort(compute, primitives, values, SortKeyWidth::Bits32);
+        all_valid &= benchmarkCompact(compute, primitives, values);
+        all_valid &= benchmarkHistogram(compute, primitives, values);
+
+        if (uint64_t(count) * 2 * sizeof(uint32_t) <= max_binding_size)
+        {
+            std::vector<uint32_t> wide_keys(uint64_t(count) * 2);
+            for (uint32_t& word : wide_keys)
+                word = random();
+            all_valid &= benchmarkRadixSort(compute, primitives, wide_keys, SortKeyWidth::Bits64);
+        }
+    }
+
+    primitives.Terminate();
+    compute.Terminate();
+    wgpuQueueRelease(queue);
+    wgpuDeviceRelease(device);
+
+    return all_valid ? 0 : 1;
+}
@@ -0,0 +1,456 @@
+#include "compute.h"
+#include "webgpu-utils.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+
+#ifdef WEBGPU_BACKEND_WGPU
+#include <webgpu/wgpu.h>
+#endif // WEBGPU_BACKEND_WGPU
+
+#ifdef __EMSCRIPTEN__
+#  include <emscripten.h>
+#endif // __EMSCRIPTEN__
+
+namespace
+{
+    // Largest power of two lower or equal to value (value must be > 0)
+    uint32_t floorPowerOfTwo(uint32_t value)
+    {
+        uint32_t result = 1;
+        while (result <= value / 2)
+            result *= 2;
+        return result;
+    }
+
+    uint32_t divideRoundUp(uint32_t value, uint32_t divisor)
+    {
+        return (value + divisor - 1) / divisor;
+    }
+
+    // Constants and helpers made available to every kernel
+    std::string makeKernelPrelude(WorkgroupSize size)
+    {
+        std::string prelude;
+        prelude += "const WORKGROUP_SIZE_X: u32 = " + std::to_string(size.x) + "u;\n";
+        prelude += "const WORKGROUP_SIZE_Y: u32 = " + std::to_string(size.y) + "u;\n";
+        prelude += "const WORKGROUP_SIZE_Z: u32 = " + std::to_string(size.z) + "u;\n";
+        prelude +=
+            "fn global_index_1d(workgroup_id: vec3<u32>, local_index: u32, num_workgroups: vec3<u32>) -> u32 {\n"
+            "    return (workgroup_id.y * num_workgroups.x + workgroup_id.x) * WORKGROUP_SIZE_X + local_index;\n"
+            "}\n";
+        return prelude;
+    }
+}
+
+WorkgroupSize chooseWorkgroupSize(WGPULimits const& limits, uint32_t dimensions, uint32_t preferred_invocations)
+{
+    assert(dimensions >= 1 && dimensions <= 3);
+
+    uint32_t budget = floorPowerOfTwo(std::max(1u, std::min(preferred_invocations, limits.maxComputeInvocationsPerWorkgroup)));
+    uint32_t const max_size[3] = { limits.maxComputeWorkgroupSizeX, limits.maxComputeWorkgroupSizeY, limits.maxComputeWorkgroupSizeZ };
+    uint32_t size[3] = { 1, 1, 1 };
+
+    // Hand out the invocation budget one factor of two at a time, round robin
+    // over the axes, so that 2D and 3D workgroups stay as square as possible.
+    bool grew = true;
+    while (grew)
+    {
+        grew = false;
+        for (uint32_t axis = 0; axis < dimensions; ++axis)
+        {
+            if (budget < 2 || size[axis] * 2 > max_size[axis])
+                continue;
+            size[axis] *= 2;
+            budget /= 2;
+            grew = true;
+        }
+    }
+
+    return WorkgroupSize{ size[0], size[1], size[2] };
+}
+
+ComputeKernel::ComputeKernel(WGPUDevice device, WGPUComputePipeline pipeline, WorkgroupSize workgroup_size, uint32_t dimensions)
+    : m_device(device)
+    , m_pipeline(pipeline)
+    , m_workgroup_size(workgroup_size)
+    , m_dimensions(dimensions)
+{}
+
+ComputeKernel::~ComputeKernel()
+{
+    wgpuComputePipelineRelease(m_pipeline);
+}
+
+WGPUBindGroup ComputeKernel::CreateBindGroup(uint32_t group, std::initializer_list<WGPUBuffer> buffers) const
+{
+    std::vector<WGPUBindGroupEntry> entries;
+    entries.reserve(buffers.size());
+    for (WGPUBuffer buffer : buffers)
+    {
+        WGPUBindGroupEntry entry = {};
+        entry.nextInChain = nullptr;
+        entry.binding = static_cast<uint32_t>(entries.size());
+        entry.buffer = buffer;
+        entry.offset = 0;
+        entry.size = wgpuBufferGetSize(buffer);
+        entries.push_back(entry);
+    }
+
+    WGPUBindGroupLayout layout = wgpuComputePipelineGetBindGroupLayout(m_pipeline, group);
+
+    WGPUBindGroupDescriptor bind_group_descriptor = {};
+    bind_group_descriptor.nextInChain = nullptr;
+    bind_group_descriptor.label = "Compute bind group";
+    bind_group_descriptor.layout = layout;
+    bind_group_descriptor.entryCount = entries.size();
+    bind_group_descriptor.entries = entries.data();
+    WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(m_device, &bind_group_descriptor);
+
+    wgpuBindGroupLayoutRelease(layout);
+
+    return bind_group;
+}
+
+bool ComputeContext::Initialize(WGPUDevice device, WGPUQueue queue)
+{
+    m_device = device;
+    m_queue = queue;
+
+    if (!getDeviceLimits(device, m_limits))
+    {
+        std::cerr << "Could not read the device limits for compute!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void ComputeContext::Terminate()
+{
+    ReleaseDispatches();
+
+    for (PendingReadback& readback : m_readbacks)
+    {
+        readback.on_failure("Compute context terminated");
+        wgpuBufferRelease(readback.source);
+        wgpuBufferRelease(readback.staging);
+    }
+    m_readbacks.clear();
+
+    for (PendingReadback& readback : m_encoded_readbacks)
+    {
+        readback.on_failure("Compute context terminated");
+        wgpuBufferRelease(readback.staging);
+    }
+    m_encoded_readbacks.clear();
+    m_dispatches_encoded = false;
+
+    m_kernels.clear();
+}
+
+ComputeKernel* ComputeContext::CreateKernel(char const* label, std::string const& wgsl_source, char const* entry_point, uint32_t dimensions, WGPUPipelineLayout layout)
+{
+    WorkgroupSize workgroup_size = chooseWorkgroupSize(m_limits, dimensions);
+    std::string code = makeKernelPrelude(workgroup_size) + wgsl_source;
+
+    WGPUShaderModuleWGSLDescriptor wgsl_descriptor = {};
+    wgsl_descriptor.chain.next = nullptr;
+    wgsl_descriptor.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+    wgsl_descriptor.code = code.c_str();
+
+    WGPUShaderModuleDescriptor shader_descriptor = {};
+    shader_descriptor.nextInChain = &wgsl_descriptor.chain;
+    shader_descriptor.label = label;
+#ifdef WEBGPU_BACKEND_WGPU
+    shader_descriptor.hintCount = 0;
+    shader_descriptor.hints = nullptr;
+#endif // WEBGPU_BACKEND_WGPU
+    WGPUShaderModule shader_module = wgpuDeviceCreateShaderModule(m_device, &shader_descriptor);
+
+    WGPUComputePipelineDescriptor pipeline_descriptor = {};
+    pipeline_descriptor.nextInChain = nullptr;
+    pipeline_descriptor.label = label;
+    pipeline_descriptor.layout = layout; // deduced from the shader if null
+    pipeline_descriptor.compute.nextInChain = nullptr;
+    pipeline_descriptor.compute.module = shader_module;
+    pipeline_descriptor.compute.entryPoint = entry_point;
+    pipeline_descriptor.compute.constantCount = 0;
+    pipeline_descriptor.compute.constants = nullptr;
+    WGPUComputePipeline pipeline = wgpuDeviceCreateComputePipeline(m_device, &pipeline_descriptor);
+
+    wgpuShaderModuleRelease(shader_module);
+
+    if (!pipeline)
+    {
+        std::cerr << "Could not create compute kernel " << label << std::endl;
+        return nullptr;
+    }
+
+    m_kernels.push_back(std::make_unique<ComputeKernel>(m_device, pipeline, workgroup_size, dimensions));
+    return m_kernels.back().get();
+}
+
+std::vector<WGPUBindGroup> ComputeContext::ReferenceBindGroups(std::initializer_list<WGPUBindGroup> bind_groups)
+{
+    // Bind groups are only used when the batch is encoded, so we keep them
+    // alive until then in case the caller releases them right away.
+    std::vector<WGPUBindGroup> result(bind_groups);
+    for (WGPUBindGroup bind_group : result)
+        wgpuBindGroupReference(bind_group);
+    return result;
+}
+
+void ComputeContext::ReleaseDispatches()
+{
+    for (PendingDispatch& dispatch : m_dispatches)
+    {
+        for (WGPUBindGroup bind_group : dispatch.bind_groups)
+            wgpuBindGroupRelease(bind_group);
+        if (dispatch.indirect_buffer)
+            wgpuBufferRelease(dispatch.indirect_buffer);
+    }
+    m_dispatches.clear();
+}
+
+void ComputeContext::Dispatch(ComputeKernel const& kernel, std::initializer_list<WGPUBindGroup> bind_groups, uint32_t count_x, uint32_t count_y, uint32_t count_z)
+{
+    if (count_x == 0 || count_y == 0 || count_z == 0)
+        return;
+
+    WorkgroupSize size = kernel.GetWorkgroupSize();
+    uint32_t const max_groups = m_limits.maxComputeWorkgroupsPerDimension;
+
+    PendingDispatch dispatch = {};
+    dispatch.pipeline = kernel.GetPipeline();
+    dispatch.workgroups[0] = divideRoundUp(count_x, size.x);
+    dispatch.workgroups[1] = divideRoundUp(count_y, size.y);
+    dispatch.workgroups[2] = divideRoundUp(count_z, size.z);
+    dispatch.indirect_buffer = nullptr;
+    dispatch.indirect_offset = 0;
+
+    if (kernel.GetDimensions() == 1 && dispatch.workgroups[0] > max_groups)
+    {
+        // Fold large 1D grids onto the y axis, global_index_1d() unfolds them
+        uint32_t groups = dispatch.workgroups[0];
+        dispatch.workgroups[0] = max_groups;
+        dispatch.workgroups[1] = divideRoundUp(groups, max_groups);
+    }
+
+    assert(dispatch.workgroups[0] <= max_groups && dispatch.workgroups[1] <= max_groups && dispatch.workgroups[2] <= max_groups);
+
+    dispatch.bind_groups = ReferenceBindGroups(bind_groups);
+    m_dispatches.push_back(std::move(dispatch));
+}
+
+void ComputeContext::DispatchIndirect(ComputeKernel const& kernel, std::initializer_list<WGPUBindGroup> bind_groups, WGPUBuffer indirect_buffer, uint64_t indirect_offset)
+{
+    PendingDispatch dispatch = {};
+    dispatch.pipeline = kernel.GetPipeline();
+    dispatch.indirect_buffer = indirect_buffer;
+    dispatch.indirect_offset = indirect_offset;
+    wgpuBufferReference(indirect_buffer);
+    dispatch.bind_groups = ReferenceBindGroups(bind_groups);
+    m_dispatches.push_back(std::move(dispatch));
+}
+
+void ComputeContext::QueueCommands(std::function<void(WGPUCommandEncoder)> record)
+{
+    PendingDispatch commands = {};
+    commands.pipeline = nullptr;
+    commands.indirect_buffer = nullptr;
+    commands.commands = std::move(record);
+    m_dispatches.push_back(std::move(commands));
+}
+
+void ComputeContext::QueueReadback(WGPUBuffer source, uint64_t offset, uint64_t size, std::function<void(void const*)> on_success, std::function<void(char const*)> on_failure)
+{
+    // Buffer copies work on multiples of 4 bytes, and copying more than asked
+    // could read past the end of the source
+    if (offset % 4 != 0 || size % 4 != 0)
+    {
+        on_failure("Compute readback offset and size must be multiples of 4 bytes");
+        return;
+    }
+    if (offset > wgpuBufferGetSize(source) || size > wgpuBufferGetSize(source) - offset)
+    {
+        on_failure("Compute readback goes past the end of its source buffer");
+        return;
+    }
+
+    WGPUBufferDescriptor staging_descriptor = {};
+    staging_descriptor.nextInChain = nullptr;
+    staging_descriptor.label = "Compute readback buffer";
+    staging_descriptor.usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_MapRead;
+    staging_descriptor.size = size;
+    staging_descriptor.mappedAtCreation = false;
+
+    // Keep the source alive until the copy is encoded
+    wgpuBufferReference(source);
+
+    PendingReadback readback;
+    readback.source = source;
+    readback.offset = offset;
+    readback.size = size;
+    readback.staging = wgpuDeviceCreateBuffer(m_device, &staging_descriptor);
+    readback.on_success = std::move(on_success);
+    readback.on_failure = std::move(on_failure);
+    m_readbacks.push_back(std::move(readback));
+}
+
+bool ComputeContext::HasPendingWork() const
+{
+    return !m_dispatches.empty() || !m_readbacks.empty();
+}
+
+void ComputeContext::Encode(WGPUCommandEncoder encoder)
+{
+    if (!m_dispatches.empty())
+    {
+        WGPUComputePassDescriptor compute_pass_descriptor = {};
+        compute_pass_descriptor.nextInChain = nullptr;
+        compute_pass_descriptor.label = "Batched compute pass";
+        compute_pass_descriptor.timestampWrites = nullptr;
+
+        // The pass is only interrupted by queued commands that cannot be
+        // recorded in a compute pass
+        WGPUComputePassEncoder compute_pass = nullptr;
+
+        // Consecutive dispatches of the same kernel do not set the pipeline again
+        WGPUComputePipeline current_pipeline = nullptr;
+        for (PendingDispatch& dispatch : m_dispatches)
+        {
+            if (dispatch.commands)
+            {
+                if (compute_pass)
+                {
+                    wgpuComputePassEncoderEnd(compute_pass);
+                    wgpuComputePassEncoderRelease(compute_pass);
+                    compute_pass = nullptr;
+                }
+                dispatch.commands(encoder);
+                continue;
+            }
+
+            if (!compute_pass)
+            {
+                compute_pass = wgpuCommandEncoderBeginComputePass(encoder, &compute_pass_descriptor);
+                current_pipeline = nullptr;
+            }
+
+            if (dispatch.pipeline != current_pipeline)
+            {
+                wgpuComputePassEncoderSetPipeline(compute_pass, dispatch.pipeline);
+                current_pipeline = dispatch.pipeline;
+            }
+
+            for (size_t group = 0; group < dispatch.bind_groups.size(); ++group)
+                wgpuComputePassEncoderSetBindGroup(compute_pass, static_cast<uint32_t>(group), dispatch.bind_groups[group], 0, nullptr);
+
+            if (dispatch.indirect_buffer)
+                wgpuComputePassEncoderDispatchWorkgroupsIndirect(compute_pass, dispatch.indirect_buffer, dispatch.indirect_offset);
+            else
+                wgpuComputePassEncoderDispatchWorkgroups(compute_pass, dispatch.workgroups[0], dispatch.workgroups[1], dispatch.workgroups[2]);
+        }
+
+        if (compute_pass)
+        {
+            wgpuComputePassEncoderEnd(compute_pass);
+            wgpuComputePassEncoderRelease(compute_pass);
+        }
+
+        ReleaseDispatches();
+        m_dispatches_encoded = true;
+    }
+
+    for (PendingReadback& readback : m_readbacks)
+    {
+        wgpuCommandEncoderCopyBufferToBuffer(encoder, readback.source, readback.offset, readback.staging, 0, readback.size);
+        wgpuBufferRelease(readback.source);
+        m_encoded_readbacks.push_back(std::move(readback));
+    }
+    m_readbacks.clear();
+}
+
+void ComputeContext::MapReadbacks()
+{
+    // Called by wgpuBufferMapAsync when the staging buffer is ready, the
+    // readback is handed over through the user data pointer.
+    auto onBufferMapped = [](WGPUBufferMapAsyncStatus status, void* user_data)
+        {
+            std::unique_ptr<PendingReadback> readback(reinterpret_cast<PendingReadback*>(user_data));
+
+            if (status == WGPUBufferMapAsyncStatus_Success)
+            {
+                readback->on_success(wgpuBufferGetConstMappedRange(readback->staging, 0, wgpuBufferGetSize(readback->staging)));
+                wgpuBufferUnmap(readback->staging);
+            }
+            else
+            {
+                readback->on_failure("Could not map compute readback buffer");
+            }
+
+            wgpuBufferRelease(readback->staging);
+        };
+
+    for (PendingReadback& readback : m_encoded_readbacks)
+    {
+        PendingReadback* user_data = new PendingReadback(std::move(readback));
+        wgpuBufferMapAsync(user_data->staging, WGPUMapMode_Read, 0, wgpuBufferGetSize(user_data->staging), onBufferMapped, user_data);
+    }
+    m_encoded_readbacks.clear();
+    m_dispatches_encoded = false;
+}
+
+void ComputeContext::Flush()
+{
+    if (!HasPendingWork())
+        return;
+
+    WGPUCommandEncoderDescriptor encoder_descriptor = {};
+    encoder_descriptor.nextInChain = nullptr;
+    encoder_descriptor.label = "Compute command encoder";
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(m_device, &encoder_descriptor);
+
+    Encode(encoder);
+
+    WGPUCommandBufferDescriptor command_buffer_descriptor = {};
+    command_buffer_descriptor.nextInChain = nullptr;
+    command_buffer_descriptor.label = "Compute command buffer";
+    WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder, &command_buffer_descriptor);
+    wgpuCommandEncoderRelease(encoder);
+
+    wgpuQueueSubmit(m_queue, 1, &command);
+    wgpuCommandBufferRelease(command);
+
+    MapReadbacks();
+}
+
+void ComputeContext::Finish()
+{
+    Flush();
+
+    bool done = false;
+    auto onQueueWorkDone = [](WGPUQueueWorkDoneStatus /* status */, void* user_data)
+        {
+            *reinterpret_cast<bool*>(user_data) = true;
+        };
+    wgpuQueueOnSubmittedWorkDone(m_queue, onQueueWorkDone, &done);
+
+    while (!done)
+        Poll(true);
+}
+
+void ComputeContext::Poll([[maybe_unused]] bool wait)
+{
+#if defined(WEBGPU_BACKEND_DAWN)
+    wgpuDeviceTick(m_device);
+#elif defined(WEBGPU_BACKEND_WGPU)
+    wgpuDevicePoll(m_device, wait, nullptr);
+#elif defined(__EMSCRIPTEN__)
+    // Callbacks are run by the browser, give it a chance to do so
+    if (wait)
+        emscripten_sleep(1);
+#endif
+}
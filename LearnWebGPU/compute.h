@@ -0,0 +1,213 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Number of invocations of a workgroup along each axis, as written in the
+ * @workgroup_size attribute of a compute entry point.
+ */
+struct WorkgroupSize
+{
+    uint32_t x = 1;
+    uint32_t y = 1;
+    uint32_t z = 1;
+};
+
+/**
+ * Pick a workgroup size for a kernel working on a grid of the given number of
+ * dimensions (1, 2 or 3). Each axis is a power of two, the total number of
+ * invocations never exceeds `preferred_invocations` and the size respects the
+ * maxComputeWorkgroupSize* and maxComputeInvocationsPerWorkgroup limits.
+ */
+WorkgroupSize chooseWorkgroupSize(WGPULimits const& limits, uint32_t dimensions, uint32_t preferred_invocations = 256);
+
+/**
+ * A compute pipeline together with the workgroup size it was compiled with.
+ *
+ * The WGSL source given to ComputeContext::CreateKernel is prefixed with the
+ * constants WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y and WORKGROUP_SIZE_Z, so a
+ * kernel is written as
+ *     @compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+ *     fn main(...) { ... }
+ * and the prelude also provides global_index_1d() for 1D kernels, whose grid
+ * may be folded onto the y axis when it is larger than
+ * maxComputeWorkgroupsPerDimension.
+ */
+class ComputeKernel
+{
+public:
+    ComputeKernel(WGPUDevice device, WGPUComputePipeline pipeline, WorkgroupSize workgroup_size, uint32_t dimensions);
+    ~ComputeKernel();
+
+    ComputeKernel(ComputeKernel const&) = delete;
+    ComputeKernel& operator=(ComputeKernel const&) = delete;
+
+    WGPUComputePipeline GetPipeline() const { return m_pipeline; }
+    WorkgroupSize GetWorkgroupSize() const { return m_workgroup_size; }
+    uint32_t GetDimensions() const { return m_dimensions; }
+
+    // Create a bind group for the given group index of this kernel, where the
+    // i-th buffer is bound (in full) to @binding(i). The caller releases it.
+    WGPUBindGroup CreateBindGroup(uint32_t group, std::initializer_list<WGPUBuffer> buffers) const;
+
+private:
+    WGPUDevice m_device;
+    WGPUComputePipeline m_pipeline;
+    WorkgroupSize m_workgroup_size;
+    uint32_t m_dimensions;
+};
+
+/**
+ * Record compute work and batch it: every dispatch queued between two flushes
+ * is encoded in a single compute pass, and readbacks of the results are
+ * delivered through futures once the GPU is done with them.
+ *
+ * Futures are fulfilled from the map callbacks of WebGPU, which only run when
+ * the device is polled (see Poll() and Wait()). The main loop of the
+ * application polls the device every frame.
+ */
+class ComputeContext
+{
+public:
+    // Initialize the context for the given device and queue, return false if
+    // the limits of the device could not be read.
+    bool Initialize(WGPUDevice device, WGPUQueue queue);
+
+    // Release every kernel and drop pending work
+    void Terminate();
+
+    // Compile a kernel, `dimensions` being the number of axes of its grid.
+    // The bind group layouts are deduced from the shader unless an explicit
+    // `layout` is given. The kernel is owned by the context and lives until
+    // Terminate().
+    ComputeKernel* CreateKernel(char const* label, std::string const& wgsl_source, char const* entry_point, uint32_t dimensions = 1, WGPUPipelineLayout layout = nullptr);
+
+    // Queue a dispatch covering at least count_x * count_y * count_z
+    // invocations; the number of workgroups is derived from the kernel's
+    // workgroup size. Bind group i is set at group index i.
+    void Dispatch(ComputeKernel const& kernel, std::initializer_list<WGPUBindGroup> bind_groups, uint32_t count_x, uint32_t count_y = 1, uint32_t count_z = 1);
+
+    // Queue a dispatch whose workgroup counts are read from `indirect_buffer`
+    void DispatchIndirect(ComputeKernel const& kernel, std::initializer_list<WGPUBindGroup> bind_groups, WGPUBuffer indirect_buffer, uint64_t indirect_offset = 0);
+
+    // Queue commands that cannot be recorded in a compute pass (copies,
+    // render passes). They run in order with the queued dispatches.
+    void QueueCommands(std::function<void(WGPUCommandEncoder)> record);
+
+    // Queue a copy of `count` elements of type T from `source` (starting at
+    // `offset` bytes), readable on the CPU once the returned future is ready.
+    // The offset and size in bytes must be multiples of 4, or the future
+    // holds an error.
+    template <typename T>
+    std::future<std::vector<T>> ReadBuffer(WGPUBuffer source, uint64_t offset, size_t count)
+    {
+        auto promise = std::make_shared<std::promise<std::vector<T>>>();
+        std::future<std::vector<T>> future = promise->get_future();
+
+        QueueReadback(
+            source, offset, count * sizeof(T),
+            [promise, count](void const* data)
+            {
+                std::vector<T> values(count);
+                std::memcpy(values.data(), data, count * sizeof(T));
+                promise->set_value(std::move(values));
+            },
+            [promise](char const* message)
+            {
+                promise->set_exception(std::make_exception_ptr(std::runtime_error(message)));
+            });
+
+        return future;
+    }
+
+    // Return true if some dispatches or readbacks are waiting to be encoded
+    bool HasPendingWork() const;
+
+    // Return true if some dispatches are waiting to be encoded, or were
+    // encoded by Encode() but MapReadbacks() was not called since, meaning
+    // their command buffer may not be submitted yet
+    bool HasUnsubmittedDispatches() const { return !m_dispatches.empty() || m_dispatches_encoded; }
+
+    // Encode all queued dispatches in a single compute pass of `encoder`
+    // (split only around queued commands), followed by the copies of the
+    // queued readbacks. The caller must call
+    // MapReadbacks() once the command buffer has been submitted.
+    void Encode(WGPUCommandEncoder encoder);
+
+    // Start mapping the readbacks encoded by the last call to Encode(), once
+    // its command buffer has been submitted
+    void MapReadbacks();
+
+    // Encode and submit all queued work at once, then start the readbacks
+    void Flush();
+
+    // Let the device process its callbacks, blocking until the queue is idle
+    // if `wait` is true (on backends that support it).
+    void Poll(bool wait);
+
+    // Flush queued work and poll the device until `future` is ready, then
+    // return its value
+    template <typename T>
+    T Wait(std::future<T>& future)
+    {
+        Flush();
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            Poll(true);
+        return future.get();
+    }
+
+    // Flush all queued work and block until the GPU has executed it
+    void Finish();
+
+    WGPUDevice GetDevice() const { return m_device; }
+    WGPUQueue GetQueue() const { return m_queue; }
+    WGPULimits const& GetLimits() const { return m_limits; }
+
+private:
+    struct PendingDispatch
+    {
+        WGPUComputePipeline pipeline;
+        std::vector<WGPUBindGroup> bind_groups;
+        uint32_t workgroups[3];
+        WGPUBuffer indirect_buffer;
+        uint64_t indirect_offset;
+        // When set, recorded outside of the compute pass instead of a dispatch
+        std::function<void(WGPUCommandEncoder)> commands;
+    };
+
+    struct PendingReadback
+    {
+        WGPUBuffer source;
+        uint64_t offset;
+        uint64_t size;
+        WGPUBuffer staging;
+        std::function<void(void const*)> on_success;
+        std::function<void(char const*)> on_failure;
+    };
+
+    void QueueReadback(WGPUBuffer source, uint64_t offset, uint64_t size, std::function<void(void const*)> on_success, std::function<void(char const*)> on_failure);
+    std::vector<WGPUBindGroup> ReferenceBindGroups(std::initializer_list<WGPUBindGroup> bind_groups);
+    void ReleaseDispatches();
+
+    WGPUDevice m_device = nullptr;
+    WGPUQueue  m_queue = nullptr;
+    WGPULimits m_limits = {};
+
+    std::vector<std::unique_ptr<ComputeKernel>> m_kernels;
+    std::vector<PendingDispatch> m_dispatches;
+    std::vector<PendingReadback> m_readbacks;
+    std::vector<PendingReadback> m_encoded_readbacks;
+    // Dispatches were encoded but not known to be submitted yet
+    bool m_dispatches_encoded = false;
+};
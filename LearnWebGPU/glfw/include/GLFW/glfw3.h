@@ -941,6 +941,19 @@ extern "C" {
  */
 #define GLFW_POSITION_Y             0x0002000F
 
+/*! @brief Window occlusion window attribute.
+ *
+ *  Window occlusion [window attribute](@ref GLFW_OCCLUDED_attrib).
+ */
+#define GLFW_OCCLUDED               0x00020010
+
+/*! @brief Exclusive low-latency full screen window hint and attribute.
+ *
+ *  Exclusive low-latency full screen [window hint](@ref GLFW_EXCLUSIVE_FULLSCREEN_hint)
+ *  or [window attribute](@ref GLFW_EXCLUSIVE_FULLSCREEN_attrib).
+ */
+#define GLFW_EXCLUSIVE_FULLSCREEN   0x00020011
+
 /*! @brief Framebuffer bit depth hint.
  *
  *  Framebuffer bit depth [hint](@ref GLFW_RED_BITS).
@@ -1179,6 +1192,9 @@ extern "C" {
 #define GLFW_WAYLAND_PREFER_LIBDECOR    0x00038001
 #define GLFW_WAYLAND_DISABLE_LIBDECOR   0x00038002
 
+#define GLFW_OVERFLOW_DROP          0x00039001
+#define GLFW_OVERFLOW_CALLBACK      0x00039002
+
 #define GLFW_ANY_POSITION           0x80000000
 
 /*! @defgroup shapes Standard cursor shapes
@@ -1327,6 +1343,61 @@ extern "C" {
  *  Wayland specific [init hint](@ref GLFW_WAYLAND_LIBDECOR_hint).
  */
 #define GLFW_WAYLAND_LIBDECOR       0x00053001
+/*! @brief Event queue init hint.
+ *
+ *  Event queue capacity [init hint](@ref GLFW_EVENT_QUEUE_hint).
+ */
+#define GLFW_EVENT_QUEUE            0x00054001
+/*! @brief Event queue init hint.
+ *
+ *  Event queue overflow policy [init hint](@ref GLFW_EVENT_QUEUE_OVERFLOW_hint).
+ */
+#define GLFW_EVENT_QUEUE_OVERFLOW   0x00054002
+/*! @brief Event queue init hint.
+ *
+ *  Event queue coalescing [init hint](@ref GLFW_EVENT_QUEUE_COALESCE_hint).
+ */
+#define GLFW_EVENT_QUEUE_COALESCE   0x00054003
+/*! @brief Input coalescing init hint.
+ *
+ *  Cursor motion and scroll coalescing [init hint](@ref GLFW_COALESCE_MOTION_hint).
+ */
+#define GLFW_COALESCE_MOTION        0x00054004
+/*! @brief Event thread init hint.
+ *
+ *  Event processing off the main thread [init hint](@ref GLFW_EVENT_THREAD_hint).
+ *
+ *  When set to `GLFW_TRUE` on X11 or Wayland, the first thread to process
+ *  events becomes the event thread and the only thread allowed to do so.
+ *  Window callbacks are called on that thread.  Window management functions
+ *  called from other threads, such as @ref glfwSetWindowSize, @ref
+ *  glfwSetWindowTitle, @ref glfwSetInputMode or @ref glfwSetCursor, are queued
+ *  and run by the event thread the next time it processes events, which they
+ *  wake up.  Windows must still be created and destroyed on the event thread.
+ *  This hint is ignored on other platforms.
+ */
+#define GLFW_EVENT_THREAD           0x00054005
+/*! @brief TSC timer init hint.
+ *
+ *  Cycle counter timer [init hint](@ref GLFW_TSC_TIMER_hint).
+ *
+ *  When set to `GLFW_TRUE` on x86-64 Linux, the timer reads the invariant
+ *  time-stamp counter of the CPU directly instead of calling `clock_gettime`,
+ *  if the kernel itself uses that counter as its clock source.  Otherwise the
+ *  timer uses `CLOCK_MONOTONIC_RAW`, which is not slewed by NTP.  This hint is
+ *  ignored on other platforms.
+ */
+#define GLFW_TSC_TIMER              0x00054006
+/*! @brief Clipboard size limit init hint.
+ *
+ *  Clipboard transfer size [init hint](@ref GLFW_CLIPBOARD_SIZE_LIMIT_hint).
+ *
+ *  The largest clipboard string, in bytes, that GLFW will receive from other
+ *  applications.  Transfers that grow past it are abandoned and reported as
+ *  @ref GLFW_FORMAT_UNAVAILABLE.  The default value `GLFW_DONT_CARE` means
+ *  there is no limit.
+ */
+#define GLFW_CLIPBOARD_SIZE_LIMIT   0x00054007
 /*! @} */
 
 /*! @addtogroup init
@@ -1343,6 +1414,58 @@ extern "C" {
 #define GLFW_PLATFORM_NULL          0x00060005
 /*! @} */
 
+/*! @addtogroup input
+ *  @{ */
+/*! @brief Event types of the event queue.
+ *
+ *  The types of [queued events](@ref GLFWevent).
+ */
+#define GLFW_EVENT_NONE             0
+#define GLFW_EVENT_OVERFLOW         0x00070001
+#define GLFW_EVENT_KEY              0x00070002
+#define GLFW_EVENT_CHAR             0x00070003
+#define GLFW_EVENT_MOUSE_BUTTON     0x00070004
+#define GLFW_EVENT_CURSOR_POS       0x00070005
+#define GLFW_EVENT_CURSOR_ENTER     0x00070006
+#define GLFW_EVENT_SCROLL           0x00070007
+#define GLFW_EVENT_WINDOW_POS       0x00070008
+#define GLFW_EVENT_WINDOW_SIZE      0x00070009
+#define GLFW_EVENT_WINDOW_CLOSE     0x0007000A
+#define GLFW_EVENT_WINDOW_REFRESH   0x0007000B
+#define GLFW_EVENT_WINDOW_FOCUS     0x0007000C
+#define GLFW_EVENT_WINDOW_ICONIFY   0x0007000D
+#define GLFW_EVENT_WINDOW_MAXIMIZE  0x0007000E
+#define GLFW_EVENT_FRAMEBUFFER_SIZE 0x0007000F
+#define GLFW_EVENT_CONTENT_SCALE    0x00070010
+#define GLFW_EVENT_WINDOW_VISIBILITY 0x00070011
+/*! @} */
+
+/*! @addtogroup window
+ *  @{ */
+/*! @brief Window visibility states.
+ *
+ *  Whether the contents of a window can be seen, as returned by @ref
+ *  glfwGetWindowVisibility.  When several apply, the first one listed here is
+ *  reported.
+ */
+#define GLFW_VISIBILITY_HIDDEN      0x0003A001
+#define GLFW_VISIBILITY_ICONIFIED   0x0003A002
+#define GLFW_VISIBILITY_OCCLUDED    0x0003A003
+#define GLFW_VISIBILITY_VISIBLE     0x0003A004
+/*! @} */
+
+/*! @addtogroup window
+ *  @{ */
+/*! @brief Presentation feedback flags.
+ *
+ *  How a frame was [presented](@ref GLFWpresentation).
+ */
+#define GLFW_PRESENTATION_VSYNC         0x0001
+#define GLFW_PRESENTATION_HW_CLOCK      0x0002
+#define GLFW_PRESENTATION_HW_COMPLETION 0x0004
+#define GLFW_PRESENTATION_ZERO_COPY     0x0008
+/*! @} */
+
 #define GLFW_DONT_CARE              -1
 
 
@@ -1674,6 +1797,24 @@ typedef void (* GLFWwindowclosefun)(GLFWwindow* window);
  */
 typedef void (* GLFWwindowrefreshfun)(GLFWwindow* window);
 
+/*! @brief The function pointer type for window frame callbacks.
+ *
+ *  This is the function pointer type for window frame callbacks.  A window
+ *  frame callback function has the following signature:
+ *  @code
+ *  void function_name(GLFWwindow* window);
+ *  @endcode
+ *
+ *  @param[in] window The window that is ready for a new frame.
+ *
+ *  @sa @ref glfwSetWindowFrameCallback
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+typedef void (* GLFWwindowframefun)(GLFWwindow* window);
+
 /*! @brief The function pointer type for window focus callbacks.
  *
  *  This is the function pointer type for window focus callbacks.  A window
@@ -1716,6 +1857,28 @@ typedef void (* GLFWwindowfocusfun)(GLFWwindow* window, int focused);
  */
 typedef void (* GLFWwindowiconifyfun)(GLFWwindow* window, int iconified);
 
+/*! @brief The function pointer type for window visibility callbacks.
+ *
+ *  This is the function pointer type for window visibility callbacks.  A
+ *  window visibility callback function has the following signature:
+ *  @code
+ *  void function_name(GLFWwindow* window, int visibility)
+ *  @endcode
+ *
+ *  @param[in] window The window whose visibility changed.
+ *  @param[in] visibility The new visibility state of the window, one of
+ *  `GLFW_VISIBILITY_HIDDEN`, `GLFW_VISIBILITY_ICONIFIED`,
+ *  `GLFW_VISIBILITY_OCCLUDED` or `GLFW_VISIBILITY_VISIBLE`.
+ *
+ *  @sa @ref glfwSetWindowVisibilityCallback
+ *  @sa @ref glfwGetWindowVisibility
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+typedef void (* GLFWwindowvisibilityfun)(GLFWwindow* window, int visibility);
+
 /*! @brief The function pointer type for window maximize callbacks.
  *
  *  This is the function pointer type for window maximize callbacks.  A window
@@ -1968,6 +2131,29 @@ typedef void (* GLFWcharmodsfun)(GLFWwindow* window, unsigned int codepoint, int
  */
 typedef void (* GLFWdropfun)(GLFWwindow* window, int path_count, const char* paths[]);
 
+/*! @brief The function pointer type for clipboard string callbacks.
+ *
+ *  This is the function pointer type for clipboard string callbacks.  A
+ *  clipboard string callback function has the following signature:
+ *  @code
+ *  void function_name(GLFWwindow* window, const char* string)
+ *  @endcode
+ *
+ *  @param[in] window The window that requested the clipboard contents.
+ *  @param[in] string The contents of the clipboard as a UTF-8 encoded string,
+ *  or `NULL` if they could not be received.
+ *
+ *  @pointer_lifetime The string is valid until the callback function returns.
+ *
+ *  @sa @ref clipboard
+ *  @sa @ref glfwRequestClipboardString
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+typedef void (* GLFWclipboardfun)(GLFWwindow* window, const char* string);
+
 /*! @brief The function pointer type for monitor configuration callbacks.
  *
  *  This is the function pointer type for monitor configuration callbacks.
@@ -2010,6 +2196,26 @@ typedef void (* GLFWmonitorfun)(GLFWmonitor* monitor, int event);
  */
 typedef void (* GLFWjoystickfun)(int jid, int event);
 
+/*! @brief The function pointer type for event source callbacks.
+ *
+ *  This is the function pointer type for event source callbacks.  An event
+ *  source callback function has the following signature:
+ *  @code
+ *  void function_name(int fd, void* pointer)
+ *  @endcode
+ *
+ *  @param[in] fd The file descriptor that is ready for reading.
+ *  @param[in] pointer The user pointer passed to @ref glfwAddEventSource.
+ *
+ *  @sa @ref events_sources
+ *  @sa @ref glfwAddEventSource
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+typedef void (* GLFWeventsourcefun)(int fd, void* pointer);
+
 /*! @brief Video mode type.
  *
  *  This describes a single video mode.
@@ -2122,6 +2328,132 @@ typedef struct GLFWgamepadstate
     float axes[6];
 } GLFWgamepadstate;
 
+/*! @brief Queued event.
+ *
+ *  This describes an event retrieved from the event queue with @ref
+ *  glfwGetEvents.  Which members are used depends on the type of the event,
+ *  mirroring the arguments of the matching callback:
+ *
+ *  - `GLFW_EVENT_KEY`: `key`, `scancode`, `action` and `mods`
+ *  - `GLFW_EVENT_CHAR`: `codepoint` and `mods`
+ *  - `GLFW_EVENT_MOUSE_BUTTON`: `key` (the button), `action` and `mods`
+ *  - `GLFW_EVENT_CURSOR_POS` and `GLFW_EVENT_SCROLL`: `x` and `y`
+ *  - `GLFW_EVENT_WINDOW_POS` and `GLFW_EVENT_CONTENT_SCALE`: `x` and `y`
+ *  - `GLFW_EVENT_WINDOW_SIZE` and `GLFW_EVENT_FRAMEBUFFER_SIZE`: `width` and
+ *    `height`
+ *  - `GLFW_EVENT_CURSOR_ENTER`, `GLFW_EVENT_WINDOW_FOCUS`,
+ *    `GLFW_EVENT_WINDOW_ICONIFY` and `GLFW_EVENT_WINDOW_MAXIMIZE`: `action`,
+ *    `GLFW_TRUE` or `GLFW_FALSE`
+ *  - `GLFW_EVENT_WINDOW_VISIBILITY`: `action`, the new [visibility
+ *    state](@ref glfwGetWindowVisibility)
+ *  - `GLFW_EVENT_OVERFLOW`: `count`, the number of events lost at this point
+ *    of the queue
+ *
+ *  @sa @ref events_queue
+ *  @sa @ref glfwGetEvents
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+typedef struct GLFWevent
+{
+    /*! The type of the event.
+     */
+    int type;
+    /*! The window that received the event, or `NULL` for overflow events.
+     */
+    GLFWwindow* window;
+    /*! The time of the event, in the units of @ref glfwGetTimerValue.
+     */
+    uint64_t time;
+    /*! The [key](@ref keys) or [mouse button](@ref buttons).
+     */
+    int key;
+    /*! The platform-specific scancode of the key.
+     */
+    int scancode;
+    /*! The action, or the new state of a window attribute.
+     */
+    int action;
+    /*! The [modifier key flags](@ref mods).
+     */
+    int mods;
+    /*! The Unicode code point of the character.
+     */
+    unsigned int codepoint;
+    /*! The number of events lost to overflow.
+     */
+    int count;
+    /*! The horizontal position, offset or scale.
+     */
+    double x;
+    /*! The vertical position, offset or scale.
+     */
+    double y;
+    /*! The width of the window or framebuffer.
+     */
+    int width;
+    /*! The height of the window or framebuffer.
+     */
+    int height;
+} GLFWevent;
+
+/*! @brief Presentation feedback.
+ *
+ *  This describes when and how a frame of a window was shown, or that it was
+ *  never shown.
+ *
+ *  @sa @ref glfwSetWindowPresentCallback
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+typedef struct GLFWpresentation
+{
+    /*! `GLFW_TRUE` if the frame was shown, or `GLFW_FALSE` if it was replaced
+     *  or its window hidden before being shown.  The other members are zero
+     *  for frames that were not shown.
+     */
+    int presented;
+    /*! The time the frame started being shown, in the time base of @ref
+     *  glfwGetTime.
+     */
+    double time;
+    /*! The predicted time until the next display refresh, in seconds, or zero
+     *  if unknown.
+     */
+    double refreshInterval;
+    /*! The display refresh counter when the frame was first shown, or zero if
+     *  unknown.
+     */
+    uint64_t sequence;
+    /*! A combination of the `GLFW_PRESENTATION_*` flags.
+     */
+    int flags;
+} GLFWpresentation;
+
+/*! @brief The function pointer type for presentation feedback callbacks.
+ *
+ *  This is the function pointer type for presentation feedback callbacks.
+ *  A presentation feedback callback function has the following signature:
+ *  @code
+ *  void function_name(GLFWwindow* window, const GLFWpresentation* presentation);
+ *  @endcode
+ *
+ *  @param[in] window The window whose frame was presented or discarded.
+ *  @param[in] presentation The presentation feedback.  The structure is only
+ *  valid until the callback returns.
+ *
+ *  @sa @ref glfwSetWindowPresentCallback
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+typedef void (* GLFWwindowpresentfun)(GLFWwindow* window, const GLFWpresentation* presentation);
+
 /*! @brief Custom heap memory allocator.
  *
  *  This describes a custom heap memory allocator for GLFW.  To set an allocator, pass it
@@ -4120,6 +4452,7 @@ GLFWAPI int glfwGetWindowAttrib(GLFWwindow* window, int attrib);
  *  [GLFW_AUTO_ICONIFY](@ref GLFW_AUTO_ICONIFY_attrib) and
  *  [GLFW_FOCUS_ON_SHOW](@ref GLFW_FOCUS_ON_SHOW_attrib).
  *  [GLFW_MOUSE_PASSTHROUGH](@ref GLFW_MOUSE_PASSTHROUGH_attrib)
+ *  [GLFW_EXCLUSIVE_FULLSCREEN](@ref GLFW_EXCLUSIVE_FULLSCREEN_attrib)
  *
  *  Some of these attributes are ignored for full screen windows.  The new
  *  value will take effect if the window is later made windowed.
@@ -4141,6 +4474,11 @@ GLFWAPI int glfwGetWindowAttrib(GLFWwindow* window, int attrib);
  *  @remark @wayland The [GLFW_FLOATING](@ref GLFW_FLOATING_attrib) window attribute is
  *  not supported.  Setting this will emit @ref GLFW_FEATURE_UNAVAILABLE.
  *
+ *  @remark @wayland The [GLFW_EXCLUSIVE_FULLSCREEN](@ref GLFW_EXCLUSIVE_FULLSCREEN_attrib)
+ *  window attribute uses the `wp_tearing_control_v1` protocol and has no effect
+ *  if the compositor does not support it.  Do not use it together with a
+ *  swapchain that manages tearing control for the same surface itself.
+ *
  *  @thread_safety This function must only be called from the main thread.
  *
  *  @sa @ref window_attribs
@@ -4152,6 +4490,43 @@ GLFWAPI int glfwGetWindowAttrib(GLFWwindow* window, int attrib);
  */
 GLFWAPI void glfwSetWindowAttrib(GLFWwindow* window, int attrib, int value);
 
+/*! @brief Returns whether the contents of the specified window can be seen.
+ *
+ *  This function returns the visibility state of the specified window, which
+ *  combines whether it is shown, iconified and occluded into a single value.
+ *  An application can use it to render less or not at all while its window
+ *  cannot be seen.
+ *
+ *  The state is tracked from window events, so this function does not query
+ *  the window system.
+ *
+ *  @param[in] window The window to query.
+ *  @return One of `GLFW_VISIBILITY_HIDDEN`, `GLFW_VISIBILITY_ICONIFIED`,
+ *  `GLFW_VISIBILITY_OCCLUDED` or `GLFW_VISIBILITY_VISIBLE`, or zero if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @remark @x11 Occlusion is reported from `VisibilityNotify` events, which
+ *  most compositing window managers never send for partially or fully covered
+ *  windows.
+ *
+ *  @remark @wayland A window is reported as occluded while the compositor has
+ *  suspended it.  There is no way to tell an iconified window apart, so
+ *  `GLFW_VISIBILITY_ICONIFIED` is never returned.
+ *
+ *  @remark @win32 Occlusion is not reported.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref glfwSetWindowVisibilityCallback
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+GLFWAPI int glfwGetWindowVisibility(GLFWwindow* window);
+
 /*! @brief Sets the user pointer of the specified window.
  *
  *  This function sets the user-defined pointer of the specified window.  The
@@ -4339,6 +4714,90 @@ GLFWAPI GLFWwindowclosefun glfwSetWindowCloseCallback(GLFWwindow* window, GLFWwi
  */
 GLFWAPI GLFWwindowrefreshfun glfwSetWindowRefreshCallback(GLFWwindow* window, GLFWwindowrefreshfun callback);
 
+/*! @brief Sets the frame callback for the specified window.
+ *
+ *  This function sets the frame callback of the specified window, which is
+ *  called when the window system is ready for the next frame of the window.
+ *  Rendering right after this callback gives the frame the most time to be
+ *  shown at the next display refresh.
+ *
+ *  While the callback is set, GLFW asks the window system to signal the next
+ *  frame each time a frame has been presented.  No frame callbacks are made
+ *  while the window is not visible, for example when it is hidden, iconified or
+ *  fully covered, so an application can skip rendering until the next one.
+ *
+ *  @param[in] window The window whose callback to set.
+ *  @param[in] callback The new callback, or `NULL` to remove the currently set
+ *  callback.
+ *  @return The previously set callback, or `NULL` if no callback was set or the
+ *  library had not been [initialized](@ref intro_init).
+ *
+ *  @callback_signature
+ *  @code
+ *  void function_name(GLFWwindow* window);
+ *  @endcode
+ *  For more information about the callback parameters, see the
+ *  [function pointer type](@ref GLFWwindowframefun).
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @remark @wayland This callback is driven by `wl_surface.frame`.
+ *
+ *  @remark This callback is currently only called on Wayland.  On other
+ *  platforms it is never called.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref glfwSetWindowPresentCallback
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+GLFWAPI GLFWwindowframefun glfwSetWindowFrameCallback(GLFWwindow* window, GLFWwindowframefun callback);
+
+/*! @brief Sets the presentation feedback callback for the specified window.
+ *
+ *  This function sets the presentation feedback callback of the specified
+ *  window, which is called with the time a frame of the window was shown on the
+ *  display, or when it was discarded without being shown.  The difference
+ *  between that time and the time a frame was submitted is the latency from
+ *  rendering to light.
+ *
+ *  While the callback is set, GLFW requests feedback for the next frame each
+ *  time the previous feedback has arrived.
+ *
+ *  @param[in] window The window whose callback to set.
+ *  @param[in] callback The new callback, or `NULL` to remove the currently set
+ *  callback.
+ *  @return The previously set callback, or `NULL` if no callback was set or the
+ *  library had not been [initialized](@ref intro_init).
+ *
+ *  @callback_signature
+ *  @code
+ *  void function_name(GLFWwindow* window, const GLFWpresentation* presentation);
+ *  @endcode
+ *  For more information about the callback parameters, see the
+ *  [function pointer type](@ref GLFWwindowpresentfun).
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @remark @wayland This callback is driven by `wp_presentation` feedback and
+ *  is never called if the compositor does not support it.
+ *
+ *  @remark This callback is currently only called on Wayland.  On other
+ *  platforms it is never called.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref glfwSetWindowFrameCallback
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+GLFWAPI GLFWwindowpresentfun glfwSetWindowPresentCallback(GLFWwindow* window, GLFWwindowpresentfun callback);
+
 /*! @brief Sets the focus callback for the specified window.
  *
  *  This function sets the focus callback of the specified window, which is
@@ -4404,6 +4863,37 @@ GLFWAPI GLFWwindowfocusfun glfwSetWindowFocusCallback(GLFWwindow* window, GLFWwi
  */
 GLFWAPI GLFWwindowiconifyfun glfwSetWindowIconifyCallback(GLFWwindow* window, GLFWwindowiconifyfun callback);
 
+/*! @brief Sets the visibility callback for the specified window.
+ *
+ *  This function sets the visibility callback of the specified window, which
+ *  is called when the [visibility state](@ref glfwGetWindowVisibility) of the
+ *  window changes.
+ *
+ *  @param[in] window The window whose callback to set.
+ *  @param[in] callback The new callback, or `NULL` to remove the currently set
+ *  callback.
+ *  @return The previously set callback, or `NULL` if no callback was set or the
+ *  library had not been [initialized](@ref intro_init).
+ *
+ *  @callback_signature
+ *  @code
+ *  void function_name(GLFWwindow* window, int visibility)
+ *  @endcode
+ *  For more information about the callback parameters, see the
+ *  [function pointer type](@ref GLFWwindowvisibilityfun).
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref glfwGetWindowVisibility
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+GLFWAPI GLFWwindowvisibilityfun glfwSetWindowVisibilityCallback(GLFWwindow* window, GLFWwindowvisibilityfun callback);
+
 /*! @brief Sets the maximize callback for the specified window.
  *
  *  This function sets the maximization callback of the specified window, which
@@ -4521,7 +5011,8 @@ GLFWAPI GLFWwindowcontentscalefun glfwSetWindowContentScaleCallback(GLFWwindow*
  *
  *  @reentrancy This function must not be called from a callback.
  *
- *  @thread_safety This function must only be called from the main thread.
+ *  @thread_safety This function must only be called from the main thread, or
+ *  from the event thread if the @ref GLFW_EVENT_THREAD_hint init hint is set.
  *
  *  @sa @ref events
  *  @sa @ref glfwWaitEvents
@@ -4566,7 +5057,8 @@ GLFWAPI void glfwPollEvents(void);
  *
  *  @reentrancy This function must not be called from a callback.
  *
- *  @thread_safety This function must only be called from the main thread.
+ *  @thread_safety This function must only be called from the main thread, or
+ *  from the event thread if the @ref GLFW_EVENT_THREAD_hint init hint is set.
  *
  *  @sa @ref events
  *  @sa @ref glfwPollEvents
@@ -4615,7 +5107,8 @@ GLFWAPI void glfwWaitEvents(void);
  *
  *  @reentrancy This function must not be called from a callback.
  *
- *  @thread_safety This function must only be called from the main thread.
+ *  @thread_safety This function must only be called from the main thread, or
+ *  from the event thread if the @ref GLFW_EVENT_THREAD_hint init hint is set.
  *
  *  @sa @ref events
  *  @sa @ref glfwPollEvents
@@ -4647,6 +5140,64 @@ GLFWAPI void glfwWaitEventsTimeout(double timeout);
  */
 GLFWAPI void glfwPostEmptyEvent(void);
 
+/*! @brief Adds a file descriptor to the sources of events.
+ *
+ *  This function adds a file descriptor to the set waited on by @ref
+ *  glfwWaitEvents and @ref glfwWaitEventsTimeout, which return when it becomes
+ *  ready for reading.  While it is ready, the callback is called by event
+ *  processing with the file descriptor and the specified user pointer.  The
+ *  callback should read the pending data, or remove the source, so that it
+ *  does not keep waking up the event loop.
+ *
+ *  This lets other I/O be handled by the event loop of the application,
+ *  without a helper thread calling @ref glfwPostEmptyEvent.
+ *
+ *  @param[in] fd The file descriptor to wait on.  It must support `poll`.
+ *  @param[in] callback The function called when the file descriptor is ready.
+ *  @param[in] pointer The user pointer passed to the callback.
+ *  @return `GLFW_TRUE` if successful, or `GLFW_FALSE` if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_INVALID_VALUE, @ref GLFW_FEATURE_UNAVAILABLE and @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @win32 @macos Event sources are not available and this function
+ *  emits @ref GLFW_FEATURE_UNAVAILABLE.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref events_sources
+ *  @sa @ref glfwRemoveEventSource
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+GLFWAPI int glfwAddEventSource(int fd, GLFWeventsourcefun callback, void* pointer);
+
+/*! @brief Removes a file descriptor from the sources of events.
+ *
+ *  This function removes a file descriptor added with @ref glfwAddEventSource.
+ *  It must be called before the file descriptor is closed.  This function may
+ *  be called from the callback of the source.
+ *
+ *  @param[in] fd The file descriptor to remove.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_INVALID_VALUE.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref events_sources
+ *  @sa @ref glfwAddEventSource
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup window
+ */
+GLFWAPI void glfwRemoveEventSource(int fd);
+
 /*! @brief Returns the value of an input option for the specified window.
  *
  *  This function returns the value of an input option for the specified window.
@@ -4967,6 +5518,37 @@ GLFWAPI int glfwGetMouseButton(GLFWwindow* window, int button);
  */
 GLFWAPI void glfwGetCursorPos(GLFWwindow* window, double* xpos, double* ypos);
 
+/*! @brief Retrieves the cursor motion accumulated since the last call.
+ *
+ *  This function returns the sum of the cursor motion of the specified window,
+ *  in screen coordinates, since the last call to this function for that window
+ *  or since it was created, then resets it to zero.
+ *
+ *  Every motion event received by event processing is added to the sum, even
+ *  when cursor motion callbacks are merged with the @ref
+ *  GLFW_COALESCE_MOTION_hint init hint.  If [raw mouse motion](@ref raw_mouse_motion)
+ *  is enabled, the sum is of the raw motion of the mouse.
+ *
+ *  Any or all of the delta arguments may be `NULL`.  If an error occurs, all
+ *  non-`NULL` delta arguments will be set to zero.
+ *
+ *  @param[in] window The desired window.
+ *  @param[out] xdelta Where to store the horizontal motion, or `NULL`.
+ *  @param[out] ydelta Where to store the vertical motion, or `NULL`.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref cursor_pos
+ *  @sa @ref glfwGetCursorPos
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwGetCursorDelta(GLFWwindow* window, double* xdelta, double* ydelta);
+
 /*! @brief Sets the position of the cursor, relative to the content area of the
  *  window.
  *
@@ -5326,6 +5908,11 @@ GLFWAPI GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow* window, GLFWmo
  *  position, in screen coordinates, relative to the upper-left corner of the
  *  content area of the window.
  *
+ *  With the @ref GLFW_COALESCE_MOTION_hint init hint, consecutive motion
+ *  events are merged and the callback is called once with the latest position,
+ *  before the next other input event of the window or by the end of event
+ *  processing.  Use @ref glfwGetCursorDelta for the motion in between.
+ *
  *  @param[in] window The window whose callback to set.
  *  @param[in] callback The new callback, or `NULL` to remove the currently set
  *  callback.
@@ -5391,6 +5978,11 @@ GLFWAPI GLFWcursorenterfun glfwSetCursorEnterCallback(GLFWwindow* window, GLFWcu
  *  The scroll callback receives all scrolling input, like that from a mouse
  *  wheel or a touchpad scrolling area.
  *
+ *  With the @ref GLFW_COALESCE_MOTION_hint init hint, consecutive scroll
+ *  events are summed and the callback is called once with the total offsets,
+ *  before the next other input event of the window or by the end of event
+ *  processing.
+ *
  *  @param[in] window The window whose callback to set.
  *  @param[in] callback The new scroll callback, or `NULL` to remove the
  *  currently set callback.
@@ -5896,6 +6488,238 @@ GLFWAPI const char* glfwGetGamepadName(int jid);
  */
 GLFWAPI int glfwGetGamepadState(int jid, GLFWgamepadstate* state);
 
+/*! @brief Retrieves the state of all joysticks remapped as gamepads.
+ *
+ *  This function retrieves the state of every joystick with a gamepad mapping
+ *  in a single call, as if @ref glfwGetGamepadState was called for each of
+ *  them.
+ *
+ *  The state of joystick `jid` is written to `states[jid]`.  The states of
+ *  joysticks that are not present or have no gamepad mapping are cleared.
+ *
+ *  @param[out] states An array of `count` gamepad states.
+ *  @param[in] count The number of elements in `states`.  Joysticks past the
+ *  end of the array are not retrieved.  This is at most @ref
+ *  GLFW_JOYSTICK_LAST + 1.
+ *  @return A bit mask where bit `jid` is set if the state of that joystick was
+ *  retrieved, or zero if none was or an [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @remark Gamepad mappings are compiled for each joystick when it connects
+ *  or the mappings are updated, so this function and @ref glfwGetGamepadState
+ *  do not parse or search mappings.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref gamepad
+ *  @sa @ref glfwGetGamepadState
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwGetGamepadStates(GLFWgamepadstate* states, int count);
+
+/*! @brief Retrieves events from the event queue.
+ *
+ *  This function removes up to `count` of the oldest events from the event
+ *  queue and copies them to `events`, in the order they were received.
+ *
+ *  The event queue is enabled with the @ref GLFW_EVENT_QUEUE_hint init hint.
+ *  While it is enabled, key, character, mouse button, cursor, scroll and window
+ *  events are appended to the queue by event processing instead of being
+ *  passed to their callbacks.  Window state such as the key states returned by
+ *  @ref glfwGetKey and the close flag is updated as before.  File drop, monitor,
+ *  joystick, frame and presentation events are always delivered through their
+ *  callbacks.
+ *
+ *  The queue is a lock-free ring with a single producer, the thread processing
+ *  events, and a single consumer, the thread calling this function.  If the
+ *  queue is full, new events are either dropped and counted, with a
+ *  `GLFW_EVENT_OVERFLOW` event queued once there is room again, or passed to
+ *  their callbacks, as selected with the @ref GLFW_EVENT_QUEUE_OVERFLOW_hint
+ *  init hint.
+ *
+ *  With the @ref GLFW_EVENT_QUEUE_COALESCE_hint init hint, consecutive cursor
+ *  motion, window position, size, framebuffer size, content scale and refresh
+ *  events of a window are merged into the latest one and consecutive scroll
+ *  events are summed.  Merged events are queued by the end of event processing.
+ *
+ *  @param[out] events An array of `count` events.
+ *  @param[in] count The number of elements in `events`.
+ *  @return The number of events retrieved, or zero if the queue is empty or
+ *  an [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_FEATURE_UNAVAILABLE.
+ *
+ *  @pointer_lifetime The window handles of queued events are not updated when
+ *  a window is destroyed.  Retrieve or discard the events of a window before
+ *  destroying it.
+ *
+ *  @thread_safety This function may be called from any thread, but only from
+ *  one thread at a time.
+ *
+ *  @sa @ref events_queue
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwGetEvents(GLFWevent* events, int count);
+
+/*! @brief Starts recording input to a file.
+ *
+ *  This function starts recording the key, character, mouse button, cursor,
+ *  scroll, window size, framebuffer size, focus, iconification, close request
+ *  and joystick events of all windows and joysticks to the specified file, for
+ *  later replay with @ref glfwStartInputReplay.  The end of each call to @ref
+ *  glfwPollEvents, @ref glfwWaitEvents or @ref glfwWaitEventsTimeout is also
+ *  recorded.  Joysticks connected when recording starts are recorded as being
+ *  connected at the start.
+ *
+ *  Windows are identified in the recording by the order they were created in
+ *  since initialization, so a replay needs to create its windows in the same
+ *  order as the recorded session.
+ *
+ *  Recording stops when @ref glfwStopInputRecording is called, when writing
+ *  fails or when the library is terminated.
+ *
+ *  @param[in] path The path of the file to record to.  Any existing file is
+ *  replaced.
+ *  @return `GLFW_TRUE` if recording started, or `GLFW_FALSE` if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_INVALID_VALUE and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark Input cannot be recorded while it is being replayed.
+ *
+ *  @thread_safety This function must only be called from the thread that
+ *  processes events.
+ *
+ *  @sa @ref glfwStopInputRecording
+ *  @sa @ref glfwStartInputReplay
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwStartInputRecording(const char* path);
+
+/*! @brief Stops recording input.
+ *
+ *  This function stops the recording started with @ref
+ *  glfwStartInputRecording and closes its file.  If input is not being
+ *  recorded, this function does nothing.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the thread that
+ *  processes events.
+ *
+ *  @sa @ref glfwStartInputRecording
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwStopInputRecording(void);
+
+/*! @brief Starts replaying input recorded to a file.
+ *
+ *  This function starts replaying the input recorded to the specified file by
+ *  @ref glfwStartInputRecording.  Recorded events are passed to callbacks and
+ *  the event queue by @ref glfwPollEvents, @ref glfwWaitEvents and @ref
+ *  glfwWaitEventsTimeout as if they had been received from the system, and
+ *  update window and joystick state in the same way.  Events from the system
+ *  are discarded while input is being replayed, except those of joysticks
+ *  connected to the machine.  Recorded joysticks are connected as new
+ *  joysticks, which may have different joystick IDs than when recorded.
+ *
+ *  If `speed` is positive, events are replayed at their recorded times scaled
+ *  by it, so that `1.0` replays in real time and `2.0` twice as fast.  The
+ *  event waiting functions return in time for the next replayed event.  If
+ *  `speed` is zero, each call to an event processing function replays the
+ *  events of one recorded call without waiting, which makes a replay
+ *  independent of how fast it runs.
+ *
+ *  Replay works with any platform, including the
+ *  [null platform](@ref GLFW_PLATFORM_NULL), so recorded interactive sessions
+ *  can be run on machines without a display.  Replayed window size events do
+ *  not resize the window itself.
+ *
+ *  The file is read completely when replay starts.  Replay stops at the end
+ *  of the recording, when @ref glfwStopInputReplay is called, when the
+ *  recording is found to be invalid or when the library is terminated, and
+ *  replayed joysticks are then disconnected.
+ *
+ *  @param[in] path The path of the recording to replay.
+ *  @param[in] speed The replay speed, or zero to replay one recorded call to
+ *  an event processing function per call.
+ *  @return `GLFW_TRUE` if replay started, or `GLFW_FALSE` if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_INVALID_VALUE and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark Input cannot be replayed while it is being recorded.
+ *
+ *  @thread_safety This function must only be called from the thread that
+ *  processes events.
+ *
+ *  @sa @ref glfwStopInputReplay
+ *  @sa @ref glfwIsReplayingInput
+ *  @sa @ref glfwStartInputRecording
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwStartInputReplay(const char* path, double speed);
+
+/*! @brief Stops replaying input.
+ *
+ *  This function stops the replay started with @ref glfwStartInputReplay and
+ *  disconnects the replayed joysticks.  If input is not being replayed, this
+ *  function does nothing.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the thread that
+ *  processes events.
+ *
+ *  @sa @ref glfwStartInputReplay
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwStopInputReplay(void);
+
+/*! @brief Returns whether input is being replayed.
+ *
+ *  This function returns whether a replay started with @ref
+ *  glfwStartInputReplay is still running.  A benchmark can use it to end
+ *  once the whole recording has been replayed.
+ *
+ *  @return `GLFW_TRUE` if input is being replayed, or `GLFW_FALSE` otherwise
+ *  or if an [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the thread that
+ *  processes events.
+ *
+ *  @sa @ref glfwStartInputReplay
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwIsReplayingInput(void);
+
 /*! @brief Sets the clipboard to the specified string.
  *
  *  This function sets the system clipboard to the specified, UTF-8 encoded
@@ -5961,6 +6785,46 @@ GLFWAPI void glfwSetClipboardString(GLFWwindow* window, const char* string);
  */
 GLFWAPI const char* glfwGetClipboardString(GLFWwindow* window);
 
+/*! @brief Requests the contents of the clipboard without waiting for them.
+ *
+ *  This function starts receiving the contents of the system clipboard and
+ *  returns immediately.  The specified callback is called with the contents,
+ *  converted to a UTF-8 encoded string, once they have arrived.  If the
+ *  clipboard is empty, its contents cannot be converted or they exceed the
+ *  [clipboard size limit](@ref GLFW_CLIPBOARD_SIZE_LIMIT_hint), the callback
+ *  is called with `NULL` and an error is emitted.
+ *
+ *  Large contents are received in chunks while events are processed, so the
+ *  calling thread is not blocked for the duration of the transfer.  If the
+ *  contents are available locally, as when GLFW owns the clipboard or on
+ *  platforms where reading it does not involve another process, the callback
+ *  is called before this function returns.
+ *
+ *  Each window has at most one pending request.  Requesting again before the
+ *  callback has been called replaces the callback.  A request made from
+ *  within a clipboard string callback is started by the next call to @ref
+ *  glfwPollEvents, @ref glfwWaitEvents or @ref glfwWaitEventsTimeout.
+ *
+ *  @param[in] window The window whose callback to call.
+ *  @param[in] callback The function to call with the clipboard contents.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_FORMAT_UNAVAILABLE and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @x11 @wayland The transfer progresses only while events are being
+ *  processed, for example by @ref glfwPollEvents.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref clipboard
+ *  @sa @ref glfwGetClipboardString
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwRequestClipboardString(GLFWwindow* window, GLFWclipboardfun callback);
+
 /*! @brief Returns the GLFW time.
  *
  *  This function returns the current GLFW time, in seconds.  Unless the time
@@ -6008,6 +6872,9 @@ GLFWAPI double glfwGetTime(void);
  *  @remark The upper limit of GLFW time is calculated as
  *  floor((2<sup>64</sup> - 1) / 10<sup>9</sup>) and is due to implementations
  *  storing nanoseconds in 64 bits.  The limit may be increased in the future.
+ *  With a timer faster than 1 GHz, such as the one selected by the @ref
+ *  GLFW_TSC_TIMER_hint, the limit is lower and calculated as
+ *  (2<sup>64</sup> - 1) / @ref glfwGetTimerFrequency instead.
  *
  *  @thread_safety This function may be called from any thread.  Reading and
  *  writing of the internal base time is not atomic, so it needs to be
@@ -6063,6 +6930,31 @@ GLFWAPI uint64_t glfwGetTimerValue(void);
  */
 GLFWAPI uint64_t glfwGetTimerFrequency(void);
 
+/*! @brief Returns the GLFW time in nanoseconds.
+ *
+ *  This function returns the current GLFW time, as returned by @ref
+ *  glfwGetTime, as a whole number of nanoseconds.  It avoids the floating
+ *  point conversion of @ref glfwGetTime and keeps full precision however long
+ *  the application runs, which makes it suited to profiling and frame pacing.
+ *
+ *  @return The current time, in nanoseconds, or zero if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function may be called from any thread.  Reading and
+ *  writing of the internal base time is not atomic, so it needs to be
+ *  externally synchronized with calls to @ref glfwSetTime.
+ *
+ *  @sa @ref time
+ *  @sa @ref glfwGetTime
+ *
+ *  @since Added in version 3.5.
+ *
+ *  @ingroup input
+ */
+GLFWAPI uint64_t glfwGetTimeNanoseconds(void);
+
 /*! @brief Makes the context of the specified window current for the calling
  *  thread.
  *
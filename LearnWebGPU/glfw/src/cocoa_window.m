@@ -316,6 +316,8 @@ static const NSRange kEmptyRange = { NSNotFound, 0 };
             window->ns.occluded = GLFW_FALSE;
         else
             window->ns.occluded = GLFW_TRUE;
+
+        _glfwInputWindowOcclusion(window, window->ns.occluded);
     }
 #endif
 }
@@ -0,0 +1,438 @@
+//========================================================================
+// GLFW 3.4 - www.glfw.org
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2019 Camilla Löwy <elmindreda@glfw.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <string.h>
+
+// The vector kernels write the ARGB values as B, G, R, A bytes and so are
+// only used where that is the native byte order of a 32-bit value
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define _GLFW_IMAGE_SSE2
+ #include <emmintrin.h>
+ #if defined(__AVX2__)
+  #define _GLFW_IMAGE_AVX2
+  #include <immintrin.h>
+ #endif
+#elif defined(__ARM_NEON) && defined(__BYTE_ORDER__) && \
+      __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+ #define _GLFW_IMAGE_NEON
+ #include <arm_neon.h>
+#endif
+
+// Converts RGBA pixels one at a time
+//
+static void convertScalar(uint32_t* target, const unsigned char* source,
+                          size_t count, GLFWbool premultiply)
+{
+    for (size_t i = 0;  i < count;  i++, source += 4)
+    {
+        const uint32_t alpha = source[3];
+
+        if (premultiply)
+        {
+            target[i] = (alpha << 24) |
+                        ((source[0] * alpha) / 255 << 16) |
+                        ((source[1] * alpha) / 255 <<  8) |
+                        ((source[2] * alpha) / 255 <<  0);
+        }
+        else
+        {
+            target[i] = (alpha << 24) |
+                        ((uint32_t) source[0] << 16) |
+                        ((uint32_t) source[1] <<  8) |
+                        ((uint32_t) source[2] <<  0);
+        }
+    }
+}
+
+#if defined(_GLFW_IMAGE_SSE2)
+
+// Swaps the red and blue channels of four pixels
+//
+static __m128i swizzleSSE2(__m128i pixels)
+{
+    const __m128i ga = _mm_set1_epi32((int) 0xff00ff00);
+    const __m128i rb = _mm_set1_epi32(0x000000ff);
+
+    return _mm_or_si128(_mm_and_si128(pixels, ga),
+                        _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), rb),
+                                     _mm_slli_epi32(_mm_and_si128(pixels, rb), 16)));
+}
+
+// Premultiplies and swaps the red and blue channels of two pixels widened to
+// 16 bits per channel
+//
+static __m128i premultiplySSE2(__m128i pixels)
+{
+    const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i alpha =
+        _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+                            _MM_SHUFFLE(3, 3, 3, 3));
+
+    // This is an exact division by 255 for all products of two bytes
+    __m128i result = _mm_mullo_epi16(pixels, alpha);
+    result = _mm_add_epi16(result, _mm_srli_epi16(result, 8));
+    result = _mm_srli_epi16(_mm_add_epi16(result, _mm_set1_epi16(1)), 8);
+    result = _mm_or_si128(_mm_andnot_si128(alphaMask, result),
+                          _mm_and_si128(alphaMask, pixels));
+
+    result = _mm_shufflelo_epi16(result, _MM_SHUFFLE(3, 0, 1, 2));
+    return _mm_shufflehi_epi16(result, _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+#endif /*_GLFW_IMAGE_SSE2*/
+
+#if defined(_GLFW_IMAGE_AVX2)
+
+// Converts eight pixels, see swizzleSSE2 and premultiplySSE2
+//
+static __m256i convertAVX2(__m256i pixels, GLFWbool premultiply)
+{
+    if (!premultiply)
+    {
+        const __m256i swap = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7,
+                                              10, 9, 8, 11, 14, 13, 12, 15,
+                                              2, 1, 0, 3, 6, 5, 4, 7,
+                                              10, 9, 8, 11, 14, 13, 12, 15);
+        return _mm256_shuffle_epi8(pixels, swap);
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i alphaMask = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0,
+                                               -1, 0, 0, 0, -1, 0, 0, 0);
+    __m256i halves[2] =
+    {
+        _mm256_unpacklo_epi8(pixels, zero),
+        _mm256_unpackhi_epi8(pixels, zero)
+    };
+
+    for (int i = 0;  i < 2;  i++)
+    {
+        const __m256i alpha =
+            _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(halves[i],
+                                                          _MM_SHUFFLE(3, 3, 3, 3)),
+                                   _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m256i result = _mm256_mullo_epi16(halves[i], alpha);
+        result = _mm256_add_epi16(result, _mm256_srli_epi16(result, 8));
+        result = _mm256_srli_epi16(_mm256_add_epi16(result, one), 8);
+        result = _mm256_blendv_epi8(result, halves[i], alphaMask);
+
+        result = _mm256_shufflelo_epi16(result, _MM_SHUFFLE(3, 0, 1, 2));
+        halves[i] = _mm256_shufflehi_epi16(result, _MM_SHUFFLE(3, 0, 1, 2));
+    }
+
+    return _mm256_packus_epi16(halves[0], halves[1]);
+}
+
+#endif /*_GLFW_IMAGE_AVX2*/
+
+#if defined(_GLFW_IMAGE_NEON)
+
+// Divides the products of two bytes by 255, exactly
+//
+static uint8x8_t divide255NEON(uint16x8_t products)
+{
+    products = vsraq_n_u16(products, products, 8);
+    return vshrn_n_u16(vaddq_u16(products, vdupq_n_u16(1)), 8);
+}
+
+// Premultiplies one channel of sixteen pixels
+//
+static uint8x16_t premultiplyNEON(uint8x16_t channel, uint8x16_t alpha)
+{
+    const uint16x8_t low = vmull_u8(vget_low_u8(channel), vget_low_u8(alpha));
+    const uint16x8_t high = vmull_u8(vget_high_u8(channel), vget_high_u8(alpha));
+    return vcombine_u8(divide255NEON(low), divide255NEON(high));
+}
+
+#endif /*_GLFW_IMAGE_NEON*/
+
+// Mixes a value into a running hash
+//
+static uint64_t mixHash(uint64_t hash, uint64_t value)
+{
+    hash = (hash ^ value) * 0x9e3779b97f4a7c15;
+    return hash ^ (hash >> 32);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
+// Converts the RGBA pixels of an image to 32-bit ARGB values, as used by
+// X11 icons and cursors, Wayland shm buffers and Win32 DIBs
+//
+void _glfwConvertImageARGB(uint32_t* target, const GLFWimage* image,
+                           GLFWbool premultiply)
+{
+    const unsigned char* source = image->pixels;
+    const size_t count = (size_t) image->width * image->height;
+    size_t i = 0;
+
+#if defined(_GLFW_IMAGE_AVX2)
+    for (;  i + 8 <= count;  i += 8)
+    {
+        const __m256i pixels = _mm256_loadu_si256((const __m256i*) (source + i * 4));
+        _mm256_storeu_si256((__m256i*) (target + i), convertAVX2(pixels, premultiply));
+    }
+#endif
+
+#if defined(_GLFW_IMAGE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+
+    for (;  i + 4 <= count;  i += 4)
+    {
+        const __m128i pixels = _mm_loadu_si128((const __m128i*) (source + i * 4));
+        __m128i result;
+
+        if (premultiply)
+        {
+            result = _mm_packus_epi16(premultiplySSE2(_mm_unpacklo_epi8(pixels, zero)),
+                                      premultiplySSE2(_mm_unpackhi_epi8(pixels, zero)));
+        }
+        else
+            result = swizzleSSE2(pixels);
+
+        _mm_storeu_si128((__m128i*) (target + i), result);
+    }
+#elif defined(_GLFW_IMAGE_NEON)
+    for (;  i + 16 <= count;  i += 16)
+    {
+        const uint8x16x4_t pixels = vld4q_u8(source + i * 4);
+        uint8x16x4_t result;
+
+        if (premultiply)
+        {
+            result.val[0] = premultiplyNEON(pixels.val[2], pixels.val[3]);
+            result.val[1] = premultiplyNEON(pixels.val[1], pixels.val[3]);
+            result.val[2] = premultiplyNEON(pixels.val[0], pixels.val[3]);
+        }
+        else
+        {
+            result.val[0] = pixels.val[2];
+            result.val[1] = pixels.val[1];
+            result.val[2] = pixels.val[0];
+        }
+
+        result.val[3] = pixels.val[3];
+        vst4q_u8((uint8_t*) (target + i), result);
+    }
+#endif
+
+    convertScalar(target + i, source + i * 4, count - i, premultiply);
+}
+
+// Returns a non-zero hash of the size and pixels of an image, so that zero can
+// stand for no image at all
+//
+uint64_t _glfwHashImage(const GLFWimage* image, uint64_t seed)
+{
+    const unsigned char* source = image->pixels;
+    const size_t size = (size_t) image->width * image->height * 4;
+    uint64_t hash = mixHash(seed ^ 0xcbf29ce484222325,
+                            ((uint64_t) (uint32_t) image->width << 32) |
+                            (uint32_t) image->height);
+    size_t i = 0;
+
+    for (;  i + 8 <= size;  i += 8)
+    {
+        uint64_t value;
+        memcpy(&value, source + i, sizeof(value));
+        hash = mixHash(hash, value);
+    }
+
+    if (i < size)
+    {
+        uint64_t value = 0;
+        memcpy(&value, source + i, size - i);
+        hash = mixHash(hash, value);
+    }
+
+    // Final avalanche so nearby images land far apart
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccd;
+    hash ^= hash >> 33;
+
+    return hash ? hash : 1;
+}
+
+// Returns a copy of the specified images, with their pixels in the same
+// allocation, or NULL if out of memory
+//
+GLFWimage* _glfwCopyImages(int count, const GLFWimage* images)
+{
+    size_t size = count * sizeof(GLFWimage);
+    for (int i = 0;  i < count;  i++)
+        size += (size_t) images[i].width * images[i].height * 4;
+
+    GLFWimage* copies = _glfw_calloc(size, 1);
+    if (!copies)
+        return NULL;
+
+    unsigned char* pixels = (unsigned char*) (copies + count);
+
+    for (int i = 0;  i < count;  i++)
+    {
+        const size_t pixelSize = (size_t) images[i].width * images[i].height * 4;
+
+        copies[i].width = images[i].width;
+        copies[i].height = images[i].height;
+        copies[i].pixels = pixels;
+        memcpy(pixels, images[i].pixels, pixelSize);
+        pixels += pixelSize;
+    }
+
+    return copies;
+}
+
+// Returns whether two sets of images have the same sizes and pixels
+//
+GLFWbool _glfwEqualImages(int count, const GLFWimage* a, const GLFWimage* b)
+{
+    for (int i = 0;  i < count;  i++)
+    {
+        if (a[i].width != b[i].width || a[i].height != b[i].height)
+            return GLFW_FALSE;
+
+        const size_t size = (size_t) a[i].width * a[i].height * 4;
+        if (memcmp(a[i].pixels, b[i].pixels, size) != 0)
+            return GLFW_FALSE;
+    }
+
+    return GLFW_TRUE;
+}
+
+// Returns the cached native image created from the specified image and key, and
+// takes a reference to it, or zero if there is none
+//
+// The key holds what else the native image was created from, such as the
+// cursor hotspot
+//
+uintptr_t _glfwAcquireCachedImage(_GLFWimagecache* cache, const GLFWimage* image, uint64_t key)
+{
+    const uint64_t hash = _glfwHashImage(image, key);
+
+    for (int i = 0;  i < _GLFW_IMAGE_CACHE_SIZE;  i++)
+    {
+        if (cache->entries[i].handle &&
+            cache->entries[i].hash == hash &&
+            cache->entries[i].key == key &&
+            _glfwEqualImages(1, cache->entries[i].image, image))
+        {
+            cache->entries[i].refs++;
+            cache->entries[i].lastUse = ++cache->clock;
+            return cache->entries[i].handle;
+        }
+    }
+
+    return 0;
+}
+
+// Adds a newly created native image with one reference to the cache, evicting
+// the least recently used image not in use if the cache is full
+//
+// If every cached image is in use, or the image cannot be copied, the new one
+// is left out of the cache and will not be found by _glfwReleaseCachedImage
+//
+void _glfwInsertCachedImage(_GLFWimagecache* cache, const GLFWimage* image, uint64_t key, uintptr_t handle)
+{
+    int slot = -1;
+
+    for (int i = 0;  i < _GLFW_IMAGE_CACHE_SIZE;  i++)
+    {
+        if (cache->entries[i].refs)
+            continue;
+
+        if (!cache->entries[i].handle)
+        {
+            slot = i;
+            break;
+        }
+
+        if (slot == -1 || cache->entries[i].lastUse < cache->entries[slot].lastUse)
+            slot = i;
+    }
+
+    if (slot == -1)
+        return;
+
+    GLFWimage* copy = _glfwCopyImages(1, image);
+    if (!copy)
+        return;
+
+    if (cache->entries[slot].handle)
+    {
+        cache->destroy(cache->entries[slot].handle);
+        _glfw_free(cache->entries[slot].image);
+    }
+
+    cache->entries[slot].hash = _glfwHashImage(image, key);
+    cache->entries[slot].key = key;
+    cache->entries[slot].image = copy;
+    cache->entries[slot].handle = handle;
+    cache->entries[slot].refs = 1;
+    cache->entries[slot].lastUse = ++cache->clock;
+}
+
+// Drops a reference to a native image, keeping it cached for reuse
+//
+// Returns GLFW_FALSE if the image is not cached and should be destroyed by the
+// caller
+//
+GLFWbool _glfwReleaseCachedImage(_GLFWimagecache* cache, uintptr_t handle)
+{
+    for (int i = 0;  i < _GLFW_IMAGE_CACHE_SIZE;  i++)
+    {
+        if (cache->entries[i].handle == handle && cache->entries[i].refs)
+        {
+            cache->entries[i].refs--;
+            return GLFW_TRUE;
+        }
+    }
+
+    return GLFW_FALSE;
+}
+
+// Destroys every cached native image
+//
+void _glfwClearImageCache(_GLFWimagecache* cache)
+{
+    for (int i = 0;  i < _GLFW_IMAGE_CACHE_SIZE;  i++)
+    {
+        if (cache->entries[i].handle)
+            cache->destroy(cache->entries[i].handle);
+
+        _glfw_free(cache->entries[i].image);
+    }
+
+    memset(cache->entries, 0, sizeof(cache->entries));
+}
+
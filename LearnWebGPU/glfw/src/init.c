@@ -50,6 +50,7 @@ static GLFWallocator _glfwInitAllocator;
 static _GLFWinitconfig _glfwInitHints =
 {
     .hatButtons = GLFW_TRUE,
+    .coalesceMotion = GLFW_FALSE,
     .angleType = GLFW_ANGLE_PLATFORM_TYPE_NONE,
     .platformID = GLFW_ANY_PLATFORM,
     .vulkanLoader = NULL,
@@ -66,6 +67,15 @@ static _GLFWinitconfig _glfwInitHints =
     {
         .libdecorMode = GLFW_WAYLAND_PREFER_LIBDECOR
     },
+    .events =
+    {
+        .capacity = 0,
+        .overflow = GLFW_OVERFLOW_DROP,
+        .coalesce = GLFW_FALSE
+    },
+    .eventThread = GLFW_FALSE,
+    .tscTimer = GLFW_FALSE,
+    .clipboardLimit = GLFW_DONT_CARE,
 };
 
 // The allocation function used when no custom allocator is set
@@ -118,6 +128,15 @@ static void terminate(void)
     _glfw_free(_glfw.mappings);
     _glfw.mappings = NULL;
     _glfw.mappingCount = 0;
+    _glfw.mappingCapacity = 0;
+
+    _glfw_free(_glfw.mappingIndex);
+    _glfw.mappingIndex = NULL;
+    _glfw.mappingIndexSize = 0;
+
+    _glfwTerminateInputRecord();
+    _glfwTerminateEventQueue();
+    _glfwTerminateCommandQueue();
 
     _glfwTerminateVulkan();
     _glfw.platform.terminateJoysticks();
@@ -422,6 +441,19 @@ GLFWAPI int glfwInit(void)
 
     _glfwPlatformInitTimer();
     _glfw.timer.offset = _glfwPlatformGetTimerValue();
+    _glfw.timer.frequency = _glfwPlatformGetTimerFrequency();
+    _glfw.timer.nanoseconds = 1000000000 / _glfw.timer.frequency;
+#if defined(__SIZEOF_INT128__)
+    _glfw.timer.nanosecondFraction = (uint64_t)
+        (((unsigned __int128) (1000000000 % _glfw.timer.frequency) << 64) /
+         _glfw.timer.frequency);
+#endif
+
+    if (!_glfwInitEventQueue() || !_glfwInitCommandQueue())
+    {
+        terminate();
+        return GLFW_FALSE;
+    }
 
     _glfw.initialized = GLFW_TRUE;
 
@@ -462,6 +494,27 @@ GLFWAPI void glfwInitHint(int hint, int value)
         case GLFW_WAYLAND_LIBDECOR:
             _glfwInitHints.wl.libdecorMode = value;
             return;
+        case GLFW_EVENT_QUEUE:
+            _glfwInitHints.events.capacity = value;
+            return;
+        case GLFW_EVENT_QUEUE_OVERFLOW:
+            _glfwInitHints.events.overflow = value;
+            return;
+        case GLFW_EVENT_QUEUE_COALESCE:
+            _glfwInitHints.events.coalesce = value;
+            return;
+        case GLFW_COALESCE_MOTION:
+            _glfwInitHints.coalesceMotion = value;
+            return;
+        case GLFW_EVENT_THREAD:
+            _glfwInitHints.eventThread = value;
+            return;
+        case GLFW_TSC_TIMER:
+            _glfwInitHints.tscTimer = value;
+            return;
+        case GLFW_CLIPBOARD_SIZE_LIMIT:
+            _glfwInitHints.clipboardLimit = value;
+            return;
     }
 
     _glfwInputError(GLFW_INVALID_ENUM,
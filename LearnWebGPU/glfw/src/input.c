@@ -65,16 +65,150 @@ static GLFWbool initJoysticks(void)
     return _glfw.joysticksInitialized = GLFW_TRUE;
 }
 
-// Finds a mapping based on joystick GUID
+// Polls the device of a joystick, unless its state comes from input replay
 //
-static _GLFWmapping* findMapping(const char* guid)
+static GLFWbool pollJoystick(_GLFWjoystick* js, int mode)
 {
-    int i;
+    if (js->replayed)
+        return GLFW_TRUE;
+
+    return _glfw.platform.pollJoystick(js, mode);
+}
+
+static GLFWbool parseMapping(_GLFWmapping* mapping, const char* string);
+
+// Hashes a joystick GUID for the mapping index (FNV-1a)
+//
+static uint32_t hashGUID(const char* guid)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*guid)
+    {
+        hash ^= (unsigned char) *guid++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+// Returns the index slot holding the mapping with the specified GUID, or the
+// empty slot where it would be inserted
+//
+static int* findMappingSlot(const char* guid)
+{
+    const int mask = _glfw.mappingIndexSize - 1;
+    int slot = (int) (hashGUID(guid) & (uint32_t) mask);
+
+    while (_glfw.mappingIndex[slot] != -1)
+    {
+        if (strcmp(_glfw.mappings[_glfw.mappingIndex[slot]].guid, guid) == 0)
+            break;
+
+        slot = (slot + 1) & mask;
+    }
+
+    return _glfw.mappingIndex + slot;
+}
+
+// Rebuilds the mapping index to hold at least the specified number of mappings
+// with a load factor of at most one half
+//
+static GLFWbool resizeMappingIndex(int count)
+{
+    int i, size = 64;
+    int* index;
+
+    while (size < count * 2)
+        size *= 2;
+
+    if (size <= _glfw.mappingIndexSize)
+        return GLFW_TRUE;
+
+    index = _glfw_calloc(size, sizeof(int));
+    if (!index)
+        return GLFW_FALSE;
+
+    memset(index, 0xff, size * sizeof(int));
+
+    _glfw_free(_glfw.mappingIndex);
+    _glfw.mappingIndex = index;
+    _glfw.mappingIndexSize = size;
 
+    // Earlier entries take precedence, except over ones that failed to parse
     for (i = 0;  i < _glfw.mappingCount;  i++)
     {
-        if (strcmp(_glfw.mappings[i].guid, guid) == 0)
-            return _glfw.mappings + i;
+        int* slot = findMappingSlot(_glfw.mappings[i].guid);
+        if (*slot == -1 || _glfw.mappings[*slot].invalid)
+            *slot = i;
+    }
+
+    return GLFW_TRUE;
+}
+
+// Makes room in the mapping array and index for the specified number of mappings
+//
+static GLFWbool reserveMappings(int count)
+{
+    if (count > _glfw.mappingCapacity)
+    {
+        int capacity = _glfw.mappingCapacity ? _glfw.mappingCapacity : 16;
+        _GLFWmapping* mappings;
+
+        while (capacity < count)
+            capacity *= 2;
+
+        mappings = _glfw_realloc(_glfw.mappings, sizeof(_GLFWmapping) * capacity);
+        if (!mappings)
+            return GLFW_FALSE;
+
+        _glfw.mappings = mappings;
+        _glfw.mappingCapacity = capacity;
+    }
+
+    return resizeMappingIndex(count);
+}
+
+// Finds a mapping based on joystick GUID, parsing it on first use
+//
+static _GLFWmapping* findMapping(const char* guid)
+{
+    int* slot;
+
+    if (!_glfw.mappingIndexSize)
+        return NULL;
+
+    slot = findMappingSlot(guid);
+
+    while (*slot != -1)
+    {
+        int i;
+        _GLFWmapping* mapping = _glfw.mappings + *slot;
+
+        if (mapping->source)
+        {
+            const char* source = mapping->source;
+            mapping->source = NULL;
+            mapping->invalid = !parseMapping(mapping, source);
+        }
+
+        if (!mapping->invalid)
+            return mapping;
+
+        // Fall back to the next built-in line for the same GUID, if any
+        for (i = *slot + 1;  i < _glfw.mappingCount;  i++)
+        {
+            if (!_glfw.mappings[i].invalid &&
+                strcmp(_glfw.mappings[i].guid, guid) == 0)
+            {
+                break;
+            }
+        }
+
+        if (i == _glfw.mappingCount)
+            return NULL;
+
+        *slot = i;
     }
 
     return NULL;
@@ -120,7 +254,172 @@ static _GLFWmapping* findValidMapping(const _GLFWjoystick* js)
     return mapping;
 }
 
-// Parses an SDL_GameControllerDB line and adds it to the mapping list
+// Returns the index in the joystick button array of a mapping element that
+// reads a button or a hat bit
+//
+static int getMappedButtonIndex(const _GLFWmapelement* e,
+                                const _GLFWjoystick* js)
+{
+    if (e->type == _GLFW_JOYSTICK_HATBIT)
+    {
+        // Hat bits are also reported as four buttons per hat, after the
+        // regular buttons
+        const unsigned int hat = e->index >> 4;
+        const unsigned int bit = e->index & 0xf;
+        int shift = 0;
+
+        while (shift < 3 && !(bit & (1u << shift)))
+            shift++;
+
+        return js->buttonCount + hat * 4 + shift;
+    }
+
+    return e->index;
+}
+
+// Compiles the mapping of the specified joystick into runs of operations
+// that need no per-element type checks when evaluated
+//
+static void compileMapping(_GLFWjoystick* js)
+{
+    int i;
+    _GLFWmapop* op = js->ops;
+
+    js->buttonsFromButtons = 0;
+    js->buttonsFromAxes = 0;
+    js->axesFromAxes = 0;
+    js->axesFromButtons = 0;
+
+    if (!js->mapping)
+        return;
+
+    for (i = 0;  i <= GLFW_GAMEPAD_BUTTON_LAST;  i++)
+    {
+        const _GLFWmapelement* e = js->mapping->buttons + i;
+        if (e->type == _GLFW_JOYSTICK_BUTTON ||
+            (e->type == _GLFW_JOYSTICK_HATBIT && (e->index & 0xf)))
+        {
+            op->output = (uint8_t) i;
+            op->input = (uint8_t) getMappedButtonIndex(e, js);
+            op->scale = 1.f;
+            op->offset = 0.f;
+            op++;
+            js->buttonsFromButtons++;
+        }
+    }
+
+    for (i = 0;  i <= GLFW_GAMEPAD_BUTTON_LAST;  i++)
+    {
+        const _GLFWmapelement* e = js->mapping->buttons + i;
+        if (e->type == _GLFW_JOYSTICK_AXIS)
+        {
+            // Half axes are pressed on their positive side, full and inverted
+            // half axes on their negative side
+            const float sign =
+                (e->axisOffset < 0 || (e->axisOffset == 0 && e->axisScale > 0))
+                ? 1.f : -1.f;
+
+            op->output = (uint8_t) i;
+            op->input = e->index;
+            op->scale = e->axisScale * sign;
+            op->offset = e->axisOffset * sign;
+            op++;
+            js->buttonsFromAxes++;
+        }
+    }
+
+    for (i = 0;  i <= GLFW_GAMEPAD_AXIS_LAST;  i++)
+    {
+        const _GLFWmapelement* e = js->mapping->axes + i;
+        if (e->type == _GLFW_JOYSTICK_AXIS)
+        {
+            op->output = (uint8_t) i;
+            op->input = e->index;
+            op->scale = e->axisScale;
+            op->offset = e->axisOffset;
+            op++;
+            js->axesFromAxes++;
+        }
+    }
+
+    for (i = 0;  i <= GLFW_GAMEPAD_AXIS_LAST;  i++)
+    {
+        const _GLFWmapelement* e = js->mapping->axes + i;
+        if (e->type == _GLFW_JOYSTICK_BUTTON || e->type == _GLFW_JOYSTICK_HATBIT)
+        {
+            // A released hat bit maps to -1 like a released button
+            op->output = (uint8_t) i;
+            op->input = (uint8_t) getMappedButtonIndex(e, js);
+            op->scale = (e->type == _GLFW_JOYSTICK_HATBIT && !(e->index & 0xf))
+                ? 0.f : 2.f;
+            op->offset = -1.f;
+            op++;
+            js->axesFromButtons++;
+        }
+    }
+}
+
+// Finds and compiles the mapping of the specified joystick
+//
+static void updateJoystickMapping(_GLFWjoystick* js)
+{
+    js->mapping = findValidMapping(js);
+    compileMapping(js);
+}
+
+// Evaluates the compiled mapping of the specified joystick
+//
+static void evaluateMapping(const _GLFWjoystick* js, GLFWgamepadstate* state)
+{
+    const _GLFWmapop* op = js->ops;
+    const _GLFWmapop* end;
+
+    memset(state, 0, sizeof(GLFWgamepadstate));
+
+    for (end = op + js->buttonsFromButtons;  op < end;  op++)
+        state->buttons[op->output] = js->buttons[op->input];
+
+    for (end = op + js->buttonsFromAxes;  op < end;  op++)
+    {
+        const float value = js->axes[op->input] * op->scale + op->offset;
+        state->buttons[op->output] = (unsigned char) (value >= 0.f);
+    }
+
+    for (end = op + js->axesFromAxes;  op < end;  op++)
+    {
+        const float value = js->axes[op->input] * op->scale + op->offset;
+        state->axes[op->output] = fminf(fmaxf(value, -1.f), 1.f);
+    }
+
+    for (end = op + js->axesFromButtons;  op < end;  op++)
+        state->axes[op->output] = js->buttons[op->input] * op->scale + op->offset;
+}
+
+// Reads the GUID at the start of an SDL_GameControllerDB line and converts it
+// to the form used by the platform joystick code
+//
+static GLFWbool parseMappingGUID(char* guid, const char* string)
+{
+    size_t i;
+    const size_t length = strcspn(string, ",");
+
+    if (length != 32 || string[length] != ',')
+        return GLFW_FALSE;
+
+    memcpy(guid, string, length);
+    guid[length] = '\0';
+
+    for (i = 0;  i < length;  i++)
+    {
+        if (guid[i] >= 'A' && guid[i] <= 'F')
+            guid[i] += 'a' - 'A';
+    }
+
+    _glfw.platform.updateGamepadGUID(guid);
+    return GLFW_TRUE;
+}
+
+// Parses an SDL_GameControllerDB line into a mapping
 //
 static GLFWbool parseMapping(_GLFWmapping* mapping, const char* string)
 {
@@ -156,15 +455,13 @@ static GLFWbool parseMapping(_GLFWmapping* mapping, const char* string)
         { "righty",        mapping->axes + GLFW_GAMEPAD_AXIS_RIGHT_Y }
     };
 
-    length = strcspn(c, ",");
-    if (length != 32 || c[length] != ',')
+    if (!parseMappingGUID(mapping->guid, c))
     {
         _glfwInputError(GLFW_INVALID_VALUE, NULL);
         return GLFW_FALSE;
     }
 
-    memcpy(mapping->guid, c, length);
-    c += length + 1;
+    c += 32 + 1;
 
     length = strcspn(c, ",");
     if (length >= sizeof(mapping->name) || c[length] != ',')
@@ -252,14 +549,161 @@ static GLFWbool parseMapping(_GLFWmapping* mapping, const char* string)
         c += strspn(c, ",");
     }
 
-    for (i = 0;  i < 32;  i++)
+    return GLFW_TRUE;
+}
+
+
+// Appends an event to the ring, failing if it is full
+//
+static GLFWbool pushEvent(const GLFWevent* event)
+{
+    const unsigned int head = _glfw.events.head;
+    const unsigned int tail = _GLFW_LOAD_ACQUIRE(_glfw.events.tail);
+
+    if (head - tail == _glfw.events.capacity)
+        return GLFW_FALSE;
+
+    _glfw.events.ring[head & (_glfw.events.capacity - 1)] = *event;
+    _GLFW_STORE_RELEASE(_glfw.events.head, head + 1);
+    return GLFW_TRUE;
+}
+
+// Passes a queued event to the callback it replaces
+//
+static void dispatchEvent(const GLFWevent* event)
+{
+    _GLFWwindow* window = (_GLFWwindow*) event->window;
+    GLFWwindow* handle = event->window;
+
+    switch (event->type)
     {
-        if (mapping->guid[i] >= 'A' && mapping->guid[i] <= 'F')
-            mapping->guid[i] += 'a' - 'A';
+        case GLFW_EVENT_KEY:
+            if (window->callbacks.key)
+            {
+                window->callbacks.key(handle, event->key, event->scancode,
+                                      event->action, event->mods);
+            }
+            break;
+        case GLFW_EVENT_CHAR:
+            if (window->callbacks.charmods)
+                window->callbacks.charmods(handle, event->codepoint, event->mods);
+            if (window->callbacks.character)
+                window->callbacks.character(handle, event->codepoint);
+            break;
+        case GLFW_EVENT_MOUSE_BUTTON:
+            if (window->callbacks.mouseButton)
+            {
+                window->callbacks.mouseButton(handle, event->key,
+                                              event->action, event->mods);
+            }
+            break;
+        case GLFW_EVENT_CURSOR_POS:
+            if (window->callbacks.cursorPos)
+                window->callbacks.cursorPos(handle, event->x, event->y);
+            break;
+        case GLFW_EVENT_CURSOR_ENTER:
+            if (window->callbacks.cursorEnter)
+                window->callbacks.cursorEnter(handle, event->action);
+            break;
+        case GLFW_EVENT_SCROLL:
+            if (window->callbacks.scroll)
+                window->callbacks.scroll(handle, event->x, event->y);
+            break;
+        case GLFW_EVENT_WINDOW_POS:
+            if (window->callbacks.pos)
+                window->callbacks.pos(handle, (int) event->x, (int) event->y);
+            break;
+        case GLFW_EVENT_WINDOW_SIZE:
+            if (window->callbacks.size)
+                window->callbacks.size(handle, event->width, event->height);
+            break;
+        case GLFW_EVENT_WINDOW_CLOSE:
+            if (window->callbacks.close)
+                window->callbacks.close(handle);
+            break;
+        case GLFW_EVENT_WINDOW_REFRESH:
+            if (window->callbacks.refresh)
+                window->callbacks.refresh(handle);
+            break;
+        case GLFW_EVENT_WINDOW_FOCUS:
+            if (window->callbacks.focus)
+                window->callbacks.focus(handle, event->action);
+            break;
+        case GLFW_EVENT_WINDOW_ICONIFY:
+            if (window->callbacks.iconify)
+                window->callbacks.iconify(handle, event->action);
+            break;
+        case GLFW_EVENT_WINDOW_MAXIMIZE:
+            if (window->callbacks.maximize)
+                window->callbacks.maximize(handle, event->action);
+            break;
+        case GLFW_EVENT_WINDOW_VISIBILITY:
+            if (window->callbacks.visibility)
+                window->callbacks.visibility(handle, event->action);
+            break;
+        case GLFW_EVENT_FRAMEBUFFER_SIZE:
+            if (window->callbacks.fbsize)
+                window->callbacks.fbsize(handle, event->width, event->height);
+            break;
+        case GLFW_EVENT_CONTENT_SCALE:
+            if (window->callbacks.scale)
+            {
+                window->callbacks.scale(handle,
+                                        (float) event->x, (float) event->y);
+            }
+            break;
     }
+}
 
-    _glfw.platform.updateGamepadGUID(mapping->guid);
-    return GLFW_TRUE;
+// Queues an event, applying the overflow policy if the ring is full
+//
+static void submitEvent(const GLFWevent* event)
+{
+    if (_glfw.events.lost)
+    {
+        // The overflow marker goes in before any event following the loss
+        GLFWevent overflow;
+        memset(&overflow, 0, sizeof(overflow));
+        overflow.type = GLFW_EVENT_OVERFLOW;
+        overflow.time = event->time;
+        overflow.count = _glfw.events.lost;
+
+        if (pushEvent(&overflow))
+            _glfw.events.lost = 0;
+        else
+        {
+            _glfw.events.lost++;
+            return;
+        }
+    }
+
+    if (pushEvent(event))
+        return;
+
+    if (_glfw.hints.init.events.overflow == GLFW_OVERFLOW_CALLBACK)
+        dispatchEvent(event);
+    else
+        _glfw.events.lost++;
+}
+
+// Returns whether events of this type may be merged into the next one
+//
+static GLFWbool isCoalescable(int type)
+{
+    switch (type)
+    {
+        case GLFW_EVENT_CURSOR_POS:
+        case GLFW_EVENT_SCROLL:
+        case GLFW_EVENT_WINDOW_POS:
+        case GLFW_EVENT_WINDOW_SIZE:
+        case GLFW_EVENT_WINDOW_REFRESH:
+        case GLFW_EVENT_FRAMEBUFFER_SIZE:
+        case GLFW_EVENT_CONTENT_SCALE:
+        case GLFW_EVENT_WINDOW_VISIBILITY:
+            return GLFW_TRUE;
+    }
+
+    return GLFW_FALSE;
 }
 
 
@@ -277,6 +721,15 @@ void _glfwInputKey(_GLFWwindow* window, int key, int scancode, int action, int m
     assert(action == GLFW_PRESS || action == GLFW_RELEASE);
     assert(mods == (mods & GLFW_MOD_MASK));
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_KEY, window, key, scancode, action, mods))
+    {
+        return;
+    }
+
+    if (window->cursorPosPending || window->scrollPending)
+        _glfwFlushCoalescedInput(window);
+
     if (key >= 0 && key <= GLFW_KEY_LAST)
     {
         GLFWbool repeated = GLFW_FALSE;
@@ -299,6 +752,18 @@ void _glfwInputKey(_GLFWwindow* window, int key, int scancode, int action, int m
     if (!window->lockKeyMods)
         mods &= ~(GLFW_MOD_CAPS_LOCK | GLFW_MOD_NUM_LOCK);
 
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_KEY, window);
+        event.key = key;
+        event.scancode = scancode;
+        event.action = action;
+        event.mods = mods;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.key)
         window->callbacks.key((GLFWwindow*) window, key, scancode, action, mods);
 }
@@ -312,12 +777,35 @@ void _glfwInputChar(_GLFWwindow* window, uint32_t codepoint, int mods, GLFWbool
     assert(mods == (mods & GLFW_MOD_MASK));
     assert(plain == GLFW_TRUE || plain == GLFW_FALSE);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_CHAR, window, codepoint, mods, plain, 0))
+    {
+        return;
+    }
+
+    if (window->cursorPosPending || window->scrollPending)
+        _glfwFlushCoalescedInput(window);
+
     if (codepoint < 32 || (codepoint > 126 && codepoint < 160))
         return;
 
     if (!window->lockKeyMods)
         mods &= ~(GLFW_MOD_CAPS_LOCK | GLFW_MOD_NUM_LOCK);
 
+    if (_glfw.events.ring)
+    {
+        if (plain)
+        {
+            GLFWevent event;
+            _glfwInitEvent(&event, GLFW_EVENT_CHAR, window);
+            event.codepoint = codepoint;
+            event.mods = mods;
+            _glfwQueueEvent(&event);
+        }
+
+        return;
+    }
+
     if (window->callbacks.charmods)
         window->callbacks.charmods((GLFWwindow*) window, codepoint, mods);
 
@@ -338,6 +826,30 @@ void _glfwInputScroll(_GLFWwindow* window, double xoffset, double yoffset)
     assert(yoffset > -FLT_MAX);
     assert(yoffset < FLT_MAX);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInputPos(_GLFW_RECORD_SCROLL, window, xoffset, yoffset))
+    {
+        return;
+    }
+
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_SCROLL, window);
+        event.x = xoffset;
+        event.y = yoffset;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
+    if (_glfw.hints.init.coalesceMotion)
+    {
+        window->scrollPendingX += xoffset;
+        window->scrollPendingY += yoffset;
+        window->scrollPending = GLFW_TRUE;
+        return;
+    }
+
     if (window->callbacks.scroll)
         window->callbacks.scroll((GLFWwindow*) window, xoffset, yoffset);
 }
@@ -352,6 +864,16 @@ void _glfwInputMouseClick(_GLFWwindow* window, int button, int action, int mods)
     assert(action == GLFW_PRESS || action == GLFW_RELEASE);
     assert(mods == (mods & GLFW_MOD_MASK));
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_MOUSE_BUTTON, window,
+                          button, action, mods, 0))
+    {
+        return;
+    }
+
+    if (window->cursorPosPending || window->scrollPending)
+        _glfwFlushCoalescedInput(window);
+
     if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
         return;
 
@@ -363,6 +885,17 @@ void _glfwInputMouseClick(_GLFWwindow* window, int button, int action, int mods)
     else
         window->mouseButtons[button] = (char) action;
 
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_MOUSE_BUTTON, window);
+        event.key = button;
+        event.action = action;
+        event.mods = mods;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.mouseButton)
         window->callbacks.mouseButton((GLFWwindow*) window, button, action, mods);
 }
@@ -381,9 +914,40 @@ void _glfwInputCursorPos(_GLFWwindow* window, double xpos, double ypos)
     if (window->virtualCursorPosX == xpos && window->virtualCursorPosY == ypos)
         return;
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInputPos(_GLFW_RECORD_CURSOR_POS, window, xpos, ypos))
+    {
+        return;
+    }
+
+    // The first position after the cursor enters the window is not motion
+    if (window->cursorTracked)
+    {
+        window->cursorDeltaX += xpos - window->virtualCursorPosX;
+        window->cursorDeltaY += ypos - window->virtualCursorPosY;
+    }
+
+    window->cursorTracked = GLFW_TRUE;
     window->virtualCursorPosX = xpos;
     window->virtualCursorPosY = ypos;
 
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_CURSOR_POS, window);
+        event.x = xpos;
+        event.y = ypos;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
+    if (_glfw.hints.init.coalesceMotion)
+    {
+        // The latest position is passed on by _glfwFlushCoalescedInput
+        window->cursorPosPending = GLFW_TRUE;
+        return;
+    }
+
     if (window->callbacks.cursorPos)
         window->callbacks.cursorPos((GLFWwindow*) window, xpos, ypos);
 }
@@ -395,6 +959,27 @@ void _glfwInputCursorEnter(_GLFWwindow* window, GLFWbool entered)
     assert(window != NULL);
     assert(entered == GLFW_TRUE || entered == GLFW_FALSE);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_CURSOR_ENTER, window, entered, 0, 0, 0))
+    {
+        return;
+    }
+
+    if (window->cursorPosPending || window->scrollPending)
+        _glfwFlushCoalescedInput(window);
+
+    if (!entered)
+        window->cursorTracked = GLFW_FALSE;
+
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_CURSOR_ENTER, window);
+        event.action = entered;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.cursorEnter)
         window->callbacks.cursorEnter((GLFWwindow*) window, entered);
 }
@@ -407,10 +992,105 @@ void _glfwInputDrop(_GLFWwindow* window, int count, const char** paths)
     assert(count > 0);
     assert(paths != NULL);
 
+    if (window->cursorPosPending || window->scrollPending)
+        _glfwFlushCoalescedInput(window);
+
     if (window->callbacks.drop)
         window->callbacks.drop((GLFWwindow*) window, count, paths);
 }
 
+// Notifies shared code that the clipboard contents requested by windows have
+// arrived, or could not be received
+//
+void _glfwInputClipboardString(const char* string)
+{
+    _GLFWwindow* window;
+    const GLFWbool delivering = _glfw.clipboard.delivering;
+
+    // Only the requests made so far are answered here, those made by the
+    // callbacks are started by the next event processing so that a callback
+    // requesting again is not answered from within itself without end
+    for (window = _glfw.windowListHead;  window;  window = window->next)
+    {
+        if (window->clipboardRequest)
+        {
+            window->clipboardDelivery = window->clipboardRequest;
+            window->clipboardRequest = NULL;
+        }
+    }
+
+    _glfw.clipboard.delivering = GLFW_TRUE;
+
+    for (;;)
+    {
+        // A callback may destroy any window, so the list is searched again
+        // after each one returns
+        for (window = _glfw.windowListHead;  window;  window = window->next)
+        {
+            if (window->clipboardDelivery)
+                break;
+        }
+
+        if (!window)
+            break;
+
+        const GLFWclipboardfun callback = window->clipboardDelivery;
+        window->clipboardDelivery = NULL;
+        callback((GLFWwindow*) window, string);
+    }
+
+    // A callback reading the clipboard may have delivered it from within
+    _glfw.clipboard.delivering = delivering;
+}
+
+// Checks an incoming clipboard transfer against the size limit init hint
+//
+GLFWbool _glfwCheckClipboardSize(size_t size)
+{
+    if (_glfw.hints.init.clipboardLimit != GLFW_DONT_CARE &&
+        size > (size_t) _glfw.hints.init.clipboardLimit)
+    {
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "Clipboard contents exceed the size limit of %i bytes",
+                        _glfw.hints.init.clipboardLimit);
+        return GLFW_FALSE;
+    }
+
+    return GLFW_TRUE;
+}
+
+// Asks the platform for the clipboard contents on behalf of the windows with a
+// pending request
+//
+static void requestClipboardString(void)
+{
+    if (_glfw.platform.requestClipboardString)
+        _glfw.platform.requestClipboardString();
+    else
+    {
+        // The clipboard of this platform is read without waiting on another
+        // process, so there is nothing to gain from deferring the callback
+        const char* string = _glfw.platform.getClipboardString();
+        if (string && !_glfwCheckClipboardSize(strlen(string)))
+            string = NULL;
+
+        _glfwInputClipboardString(string);
+    }
+}
+
+// Starts the clipboard requests made by clipboard callbacks, returning whether
+// there were any
+//
+GLFWbool _glfwRequestDeferredClipboardString(void)
+{
+    if (!_glfw.clipboard.deferred)
+        return GLFW_FALSE;
+
+    _glfw.clipboard.deferred = GLFW_FALSE;
+    requestClipboardString();
+    return GLFW_TRUE;
+}
+
 // Notifies shared code of a joystick connection or disconnection
 //
 void _glfwInputJoystick(_GLFWjoystick* js, int event)
@@ -418,6 +1098,15 @@ void _glfwInputJoystick(_GLFWjoystick* js, int event)
     assert(js != NULL);
     assert(event == GLFW_CONNECTED || event == GLFW_DISCONNECTED);
 
+    if (_glfw.record.mode)
+    {
+        const int type = event == GLFW_CONNECTED ?
+            _GLFW_RECORD_JOYSTICK_CONNECTED : _GLFW_RECORD_JOYSTICK_DISCONNECTED;
+
+        if (!_glfwRecordJoystick(type, js, 0, 0.f))
+            return;
+    }
+
     if (event == GLFW_CONNECTED)
         js->connected = GLFW_TRUE;
     else if (event == GLFW_DISCONNECTED)
@@ -435,6 +1124,12 @@ void _glfwInputJoystickAxis(_GLFWjoystick* js, int axis, float value)
     assert(axis >= 0);
     assert(axis < js->axisCount);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordJoystick(_GLFW_RECORD_JOYSTICK_AXIS, js, axis, value))
+    {
+        return;
+    }
+
     js->axes[axis] = value;
 }
 
@@ -447,6 +1142,12 @@ void _glfwInputJoystickButton(_GLFWjoystick* js, int button, char value)
     assert(button < js->buttonCount);
     assert(value == GLFW_PRESS || value == GLFW_RELEASE);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordJoystick(_GLFW_RECORD_JOYSTICK_BUTTON, js, button, value))
+    {
+        return;
+    }
+
     js->buttons[button] = value;
 }
 
@@ -466,6 +1167,12 @@ void _glfwInputJoystickHat(_GLFWjoystick* js, int hat, char value)
     assert((value & GLFW_HAT_LEFT) == 0 || (value & GLFW_HAT_RIGHT) == 0);
     assert((value & GLFW_HAT_UP) == 0 || (value & GLFW_HAT_DOWN) == 0);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordJoystick(_GLFW_RECORD_JOYSTICK_HAT, js, hat, value))
+    {
+        return;
+    }
+
     base = js->buttonCount + hat * 4;
 
     js->buttons[base + 0] = (value & 0x01) ? GLFW_PRESS : GLFW_RELEASE;
@@ -481,18 +1188,153 @@ void _glfwInputJoystickHat(_GLFWjoystick* js, int hat, char value)
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
 
+// Allocates the event queue if enabled by the init hints
+//
+GLFWbool _glfwInitEventQueue(void)
+{
+    unsigned int capacity = 1;
+
+    if (_glfw.hints.init.events.capacity <= 0)
+        return GLFW_TRUE;
+
+    // A power of two capacity lets the free running indices wrap around
+    while (capacity < (unsigned int) _glfw.hints.init.events.capacity &&
+           capacity < 0x40000000u)
+    {
+        capacity <<= 1;
+    }
+
+    _glfw.events.ring = _glfw_calloc(capacity, sizeof(GLFWevent));
+    if (!_glfw.events.ring)
+        return GLFW_FALSE;
+
+    _glfw.events.capacity = capacity;
+    _glfw.events.head = 0;
+    _glfw.events.tail = 0;
+    _glfw.events.lost = 0;
+    _glfw.events.pending.type = GLFW_EVENT_NONE;
+    return GLFW_TRUE;
+}
+
+// Frees the event queue
+//
+void _glfwTerminateEventQueue(void)
+{
+    _glfw_free(_glfw.events.ring);
+    memset(&_glfw.events, 0, sizeof(_glfw.events));
+}
+
+// Initializes the event fields shared by all event types
+//
+void _glfwInitEvent(GLFWevent* event, int type, _GLFWwindow* window)
+{
+    memset(event, 0, sizeof(GLFWevent));
+    event->type = type;
+    event->window = (GLFWwindow*) window;
+    event->time = _glfwPlatformGetTimerValue() - _glfw.timer.offset;
+}
+
+// Queues an event from event processing, merging it with the pending event
+// if coalescing is enabled
+//
+void _glfwQueueEvent(const GLFWevent* event)
+{
+    GLFWevent* pending = &_glfw.events.pending;
+
+    if (!_glfw.hints.init.events.coalesce)
+    {
+        submitEvent(event);
+        return;
+    }
+
+    if (pending->type == event->type && pending->window == event->window)
+    {
+        if (event->type == GLFW_EVENT_SCROLL)
+        {
+            pending->x += event->x;
+            pending->y += event->y;
+            pending->time = event->time;
+        }
+        else
+            *pending = *event;
+
+        return;
+    }
+
+    _glfwFlushEventQueue();
+
+    if (isCoalescable(event->type))
+        *pending = *event;
+    else
+        submitEvent(event);
+}
+
+// Queues the pending merged event, if any
+//
+void _glfwFlushEventQueue(void)
+{
+    if (_glfw.events.pending.type != GLFW_EVENT_NONE)
+    {
+        submitEvent(&_glfw.events.pending);
+        _glfw.events.pending.type = GLFW_EVENT_NONE;
+    }
+}
+
+// Passes the merged cursor motion and scroll of a window to their callbacks
+//
+void _glfwFlushCoalescedInput(_GLFWwindow* window)
+{
+    if (window->cursorPosPending)
+    {
+        window->cursorPosPending = GLFW_FALSE;
+
+        if (window->callbacks.cursorPos)
+        {
+            window->callbacks.cursorPos((GLFWwindow*) window,
+                                        window->virtualCursorPosX,
+                                        window->virtualCursorPosY);
+        }
+    }
+
+    if (window->scrollPending)
+    {
+        const double xoffset = window->scrollPendingX;
+        const double yoffset = window->scrollPendingY;
+
+        window->scrollPending = GLFW_FALSE;
+        window->scrollPendingX = 0.0;
+        window->scrollPendingY = 0.0;
+
+        if (window->callbacks.scroll)
+            window->callbacks.scroll((GLFWwindow*) window, xoffset, yoffset);
+    }
+}
+
 // Adds the built-in set of gamepad mappings
 //
 void _glfwInitGamepadMappings(void)
 {
     size_t i;
     const size_t count = sizeof(_glfwDefaultMappings) / sizeof(char*);
-    _glfw.mappings = _glfw_calloc(count, sizeof(_GLFWmapping));
 
+    if (!reserveMappings((int) count))
+        return;
+
+    // Only the GUIDs are read here, lines are parsed when first looked up
     for (i = 0;  i < count;  i++)
     {
-        if (parseMapping(&_glfw.mappings[_glfw.mappingCount], _glfwDefaultMappings[i]))
+        _GLFWmapping* mapping = _glfw.mappings + _glfw.mappingCount;
+        memset(mapping, 0, sizeof(_GLFWmapping));
+
+        if (parseMappingGUID(mapping->guid, _glfwDefaultMappings[i]))
+        {
+            int* slot = findMappingSlot(mapping->guid);
+            if (*slot == -1)
+                *slot = _glfw.mappingCount;
+
+            mapping->source = _glfwDefaultMappings[i];
             _glfw.mappingCount++;
+        }
     }
 }
 
@@ -527,7 +1369,7 @@ _GLFWjoystick* _glfwAllocJoystick(const char* name,
 
     strncpy(js->name, name, sizeof(js->name) - 1);
     strncpy(js->guid, guid, sizeof(js->guid) - 1);
-    js->mapping = findValidMapping(js);
+    updateJoystickMapping(js);
 
     return js;
 }
@@ -589,6 +1431,13 @@ GLFWAPI void glfwSetInputMode(GLFWwindow* handle, int mode, int value)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_INPUT_MODE, window, { mode, value } };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     switch (mode)
     {
         case GLFW_CURSOR:
@@ -612,6 +1461,7 @@ GLFWAPI void glfwSetInputMode(GLFWwindow* handle, int mode, int value)
             _glfw.platform.getCursorPos(window,
                                         &window->virtualCursorPosX,
                                         &window->virtualCursorPosY);
+            window->cursorTracked = GLFW_TRUE;
             _glfw.platform.setCursorMode(window, value);
             return;
         }
@@ -801,6 +1651,27 @@ GLFWAPI void glfwGetCursorPos(GLFWwindow* handle, double* xpos, double* ypos)
         _glfw.platform.getCursorPos(window, xpos, ypos);
 }
 
+GLFWAPI void glfwGetCursorDelta(GLFWwindow* handle, double* xdelta, double* ydelta)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    if (xdelta)
+        *xdelta = 0;
+    if (ydelta)
+        *ydelta = 0;
+
+    _GLFW_REQUIRE_INIT();
+
+    if (xdelta)
+        *xdelta = window->cursorDeltaX;
+    if (ydelta)
+        *ydelta = window->cursorDeltaY;
+
+    window->cursorDeltaX = 0.0;
+    window->cursorDeltaY = 0.0;
+}
+
 GLFWAPI void glfwSetCursorPos(GLFWwindow* handle, double xpos, double ypos)
 {
     _GLFWwindow* window = (_GLFWwindow*) handle;
@@ -817,6 +1688,15 @@ GLFWAPI void glfwSetCursorPos(GLFWwindow* handle, double xpos, double ypos)
         return;
     }
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_CURSOR_POS, window };
+        command.x = xpos;
+        command.y = ypos;
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     if (!_glfw.platform.windowFocused(window))
         return;
 
@@ -915,6 +1795,9 @@ GLFWAPI void glfwDestroyCursor(GLFWcursor* handle)
         }
     }
 
+    // Requests from other threads to set this cursor would outlive it
+    _glfwDiscardCommands(NULL, cursor);
+
     _glfw.platform.destroyCursor(cursor);
 
     // Unlink cursor from global linked list
@@ -938,6 +1821,14 @@ GLFWAPI void glfwSetCursor(GLFWwindow* windowHandle, GLFWcursor* cursorHandle)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_CURSOR, window };
+        command.pointer = cursor;
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     window->cursor = cursor;
 
     _glfw.platform.setCursor(window, cursor);
@@ -1049,7 +1940,7 @@ GLFWAPI int glfwJoystickPresent(int jid)
     if (!js->connected)
         return GLFW_FALSE;
 
-    return _glfw.platform.pollJoystick(js, _GLFW_POLL_PRESENCE);
+    return pollJoystick(js, _GLFW_POLL_PRESENCE);
 }
 
 GLFWAPI const float* glfwGetJoystickAxes(int jid, int* count)
@@ -1077,7 +1968,7 @@ GLFWAPI const float* glfwGetJoystickAxes(int jid, int* count)
     if (!js->connected)
         return NULL;
 
-    if (!_glfw.platform.pollJoystick(js, _GLFW_POLL_AXES))
+    if (!pollJoystick(js, _GLFW_POLL_AXES))
         return NULL;
 
     *count = js->axisCount;
@@ -1109,7 +2000,7 @@ GLFWAPI const unsigned char* glfwGetJoystickButtons(int jid, int* count)
     if (!js->connected)
         return NULL;
 
-    if (!_glfw.platform.pollJoystick(js, _GLFW_POLL_BUTTONS))
+    if (!pollJoystick(js, _GLFW_POLL_BUTTONS))
         return NULL;
 
     if (_glfw.hints.init.hatButtons)
@@ -1145,7 +2036,7 @@ GLFWAPI const unsigned char* glfwGetJoystickHats(int jid, int* count)
     if (!js->connected)
         return NULL;
 
-    if (!_glfw.platform.pollJoystick(js, _GLFW_POLL_BUTTONS))
+    if (!pollJoystick(js, _GLFW_POLL_BUTTONS))
         return NULL;
 
     *count = js->hatCount;
@@ -1174,7 +2065,7 @@ GLFWAPI const char* glfwGetJoystickName(int jid)
     if (!js->connected)
         return NULL;
 
-    if (!_glfw.platform.pollJoystick(js, _GLFW_POLL_PRESENCE))
+    if (!pollJoystick(js, _GLFW_POLL_PRESENCE))
         return NULL;
 
     return js->name;
@@ -1202,7 +2093,7 @@ GLFWAPI const char* glfwGetJoystickGUID(int jid)
     if (!js->connected)
         return NULL;
 
-    if (!_glfw.platform.pollJoystick(js, _GLFW_POLL_PRESENCE))
+    if (!pollJoystick(js, _GLFW_POLL_PRESENCE))
         return NULL;
 
     return js->guid;
@@ -1276,19 +2167,17 @@ GLFWAPI int glfwUpdateGamepadMappings(const char* string)
                 memcpy(line, c, length);
                 line[length] = '\0';
 
-                if (parseMapping(&mapping, line))
+                if (parseMapping(&mapping, line) &&
+                    reserveMappings(_glfw.mappingCount + 1))
                 {
-                    _GLFWmapping* previous = findMapping(mapping.guid);
-                    if (previous)
-                        *previous = mapping;
-                    else
+                    int* slot = findMappingSlot(mapping.guid);
+                    if (*slot == -1)
                     {
+                        *slot = _glfw.mappingCount;
                         _glfw.mappingCount++;
-                        _glfw.mappings =
-                            _glfw_realloc(_glfw.mappings,
-                                          sizeof(_GLFWmapping) * _glfw.mappingCount);
-                        _glfw.mappings[_glfw.mappingCount - 1] = mapping;
                     }
+
+                    _glfw.mappings[*slot] = mapping;
                 }
             }
 
@@ -1305,7 +2194,7 @@ GLFWAPI int glfwUpdateGamepadMappings(const char* string)
     {
         _GLFWjoystick* js = _glfw.joysticks + jid;
         if (js->connected)
-            js->mapping = findValidMapping(js);
+            updateJoystickMapping(js);
     }
 
     return GLFW_TRUE;
@@ -1333,7 +2222,7 @@ GLFWAPI int glfwJoystickIsGamepad(int jid)
     if (!js->connected)
         return GLFW_FALSE;
 
-    if (!_glfw.platform.pollJoystick(js, _GLFW_POLL_PRESENCE))
+    if (!pollJoystick(js, _GLFW_POLL_PRESENCE))
         return GLFW_FALSE;
 
     return js->mapping != NULL;
@@ -1361,7 +2250,7 @@ GLFWAPI const char* glfwGetGamepadName(int jid)
     if (!js->connected)
         return NULL;
 
-    if (!_glfw.platform.pollJoystick(js, _GLFW_POLL_PRESENCE))
+    if (!pollJoystick(js, _GLFW_POLL_PRESENCE))
         return NULL;
 
     if (!js->mapping)
@@ -1372,7 +2261,6 @@ GLFWAPI const char* glfwGetGamepadName(int jid)
 
 GLFWAPI int glfwGetGamepadState(int jid, GLFWgamepadstate* state)
 {
-    int i;
     _GLFWjoystick* js;
 
     assert(jid >= GLFW_JOYSTICK_1);
@@ -1396,64 +2284,83 @@ GLFWAPI int glfwGetGamepadState(int jid, GLFWgamepadstate* state)
     if (!js->connected)
         return GLFW_FALSE;
 
-    if (!_glfw.platform.pollJoystick(js, _GLFW_POLL_ALL))
+    if (!pollJoystick(js, _GLFW_POLL_ALL))
         return GLFW_FALSE;
 
     if (!js->mapping)
         return GLFW_FALSE;
 
-    for (i = 0;  i <= GLFW_GAMEPAD_BUTTON_LAST;  i++)
+    evaluateMapping(js, state);
+    return GLFW_TRUE;
+}
+
+GLFWAPI int glfwGetGamepadStates(GLFWgamepadstate* states, int count)
+{
+    int jid, present = 0;
+
+    assert(states != NULL);
+    assert(count >= 0);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(0);
+
+    if (count > GLFW_JOYSTICK_LAST + 1)
+        count = GLFW_JOYSTICK_LAST + 1;
+
+    memset(states, 0, count * sizeof(GLFWgamepadstate));
+
+    if (!initJoysticks())
+        return 0;
+
+    for (jid = 0;  jid < count;  jid++)
     {
-        const _GLFWmapelement* e = js->mapping->buttons + i;
-        if (e->type == _GLFW_JOYSTICK_AXIS)
-        {
-            const float value = js->axes[e->index] * e->axisScale + e->axisOffset;
-            // HACK: This should be baked into the value transform
-            // TODO: Bake into transform when implementing output modifiers
-            if (e->axisOffset < 0 || (e->axisOffset == 0 && e->axisScale > 0))
-            {
-                if (value >= 0.f)
-                    state->buttons[i] = GLFW_PRESS;
-            }
-            else
-            {
-                if (value <= 0.f)
-                    state->buttons[i] = GLFW_PRESS;
-            }
-        }
-        else if (e->type == _GLFW_JOYSTICK_HATBIT)
-        {
-            const unsigned int hat = e->index >> 4;
-            const unsigned int bit = e->index & 0xf;
-            if (js->hats[hat] & bit)
-                state->buttons[i] = GLFW_PRESS;
-        }
-        else if (e->type == _GLFW_JOYSTICK_BUTTON)
-            state->buttons[i] = js->buttons[e->index];
+        _GLFWjoystick* js = _glfw.joysticks + jid;
+        if (!js->connected || !js->mapping)
+            continue;
+
+        if (!pollJoystick(js, _GLFW_POLL_ALL))
+            continue;
+
+        // Polling may have updated or removed the mapping
+        if (!js->mapping)
+            continue;
+
+        evaluateMapping(js, states + jid);
+        present |= 1 << jid;
     }
 
-    for (i = 0;  i <= GLFW_GAMEPAD_AXIS_LAST;  i++)
+    return present;
+}
+
+GLFWAPI int glfwGetEvents(GLFWevent* events, int count)
+{
+    unsigned int head, tail, available, i;
+
+    assert(events != NULL);
+    assert(count >= 0);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(0);
+
+    if (!_glfw.events.ring)
     {
-        const _GLFWmapelement* e = js->mapping->axes + i;
-        if (e->type == _GLFW_JOYSTICK_AXIS)
-        {
-            const float value = js->axes[e->index] * e->axisScale + e->axisOffset;
-            state->axes[i] = fminf(fmaxf(value, -1.f), 1.f);
-        }
-        else if (e->type == _GLFW_JOYSTICK_HATBIT)
-        {
-            const unsigned int hat = e->index >> 4;
-            const unsigned int bit = e->index & 0xf;
-            if (js->hats[hat] & bit)
-                state->axes[i] = 1.f;
-            else
-                state->axes[i] = -1.f;
-        }
-        else if (e->type == _GLFW_JOYSTICK_BUTTON)
-            state->axes[i] = js->buttons[e->index] * 2.f - 1.f;
+        _glfwInputError(GLFW_FEATURE_UNAVAILABLE, "Event queue is disabled");
+        return 0;
     }
 
-    return GLFW_TRUE;
+    if (count <= 0)
+        return 0;
+
+    tail = _glfw.events.tail;
+    head = _GLFW_LOAD_ACQUIRE(_glfw.events.head);
+
+    available = head - tail;
+    if (available > (unsigned int) count)
+        available = (unsigned int) count;
+
+    for (i = 0;  i < available;  i++)
+        events[i] = _glfw.events.ring[(tail + i) & (_glfw.events.capacity - 1)];
+
+    _GLFW_STORE_RELEASE(_glfw.events.tail, tail + available);
+    return (int) available;
 }
 
 GLFWAPI void glfwSetClipboardString(GLFWwindow* handle, const char* string)
@@ -1467,14 +2374,38 @@ GLFWAPI void glfwSetClipboardString(GLFWwindow* handle, const char* string)
 GLFWAPI const char* glfwGetClipboardString(GLFWwindow* handle)
 {
     _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
-    return _glfw.platform.getClipboardString();
+
+    const char* string = _glfw.platform.getClipboardString();
+    if (string && !_glfwCheckClipboardSize(strlen(string)))
+        return NULL;
+
+    return string;
+}
+
+GLFWAPI void glfwRequestClipboardString(GLFWwindow* handle, GLFWclipboardfun callback)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+    assert(callback != NULL);
+
+    _GLFW_REQUIRE_INIT();
+
+    window->clipboardRequest = callback;
+
+    if (_glfw.clipboard.delivering)
+    {
+        _glfw.clipboard.deferred = GLFW_TRUE;
+        return;
+    }
+
+    requestClipboardString();
 }
 
 GLFWAPI double glfwGetTime(void)
 {
     _GLFW_REQUIRE_INIT_OR_RETURN(0.0);
     return (double) (_glfwPlatformGetTimerValue() - _glfw.timer.offset) /
-        _glfwPlatformGetTimerFrequency();
+        _glfw.timer.frequency;
 }
 
 GLFWAPI void glfwSetTime(double time)
@@ -1487,8 +2418,18 @@ GLFWAPI void glfwSetTime(double time)
         return;
     }
 
+    // A timer faster than 1 GHz, like the TSC, cannot count that far and the
+    // conversion below would overflow
+    if (time * (double) _glfw.timer.frequency >= 18446744073709551616.0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Time %f is out of range for a %f GHz timer",
+                        time, _glfw.timer.frequency / 1e9);
+        return;
+    }
+
     _glfw.timer.offset = _glfwPlatformGetTimerValue() -
-        (uint64_t) (time * _glfwPlatformGetTimerFrequency());
+        (uint64_t) (time * _glfw.timer.frequency);
 }
 
 GLFWAPI uint64_t glfwGetTimerValue(void)
@@ -1500,6 +2441,23 @@ GLFWAPI uint64_t glfwGetTimerValue(void)
 GLFWAPI uint64_t glfwGetTimerFrequency(void)
 {
     _GLFW_REQUIRE_INIT_OR_RETURN(0);
-    return _glfwPlatformGetTimerFrequency();
+    return _glfw.timer.frequency;
+}
+
+GLFWAPI uint64_t glfwGetTimeNanoseconds(void)
+{
+    uint64_t ticks;
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(0);
+
+    ticks = _glfwPlatformGetTimerValue() - _glfw.timer.offset;
+
+#if defined(__SIZEOF_INT128__)
+    return ticks * _glfw.timer.nanoseconds + (uint64_t)
+        (((unsigned __int128) ticks * _glfw.timer.nanosecondFraction) >> 64);
+#else
+    return ticks / _glfw.timer.frequency * 1000000000 +
+        ticks % _glfw.timer.frequency * 1000000000 / _glfw.timer.frequency;
+#endif
 }
 
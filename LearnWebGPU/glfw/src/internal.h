@@ -58,6 +58,49 @@
 
 #define _GLFW_MESSAGE_SIZE      1024
 
+#define _GLFW_COMMAND_NONE                0
+#define _GLFW_COMMAND_WINDOW_TITLE        1
+#define _GLFW_COMMAND_WINDOW_POS          2
+#define _GLFW_COMMAND_WINDOW_SIZE         3
+#define _GLFW_COMMAND_WINDOW_SIZE_LIMITS  4
+#define _GLFW_COMMAND_WINDOW_ASPECT_RATIO 5
+#define _GLFW_COMMAND_WINDOW_OPACITY      6
+#define _GLFW_COMMAND_WINDOW_MONITOR      7
+#define _GLFW_COMMAND_WINDOW_ATTRIB       8
+#define _GLFW_COMMAND_ICONIFY_WINDOW      9
+#define _GLFW_COMMAND_RESTORE_WINDOW      10
+#define _GLFW_COMMAND_MAXIMIZE_WINDOW     11
+#define _GLFW_COMMAND_SHOW_WINDOW         12
+#define _GLFW_COMMAND_HIDE_WINDOW         13
+#define _GLFW_COMMAND_FOCUS_WINDOW        14
+#define _GLFW_COMMAND_REQUEST_ATTENTION   15
+#define _GLFW_COMMAND_CURSOR_POS          16
+#define _GLFW_COMMAND_INPUT_MODE          17
+#define _GLFW_COMMAND_CURSOR              18
+
+// Input recording state
+#define _GLFW_RECORDING 1
+#define _GLFW_REPLAYING 2
+
+// Input recording record types, part of the recording file format
+#define _GLFW_RECORD_POLL                  1
+#define _GLFW_RECORD_KEY                   2
+#define _GLFW_RECORD_CHAR                  3
+#define _GLFW_RECORD_MOUSE_BUTTON          4
+#define _GLFW_RECORD_CURSOR_POS            5
+#define _GLFW_RECORD_CURSOR_ENTER          6
+#define _GLFW_RECORD_SCROLL                7
+#define _GLFW_RECORD_WINDOW_SIZE           8
+#define _GLFW_RECORD_FRAMEBUFFER_SIZE      9
+#define _GLFW_RECORD_WINDOW_FOCUS          10
+#define _GLFW_RECORD_WINDOW_ICONIFY        11
+#define _GLFW_RECORD_WINDOW_CLOSE          12
+#define _GLFW_RECORD_JOYSTICK_CONNECTED    13
+#define _GLFW_RECORD_JOYSTICK_DISCONNECTED 14
+#define _GLFW_RECORD_JOYSTICK_AXIS         15
+#define _GLFW_RECORD_JOYSTICK_BUTTON       16
+#define _GLFW_RECORD_JOYSTICK_HAT          17
+
 typedef int GLFWbool;
 typedef void (*GLFWproc)(void);
 
@@ -74,7 +117,9 @@ typedef struct _GLFWmonitor     _GLFWmonitor;
 typedef struct _GLFWcursor      _GLFWcursor;
 typedef struct _GLFWmapelement  _GLFWmapelement;
 typedef struct _GLFWmapping     _GLFWmapping;
+typedef struct _GLFWmapop       _GLFWmapop;
 typedef struct _GLFWjoystick    _GLFWjoystick;
+typedef struct _GLFWcommand     _GLFWcommand;
 typedef struct _GLFWtls         _GLFWtls;
 typedef struct _GLFWmutex       _GLFWmutex;
 
@@ -322,6 +367,29 @@ typedef PFN_vkVoidFunction (APIENTRY * PFN_vkGetInstanceProcAddr)(VkInstance,con
 typedef VkResult (APIENTRY * PFN_vkEnumerateInstanceExtensionProperties)(const char*,uint32_t*,VkExtensionProperties*);
 #define vkGetInstanceProcAddr _glfw.vk.GetInstanceProcAddr
 
+#define _GLFW_IMAGE_CACHE_SIZE 16
+
+// Native images, such as cursors, keyed by the image they were created from
+// so that setting the same image again can reuse them
+//
+typedef struct _GLFWimagecache
+{
+    struct
+    {
+        // The hash is only a quick check, the copy of the image decides
+        uint64_t    hash;
+        uint64_t    key;
+        GLFWimage*  image;
+        uintptr_t   handle;
+        // The number of GLFW objects currently using the native image
+        int         refs;
+        uint64_t    lastUse;
+    } entries[_GLFW_IMAGE_CACHE_SIZE];
+    uint64_t        clock;
+    // Destroys a native image evicted from or cleared out of the cache
+    void            (*destroy)(uintptr_t handle);
+} _GLFWimagecache;
+
 #include "platform.h"
 
 #define GLFW_NATIVE_INCLUDE_NONE
@@ -341,6 +409,18 @@ typedef VkResult (APIENTRY * PFN_vkEnumerateInstanceExtensionProperties)(const c
         return x;                                    \
     }
 
+// Loads and stores of the indices shared by the two ends of a lock-free ring
+#if defined(_MSC_VER) && !defined(__clang__)
+ #include <intrin.h>
+ #define _GLFW_LOAD_ACQUIRE(x) \
+    ((unsigned int) _InterlockedCompareExchange((volatile long*) &(x), 0, 0))
+ #define _GLFW_STORE_RELEASE(x, value) \
+    _InterlockedExchange((volatile long*) &(x), (long) (value))
+#else
+ #define _GLFW_LOAD_ACQUIRE(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+ #define _GLFW_STORE_RELEASE(x, value) __atomic_store_n(&(x), (value), __ATOMIC_RELEASE)
+#endif
+
 // Swaps the provided pointers
 #define _GLFW_SWAP(type, x, y) \
     {                          \
@@ -366,6 +446,7 @@ struct _GLFWerror
 struct _GLFWinitconfig
 {
     GLFWbool      hatButtons;
+    GLFWbool      coalesceMotion;
     int           angleType;
     int           platformID;
     PFN_vkGetInstanceProcAddr vulkanLoader;
@@ -379,6 +460,14 @@ struct _GLFWinitconfig
     struct {
         int       libdecorMode;
     } wl;
+    struct {
+        int       capacity;
+        int       overflow;
+        GLFWbool  coalesce;
+    } events;
+    GLFWbool      eventThread;
+    GLFWbool      tscTimer;
+    int           clipboardLimit;
 };
 
 // Window configuration
@@ -404,6 +493,7 @@ struct _GLFWwndconfig
     GLFWbool      centerCursor;
     GLFWbool      focusOnShow;
     GLFWbool      mousePassthrough;
+    GLFWbool      exclusiveFullscreen;
     GLFWbool      scaleToMonitor;
     GLFWbool      scaleFramebuffer;
     struct {
@@ -521,6 +611,8 @@ struct _GLFWcontext
 struct _GLFWwindow
 {
     struct _GLFWwindow* next;
+    // Identifies the window in input recordings, in order of creation
+    int                 serial;
 
     // Window settings and state
     GLFWbool            resizable;
@@ -529,7 +621,15 @@ struct _GLFWwindow
     GLFWbool            floating;
     GLFWbool            focusOnShow;
     GLFWbool            mousePassthrough;
+    // Whether full screen presentation should bypass the compositor and allow
+    // tearing, trading tear-free output for the lowest possible latency
+    GLFWbool            exclusiveFullscreen;
     GLFWbool            shouldClose;
+    // State the visibility is derived from, as last reported by the platform
+    GLFWbool            shown;
+    GLFWbool            iconified;
+    GLFWbool            occluded;
+    int                 visibility;
     void*               userPointer;
     GLFWbool            doublebuffer;
     GLFWvidmode         videoMode;
@@ -550,6 +650,13 @@ struct _GLFWwindow
     // Virtual cursor position when cursor is disabled
     double              virtualCursorPosX, virtualCursorPosY;
     GLFWbool            rawMouseMotion;
+    // Cursor motion accumulated until retrieved by glfwGetCursorDelta
+    double              cursorDeltaX, cursorDeltaY;
+    GLFWbool            cursorTracked;
+    // Merged cursor motion and scroll not yet passed to their callbacks
+    GLFWbool            cursorPosPending;
+    GLFWbool            scrollPending;
+    double              scrollPendingX, scrollPendingY;
 
     _GLFWcontext        context;
 
@@ -558,8 +665,11 @@ struct _GLFWwindow
         GLFWwindowsizefun         size;
         GLFWwindowclosefun        close;
         GLFWwindowrefreshfun      refresh;
+        GLFWwindowframefun        frame;
+        GLFWwindowpresentfun      present;
         GLFWwindowfocusfun        focus;
         GLFWwindowiconifyfun      iconify;
+        GLFWwindowvisibilityfun   visibility;
         GLFWwindowmaximizefun     maximize;
         GLFWframebuffersizefun    fbsize;
         GLFWwindowcontentscalefun scale;
@@ -573,6 +683,11 @@ struct _GLFWwindow
         GLFWdropfun               drop;
     } callbacks;
 
+    // Callback of the clipboard request not yet answered, if any
+    GLFWclipboardfun    clipboardRequest;
+    // Callback of the request being answered by the current delivery
+    GLFWclipboardfun    clipboardDelivery;
+
     // This is defined in platform.h
     GLFW_PLATFORM_WINDOW_STATE
 };
@@ -592,6 +707,8 @@ struct _GLFWmonitor
 
     GLFWvidmode*    modes;
     int             modeCount;
+    // Set when the platform reports that the mode list may have changed
+    GLFWbool        modesStale;
     GLFWvidmode     currentMode;
 
     GLFWgammaramp   originalRamp;
@@ -628,6 +745,19 @@ struct _GLFWmapping
     char            guid[33];
     _GLFWmapelement buttons[15];
     _GLFWmapelement axes[6];
+    // Built-in database line, parsed on first use, or NULL once parsed
+    const char*     source;
+    GLFWbool        invalid;
+};
+
+// Compiled gamepad mapping operation
+//
+struct _GLFWmapop
+{
+    uint8_t         output;
+    uint8_t         input;
+    float           scale;
+    float           offset;
 };
 
 // Joystick structure
@@ -636,6 +766,8 @@ struct _GLFWjoystick
 {
     GLFWbool        allocated;
     GLFWbool        connected;
+    // Created by input replay and not backed by a device
+    GLFWbool        replayed;
     float*          axes;
     int             axisCount;
     unsigned char*  buttons;
@@ -646,11 +778,30 @@ struct _GLFWjoystick
     void*           userPointer;
     char            guid[33];
     _GLFWmapping*   mapping;
+    // The mapping compiled for this joystick, as one run of operations per
+    // kind of gamepad output and joystick input
+    _GLFWmapop      ops[21];
+    uint8_t         buttonsFromButtons;
+    uint8_t         buttonsFromAxes;
+    uint8_t         axesFromAxes;
+    uint8_t         axesFromButtons;
 
     // This is defined in platform.h
     GLFW_PLATFORM_JOYSTICK_STATE
 };
 
+// Window management request made off the event thread
+//
+struct _GLFWcommand
+{
+    int             type;
+    _GLFWwindow*    window;
+    int             values[5];
+    double          x, y;
+    // Owned copy of the title, or the cursor or monitor object
+    void*           pointer;
+};
+
 // Thread local storage structure
 //
 struct _GLFWtls
@@ -689,12 +840,14 @@ struct _GLFWplatform
     int (*getKeyScancode)(int);
     void (*setClipboardString)(const char*);
     const char* (*getClipboardString)(void);
+    void (*requestClipboardString)(void);
     GLFWbool (*initJoysticks)(void);
     void (*terminateJoysticks)(void);
     GLFWbool (*pollJoystick)(_GLFWjoystick*,int);
     const char* (*getMappingName)(void);
     void (*updateGamepadGUID)(char*);
     // monitor
+    void (*pollMonitors)(void);
     void (*freeMonitor)(_GLFWmonitor*);
     void (*getMonitorPos)(_GLFWmonitor*,int*,int*);
     void (*getMonitorContentScale)(_GLFWmonitor*,float*,float*);
@@ -737,10 +890,14 @@ struct _GLFWplatform
     void (*setWindowFloating)(_GLFWwindow*,GLFWbool);
     void (*setWindowOpacity)(_GLFWwindow*,float);
     void (*setWindowMousePassthrough)(_GLFWwindow*,GLFWbool);
+    void (*setWindowExclusiveFullscreen)(_GLFWwindow*,GLFWbool);
+    void (*requestFrameEvents)(_GLFWwindow*);
     void (*pollEvents)(void);
     void (*waitEvents)(void);
     void (*waitEventsTimeout)(double);
     void (*postEmptyEvent)(void);
+    GLFWbool (*addEventSource)(int,GLFWeventsourcefun,void*);
+    void (*removeEventSource)(int);
     // EGL
     EGLenum (*getEGLPlatform)(EGLint**);
     EGLNativeDisplayType (*getEGLNativeDisplay)(void);
@@ -771,21 +928,84 @@ struct _GLFWlibrary
     _GLFWerror*         errorListHead;
     _GLFWcursor*        cursorListHead;
     _GLFWwindow*        windowListHead;
+    int                 windowSerial;
 
     _GLFWmonitor**      monitors;
     int                 monitorCount;
+    // Set once the platform has enumerated monitors
+    GLFWbool            monitorsPolled;
 
     GLFWbool            joysticksInitialized;
     _GLFWjoystick       joysticks[GLFW_JOYSTICK_LAST + 1];
     _GLFWmapping*       mappings;
     int                 mappingCount;
+    int                 mappingCapacity;
+    // Open addressed index of mappings by GUID, -1 for empty slots
+    int*                mappingIndex;
+    int                 mappingIndexSize;
+
+    // Clipboard requests made while clipboard callbacks are being called
+    struct {
+        GLFWbool        delivering;
+        GLFWbool        deferred;
+    } clipboard;
 
     _GLFWtls            errorSlot;
     _GLFWtls            contextSlot;
     _GLFWmutex          errorLock;
 
+    // Window management requests waiting for the event thread
+    struct {
+        GLFWbool        enabled;
+        // Set once a thread has started processing events
+        unsigned int    claimed;
+        // Non-NULL only on the event thread
+        _GLFWtls        eventThread;
+        _GLFWmutex      lock;
+        _GLFWcommand*   queue;
+        unsigned int    count;
+        unsigned int    capacity;
+        // The batch being run, only used by the thread running it
+        _GLFWcommand*   running;
+        unsigned int    runningCount;
+    } commands;
+
+    // Single producer, single consumer ring of queued events
+    struct {
+        GLFWevent*      ring;
+        unsigned int    capacity;
+        // Owned by the thread processing events
+        unsigned int    head;
+        int             lost;
+        GLFWevent       pending;
+        // Owned by the thread calling glfwGetEvents
+        unsigned int    tail;
+    } events;
+
+    // Input being recorded to or replayed from a file
+    struct {
+        int             mode;
+        // Set while replayed events are being passed to the event API
+        GLFWbool        injecting;
+        // The stdio FILE being recorded to
+        void*           file;
+        uint64_t        start;
+        // Time of the last recorded or replayed record, in microseconds
+        uint64_t        time;
+        double          speed;
+        unsigned char*  data;
+        size_t          size;
+        size_t          offset;
+        // Replayed joysticks by their recorded joystick ID
+        _GLFWjoystick*  joysticks[GLFW_JOYSTICK_LAST + 1];
+    } record;
+
     struct {
         uint64_t        offset;
+        uint64_t        frequency;
+        // Nanoseconds per tick, as a whole part and a 0.64 fixed point fraction
+        uint64_t        nanoseconds;
+        uint64_t        nanosecondFraction;
         // This is defined in platform.h
         GLFW_PLATFORM_LIBRARY_TIMER_STATE
     } timer;
@@ -871,6 +1091,7 @@ struct _GLFWlibrary
     GLFW_PLATFORM_LIBRARY_WINDOW_STATE
     GLFW_PLATFORM_LIBRARY_CONTEXT_STATE
     GLFW_PLATFORM_LIBRARY_JOYSTICK_STATE
+    GLFW_PLATFORM_LIBRARY_POLL_STATE
 };
 
 // Global state shared between compilation units of GLFW
@@ -912,8 +1133,12 @@ void _glfwInputFramebufferSize(_GLFWwindow* window, int width, int height);
 void _glfwInputWindowContentScale(_GLFWwindow* window,
                                   float xscale, float yscale);
 void _glfwInputWindowIconify(_GLFWwindow* window, GLFWbool iconified);
+void _glfwInputWindowOcclusion(_GLFWwindow* window, GLFWbool occluded);
 void _glfwInputWindowMaximize(_GLFWwindow* window, GLFWbool maximized);
 void _glfwInputWindowDamage(_GLFWwindow* window);
+void _glfwInputWindowFrame(_GLFWwindow* window);
+void _glfwInputWindowPresentation(_GLFWwindow* window,
+                                  const GLFWpresentation* presentation);
 void _glfwInputWindowCloseRequest(_GLFWwindow* window);
 void _glfwInputWindowMonitor(_GLFWwindow* window, _GLFWmonitor* monitor);
 
@@ -926,6 +1151,9 @@ void _glfwInputMouseClick(_GLFWwindow* window, int button, int action, int mods)
 void _glfwInputCursorPos(_GLFWwindow* window, double xpos, double ypos);
 void _glfwInputCursorEnter(_GLFWwindow* window, GLFWbool entered);
 void _glfwInputDrop(_GLFWwindow* window, int count, const char** names);
+void _glfwInputClipboardString(const char* string);
+GLFWbool _glfwCheckClipboardSize(size_t size);
+GLFWbool _glfwRequestDeferredClipboardString(void);
 void _glfwInputJoystick(_GLFWjoystick* js, int event);
 void _glfwInputJoystickAxis(_GLFWjoystick* js, int axis, float value);
 void _glfwInputJoystickButton(_GLFWjoystick* js, int button, char value);
@@ -963,8 +1191,30 @@ _GLFWmonitor* _glfwAllocMonitor(const char* name, int widthMM, int heightMM);
 void _glfwFreeMonitor(_GLFWmonitor* monitor);
 void _glfwAllocGammaArrays(GLFWgammaramp* ramp, unsigned int size);
 void _glfwFreeGammaArrays(GLFWgammaramp* ramp);
+void _glfwPollMonitors(void);
 void _glfwSplitBPP(int bpp, int* red, int* green, int* blue);
 
+GLFWbool _glfwInitEventQueue(void);
+void _glfwTerminateEventQueue(void);
+void _glfwInitEvent(GLFWevent* event, int type, _GLFWwindow* window);
+void _glfwQueueEvent(const GLFWevent* event);
+void _glfwFlushEventQueue(void);
+void _glfwFlushCoalescedInput(_GLFWwindow* window);
+
+GLFWbool _glfwInitCommandQueue(void);
+void _glfwTerminateCommandQueue(void);
+GLFWbool _glfwShouldDeferCommand(void);
+void _glfwDeferCommand(const _GLFWcommand* command);
+void _glfwDiscardCommands(_GLFWwindow* window, const void* object);
+
+GLFWbool _glfwRecordInput(int type, _GLFWwindow* window,
+                          int a, int b, int c, int d);
+GLFWbool _glfwRecordInputPos(int type, _GLFWwindow* window, double x, double y);
+GLFWbool _glfwRecordJoystick(int type, _GLFWjoystick* js, int index, float value);
+void _glfwUpdateInputRecord(void);
+double _glfwGetReplayTimeout(double timeout);
+void _glfwTerminateInputRecord(void);
+
 void _glfwInitGamepadMappings(void);
 _GLFWjoystick* _glfwAllocJoystick(const char* name,
                                   const char* guid,
@@ -996,6 +1246,16 @@ GLFWbool _glfwInitVulkan(int mode);
 void _glfwTerminateVulkan(void);
 const char* _glfwGetVulkanResultString(VkResult result);
 
+void _glfwConvertImageARGB(uint32_t* target, const GLFWimage* image,
+                           GLFWbool premultiply);
+uint64_t _glfwHashImage(const GLFWimage* image, uint64_t seed);
+GLFWimage* _glfwCopyImages(int count, const GLFWimage* images);
+GLFWbool _glfwEqualImages(int count, const GLFWimage* a, const GLFWimage* b);
+uintptr_t _glfwAcquireCachedImage(_GLFWimagecache* cache, const GLFWimage* image, uint64_t key);
+void _glfwInsertCachedImage(_GLFWimagecache* cache, const GLFWimage* image, uint64_t key, uintptr_t handle);
+GLFWbool _glfwReleaseCachedImage(_GLFWimagecache* cache, uintptr_t handle);
+void _glfwClearImageCache(_GLFWimagecache* cache);
+
 size_t _glfwEncodeUTF8(char* s, uint32_t codepoint);
 char** _glfwParseUriList(char* text, int* count);
 
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/inotify.h>
+#include <sys/epoll.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <dirent.h>
@@ -45,6 +46,9 @@
 #define SYN_DROPPED 3
 #endif
 
+// Number of evdev events read per syscall
+#define _GLFW_JOYSTICK_EVENT_BATCH 64
+
 // Apply an EV_KEY event to the specified joystick
 //
 static void handleKeyEvent(_GLFWjoystick* js, int code, int value)
@@ -233,6 +237,12 @@ static GLFWbool openJoystickDevice(const char* path)
     strncpy(linjs.path, path, sizeof(linjs.path) - 1);
     memcpy(&js->linjs, &linjs, sizeof(linjs));
 
+    if (_glfw.linjs.epoll > 0)
+    {
+        struct epoll_event event = { EPOLLIN, { .fd = linjs.fd } };
+        epoll_ctl(_glfw.linjs.epoll, EPOLL_CTL_ADD, linjs.fd, &event);
+    }
+
     pollAbsState(js);
 
     _glfwInputJoystick(js, GLFW_CONNECTED);
@@ -246,10 +256,105 @@ static GLFWbool openJoystickDevice(const char* path)
 static void closeJoystick(_GLFWjoystick* js)
 {
     _glfwInputJoystick(js, GLFW_DISCONNECTED);
+
+    if (_glfw.linjs.epoll > 0)
+        epoll_ctl(_glfw.linjs.epoll, EPOLL_CTL_DEL, js->linjs.fd, NULL);
+
     close(js->linjs.fd);
     _glfwFreeJoystick(js);
 }
 
+// Apply a single evdev event to the specified joystick
+//
+static void handleEvent(_GLFWjoystick* js, const struct input_event* e)
+{
+    if (e->type == EV_SYN)
+    {
+        if (e->code == SYN_DROPPED)
+            js->linjs.dropped = GLFW_TRUE;
+        else if (e->code == SYN_REPORT && js->linjs.dropped)
+        {
+            // Events were lost, so resynchronize from the device state
+            js->linjs.dropped = GLFW_FALSE;
+            pollAbsState(js);
+        }
+    }
+
+    if (js->linjs.dropped)
+        return;
+
+    if (e->type == EV_KEY)
+        handleKeyEvent(js, e->code, e->value);
+    else if (e->type == EV_ABS)
+        handleAbsEvent(js, e->code, e->value);
+}
+
+// Read all queued events of the specified joystick (non-blocking), as many per
+// syscall as fit in the batch
+//
+static void readJoystickEvents(_GLFWjoystick* js)
+{
+    for (;;)
+    {
+        struct input_event events[_GLFW_JOYSTICK_EVENT_BATCH];
+
+        errno = 0;
+        const ssize_t size = read(js->linjs.fd, events, sizeof(events));
+        if (size < 0)
+        {
+            // Reset the joystick slot if the device was disconnected
+            if (errno == ENODEV)
+                closeJoystick(js);
+
+            break;
+        }
+
+        const size_t count = (size_t) size / sizeof(events[0]);
+
+        for (size_t i = 0;  i < count;  i++)
+            handleEvent(js, events + i);
+
+        // A partial batch means the queue is empty
+        if (count < _GLFW_JOYSTICK_EVENT_BATCH)
+            break;
+    }
+}
+
+// Read the events of all joysticks with queued input, optionally also handling
+// device connection and disconnection
+//
+static void processJoystickEvents(GLFWbool detect)
+{
+    struct epoll_event events[GLFW_JOYSTICK_LAST + 2];
+    const int count = epoll_wait(_glfw.linjs.epoll,
+                                 events,
+                                 sizeof(events) / sizeof(events[0]),
+                                 0);
+
+    for (int i = 0;  i < count;  i++)
+    {
+        const int fd = events[i].data.fd;
+
+        if (fd == _glfw.linjs.inotify)
+        {
+            if (detect)
+                _glfwDetectJoystickConnectionLinux();
+
+            continue;
+        }
+
+        for (int jid = 0;  jid <= GLFW_JOYSTICK_LAST;  jid++)
+        {
+            _GLFWjoystick* js = _glfw.joysticks + jid;
+            if (js->connected && js->linjs.fd == fd)
+            {
+                readJoystickEvents(js);
+                break;
+            }
+        }
+    }
+}
+
 // Lexically compare joysticks by name; used by qsort
 //
 static int compareJoysticks(const void* fp, const void* sp)
@@ -302,6 +407,26 @@ void _glfwDetectJoystickConnectionLinux(void)
     }
 }
 
+// Reads queued joystick input and handles device connection changes
+//
+void _glfwProcessJoystickEventsLinux(void)
+{
+    if (_glfw.linjs.epoll > 0)
+        processJoystickEvents(GLFW_TRUE);
+    else
+        _glfwDetectJoystickConnectionLinux();
+}
+
+// Returns the fd to wait on for joystick input and connection changes
+//
+int _glfwGetJoystickFDLinux(void)
+{
+    if (_glfw.linjs.epoll > 0)
+        return _glfw.linjs.epoll;
+
+    return _glfw.linjs.inotify > 0 ? _glfw.linjs.inotify : -1;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
@@ -324,6 +449,17 @@ GLFWbool _glfwInitJoysticksLinux(void)
 
     // Continue without device connection notifications if inotify fails
 
+    // Joysticks are read when the epoll set says they have input, instead of
+    // trying each of them on every query
+    _glfw.linjs.epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (_glfw.linjs.epoll > 0 && _glfw.linjs.inotify > 0)
+    {
+        struct epoll_event event = { EPOLLIN, { .fd = _glfw.linjs.inotify } };
+        epoll_ctl(_glfw.linjs.epoll, EPOLL_CTL_ADD, _glfw.linjs.inotify, &event);
+    }
+
+    // Continue reading every joystick on each query if epoll fails
+
     _glfw.linjs.regexCompiled = (regcomp(&_glfw.linjs.regex, "^event[0-9]\\+$", 0) == 0);
     if (!_glfw.linjs.regexCompiled)
     {
@@ -379,46 +515,20 @@ void _glfwTerminateJoysticksLinux(void)
         close(_glfw.linjs.inotify);
     }
 
+    if (_glfw.linjs.epoll > 0)
+        close(_glfw.linjs.epoll);
+
     if (_glfw.linjs.regexCompiled)
         regfree(&_glfw.linjs.regex);
 }
 
 GLFWbool _glfwPollJoystickLinux(_GLFWjoystick* js, int mode)
 {
-    // Read all queued events (non-blocking)
-    for (;;)
-    {
-        struct input_event e;
-
-        errno = 0;
-        if (read(js->linjs.fd, &e, sizeof(e)) < 0)
-        {
-            // Reset the joystick slot if the device was disconnected
-            if (errno == ENODEV)
-                closeJoystick(js);
-
-            break;
-        }
-
-        if (e.type == EV_SYN)
-        {
-            if (e.code == SYN_DROPPED)
-                _glfw.linjs.dropped = GLFW_TRUE;
-            else if (e.code == SYN_REPORT)
-            {
-                _glfw.linjs.dropped = GLFW_FALSE;
-                pollAbsState(js);
-            }
-        }
-
-        if (_glfw.linjs.dropped)
-            continue;
-
-        if (e.type == EV_KEY)
-            handleKeyEvent(js, e.code, e.value);
-        else if (e.type == EV_ABS)
-            handleAbsEvent(js, e.code, e.value);
-    }
+    // Connection changes are left to the event processing
+    if (_glfw.linjs.epoll > 0)
+        processJoystickEvents(GLFW_FALSE);
+    else
+        readJoystickEvents(js);
 
     return js->connected;
 }
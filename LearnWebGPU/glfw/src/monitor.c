@@ -69,7 +69,7 @@ static GLFWbool refreshVideoModes(_GLFWmonitor* monitor)
     int modeCount;
     GLFWvidmode* modes;
 
-    if (monitor->modes)
+    if (monitor->modes && !monitor->modesStale)
         return GLFW_TRUE;
 
     modes = _glfw.platform.getVideoModes(monitor, &modeCount);
@@ -81,6 +81,7 @@ static GLFWbool refreshVideoModes(_GLFWmonitor* monitor)
     _glfw_free(monitor->modes);
     monitor->modes = modes;
     monitor->modeCount = modeCount;
+    monitor->modesStale = GLFW_FALSE;
 
     return GLFW_TRUE;
 }
@@ -149,7 +150,12 @@ void _glfwInputMonitor(_GLFWmonitor* monitor, int action, int placement)
         _glfw.callbacks.monitor((GLFWmonitor*) monitor, action);
 
     if (action == GLFW_DISCONNECTED)
+    {
+        // Requests from other threads to make a window full screen on this
+        // monitor would outlive it
+        _glfwDiscardCommands(NULL, monitor);
         _glfwFreeMonitor(monitor);
+    }
 }
 
 // Notifies shared code that a full screen window has acquired or released
@@ -297,6 +303,20 @@ void _glfwSplitBPP(int bpp, int* red, int* green, int* blue)
 }
 
 
+// Enumerates monitors on first use, for platforms that support it
+//
+void _glfwPollMonitors(void)
+{
+    if (_glfw.monitorsPolled)
+        return;
+
+    _glfw.monitorsPolled = GLFW_TRUE;
+
+    if (_glfw.platform.pollMonitors)
+        _glfw.platform.pollMonitors();
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                        GLFW public API                       //////
 //////////////////////////////////////////////////////////////////////////
@@ -308,6 +328,7 @@ GLFWAPI GLFWmonitor** glfwGetMonitors(int* count)
     *count = 0;
 
     _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
+    _glfwPollMonitors();
 
     *count = _glfw.monitorCount;
     return (GLFWmonitor**) _glfw.monitors;
@@ -316,6 +337,7 @@ GLFWAPI GLFWmonitor** glfwGetMonitors(int* count)
 GLFWAPI GLFWmonitor* glfwGetPrimaryMonitor(void)
 {
     _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
+    _glfwPollMonitors();
 
     if (!_glfw.monitorCount)
         return NULL;
@@ -422,6 +444,10 @@ GLFWAPI void* glfwGetMonitorUserPointer(GLFWmonitor* handle)
 GLFWAPI GLFWmonitorfun glfwSetMonitorCallback(GLFWmonitorfun cbfun)
 {
     _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
+
+    // Connection events are only reported for an enumerated monitor list
+    _glfwPollMonitors();
+
     _GLFW_SWAP(GLFWmonitorfun, _glfw.callbacks.monitor, cbfun);
     return cbfun;
 }
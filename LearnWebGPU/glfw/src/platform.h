@@ -210,3 +210,10 @@
  #define GLFW_BUILD_POSIX_POLL
 #endif
 
+#if defined(GLFW_BUILD_POSIX_POLL)
+ #include "posix_poll.h"
+ #define GLFW_PLATFORM_LIBRARY_POLL_STATE GLFW_POSIX_LIBRARY_POLL_STATE
+#else
+ #define GLFW_PLATFORM_LIBRARY_POLL_STATE
+#endif
+
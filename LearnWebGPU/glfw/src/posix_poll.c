@@ -32,7 +32,64 @@
 
 #include <signal.h>
 #include <time.h>
+#include <limits.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+ #include <sys/epoll.h>
+ #include <sys/eventfd.h>
+#endif
+
+// Maximum number of ready file descriptors handled per wait
+#define _GLFW_POLL_EVENT_COUNT 16
+
+// Returns the watched source with the specified file descriptor, if any
+//
+static _GLFWpollsourcePOSIX* findSource(int fd)
+{
+    for (int i = 0;  i < _glfw.posixPoll.sourceCount;  i++)
+    {
+        if (_glfw.posixPoll.sources[i].fd == fd)
+            return _glfw.posixPoll.sources + i;
+    }
+
+    return NULL;
+}
+
+// Create the pipe for empty events without assumuing the OS has pipe2(2)
+//
+static GLFWbool createEmptyEventPipe(void)
+{
+    if (pipe(_glfw.posixPoll.emptyEventFDs) != 0)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "POSIX: Failed to create empty event pipe: %s",
+                        strerror(errno));
+        return GLFW_FALSE;
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        const int sf = fcntl(_glfw.posixPoll.emptyEventFDs[i], F_GETFL, 0);
+        const int df = fcntl(_glfw.posixPoll.emptyEventFDs[i], F_GETFD, 0);
+
+        if (sf == -1 || df == -1 ||
+            fcntl(_glfw.posixPoll.emptyEventFDs[i], F_SETFL, sf | O_NONBLOCK) == -1 ||
+            fcntl(_glfw.posixPoll.emptyEventFDs[i], F_SETFD, df | FD_CLOEXEC) == -1)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "POSIX: Failed to set flags for empty event pipe: %s",
+                            strerror(errno));
+            return GLFW_FALSE;
+        }
+    }
+
+    return GLFW_TRUE;
+}
 
 GLFWbool _glfwPollPOSIX(struct pollfd* fds, nfds_t count, double* timeout)
 {
@@ -41,19 +98,22 @@ GLFWbool _glfwPollPOSIX(struct pollfd* fds, nfds_t count, double* timeout)
         if (timeout)
         {
             const uint64_t base = _glfwPlatformGetTimerValue();
+            // Longer waits than an int of seconds are as good as endless
+            const double duration = *timeout < INT_MAX ? *timeout : INT_MAX;
 
 #if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__CYGWIN__)
-            const time_t seconds = (time_t) *timeout;
-            const long nanoseconds = (long) ((*timeout - seconds) * 1e9);
+            const time_t seconds = (time_t) duration;
+            const long nanoseconds = (long) ((duration - seconds) * 1e9);
             const struct timespec ts = { seconds, nanoseconds };
             const int result = ppoll(fds, count, &ts, NULL);
 #elif defined(__NetBSD__)
-            const time_t seconds = (time_t) *timeout;
-            const long nanoseconds = (long) ((*timeout - seconds) * 1e9);
+            const time_t seconds = (time_t) duration;
+            const long nanoseconds = (long) ((duration - seconds) * 1e9);
             const struct timespec ts = { seconds, nanoseconds };
             const int result = pollts(fds, count, &ts, NULL);
 #else
-            const int milliseconds = (int) (*timeout * 1e3);
+            const int milliseconds =
+                duration * 1e3 < INT_MAX ? (int) (duration * 1e3) : INT_MAX;
             const int result = poll(fds, count, milliseconds);
 #endif
             const int error = errno; // clock_gettime may overwrite our error
@@ -79,5 +139,314 @@ GLFWbool _glfwPollPOSIX(struct pollfd* fds, nfds_t count, double* timeout)
     }
 }
 
+// Creates the empty event file descriptors and the epoll set, if available
+//
+GLFWbool _glfwInitPollSetPOSIX(void)
+{
+#if defined(__linux__)
+    // A single eventfd replaces the pipe and its counter resets in one read
+    const int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fd != -1)
+    {
+        _glfw.posixPoll.emptyEventFDs[0] = fd;
+        _glfw.posixPoll.emptyEventFDs[1] = fd;
+    }
+
+    // Without an epoll set every wait falls back to poll(2)
+    _glfw.posixPoll.epoll = epoll_create1(EPOLL_CLOEXEC);
+#endif
+
+    if (_glfw.posixPoll.emptyEventFDs[0] <= 0)
+    {
+        if (!createEmptyEventPipe())
+            return GLFW_FALSE;
+    }
+
+    return _glfwWatchPollFDPOSIX(_glfw.posixPoll.emptyEventFDs[0],
+                                 _GLFW_POLL_EMPTY_EVENT);
+}
+
+// Closes the empty event file descriptors and the epoll set
+//
+void _glfwTerminatePollSetPOSIX(void)
+{
+    if (_glfw.posixPoll.emptyEventFDs[0] > 0)
+        close(_glfw.posixPoll.emptyEventFDs[0]);
+    if (_glfw.posixPoll.emptyEventFDs[1] > 0 &&
+        _glfw.posixPoll.emptyEventFDs[1] != _glfw.posixPoll.emptyEventFDs[0])
+    {
+        close(_glfw.posixPoll.emptyEventFDs[1]);
+    }
+
+    if (_glfw.posixPoll.epoll > 0)
+        close(_glfw.posixPoll.epoll);
+
+    _glfw_free(_glfw.posixPoll.sources);
+    _glfw_free(_glfw.posixPoll.fds);
+    memset(&_glfw.posixPoll, 0, sizeof(_glfw.posixPoll));
+}
+
+// Adds a file descriptor to the set waited on by the event loop
+// Adding an already watched file descriptor does nothing
+//
+GLFWbool _glfwWatchPollFDPOSIX(int fd, unsigned int bit)
+{
+    _GLFWpollsourcePOSIX* sources;
+    struct pollfd* fds;
+    const int count = _glfw.posixPoll.sourceCount;
+
+    if (findSource(fd))
+        return GLFW_TRUE;
+
+    sources = _glfw_realloc(_glfw.posixPoll.sources,
+                            (count + 1) * sizeof(_GLFWpollsourcePOSIX));
+    if (!sources)
+        return GLFW_FALSE;
+    _glfw.posixPoll.sources = sources;
+
+    fds = _glfw_realloc(_glfw.posixPoll.fds, (count + 1) * sizeof(struct pollfd));
+    if (!fds)
+        return GLFW_FALSE;
+    _glfw.posixPoll.fds = fds;
+
+#if defined(__linux__)
+    if (_glfw.posixPoll.epoll > 0)
+    {
+        // The file descriptor goes in the upper half so that ready user
+        // sources are known without a search
+        struct epoll_event event = { EPOLLIN, { .u64 = ((uint64_t) fd << 32) | bit } };
+        if (epoll_ctl(_glfw.posixPoll.epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "POSIX: Failed to watch file descriptor: %s",
+                            strerror(errno));
+            return GLFW_FALSE;
+        }
+    }
+#endif
+
+    memset(sources + count, 0, sizeof(_GLFWpollsourcePOSIX));
+    sources[count].fd = fd;
+    sources[count].bit = bit;
+    fds[count].fd = fd;
+    fds[count].events = POLLIN;
+    fds[count].revents = 0;
+
+    _glfw.posixPoll.sourceCount++;
+    return GLFW_TRUE;
+}
+
+// Removes a file descriptor from the set waited on by the event loop
+//
+void _glfwUnwatchPollFDPOSIX(int fd)
+{
+    _GLFWpollsourcePOSIX* source = findSource(fd);
+    if (!source)
+        return;
+
+#if defined(__linux__)
+    if (_glfw.posixPoll.epoll > 0)
+        epoll_ctl(_glfw.posixPoll.epoll, EPOLL_CTL_DEL, fd, NULL);
+#endif
+
+    const int index = (int) (source - _glfw.posixPoll.sources);
+    const int last = --_glfw.posixPoll.sourceCount;
+
+    _glfw.posixPoll.sources[index] = _glfw.posixPoll.sources[last];
+    _glfw.posixPoll.fds[index] = _glfw.posixPoll.fds[last];
+}
+
+// Waits until any watched file descriptor is ready or the timeout elapses
+// Returns the bits of the ready file descriptors, or zero on timeout
+//
+unsigned int _glfwWaitPollSetPOSIX(double* timeout)
+{
+    unsigned int ready = 0;
+
+#if defined(__linux__)
+    if (_glfw.posixPoll.epoll > 0)
+    {
+        struct epoll_event events[_GLFW_POLL_EVENT_COUNT];
+
+        for (;;)
+        {
+            int milliseconds = -1;
+            uint64_t base = 0;
+
+            if (timeout)
+            {
+                // Round up to not spin on waits shorter than a millisecond, and
+                // clamp to the longest wait an int can hold
+                if (*timeout * 1e3 >= INT_MAX)
+                    milliseconds = INT_MAX;
+                else
+                {
+                    milliseconds = (int) (*timeout * 1e3);
+                    if (milliseconds < *timeout * 1e3)
+                        milliseconds++;
+                }
+
+                base = _glfwPlatformGetTimerValue();
+            }
+
+            const int count = epoll_wait(_glfw.posixPoll.epoll,
+                                         events, _GLFW_POLL_EVENT_COUNT,
+                                         milliseconds);
+            const int error = errno; // clock_gettime may overwrite our error
+
+            if (timeout)
+            {
+                *timeout -= (_glfwPlatformGetTimerValue() - base) /
+                    (double) _glfwPlatformGetTimerFrequency();
+            }
+
+            if (count > 0)
+            {
+                for (int i = 0;  i < count;  i++)
+                    ready |= (unsigned int) events[i].data.u64;
+
+                return ready;
+            }
+            else if (count == -1 && error != EINTR)
+                return 0;
+            else if (timeout && *timeout <= 0.0)
+                return 0;
+        }
+    }
+#endif
+
+    if (!_glfwPollPOSIX(_glfw.posixPoll.fds, _glfw.posixPoll.sourceCount, timeout))
+        return 0;
+
+    for (int i = 0;  i < _glfw.posixPoll.sourceCount;  i++)
+    {
+        if (_glfw.posixPoll.fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+            ready |= _glfw.posixPoll.sources[i].bit;
+    }
+
+    return ready;
+}
+
+// Calls the callbacks of the user sources that are ready for reading
+//
+void _glfwDispatchEventSourcesPOSIX(void)
+{
+    int stackReady[_GLFW_POLL_EVENT_COUNT];
+    int* ready = stackReady;
+    int count = 0;
+    double timeout = 0.0;
+
+    if (!_glfw.posixPoll.userSourceCount)
+        return;
+
+    // Every watched file descriptor is checked, not just a batch of the ready
+    // ones, so that busy display or joystick file descriptors cannot crowd
+    // out the user sources
+    if (!_glfwPollPOSIX(_glfw.posixPoll.fds, _glfw.posixPoll.sourceCount, &timeout))
+        return;
+
+    if (_glfw.posixPoll.userSourceCount > _GLFW_POLL_EVENT_COUNT)
+    {
+        ready = _glfw_calloc(_glfw.posixPoll.userSourceCount, sizeof(int));
+        if (!ready)
+            return;
+    }
+
+    for (int i = 0;  i < _glfw.posixPoll.sourceCount;  i++)
+    {
+        if ((_glfw.posixPoll.sources[i].bit & _GLFW_POLL_USER) &&
+            (_glfw.posixPoll.fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+        {
+            ready[count++] = _glfw.posixPoll.fds[i].fd;
+        }
+    }
+
+    // Callbacks may remove sources, so they are looked up again each time
+    for (int i = 0;  i < count;  i++)
+    {
+        const _GLFWpollsourcePOSIX* source = findSource(ready[i]);
+        if (source && source->callback)
+            source->callback(source->fd, source->pointer);
+    }
+
+    if (ready != stackReady)
+        _glfw_free(ready);
+}
+
+// Wakes up the event loop from any thread
+//
+void _glfwPostEmptyEventPOSIX(void)
+{
+    const int fd = _glfw.posixPoll.emptyEventFDs[1];
+
+    for (;;)
+    {
+        ssize_t result;
+
+        if (fd == _glfw.posixPoll.emptyEventFDs[0])
+        {
+            const uint64_t value = 1;
+            result = write(fd, &value, sizeof(value));
+        }
+        else
+        {
+            const char byte = 0;
+            result = write(fd, &byte, 1);
+        }
+
+        if (result > 0 || (result == -1 && errno != EINTR))
+            break;
+    }
+}
+
+// Drains available data from the empty event file descriptor
+//
+void _glfwDrainEmptyEventsPOSIX(void)
+{
+    for (;;)
+    {
+        char dummy[64];
+        const ssize_t result = read(_glfw.posixPoll.emptyEventFDs[0], dummy, sizeof(dummy));
+        if (result == -1 && errno != EINTR)
+            break;
+    }
+}
+
+GLFWbool _glfwAddEventSourcePOSIX(int fd, GLFWeventsourcefun callback, void* pointer)
+{
+    _GLFWpollsourcePOSIX* source;
+
+    if (fd < 0 || findSource(fd))
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Invalid or already added file descriptor %i", fd);
+        return GLFW_FALSE;
+    }
+
+    if (!_glfwWatchPollFDPOSIX(fd, _GLFW_POLL_USER))
+        return GLFW_FALSE;
+
+    source = findSource(fd);
+    source->callback = callback;
+    source->pointer = pointer;
+
+    _glfw.posixPoll.userSourceCount++;
+    return GLFW_TRUE;
+}
+
+void _glfwRemoveEventSourcePOSIX(int fd)
+{
+    const _GLFWpollsourcePOSIX* source = findSource(fd);
+    if (!source || !(source->bit & _GLFW_POLL_USER))
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "File descriptor %i is not an event source", fd);
+        return;
+    }
+
+    _glfwUnwatchPollFDPOSIX(fd);
+    _glfw.posixPoll.userSourceCount--;
+}
+
 #endif // GLFW_BUILD_POSIX_POLL
 
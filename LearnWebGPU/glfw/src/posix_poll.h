@@ -26,5 +26,54 @@
 
 #include <poll.h>
 
+#define GLFW_POSIX_LIBRARY_POLL_STATE _GLFWpollPOSIX posixPoll;
+
+// Bits returned by _glfwWaitPollSetPOSIX for the watched file descriptors
+// Bits from _GLFW_POLL_PLATFORM up are free for platform specific sources
+#define _GLFW_POLL_DISPLAY      0x01
+#define _GLFW_POLL_EMPTY_EVENT  0x02
+#define _GLFW_POLL_JOYSTICK     0x04
+#define _GLFW_POLL_USER         0x08
+#define _GLFW_POLL_PLATFORM     0x10
+
+// File descriptor watched by the event loop
+//
+typedef struct _GLFWpollsourcePOSIX
+{
+    int                 fd;
+    unsigned int        bit;
+    // Only set for user sources
+    GLFWeventsourcefun  callback;
+    void*               pointer;
+} _GLFWpollsourcePOSIX;
+
+// POSIX event loop global data
+//
+typedef struct _GLFWpollPOSIX
+{
+    // Persistent epoll set of the sources, if available
+    int                     epoll;
+    // Read and write ends of the empty event pipe, both the same eventfd if
+    // available
+    int                     emptyEventFDs[2];
+    _GLFWpollsourcePOSIX*   sources;
+    // Kept in step with the sources for poll(2) when there is no epoll set
+    struct pollfd*          fds;
+    int                     sourceCount;
+    int                     userSourceCount;
+} _GLFWpollPOSIX;
+
 GLFWbool _glfwPollPOSIX(struct pollfd* fds, nfds_t count, double* timeout);
 
+GLFWbool _glfwInitPollSetPOSIX(void);
+void _glfwTerminatePollSetPOSIX(void);
+GLFWbool _glfwWatchPollFDPOSIX(int fd, unsigned int bit);
+void _glfwUnwatchPollFDPOSIX(int fd);
+unsigned int _glfwWaitPollSetPOSIX(double* timeout);
+void _glfwDispatchEventSourcesPOSIX(void);
+void _glfwPostEmptyEventPOSIX(void);
+void _glfwDrainEmptyEventsPOSIX(void);
+
+GLFWbool _glfwAddEventSourcePOSIX(int fd, GLFWeventsourcefun callback, void* pointer);
+void _glfwRemoveEventSourcePOSIX(int fd);
+
@@ -32,6 +32,73 @@
 #include <unistd.h>
 #include <sys/time.h>
 
+#if defined(__linux__) && defined(__x86_64__)
+ #define _GLFW_TSC_TIMER
+ #include <cpuid.h>
+ #include <stdio.h>
+ #include <string.h>
+ #include <x86intrin.h>
+#endif
+
+#if defined(_GLFW_TSC_TIMER)
+
+// Returns the frequency of the invariant TSC, or zero if it should not be used
+//
+static uint64_t getTSCFrequency(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    char source[16] = "";
+    FILE* file;
+    struct timespec ts;
+    uint64_t tsc, ns;
+
+    if (__get_cpuid_max(0x80000000, NULL) < 0x80000007)
+        return 0;
+
+    __cpuid(0x80000007, eax, ebx, ecx, edx);
+    if (!(edx & (1 << 8)))
+        return 0;
+
+    // Only trust the TSC if the kernel found it synchronized across CPUs
+    file = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource",
+                 "r");
+    if (!file)
+        return 0;
+
+    if (!fgets(source, sizeof(source), file))
+        source[0] = '\0';
+
+    fclose(file);
+
+    if (strcmp(source, "tsc\n") != 0)
+        return 0;
+
+    // Prefer the nominal frequency reported by the CPU
+    if (__get_cpuid_max(0, NULL) >= 0x15)
+    {
+        __cpuid(0x15, eax, ebx, ecx, edx);
+        if (eax && ebx && ecx)
+            return (uint64_t) ecx * ebx / eax;
+    }
+
+    // Otherwise calibrate it against the raw monotonic clock
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    ns = (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+    tsc = __rdtsc();
+
+    ts.tv_sec = 0;
+    ts.tv_nsec = 10000000;
+    nanosleep(&ts, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    ns = (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec - ns;
+    tsc = __rdtsc() - tsc;
+
+    return tsc * 1000000000 / ns;
+}
+
+#endif // _GLFW_TSC_TIMER
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
@@ -46,11 +113,36 @@ void _glfwPlatformInitTimer(void)
     struct timespec ts;
     if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
         _glfw.timer.posix.clock = CLOCK_MONOTONIC;
+
+ #if defined(CLOCK_MONOTONIC_RAW)
+    if (_glfw.hints.init.tscTimer &&
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts) == 0)
+    {
+        _glfw.timer.posix.clock = CLOCK_MONOTONIC_RAW;
+    }
+ #endif
+#endif
+
+#if defined(_GLFW_TSC_TIMER)
+    if (_glfw.hints.init.tscTimer)
+    {
+        const uint64_t frequency = getTSCFrequency();
+        if (frequency)
+        {
+            _glfw.timer.posix.tsc = GLFW_TRUE;
+            _glfw.timer.posix.frequency = frequency;
+        }
+    }
 #endif
 }
 
 uint64_t _glfwPlatformGetTimerValue(void)
 {
+#if defined(_GLFW_TSC_TIMER)
+    if (_glfw.timer.posix.tsc)
+        return __rdtsc();
+#endif
+
     struct timespec ts;
     clock_gettime(_glfw.timer.posix.clock, &ts);
     return (uint64_t) ts.tv_sec * _glfw.timer.posix.frequency + (uint64_t) ts.tv_nsec;
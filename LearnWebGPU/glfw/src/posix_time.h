@@ -37,5 +37,6 @@ typedef struct _GLFWtimerPOSIX
 {
     clockid_t   clock;
     uint64_t    frequency;
+    GLFWbool    tsc;
 } _GLFWtimerPOSIX;
 
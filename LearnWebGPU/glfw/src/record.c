@@ -0,0 +1,743 @@
+//========================================================================
+// GLFW 3.4 - www.glfw.org
+//------------------------------------------------------------------------
+// Copyright (c) 2006-2019 Camilla Löwy <elmindreda@glfw.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <assert.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A recording is this magic, ending with the format version, followed by
+// records.  Each record is a type byte, a 32-bit window serial, a 32-bit time
+// since the previous record in microseconds and the payload of its type.
+// All values are little-endian.
+//
+#define _GLFW_RECORD_MAGIC "GLFWREC\x02"
+#define _GLFW_RECORD_MAGIC_SIZE 8
+#define _GLFW_RECORD_HEADER_SIZE 9
+
+// The number of 32-bit integers and 64-bit floats in the payload of each
+// record type, indexed by type
+//
+static const struct
+{
+    int ints;
+    int doubles;
+} layouts[] =
+{
+    { 0, 0 },
+    { 0, 0 }, // _GLFW_RECORD_POLL
+    { 4, 0 }, // _GLFW_RECORD_KEY
+    { 3, 0 }, // _GLFW_RECORD_CHAR
+    { 3, 0 }, // _GLFW_RECORD_MOUSE_BUTTON
+    { 0, 2 }, // _GLFW_RECORD_CURSOR_POS
+    { 1, 0 }, // _GLFW_RECORD_CURSOR_ENTER
+    { 0, 2 }, // _GLFW_RECORD_SCROLL
+    { 2, 0 }, // _GLFW_RECORD_WINDOW_SIZE
+    { 2, 0 }, // _GLFW_RECORD_FRAMEBUFFER_SIZE
+    { 1, 0 }, // _GLFW_RECORD_WINDOW_FOCUS
+    { 1, 0 }, // _GLFW_RECORD_WINDOW_ICONIFY
+    { 0, 0 }, // _GLFW_RECORD_WINDOW_CLOSE
+    { 4, 0 }, // _GLFW_RECORD_JOYSTICK_CONNECTED, followed by name and GUID
+    { 1, 0 }, // _GLFW_RECORD_JOYSTICK_DISCONNECTED
+    { 2, 1 }, // _GLFW_RECORD_JOYSTICK_AXIS
+    { 3, 0 }, // _GLFW_RECORD_JOYSTICK_BUTTON
+    { 3, 0 }, // _GLFW_RECORD_JOYSTICK_HAT
+};
+
+#define _GLFW_RECORD_LAST _GLFW_RECORD_JOYSTICK_HAT
+
+// Returns the time since recording or replay started, in microseconds
+//
+static uint64_t getRecordTime(void)
+{
+    const uint64_t ticks = _glfwPlatformGetTimerValue() - _glfw.record.start;
+    return (uint64_t) ((double) ticks * 1e6 /
+                       (double) _glfwPlatformGetTimerFrequency());
+}
+
+static void putUint(unsigned char* data, uint64_t value, int size)
+{
+    int i;
+
+    for (i = 0;  i < size;  i++)
+        data[i] = (unsigned char) (value >> (i * 8));
+}
+
+static uint64_t getUint(const unsigned char* data, int size)
+{
+    int i;
+    uint64_t value = 0;
+
+    for (i = 0;  i < size;  i++)
+        value |= (uint64_t) data[i] << (i * 8);
+
+    return value;
+}
+
+static void stopRecording(void)
+{
+    fclose(_glfw.record.file);
+    _glfw.record.file = NULL;
+    _glfw.record.mode = 0;
+}
+
+// Writes a record of the specified type to the recording
+//
+static void writeRecord(int type,
+                        int serial,
+                        const int* ints,
+                        const double* doubles,
+                        const _GLFWjoystick* js)
+{
+    int i;
+    unsigned char data[_GLFW_RECORD_HEADER_SIZE + 4 * 4 + 2 * 8 +
+                       2 + sizeof(js->name) + sizeof(js->guid)];
+    unsigned char* p = data;
+    const uint64_t now = getRecordTime();
+    uint64_t delta = now - _glfw.record.time;
+
+    if (delta > UINT32_MAX)
+        delta = UINT32_MAX;
+
+    _glfw.record.time += delta;
+
+    putUint(p + 0, type, 1);
+    putUint(p + 1, (uint32_t) serial, 4);
+    putUint(p + 5, delta, 4);
+    p += _GLFW_RECORD_HEADER_SIZE;
+
+    for (i = 0;  i < layouts[type].ints;  i++, p += 4)
+        putUint(p, (uint32_t) ints[i], 4);
+
+    for (i = 0;  i < layouts[type].doubles;  i++, p += 8)
+    {
+        uint64_t bits;
+        memcpy(&bits, doubles + i, sizeof(bits));
+        putUint(p, bits, 8);
+    }
+
+    if (type == _GLFW_RECORD_JOYSTICK_CONNECTED)
+    {
+        const size_t nameLength = strlen(js->name);
+        const size_t guidLength = strlen(js->guid);
+
+        *p++ = (unsigned char) nameLength;
+        memcpy(p, js->name, nameLength);
+        p += nameLength;
+
+        *p++ = (unsigned char) guidLength;
+        memcpy(p, js->guid, guidLength);
+        p += guidLength;
+    }
+
+    if (fwrite(data, p - data, 1, _glfw.record.file) != 1)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to write input recording; recording stopped");
+        stopRecording();
+    }
+}
+
+// Records the connection and current state of a joystick
+//
+static void writeJoystick(_GLFWjoystick* js)
+{
+    int i;
+    const int jid = (int) (js - _glfw.joysticks);
+    const int counts[4] = { jid, js->axisCount, js->buttonCount, js->hatCount };
+
+    writeRecord(_GLFW_RECORD_JOYSTICK_CONNECTED, 0, counts, NULL, js);
+
+    for (i = 0;  i < js->axisCount;  i++)
+        _glfwRecordJoystick(_GLFW_RECORD_JOYSTICK_AXIS, js, i, js->axes[i]);
+    for (i = 0;  i < js->buttonCount;  i++)
+        _glfwRecordJoystick(_GLFW_RECORD_JOYSTICK_BUTTON, js, i, js->buttons[i]);
+    for (i = 0;  i < js->hatCount;  i++)
+        _glfwRecordJoystick(_GLFW_RECORD_JOYSTICK_HAT, js, i, js->hats[i]);
+}
+
+// Disconnects and frees a joystick created by replay
+//
+static void releaseJoystick(int jid)
+{
+    _GLFWjoystick* js = _glfw.record.joysticks[jid];
+    if (!js)
+        return;
+
+    _glfw.record.joysticks[jid] = NULL;
+    _glfwInputJoystick(js, GLFW_DISCONNECTED);
+    _glfwFreeJoystick(js);
+}
+
+static void stopReplay(void)
+{
+    int jid;
+
+    _glfw_free(_glfw.record.data);
+    _glfw.record.data = NULL;
+    _glfw.record.size = 0;
+    _glfw.record.offset = 0;
+    _glfw.record.mode = 0;
+
+    for (jid = 0;  jid <= GLFW_JOYSTICK_LAST;  jid++)
+        releaseJoystick(jid);
+}
+
+static _GLFWwindow* findWindow(int serial)
+{
+    _GLFWwindow* window;
+
+    for (window = _glfw.windowListHead;  window;  window = window->next)
+    {
+        if (window->serial == serial)
+            return window;
+    }
+
+    return NULL;
+}
+
+// Returns the size of the record at the current replay offset, or zero if it
+// extends past the end of the recording
+//
+static size_t getRecordSize(int type)
+{
+    const unsigned char* data = _glfw.record.data + _glfw.record.offset;
+    const size_t available = _glfw.record.size - _glfw.record.offset;
+    size_t size = _GLFW_RECORD_HEADER_SIZE +
+                  layouts[type].ints * 4 + layouts[type].doubles * 8;
+
+    if (type == _GLFW_RECORD_JOYSTICK_CONNECTED)
+    {
+        // The name and GUID lengths
+        if (size + 1 > available)
+            return 0;
+        size += 1 + data[size];
+
+        if (size + 1 > available)
+            return 0;
+        size += 1 + data[size];
+    }
+
+    if (size > available)
+        return 0;
+
+    return size;
+}
+
+// Passes a single replayed record to the event API
+//
+static GLFWbool injectRecord(int type, _GLFWwindow* window,
+                             const unsigned char* payload)
+{
+    int i, ints[4];
+    double doubles[2];
+    _GLFWjoystick* js = NULL;
+
+    for (i = 0;  i < layouts[type].ints;  i++, payload += 4)
+        ints[i] = (int) (int32_t) getUint(payload, 4);
+
+    for (i = 0;  i < layouts[type].doubles;  i++, payload += 8)
+    {
+        const uint64_t bits = getUint(payload, 8);
+        memcpy(doubles + i, &bits, sizeof(bits));
+    }
+
+    if (type >= _GLFW_RECORD_JOYSTICK_CONNECTED)
+    {
+        if (ints[0] < 0 || ints[0] > GLFW_JOYSTICK_LAST)
+            return GLFW_FALSE;
+
+        js = _glfw.record.joysticks[ints[0]];
+    }
+
+    switch (type)
+    {
+        case _GLFW_RECORD_KEY:
+            if (ints[0] < GLFW_KEY_UNKNOWN || ints[0] > GLFW_KEY_LAST ||
+                (ints[2] != GLFW_PRESS && ints[2] != GLFW_RELEASE))
+            {
+                return GLFW_FALSE;
+            }
+            if (window)
+                _glfwInputKey(window, ints[0], ints[1], ints[2], ints[3]);
+            break;
+
+        case _GLFW_RECORD_CHAR:
+            if (window)
+                _glfwInputChar(window, ints[0], ints[1], ints[2] != 0);
+            break;
+
+        case _GLFW_RECORD_MOUSE_BUTTON:
+            if (ints[0] < 0 || ints[0] > GLFW_MOUSE_BUTTON_LAST ||
+                (ints[1] != GLFW_PRESS && ints[1] != GLFW_RELEASE))
+            {
+                return GLFW_FALSE;
+            }
+            if (window)
+                _glfwInputMouseClick(window, ints[0], ints[1], ints[2]);
+            break;
+
+        case _GLFW_RECORD_CURSOR_POS:
+            if (window)
+                _glfwInputCursorPos(window, doubles[0], doubles[1]);
+            break;
+
+        case _GLFW_RECORD_CURSOR_ENTER:
+            if (window)
+                _glfwInputCursorEnter(window, ints[0] != 0);
+            break;
+
+        case _GLFW_RECORD_SCROLL:
+            if (window)
+                _glfwInputScroll(window, doubles[0], doubles[1]);
+            break;
+
+        case _GLFW_RECORD_WINDOW_SIZE:
+            if (ints[0] < 0 || ints[1] < 0)
+                return GLFW_FALSE;
+            if (window)
+                _glfwInputWindowSize(window, ints[0], ints[1]);
+            break;
+
+        case _GLFW_RECORD_FRAMEBUFFER_SIZE:
+            if (ints[0] < 0 || ints[1] < 0)
+                return GLFW_FALSE;
+            if (window)
+                _glfwInputFramebufferSize(window, ints[0], ints[1]);
+            break;
+
+        case _GLFW_RECORD_WINDOW_FOCUS:
+            if (window)
+                _glfwInputWindowFocus(window, ints[0] != 0);
+            break;
+
+        case _GLFW_RECORD_WINDOW_ICONIFY:
+            if (window)
+                _glfwInputWindowIconify(window, ints[0] != 0);
+            break;
+
+        case _GLFW_RECORD_WINDOW_CLOSE:
+            if (window)
+                _glfwInputWindowCloseRequest(window);
+            break;
+
+        case _GLFW_RECORD_JOYSTICK_CONNECTED:
+        {
+            char name[sizeof(js->name)], guid[sizeof(js->guid)];
+            const unsigned char* p = payload;
+
+            if (ints[1] < 0 || ints[1] > 0xffff ||
+                ints[2] < 0 || ints[2] > 0xffff ||
+                ints[3] < 0 || ints[3] > 0xffff)
+            {
+                return GLFW_FALSE;
+            }
+
+            memset(name, 0, sizeof(name));
+            memcpy(name, p + 1, _glfw_min(*p, sizeof(name) - 1));
+            p += 1 + *p;
+            memset(guid, 0, sizeof(guid));
+            memcpy(guid, p + 1, _glfw_min(*p, sizeof(guid) - 1));
+
+            releaseJoystick(ints[0]);
+
+            js = _glfwAllocJoystick(name, guid, ints[1], ints[2], ints[3]);
+            if (js)
+            {
+                js->replayed = GLFW_TRUE;
+                _glfw.record.joysticks[ints[0]] = js;
+                _glfwInputJoystick(js, GLFW_CONNECTED);
+            }
+            break;
+        }
+
+        case _GLFW_RECORD_JOYSTICK_DISCONNECTED:
+            releaseJoystick(ints[0]);
+            break;
+
+        case _GLFW_RECORD_JOYSTICK_AXIS:
+            if (js && ints[1] >= 0 && ints[1] < js->axisCount)
+                _glfwInputJoystickAxis(js, ints[1], (float) doubles[0]);
+            break;
+
+        case _GLFW_RECORD_JOYSTICK_BUTTON:
+            if (ints[2] != GLFW_PRESS && ints[2] != GLFW_RELEASE)
+                return GLFW_FALSE;
+            if (js && ints[1] >= 0 && ints[1] < js->buttonCount)
+                _glfwInputJoystickButton(js, ints[1], (char) ints[2]);
+            break;
+
+        case _GLFW_RECORD_JOYSTICK_HAT:
+            if ((ints[2] & 0xf0) ||
+                ((ints[2] & GLFW_HAT_LEFT) && (ints[2] & GLFW_HAT_RIGHT)) ||
+                ((ints[2] & GLFW_HAT_UP) && (ints[2] & GLFW_HAT_DOWN)))
+            {
+                return GLFW_FALSE;
+            }
+            if (js && ints[1] >= 0 && ints[1] < js->hatCount)
+                _glfwInputJoystickHat(js, ints[1], (char) ints[2]);
+            break;
+    }
+
+    return GLFW_TRUE;
+}
+
+// Passes on the replayed records that are due
+//
+static void replayRecords(void)
+{
+    const double now = (double) getRecordTime() * _glfw.record.speed;
+
+    _glfw.record.injecting = GLFW_TRUE;
+
+    while (_glfw.record.mode == _GLFW_REPLAYING)
+    {
+        int type;
+        size_t size;
+        uint64_t delta;
+        const unsigned char* data;
+
+        if (_glfw.record.offset == _glfw.record.size)
+        {
+            stopReplay();
+            break;
+        }
+
+        data = _glfw.record.data + _glfw.record.offset;
+        type = data[0];
+
+        if (type < 1 || type > _GLFW_RECORD_LAST ||
+            !(size = getRecordSize(type)))
+        {
+            _glfwInputError(GLFW_INVALID_VALUE,
+                            "Invalid input recording; replay stopped");
+            stopReplay();
+            break;
+        }
+
+        delta = getUint(data + 5, 4);
+        if (_glfw.record.speed > 0.0 &&
+            (double) (_glfw.record.time + delta) > now)
+        {
+            break;
+        }
+
+        _glfw.record.offset += size;
+        _glfw.record.time += delta;
+
+        if (type == _GLFW_RECORD_POLL)
+        {
+            // Without timing each poll replays the events of a recorded poll
+            if (_glfw.record.speed == 0.0)
+                break;
+
+            continue;
+        }
+
+        if (!injectRecord(type,
+                          findWindow((int) (int32_t) getUint(data + 1, 4)),
+                          data + _GLFW_RECORD_HEADER_SIZE))
+        {
+            _glfwInputError(GLFW_INVALID_VALUE,
+                            "Invalid input recording; replay stopped");
+            stopReplay();
+            break;
+        }
+    }
+
+    _glfw.record.injecting = GLFW_FALSE;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                         GLFW event API                       //////
+//////////////////////////////////////////////////////////////////////////
+
+// Records an event with integer values, and returns whether it should be passed
+// on, which a live event is not while input is being replayed
+//
+GLFWbool _glfwRecordInput(int type, _GLFWwindow* window,
+                          int a, int b, int c, int d)
+{
+    if (_glfw.record.mode == _GLFW_RECORDING)
+    {
+        const int ints[4] = { a, b, c, d };
+        writeRecord(type, window->serial, ints, NULL, NULL);
+        return GLFW_TRUE;
+    }
+
+    return _glfw.record.injecting;
+}
+
+// Records an event with a position or offset, and returns whether it should be
+// passed on, which a live event is not while input is being replayed
+//
+GLFWbool _glfwRecordInputPos(int type, _GLFWwindow* window, double x, double y)
+{
+    if (_glfw.record.mode == _GLFW_RECORDING)
+    {
+        const double doubles[2] = { x, y };
+        writeRecord(type, window->serial, NULL, doubles, NULL);
+        return GLFW_TRUE;
+    }
+
+    return _glfw.record.injecting;
+}
+
+// Records a joystick event, and returns whether it should be passed on, which
+// a live event from a replayed joystick is not while input is being replayed
+//
+GLFWbool _glfwRecordJoystick(int type, _GLFWjoystick* js, int index, float value)
+{
+    if (_glfw.record.mode == _GLFW_RECORDING)
+    {
+        const int jid = (int) (js - _glfw.joysticks);
+
+        if (type == _GLFW_RECORD_JOYSTICK_CONNECTED)
+            writeJoystick(js);
+        else if (type == _GLFW_RECORD_JOYSTICK_AXIS)
+        {
+            const int ints[2] = { jid, index };
+            const double axis = value;
+            writeRecord(type, 0, ints, &axis, NULL);
+        }
+        else
+        {
+            const int ints[3] = { jid, index, (int) value };
+            writeRecord(type, 0, ints, NULL, NULL);
+        }
+
+        return GLFW_TRUE;
+    }
+
+    // Joysticks connected to the machine keep working during replay
+    if (!js->replayed)
+        return GLFW_TRUE;
+
+    return _glfw.record.injecting;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
+// Marks the end of event processing in the recording or passes on the
+// replayed events that are due
+//
+void _glfwUpdateInputRecord(void)
+{
+    if (_glfw.record.mode == _GLFW_RECORDING)
+        writeRecord(_GLFW_RECORD_POLL, 0, NULL, NULL, NULL);
+    else if (_glfw.record.mode == _GLFW_REPLAYING)
+        replayRecords();
+}
+
+// Returns how long event waiting may block before the next replayed record is
+// due, limited to the specified timeout
+//
+double _glfwGetReplayTimeout(double timeout)
+{
+    double seconds;
+    const unsigned char* data = _glfw.record.data + _glfw.record.offset;
+
+    if (_glfw.record.speed == 0.0 ||
+        _glfw.record.offset + _GLFW_RECORD_HEADER_SIZE > _glfw.record.size)
+    {
+        return 0.0;
+    }
+
+    seconds = ((double) (_glfw.record.time + getUint(data + 5, 4)) /
+               _glfw.record.speed - (double) getRecordTime()) / 1e6;
+
+    if (seconds < 0.0)
+        return 0.0;
+    if (seconds > timeout)
+        return timeout;
+
+    return seconds;
+}
+
+// Stops any recording or replay
+//
+void _glfwTerminateInputRecord(void)
+{
+    if (_glfw.record.mode == _GLFW_RECORDING)
+        stopRecording();
+    else if (_glfw.record.mode == _GLFW_REPLAYING)
+        stopReplay();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                        GLFW public API                       //////
+//////////////////////////////////////////////////////////////////////////
+
+GLFWAPI int glfwStartInputRecording(const char* path)
+{
+    int jid;
+
+    assert(path != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+
+    if (_glfw.record.mode)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Input is already being recorded or replayed");
+        return GLFW_FALSE;
+    }
+
+    _glfw.record.file = fopen(path, "wb");
+    if (!_glfw.record.file)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to create input recording %s", path);
+        return GLFW_FALSE;
+    }
+
+    if (fwrite(_GLFW_RECORD_MAGIC, _GLFW_RECORD_MAGIC_SIZE, 1,
+               _glfw.record.file) != 1)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to write input recording %s", path);
+        fclose(_glfw.record.file);
+        _glfw.record.file = NULL;
+        return GLFW_FALSE;
+    }
+
+    _glfw.record.mode = _GLFW_RECORDING;
+    _glfw.record.start = _glfwPlatformGetTimerValue();
+    _glfw.record.time = 0;
+
+    // Joysticks connected before recording started are connected on replay
+    for (jid = 0;  jid <= GLFW_JOYSTICK_LAST;  jid++)
+    {
+        if (_glfw.joysticks[jid].connected && _glfw.record.file)
+            writeJoystick(_glfw.joysticks + jid);
+    }
+
+    return _glfw.record.mode == _GLFW_RECORDING;
+}
+
+GLFWAPI void glfwStopInputRecording(void)
+{
+    _GLFW_REQUIRE_INIT();
+
+    if (_glfw.record.mode == _GLFW_RECORDING)
+        stopRecording();
+}
+
+GLFWAPI int glfwStartInputReplay(const char* path, double speed)
+{
+    FILE* file;
+    long size;
+
+    assert(path != NULL);
+    assert(speed == speed);
+    assert(speed >= 0.0);
+    assert(speed <= DBL_MAX);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+
+    if (speed != speed || speed < 0.0 || speed > DBL_MAX)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid replay speed %f", speed);
+        return GLFW_FALSE;
+    }
+
+    if (_glfw.record.mode)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Input is already being recorded or replayed");
+        return GLFW_FALSE;
+    }
+
+    file = fopen(path, "rb");
+    if (!file)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to open input recording %s", path);
+        return GLFW_FALSE;
+    }
+
+    // The whole recording is read up front to keep file I/O out of replay
+    if (fseek(file, 0, SEEK_END) != 0 ||
+        (size = ftell(file)) < _GLFW_RECORD_MAGIC_SIZE ||
+        fseek(file, 0, SEEK_SET) != 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Invalid input recording %s", path);
+        fclose(file);
+        return GLFW_FALSE;
+    }
+
+    _glfw.record.data = _glfw_calloc(size, 1);
+    if (!_glfw.record.data)
+    {
+        fclose(file);
+        return GLFW_FALSE;
+    }
+
+    if (fread(_glfw.record.data, size, 1, file) != 1 ||
+        memcmp(_glfw.record.data, _GLFW_RECORD_MAGIC,
+               _GLFW_RECORD_MAGIC_SIZE) != 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Invalid input recording %s", path);
+        fclose(file);
+        _glfw_free(_glfw.record.data);
+        _glfw.record.data = NULL;
+        return GLFW_FALSE;
+    }
+
+    fclose(file);
+
+    _glfw.record.mode = _GLFW_REPLAYING;
+    _glfw.record.size = size;
+    _glfw.record.offset = _GLFW_RECORD_MAGIC_SIZE;
+    _glfw.record.speed = speed;
+    _glfw.record.start = _glfwPlatformGetTimerValue();
+    _glfw.record.time = 0;
+    return GLFW_TRUE;
+}
+
+GLFWAPI void glfwStopInputReplay(void)
+{
+    _GLFW_REQUIRE_INIT();
+
+    if (_glfw.record.mode == _GLFW_REPLAYING)
+        stopReplay();
+}
+
+GLFWAPI int glfwIsReplayingInput(void)
+{
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+    return _glfw.record.mode == _GLFW_REPLAYING;
+}
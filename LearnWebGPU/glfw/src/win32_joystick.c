@@ -509,6 +509,7 @@ void _glfwDetectJoystickConnectionWin32(void)
             for (jid = 0;  jid <= GLFW_JOYSTICK_LAST;  jid++)
             {
                 if (_glfw.joysticks[jid].connected &&
+                    !_glfw.joysticks[jid].replayed &&
                     _glfw.joysticks[jid].win32.device == NULL &&
                     _glfw.joysticks[jid].win32.index == index)
                 {
@@ -560,7 +561,7 @@ void _glfwDetectJoystickDisconnectionWin32(void)
     for (jid = 0;  jid <= GLFW_JOYSTICK_LAST;  jid++)
     {
         _GLFWjoystick* js = _glfw.joysticks + jid;
-        if (js->connected)
+        if (js->connected && !js->replayed)
             _glfwPollJoystickWin32(js, _GLFW_POLL_PRESENCE);
     }
 }
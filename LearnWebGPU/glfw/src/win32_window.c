@@ -99,14 +99,12 @@ static const GLFWimage* chooseImage(int count, const GLFWimage* images,
 //
 static HICON createIcon(const GLFWimage* image, int xhot, int yhot, GLFWbool icon)
 {
-    int i;
     HDC dc;
     HICON handle;
     HBITMAP color, mask;
     BITMAPV5HEADER bi;
     ICONINFO ii;
-    unsigned char* target = NULL;
-    unsigned char* source = image->pixels;
+    uint32_t* target = NULL;
 
     ZeroMemory(&bi, sizeof(bi));
     bi.bV5Size        = sizeof(bi);
@@ -145,15 +143,7 @@ static HICON createIcon(const GLFWimage* image, int xhot, int yhot, GLFWbool ico
         return NULL;
     }
 
-    for (i = 0;  i < image->width * image->height;  i++)
-    {
-        target[0] = source[2];
-        target[1] = source[1];
-        target[2] = source[0];
-        target[3] = source[3];
-        target += 4;
-        source += 4;
-    }
+    _glfwConvertImageARGB(target, image, GLFW_FALSE);
 
     ZeroMemory(&ii, sizeof(ii));
     ii.fIcon    = icon;
@@ -33,6 +33,165 @@
 #include <stdlib.h>
 #include <float.h>
 
+// Makes the calling thread the event thread if there is none yet
+//
+static void claimEventThread(void)
+{
+    if (!_glfw.commands.enabled ||
+        _glfwPlatformGetTls(&_glfw.commands.eventThread))
+    {
+        return;
+    }
+
+    _glfwPlatformLockMutex(&_glfw.commands.lock);
+
+    if (!_glfw.commands.claimed)
+    {
+        _glfwPlatformSetTls(&_glfw.commands.eventThread, &_glfw.commands);
+        _GLFW_STORE_RELEASE(_glfw.commands.claimed, 1);
+    }
+
+    _glfwPlatformUnlockMutex(&_glfw.commands.lock);
+}
+
+// Runs the window management requests queued by other threads
+//
+static void runCommands(void)
+{
+    _GLFWcommand* queue;
+    _GLFWcommand* prevRunning;
+    unsigned int count, prevRunningCount, i;
+
+    if (!_glfw.commands.enabled || !_GLFW_LOAD_ACQUIRE(_glfw.commands.count))
+        return;
+
+    // Requests queued while these run wait for the next round
+    _glfwPlatformLockMutex(&_glfw.commands.lock);
+    queue = _glfw.commands.queue;
+    count = _glfw.commands.count;
+    _glfw.commands.queue = NULL;
+    _glfw.commands.count = 0;
+    _glfw.commands.capacity = 0;
+    _glfwPlatformUnlockMutex(&_glfw.commands.lock);
+
+    // Callbacks may destroy what later commands of the batch refer to, so
+    // the batch stays visible to _glfwDiscardCommands while it runs
+    prevRunning = _glfw.commands.running;
+    prevRunningCount = _glfw.commands.runningCount;
+    _glfw.commands.running = queue;
+    _glfw.commands.runningCount = count;
+
+    for (i = 0;  i < count;  i++)
+    {
+        // Take the command out of the batch before running it
+        const _GLFWcommand command = queue[i];
+        const _GLFWcommand* c = &command;
+        GLFWwindow* handle = (GLFWwindow*) c->window;
+
+        queue[i].type = _GLFW_COMMAND_NONE;
+
+        switch (c->type)
+        {
+            case _GLFW_COMMAND_WINDOW_TITLE:
+                glfwSetWindowTitle(handle, c->pointer);
+                _glfw_free(c->pointer);
+                break;
+            case _GLFW_COMMAND_WINDOW_POS:
+                glfwSetWindowPos(handle, c->values[0], c->values[1]);
+                break;
+            case _GLFW_COMMAND_WINDOW_SIZE:
+                glfwSetWindowSize(handle, c->values[0], c->values[1]);
+                break;
+            case _GLFW_COMMAND_WINDOW_SIZE_LIMITS:
+                glfwSetWindowSizeLimits(handle,
+                                        c->values[0], c->values[1],
+                                        c->values[2], c->values[3]);
+                break;
+            case _GLFW_COMMAND_WINDOW_ASPECT_RATIO:
+                glfwSetWindowAspectRatio(handle, c->values[0], c->values[1]);
+                break;
+            case _GLFW_COMMAND_WINDOW_OPACITY:
+                glfwSetWindowOpacity(handle, (float) c->x);
+                break;
+            case _GLFW_COMMAND_WINDOW_MONITOR:
+                glfwSetWindowMonitor(handle, c->pointer,
+                                     c->values[0], c->values[1],
+                                     c->values[2], c->values[3],
+                                     c->values[4]);
+                break;
+            case _GLFW_COMMAND_WINDOW_ATTRIB:
+                glfwSetWindowAttrib(handle, c->values[0], c->values[1]);
+                break;
+            case _GLFW_COMMAND_ICONIFY_WINDOW:
+                glfwIconifyWindow(handle);
+                break;
+            case _GLFW_COMMAND_RESTORE_WINDOW:
+                glfwRestoreWindow(handle);
+                break;
+            case _GLFW_COMMAND_MAXIMIZE_WINDOW:
+                glfwMaximizeWindow(handle);
+                break;
+            case _GLFW_COMMAND_SHOW_WINDOW:
+                glfwShowWindow(handle);
+                break;
+            case _GLFW_COMMAND_HIDE_WINDOW:
+                glfwHideWindow(handle);
+                break;
+            case _GLFW_COMMAND_FOCUS_WINDOW:
+                glfwFocusWindow(handle);
+                break;
+            case _GLFW_COMMAND_REQUEST_ATTENTION:
+                glfwRequestWindowAttention(handle);
+                break;
+            case _GLFW_COMMAND_CURSOR_POS:
+                glfwSetCursorPos(handle, c->x, c->y);
+                break;
+            case _GLFW_COMMAND_INPUT_MODE:
+                glfwSetInputMode(handle, c->values[0], c->values[1]);
+                break;
+            case _GLFW_COMMAND_CURSOR:
+                glfwSetCursor(handle, c->pointer);
+                break;
+        }
+    }
+
+    _glfw.commands.running = prevRunning;
+    _glfw.commands.runningCount = prevRunningCount;
+
+    _glfw_free(queue);
+}
+
+// Returns whether the command refers to the specified window or object
+//
+static GLFWbool commandRefersTo(const _GLFWcommand* c,
+                                _GLFWwindow* window, const void* object)
+{
+    if (c->type == _GLFW_COMMAND_NONE)
+        return GLFW_FALSE;
+
+    if (window && c->window == window)
+        return GLFW_TRUE;
+
+    return object && c->pointer == object &&
+           (c->type == _GLFW_COMMAND_CURSOR ||
+            c->type == _GLFW_COMMAND_WINDOW_MONITOR);
+}
+
+// Passes on the events held back for merging by event processing
+//
+static void flushEvents(void)
+{
+    if (_glfw.events.ring)
+        _glfwFlushEventQueue();
+    else if (_glfw.hints.init.coalesceMotion)
+    {
+        _GLFWwindow* window;
+
+        for (window = _glfw.windowListHead;  window;  window = window->next)
+            _glfwFlushCoalescedInput(window);
+    }
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                         GLFW event API                       //////
@@ -45,7 +204,20 @@ void _glfwInputWindowFocus(_GLFWwindow* window, GLFWbool focused)
     assert(window != NULL);
     assert(focused == GLFW_TRUE || focused == GLFW_FALSE);
 
-    if (window->callbacks.focus)
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_WINDOW_FOCUS, window, focused, 0, 0, 0))
+    {
+        return;
+    }
+
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_WINDOW_FOCUS, window);
+        event.action = focused;
+        _glfwQueueEvent(&event);
+    }
+    else if (window->callbacks.focus)
         window->callbacks.focus((GLFWwindow*) window, focused);
 
     if (!focused)
@@ -76,6 +248,16 @@ void _glfwInputWindowPos(_GLFWwindow* window, int x, int y)
 {
     assert(window != NULL);
 
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_WINDOW_POS, window);
+        event.x = x;
+        event.y = y;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.pos)
         window->callbacks.pos((GLFWwindow*) window, x, y);
 }
@@ -89,10 +271,60 @@ void _glfwInputWindowSize(_GLFWwindow* window, int width, int height)
     assert(width >= 0);
     assert(height >= 0);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_WINDOW_SIZE, window, width, height, 0, 0))
+    {
+        return;
+    }
+
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_WINDOW_SIZE, window);
+        event.width = width;
+        event.height = height;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.size)
         window->callbacks.size((GLFWwindow*) window, width, height);
 }
 
+// Derives the visibility state of a window from whether it is shown,
+// iconified and occluded, and notifies the user if it changed
+//
+static void updateVisibility(_GLFWwindow* window)
+{
+    int visibility;
+
+    if (!window->shown)
+        visibility = GLFW_VISIBILITY_HIDDEN;
+    else if (window->iconified)
+        visibility = GLFW_VISIBILITY_ICONIFIED;
+    else if (window->occluded)
+        visibility = GLFW_VISIBILITY_OCCLUDED;
+    else
+        visibility = GLFW_VISIBILITY_VISIBLE;
+
+    if (window->visibility == visibility)
+        return;
+
+    window->visibility = visibility;
+
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_WINDOW_VISIBILITY, window);
+        event.action = visibility;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
+    if (window->callbacks.visibility)
+        window->callbacks.visibility((GLFWwindow*) window, visibility);
+}
+
 // Notifies shared code that a window has been iconified or restored
 //
 void _glfwInputWindowIconify(_GLFWwindow* window, GLFWbool iconified)
@@ -100,10 +332,40 @@ void _glfwInputWindowIconify(_GLFWwindow* window, GLFWbool iconified)
     assert(window != NULL);
     assert(iconified == GLFW_TRUE || iconified == GLFW_FALSE);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_WINDOW_ICONIFY, window,
+                          iconified, 0, 0, 0))
+    {
+        return;
+    }
+
+    window->iconified = iconified;
+    updateVisibility(window);
+
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_WINDOW_ICONIFY, window);
+        event.action = iconified;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.iconify)
         window->callbacks.iconify((GLFWwindow*) window, iconified);
 }
 
+// Notifies shared code that a window has become fully covered or uncovered
+//
+void _glfwInputWindowOcclusion(_GLFWwindow* window, GLFWbool occluded)
+{
+    assert(window != NULL);
+    assert(occluded == GLFW_TRUE || occluded == GLFW_FALSE);
+
+    window->occluded = occluded;
+    updateVisibility(window);
+}
+
 // Notifies shared code that a window has been maximized or restored
 //
 void _glfwInputWindowMaximize(_GLFWwindow* window, GLFWbool maximized)
@@ -111,6 +373,15 @@ void _glfwInputWindowMaximize(_GLFWwindow* window, GLFWbool maximized)
     assert(window != NULL);
     assert(maximized == GLFW_TRUE || maximized == GLFW_FALSE);
 
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_WINDOW_MAXIMIZE, window);
+        event.action = maximized;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.maximize)
         window->callbacks.maximize((GLFWwindow*) window, maximized);
 }
@@ -124,6 +395,23 @@ void _glfwInputFramebufferSize(_GLFWwindow* window, int width, int height)
     assert(width >= 0);
     assert(height >= 0);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_FRAMEBUFFER_SIZE, window,
+                          width, height, 0, 0))
+    {
+        return;
+    }
+
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_FRAMEBUFFER_SIZE, window);
+        event.width = width;
+        event.height = height;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.fbsize)
         window->callbacks.fbsize((GLFWwindow*) window, width, height);
 }
@@ -139,6 +427,16 @@ void _glfwInputWindowContentScale(_GLFWwindow* window, float xscale, float yscal
     assert(yscale > 0.f);
     assert(yscale < FLT_MAX);
 
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_CONTENT_SCALE, window);
+        event.x = xscale;
+        event.y = yscale;
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.scale)
         window->callbacks.scale((GLFWwindow*) window, xscale, yscale);
 }
@@ -149,18 +447,62 @@ void _glfwInputWindowDamage(_GLFWwindow* window)
 {
     assert(window != NULL);
 
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_WINDOW_REFRESH, window);
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.refresh)
         window->callbacks.refresh((GLFWwindow*) window);
 }
 
+// Notifies shared code that the window system is ready for a new frame
+//
+void _glfwInputWindowFrame(_GLFWwindow* window)
+{
+    assert(window != NULL);
+
+    if (window->callbacks.frame)
+        window->callbacks.frame((GLFWwindow*) window);
+}
+
+// Notifies shared code that a frame was presented or discarded
+//
+void _glfwInputWindowPresentation(_GLFWwindow* window,
+                                  const GLFWpresentation* presentation)
+{
+    assert(window != NULL);
+    assert(presentation != NULL);
+
+    if (window->callbacks.present)
+        window->callbacks.present((GLFWwindow*) window, presentation);
+}
+
 // Notifies shared code that the user wishes to close a window
 //
 void _glfwInputWindowCloseRequest(_GLFWwindow* window)
 {
     assert(window != NULL);
 
+    if (_glfw.record.mode &&
+        !_glfwRecordInput(_GLFW_RECORD_WINDOW_CLOSE, window, 0, 0, 0, 0))
+    {
+        return;
+    }
+
     window->shouldClose = GLFW_TRUE;
 
+    if (_glfw.events.ring)
+    {
+        GLFWevent event;
+        _glfwInitEvent(&event, GLFW_EVENT_WINDOW_CLOSE, window);
+        _glfwQueueEvent(&event);
+        return;
+    }
+
     if (window->callbacks.close)
         window->callbacks.close((GLFWwindow*) window);
 }
@@ -173,6 +515,147 @@ void _glfwInputWindowMonitor(_GLFWwindow* window, _GLFWmonitor* monitor)
     window->monitor = monitor;
 }
 
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
+// Creates the lock and thread slot of the command queue, if enabled
+//
+GLFWbool _glfwInitCommandQueue(void)
+{
+    if (!_glfw.hints.init.eventThread)
+        return GLFW_TRUE;
+
+    // Only X11 and Wayland have a display connection usable from any thread
+    if (_glfw.platform.platformID != GLFW_PLATFORM_X11 &&
+        _glfw.platform.platformID != GLFW_PLATFORM_WAYLAND)
+    {
+        return GLFW_TRUE;
+    }
+
+    if (!_glfwPlatformCreateMutex(&_glfw.commands.lock))
+        return GLFW_FALSE;
+
+    if (!_glfwPlatformCreateTls(&_glfw.commands.eventThread))
+    {
+        _glfwPlatformDestroyMutex(&_glfw.commands.lock);
+        return GLFW_FALSE;
+    }
+
+    _glfw.commands.enabled = GLFW_TRUE;
+    return GLFW_TRUE;
+}
+
+// Frees the command queue and any requests left in it
+//
+void _glfwTerminateCommandQueue(void)
+{
+    unsigned int i;
+
+    if (!_glfw.commands.enabled)
+        return;
+
+    for (i = 0;  i < _glfw.commands.count;  i++)
+    {
+        if (_glfw.commands.queue[i].type == _GLFW_COMMAND_WINDOW_TITLE)
+            _glfw_free(_glfw.commands.queue[i].pointer);
+    }
+
+    _glfw_free(_glfw.commands.queue);
+    _glfwPlatformDestroyTls(&_glfw.commands.eventThread);
+    _glfwPlatformDestroyMutex(&_glfw.commands.lock);
+    memset(&_glfw.commands, 0, sizeof(_glfw.commands));
+}
+
+// Returns whether window management requests from this thread must be run by
+// the event thread
+//
+GLFWbool _glfwShouldDeferCommand(void)
+{
+    return _glfw.commands.enabled &&
+           _GLFW_LOAD_ACQUIRE(_glfw.commands.claimed) &&
+           !_glfwPlatformGetTls(&_glfw.commands.eventThread);
+}
+
+// Queues a window management request and wakes up the event thread
+//
+void _glfwDeferCommand(const _GLFWcommand* command)
+{
+    _glfwPlatformLockMutex(&_glfw.commands.lock);
+
+    if (_glfw.commands.count == _glfw.commands.capacity)
+    {
+        const unsigned int capacity = _glfw.commands.capacity ?
+                                      _glfw.commands.capacity * 2 : 16;
+        _GLFWcommand* queue = _glfw_realloc(_glfw.commands.queue,
+                                            capacity * sizeof(_GLFWcommand));
+        if (!queue)
+        {
+            // The allocator has reported GLFW_OUT_OF_MEMORY, and the request
+            // is dropped along with what it owns
+            _glfwPlatformUnlockMutex(&_glfw.commands.lock);
+            if (command->type == _GLFW_COMMAND_WINDOW_TITLE)
+                _glfw_free(command->pointer);
+            return;
+        }
+
+        _glfw.commands.queue = queue;
+        _glfw.commands.capacity = capacity;
+    }
+
+    _glfw.commands.queue[_glfw.commands.count] = *command;
+    _GLFW_STORE_RELEASE(_glfw.commands.count, _glfw.commands.count + 1);
+
+    _glfwPlatformUnlockMutex(&_glfw.commands.lock);
+
+    _glfw.platform.postEmptyEvent();
+}
+
+// Drops the queued requests for the specified window, or that refer to the
+// specified cursor or monitor object, before it is destroyed
+//
+void _glfwDiscardCommands(_GLFWwindow* window, const void* object)
+{
+    unsigned int i, count = 0;
+
+    if (!_glfw.commands.enabled)
+        return;
+
+    // Commands of the batch being run are only marked, as runCommands still
+    // walks it
+    for (i = 0;  i < _glfw.commands.runningCount;  i++)
+    {
+        _GLFWcommand* c = _glfw.commands.running + i;
+
+        if (commandRefersTo(c, window, object))
+        {
+            if (c->type == _GLFW_COMMAND_WINDOW_TITLE)
+                _glfw_free(c->pointer);
+
+            c->type = _GLFW_COMMAND_NONE;
+        }
+    }
+
+    _glfwPlatformLockMutex(&_glfw.commands.lock);
+
+    for (i = 0;  i < _glfw.commands.count;  i++)
+    {
+        _GLFWcommand* c = _glfw.commands.queue + i;
+
+        if (commandRefersTo(c, window, object))
+        {
+            if (c->type == _GLFW_COMMAND_WINDOW_TITLE)
+                _glfw_free(c->pointer);
+        }
+        else
+            _glfw.commands.queue[count++] = *c;
+    }
+
+    _GLFW_STORE_RELEASE(_glfw.commands.count, count);
+    _glfwPlatformUnlockMutex(&_glfw.commands.lock);
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                        GLFW public API                       //////
 //////////////////////////////////////////////////////////////////////////
@@ -217,6 +700,7 @@ GLFWAPI GLFWwindow* glfwCreateWindow(int width, int height,
     window = _glfw_calloc(1, sizeof(_GLFWwindow));
     window->next = _glfw.windowListHead;
     _glfw.windowListHead = window;
+    window->serial = ++_glfw.windowSerial;
 
     window->videoMode.width       = width;
     window->videoMode.height      = height;
@@ -232,6 +716,10 @@ GLFWAPI GLFWwindow* glfwCreateWindow(int width, int height,
     window->floating         = wndconfig.floating;
     window->focusOnShow      = wndconfig.focusOnShow;
     window->mousePassthrough = wndconfig.mousePassthrough;
+    window->exclusiveFullscreen = wndconfig.exclusiveFullscreen;
+    window->shown            = wndconfig.visible || window->monitor;
+    window->visibility       = window->shown ? GLFW_VISIBILITY_VISIBLE
+                                             : GLFW_VISIBILITY_HIDDEN;
     window->cursorMode       = GLFW_CURSOR_NORMAL;
 
     window->doublebuffer = fbconfig.doublebuffer;
@@ -398,6 +886,9 @@ GLFWAPI void glfwWindowHint(int hint, int value)
         case GLFW_MOUSE_PASSTHROUGH:
             _glfw.hints.window.mousePassthrough = value ? GLFW_TRUE : GLFW_FALSE;
             return;
+        case GLFW_EXCLUSIVE_FULLSCREEN:
+            _glfw.hints.window.exclusiveFullscreen = value ? GLFW_TRUE : GLFW_FALSE;
+            return;
         case GLFW_CLIENT_API:
             _glfw.hints.context.client = value;
             return;
@@ -485,6 +976,12 @@ GLFWAPI void glfwDestroyWindow(GLFWwindow* handle)
 
     _glfw.platform.destroyWindow(window);
 
+    _glfwDiscardCommands(window, NULL);
+
+    // The pending merged event is not queued yet and can still be dropped
+    if (_glfw.events.pending.window == handle)
+        _glfw.events.pending.type = GLFW_EVENT_NONE;
+
     // Unlink window from global linked list
     {
         _GLFWwindow** prev = &_glfw.windowListHead;
@@ -535,6 +1032,14 @@ GLFWAPI void glfwSetWindowTitle(GLFWwindow* handle, const char* title)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_WINDOW_TITLE, window };
+        command.pointer = _glfw_strdup(title);
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     char* prev = window->title;
     window->title = _glfw_strdup(title);
 
@@ -596,6 +1101,13 @@ GLFWAPI void glfwSetWindowPos(GLFWwindow* handle, int xpos, int ypos)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_WINDOW_POS, window, { xpos, ypos } };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     if (window->monitor)
         return;
 
@@ -625,6 +1137,13 @@ GLFWAPI void glfwSetWindowSize(GLFWwindow* handle, int width, int height)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_WINDOW_SIZE, window, { width, height } };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     window->videoMode.width  = width;
     window->videoMode.height = height;
 
@@ -663,6 +1182,14 @@ GLFWAPI void glfwSetWindowSizeLimits(GLFWwindow* handle,
         }
     }
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_WINDOW_SIZE_LIMITS, window,
+                                 { minwidth, minheight, maxwidth, maxheight } };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     window->minwidth  = minwidth;
     window->minheight = minheight;
     window->maxwidth  = maxwidth;
@@ -696,6 +1223,13 @@ GLFWAPI void glfwSetWindowAspectRatio(GLFWwindow* handle, int numer, int denom)
         }
     }
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_WINDOW_ASPECT_RATIO, window, { numer, denom } };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     window->numer = numer;
     window->denom = denom;
 
@@ -779,6 +1313,14 @@ GLFWAPI void glfwSetWindowOpacity(GLFWwindow* handle, float opacity)
         return;
     }
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_WINDOW_OPACITY, window };
+        command.x = opacity;
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     _glfw.platform.setWindowOpacity(window, opacity);
 }
 
@@ -788,6 +1330,13 @@ GLFWAPI void glfwIconifyWindow(GLFWwindow* handle)
     assert(window != NULL);
 
     _GLFW_REQUIRE_INIT();
+
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_ICONIFY_WINDOW, window };
+        _glfwDeferCommand(&command);
+        return;
+    }
     _glfw.platform.iconifyWindow(window);
 }
 
@@ -797,6 +1346,13 @@ GLFWAPI void glfwRestoreWindow(GLFWwindow* handle)
     assert(window != NULL);
 
     _GLFW_REQUIRE_INIT();
+
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_RESTORE_WINDOW, window };
+        _glfwDeferCommand(&command);
+        return;
+    }
     _glfw.platform.restoreWindow(window);
 }
 
@@ -807,6 +1363,13 @@ GLFWAPI void glfwMaximizeWindow(GLFWwindow* handle)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_MAXIMIZE_WINDOW, window };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     if (window->monitor)
         return;
 
@@ -820,6 +1383,13 @@ GLFWAPI void glfwShowWindow(GLFWwindow* handle)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_SHOW_WINDOW, window };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     if (window->monitor)
         return;
 
@@ -827,6 +1397,9 @@ GLFWAPI void glfwShowWindow(GLFWwindow* handle)
 
     if (window->focusOnShow)
         _glfw.platform.focusWindow(window);
+
+    window->shown = GLFW_TRUE;
+    updateVisibility(window);
 }
 
 GLFWAPI void glfwRequestWindowAttention(GLFWwindow* handle)
@@ -836,6 +1409,13 @@ GLFWAPI void glfwRequestWindowAttention(GLFWwindow* handle)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_REQUEST_ATTENTION, window };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     _glfw.platform.requestWindowAttention(window);
 }
 
@@ -846,10 +1426,20 @@ GLFWAPI void glfwHideWindow(GLFWwindow* handle)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_HIDE_WINDOW, window };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     if (window->monitor)
         return;
 
     _glfw.platform.hideWindow(window);
+
+    window->shown = GLFW_FALSE;
+    updateVisibility(window);
 }
 
 GLFWAPI void glfwFocusWindow(GLFWwindow* handle)
@@ -859,6 +1449,13 @@ GLFWAPI void glfwFocusWindow(GLFWwindow* handle)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_FOCUS_WINDOW, window };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     _glfw.platform.focusWindow(window);
 }
 
@@ -881,10 +1478,14 @@ GLFWAPI int glfwGetWindowAttrib(GLFWwindow* handle, int attrib)
             return _glfw.platform.windowMaximized(window);
         case GLFW_HOVERED:
             return _glfw.platform.windowHovered(window);
+        case GLFW_OCCLUDED:
+            return window->occluded;
         case GLFW_FOCUS_ON_SHOW:
             return window->focusOnShow;
         case GLFW_MOUSE_PASSTHROUGH:
             return window->mousePassthrough;
+        case GLFW_EXCLUSIVE_FULLSCREEN:
+            return window->exclusiveFullscreen;
         case GLFW_TRANSPARENT_FRAMEBUFFER:
             return _glfw.platform.framebufferTransparent(window);
         case GLFW_RESIZABLE:
@@ -932,6 +1533,13 @@ GLFWAPI void glfwSetWindowAttrib(GLFWwindow* handle, int attrib, int value)
 
     _GLFW_REQUIRE_INIT();
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_WINDOW_ATTRIB, window, { attrib, value } };
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     value = value ? GLFW_TRUE : GLFW_FALSE;
 
     switch (attrib)
@@ -966,11 +1574,26 @@ GLFWAPI void glfwSetWindowAttrib(GLFWwindow* handle, int attrib, int value)
             window->mousePassthrough = value;
             _glfw.platform.setWindowMousePassthrough(window, value);
             return;
+
+        case GLFW_EXCLUSIVE_FULLSCREEN:
+            window->exclusiveFullscreen = value;
+            if (_glfw.platform.setWindowExclusiveFullscreen)
+                _glfw.platform.setWindowExclusiveFullscreen(window, value);
+            return;
     }
 
     _glfwInputError(GLFW_INVALID_ENUM, "Invalid window attribute 0x%08X", attrib);
 }
 
+GLFWAPI int glfwGetWindowVisibility(GLFWwindow* handle)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(0);
+    return window->visibility;
+}
+
 GLFWAPI GLFWmonitor* glfwGetWindowMonitor(GLFWwindow* handle)
 {
     _GLFWwindow* window = (_GLFWwindow*) handle;
@@ -1010,6 +1633,15 @@ GLFWAPI void glfwSetWindowMonitor(GLFWwindow* wh,
         return;
     }
 
+    if (_glfwShouldDeferCommand())
+    {
+        _GLFWcommand command = { _GLFW_COMMAND_WINDOW_MONITOR, window,
+                                 { xpos, ypos, width, height, refreshRate } };
+        command.pointer = monitor;
+        _glfwDeferCommand(&command);
+        return;
+    }
+
     window->videoMode.width       = width;
     window->videoMode.height      = height;
     window->videoMode.refreshRate = refreshRate;
@@ -1081,6 +1713,36 @@ GLFWAPI GLFWwindowrefreshfun glfwSetWindowRefreshCallback(GLFWwindow* handle,
     return cbfun;
 }
 
+GLFWAPI GLFWwindowframefun glfwSetWindowFrameCallback(GLFWwindow* handle,
+                                                      GLFWwindowframefun cbfun)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
+    _GLFW_SWAP(GLFWwindowframefun, window->callbacks.frame, cbfun);
+
+    if (_glfw.platform.requestFrameEvents)
+        _glfw.platform.requestFrameEvents(window);
+
+    return cbfun;
+}
+
+GLFWAPI GLFWwindowpresentfun glfwSetWindowPresentCallback(GLFWwindow* handle,
+                                                          GLFWwindowpresentfun cbfun)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
+    _GLFW_SWAP(GLFWwindowpresentfun, window->callbacks.present, cbfun);
+
+    if (_glfw.platform.requestFrameEvents)
+        _glfw.platform.requestFrameEvents(window);
+
+    return cbfun;
+}
+
 GLFWAPI GLFWwindowfocusfun glfwSetWindowFocusCallback(GLFWwindow* handle,
                                                       GLFWwindowfocusfun cbfun)
 {
@@ -1092,6 +1754,17 @@ GLFWAPI GLFWwindowfocusfun glfwSetWindowFocusCallback(GLFWwindow* handle,
     return cbfun;
 }
 
+GLFWAPI GLFWwindowvisibilityfun glfwSetWindowVisibilityCallback(GLFWwindow* handle,
+                                                                GLFWwindowvisibilityfun cbfun)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
+    _GLFW_SWAP(GLFWwindowvisibilityfun, window->callbacks.visibility, cbfun);
+    return cbfun;
+}
+
 GLFWAPI GLFWwindowiconifyfun glfwSetWindowIconifyCallback(GLFWwindow* handle,
                                                           GLFWwindowiconifyfun cbfun)
 {
@@ -1139,13 +1812,35 @@ GLFWAPI GLFWwindowcontentscalefun glfwSetWindowContentScaleCallback(GLFWwindow*
 GLFWAPI void glfwPollEvents(void)
 {
     _GLFW_REQUIRE_INIT();
+    claimEventThread();
+    runCommands();
+    _glfwRequestDeferredClipboardString();
+
     _glfw.platform.pollEvents();
+    _glfwUpdateInputRecord();
+    runCommands();
+    flushEvents();
 }
 
 GLFWAPI void glfwWaitEvents(void)
 {
     _GLFW_REQUIRE_INIT();
-    _glfw.platform.waitEvents();
+    claimEventThread();
+    runCommands();
+
+    // A deferred clipboard request may be answered right away, which must not
+    // wait for another event
+    if (_glfwRequestDeferredClipboardString())
+        _glfw.platform.pollEvents();
+    // Waiting ends in time for the next replayed event
+    else if (_glfw.record.mode == _GLFW_REPLAYING)
+        _glfw.platform.waitEventsTimeout(_glfwGetReplayTimeout(DBL_MAX));
+    else
+        _glfw.platform.waitEvents();
+
+    _glfwUpdateInputRecord();
+    runCommands();
+    flushEvents();
 }
 
 GLFWAPI void glfwWaitEventsTimeout(double timeout)
@@ -1161,7 +1856,18 @@ GLFWAPI void glfwWaitEventsTimeout(double timeout)
         return;
     }
 
+    claimEventThread();
+    runCommands();
+
+    if (_glfwRequestDeferredClipboardString())
+        timeout = 0.0;
+    if (_glfw.record.mode == _GLFW_REPLAYING)
+        timeout = _glfwGetReplayTimeout(timeout);
+
     _glfw.platform.waitEventsTimeout(timeout);
+    _glfwUpdateInputRecord();
+    runCommands();
+    flushEvents();
 }
 
 GLFWAPI void glfwPostEmptyEvent(void)
@@ -1170,3 +1876,34 @@ GLFWAPI void glfwPostEmptyEvent(void)
     _glfw.platform.postEmptyEvent();
 }
 
+GLFWAPI int glfwAddEventSource(int fd, GLFWeventsourcefun callback, void* pointer)
+{
+    assert(fd >= 0);
+    assert(callback != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+
+    if (!_glfw.platform.addEventSource)
+    {
+        _glfwInputError(GLFW_FEATURE_UNAVAILABLE,
+                        "Event sources are not available on this platform");
+        return GLFW_FALSE;
+    }
+
+    return _glfw.platform.addEventSource(fd, callback, pointer);
+}
+
+GLFWAPI void glfwRemoveEventSource(int fd)
+{
+    _GLFW_REQUIRE_INIT();
+
+    if (!_glfw.platform.removeEventSource)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "File descriptor %i is not an event source", fd);
+        return;
+    }
+
+    _glfw.platform.removeEventSource(fd);
+}
+
@@ -47,6 +47,8 @@
 #include "relative-pointer-unstable-v1-client-protocol.h"
 #include "pointer-constraints-unstable-v1-client-protocol.h"
 #include "fractional-scale-v1-client-protocol.h"
+#include "presentation-time-client-protocol.h"
+#include "tearing-control-v1-client-protocol.h"
 #include "xdg-activation-v1-client-protocol.h"
 #include "idle-inhibit-unstable-v1-client-protocol.h"
 
@@ -83,6 +85,14 @@
 #include "fractional-scale-v1-client-protocol-code.h"
 #undef types
 
+#define types _glfw_presentation_time_types
+#include "presentation-time-client-protocol-code.h"
+#undef types
+
+#define types _glfw_tearing_control_types
+#include "tearing-control-v1-client-protocol-code.h"
+#undef types
+
 #define types _glfw_xdg_activation_types
 #include "xdg-activation-v1-client-protocol-code.h"
 #undef types
@@ -91,6 +101,11 @@
 #include "idle-inhibit-unstable-v1-client-protocol-code.h"
 #undef types
 
+static void destroyCachedCursor(uintptr_t handle)
+{
+    wl_buffer_destroy((struct wl_buffer*) handle);
+}
+
 static void wmBaseHandlePing(void* userData,
                              struct xdg_wm_base* wmBase,
                              uint32_t serial)
@@ -103,6 +118,18 @@ static const struct xdg_wm_base_listener wmBaseListener =
     wmBaseHandlePing
 };
 
+static void presentationHandleClockId(void* userData,
+                                      struct wp_presentation* presentation,
+                                      uint32_t clockId)
+{
+    _glfw.wl.presentationClock = clockId;
+}
+
+static const struct wp_presentation_listener presentationListener =
+{
+    presentationHandleClockId
+};
+
 static void registryHandleGlobal(void* userData,
                                  struct wl_registry* registry,
                                  uint32_t name,
@@ -151,7 +178,8 @@ static void registryHandleGlobal(void* userData,
     else if (strcmp(interface, "xdg_wm_base") == 0)
     {
         _glfw.wl.wmBase =
-            wl_registry_bind(registry, name, &xdg_wm_base_interface, 1);
+            wl_registry_bind(registry, name, &xdg_wm_base_interface,
+                             _glfw_min(6, version));
         xdg_wm_base_add_listener(_glfw.wl.wmBase, &wmBaseListener, NULL);
     }
     else if (strcmp(interface, "zxdg_decoration_manager_v1") == 0)
@@ -201,6 +229,21 @@ static void registryHandleGlobal(void* userData,
                              &wp_fractional_scale_manager_v1_interface,
                              1);
     }
+    else if (strcmp(interface, "wp_presentation") == 0)
+    {
+        _glfw.wl.presentation =
+            wl_registry_bind(registry, name, &wp_presentation_interface, 1);
+        wp_presentation_add_listener(_glfw.wl.presentation,
+                                     &presentationListener,
+                                     NULL);
+    }
+    else if (strcmp(interface, "wp_tearing_control_manager_v1") == 0)
+    {
+        _glfw.wl.tearingControlManager =
+            wl_registry_bind(registry, name,
+                             &wp_tearing_control_manager_v1_interface,
+                             1);
+    }
 }
 
 static void registryHandleGlobalRemove(void* userData,
@@ -445,6 +488,7 @@ GLFWbool _glfwConnectWayland(int platformID, _GLFWplatform* platform)
         .getKeyScancode = _glfwGetKeyScancodeWayland,
         .setClipboardString = _glfwSetClipboardStringWayland,
         .getClipboardString = _glfwGetClipboardStringWayland,
+        .requestClipboardString = _glfwRequestClipboardStringWayland,
 #if defined(GLFW_BUILD_LINUX_JOYSTICK)
         .initJoysticks = _glfwInitJoysticksLinux,
         .terminateJoysticks = _glfwTerminateJoysticksLinux,
@@ -499,10 +543,14 @@ GLFWbool _glfwConnectWayland(int platformID, _GLFWplatform* platform)
         .setWindowFloating = _glfwSetWindowFloatingWayland,
         .setWindowOpacity = _glfwSetWindowOpacityWayland,
         .setWindowMousePassthrough = _glfwSetWindowMousePassthroughWayland,
+        .setWindowExclusiveFullscreen = _glfwSetWindowExclusiveFullscreenWayland,
+        .requestFrameEvents = _glfwRequestFrameEventsWayland,
         .pollEvents = _glfwPollEventsWayland,
         .waitEvents = _glfwWaitEventsWayland,
         .waitEventsTimeout = _glfwWaitEventsTimeoutWayland,
         .postEmptyEvent = _glfwPostEmptyEventWayland,
+        .addEventSource = _glfwAddEventSourcePOSIX,
+        .removeEventSource = _glfwRemoveEventSourcePOSIX,
         .getEGLPlatform = _glfwGetEGLPlatformWayland,
         .getEGLNativeDisplay = _glfwGetEGLNativeDisplayWayland,
         .getEGLNativeWindow = _glfwGetEGLNativeWindowWayland,
@@ -548,6 +596,7 @@ GLFWbool _glfwConnectWayland(int platformID, _GLFWplatform* platform)
     }
 
     _glfw.wl.display = display;
+    _glfw.wl.presentationClock = CLOCK_MONOTONIC;
     _glfw.wl.client.handle = module;
 
     *platform = wayland;
@@ -559,8 +608,10 @@ int _glfwInitWayland(void)
     // These must be set before any failure checks
     _glfw.wl.keyRepeatTimerfd = -1;
     _glfw.wl.cursorTimerfd = -1;
+    _glfw.wl.transfer.fd = -1;
 
     _glfw.wl.tag = glfwGetVersionString();
+    _glfw.wl.cursorCache.destroy = destroyCachedCursor;
 
     _glfw.wl.client.display_flush = (PFN_wl_display_flush)
         _glfwPlatformGetModuleSymbol(_glfw.wl.client.handle, "wl_display_flush");
@@ -876,6 +927,22 @@ int _glfwInitWayland(void)
     if (!loadCursorTheme())
         return GLFW_FALSE;
 
+    if (!_glfwInitPollSetPOSIX())
+        return GLFW_FALSE;
+
+    _glfwWatchPollFDPOSIX(wl_display_get_fd(_glfw.wl.display), _GLFW_POLL_DISPLAY);
+
+    if (_glfw.wl.keyRepeatTimerfd >= 0)
+        _glfwWatchPollFDPOSIX(_glfw.wl.keyRepeatTimerfd, _GLFW_POLL_KEY_REPEAT);
+    if (_glfw.wl.cursorTimerfd >= 0)
+        _glfwWatchPollFDPOSIX(_glfw.wl.cursorTimerfd, _GLFW_POLL_CURSOR);
+
+    if (_glfw.wl.libdecor.context)
+    {
+        _glfwWatchPollFDPOSIX(libdecor_get_fd(_glfw.wl.libdecor.context),
+                              _GLFW_POLL_LIBDECOR);
+    }
+
     if (_glfw.wl.seat && _glfw.wl.dataDeviceManager)
     {
         _glfw.wl.dataDevice =
@@ -928,6 +995,8 @@ void _glfwTerminateWayland(void)
         _glfw.wl.xkb.handle = NULL;
     }
 
+    _glfwClearImageCache(&_glfw.wl.cursorCache);
+
     if (_glfw.wl.cursorTheme)
         wl_cursor_theme_destroy(_glfw.wl.cursorTheme);
     if (_glfw.wl.cursorThemeHiDPI)
@@ -983,6 +1052,10 @@ void _glfwTerminateWayland(void)
         xdg_activation_v1_destroy(_glfw.wl.activationManager);
     if (_glfw.wl.fractionalScaleManager)
         wp_fractional_scale_manager_v1_destroy(_glfw.wl.fractionalScaleManager);
+    if (_glfw.wl.presentation)
+        wp_presentation_destroy(_glfw.wl.presentation);
+    if (_glfw.wl.tearingControlManager)
+        wp_tearing_control_manager_v1_destroy(_glfw.wl.tearingControlManager);
     if (_glfw.wl.registry)
         wl_registry_destroy(_glfw.wl.registry);
     if (_glfw.wl.display)
@@ -995,8 +1068,13 @@ void _glfwTerminateWayland(void)
         close(_glfw.wl.keyRepeatTimerfd);
     if (_glfw.wl.cursorTimerfd >= 0)
         close(_glfw.wl.cursorTimerfd);
+    if (_glfw.wl.transfer.fd >= 0)
+        close(_glfw.wl.transfer.fd);
+
+    _glfwTerminatePollSetPOSIX();
 
     _glfw_free(_glfw.wl.clipboardString);
+    _glfw_free(_glfw.wl.transfer.data);
 }
 
 #endif // _GLFW_WAYLAND
@@ -45,7 +45,12 @@ typedef VkResult (APIENTRY *PFN_vkCreateWaylandSurfaceKHR)(VkInstance,const VkWa
 typedef VkBool32 (APIENTRY *PFN_vkGetPhysicalDeviceWaylandPresentationSupportKHR)(VkPhysicalDevice,uint32_t,struct wl_display*);
 
 #include "xkb_unicode.h"
-#include "posix_poll.h"
+
+// Bits of the Wayland specific file descriptors in the POSIX poll set
+#define _GLFW_POLL_KEY_REPEAT   (_GLFW_POLL_PLATFORM << 0)
+#define _GLFW_POLL_CURSOR       (_GLFW_POLL_PLATFORM << 1)
+#define _GLFW_POLL_LIBDECOR     (_GLFW_POLL_PLATFORM << 2)
+#define _GLFW_POLL_CLIPBOARD    (_GLFW_POLL_PLATFORM << 3)
 
 typedef int (* PFN_wl_display_flush)(struct wl_display* display);
 typedef void (* PFN_wl_display_cancel_read)(struct wl_display* display);
@@ -133,6 +138,10 @@ struct wl_output;
 #define xdg_activation_token_v1_interface _glfw_xdg_activation_token_v1_interface
 #define wl_surface_interface _glfw_wl_surface_interface
 #define wp_fractional_scale_v1_interface _glfw_wp_fractional_scale_v1_interface
+#define wp_presentation_interface _glfw_wp_presentation_interface
+#define wp_presentation_feedback_interface _glfw_wp_presentation_feedback_interface
+#define wp_tearing_control_manager_v1_interface _glfw_wp_tearing_control_manager_v1_interface
+#define wp_tearing_control_v1_interface _glfw_wp_tearing_control_v1_interface
 
 #define GLFW_WAYLAND_WINDOW_STATE         _GLFWwindowWayland  wl;
 #define GLFW_WAYLAND_LIBRARY_WINDOW_STATE _GLFWlibraryWayland wl;
@@ -229,7 +238,8 @@ enum libdecor_window_state
 	LIBDECOR_WINDOW_STATE_TILED_LEFT = 8,
 	LIBDECOR_WINDOW_STATE_TILED_RIGHT = 16,
 	LIBDECOR_WINDOW_STATE_TILED_TOP = 32,
-	LIBDECOR_WINDOW_STATE_TILED_BOTTOM = 64
+	LIBDECOR_WINDOW_STATE_TILED_BOTTOM = 64,
+	LIBDECOR_WINDOW_STATE_SUSPENDED = 128
 };
 
 enum libdecor_capabilities
@@ -355,6 +365,7 @@ typedef struct _GLFWwindowWayland
     GLFWbool                    maximized;
     GLFWbool                    activated;
     GLFWbool                    fullscreen;
+    GLFWbool                    suspended;
     GLFWbool                    hovered;
     GLFWbool                    transparent;
     GLFWbool                    scaleFramebuffer;
@@ -371,6 +382,7 @@ typedef struct _GLFWwindowWayland
         GLFWbool                iconified;
         GLFWbool                activated;
         GLFWbool                fullscreen;
+        GLFWbool                suspended;
     } pending;
 
     struct {
@@ -400,11 +412,16 @@ typedef struct _GLFWwindowWayland
     uint32_t                        scalingNumerator;
     struct wp_fractional_scale_v1*  fractionalScale;
 
+    // Pending frame and presentation feedback requests, if any
+    struct wl_callback*             frameCallback;
+    struct wp_presentation_feedback* presentationFeedback;
+
     struct zwp_relative_pointer_v1* relativePointer;
     struct zwp_locked_pointer_v1*   lockedPointer;
     struct zwp_confined_pointer_v1* confinedPointer;
 
     struct zwp_idle_inhibitor_v1*   idleInhibitor;
+    struct wp_tearing_control_v1*   tearingControl;
     struct xdg_activation_token_v1* activationToken;
 
     struct {
@@ -437,6 +454,10 @@ typedef struct _GLFWlibraryWayland
     struct zwp_idle_inhibit_manager_v1*     idleInhibitManager;
     struct xdg_activation_v1*               activationManager;
     struct wp_fractional_scale_manager_v1*  fractionalScaleManager;
+    struct wp_presentation*                 presentation;
+    struct wp_tearing_control_manager_v1*   tearingControlManager;
+    // The clock_gettime clock of presentation timestamps
+    uint32_t                    presentationClock;
 
     _GLFWofferWayland*          offers;
     unsigned int                offerCount;
@@ -453,6 +474,8 @@ typedef struct _GLFWlibraryWayland
     struct wl_cursor_theme*     cursorTheme;
     struct wl_cursor_theme*     cursorThemeHiDPI;
     struct wl_surface*          cursorSurface;
+    // Buffers of custom cursors by image, for reuse by identical cursors
+    _GLFWimagecache             cursorCache;
     const char*                 cursorPreviousName;
     int                         cursorTimerfd;
     uint32_t                    serial;
@@ -464,6 +487,14 @@ typedef struct _GLFWlibraryWayland
     int                         keyRepeatScancode;
 
     char*                       clipboardString;
+    // Clipboard contents received from a pipe as they arrive
+    struct {
+        // Read end of the pipe, or -1 if there is no transfer
+        int                     fd;
+        char*                   data;
+        size_t                  length;
+        size_t                  capacity;
+    } transfer;
     short int                   keycodes[256];
     short int                   scancodes[GLFW_KEY_LAST + 1];
     char                        keynames[GLFW_KEY_LAST + 1][5];
@@ -645,6 +676,8 @@ void _glfwSetWindowFloatingWayland(_GLFWwindow* window, GLFWbool enabled);
 float _glfwGetWindowOpacityWayland(_GLFWwindow* window);
 void _glfwSetWindowOpacityWayland(_GLFWwindow* window, float opacity);
 void _glfwSetWindowMousePassthroughWayland(_GLFWwindow* window, GLFWbool enabled);
+void _glfwSetWindowExclusiveFullscreenWayland(_GLFWwindow* window, GLFWbool enabled);
+void _glfwRequestFrameEventsWayland(_GLFWwindow* window);
 
 void _glfwSetRawMouseMotionWayland(_GLFWwindow* window, GLFWbool enabled);
 GLFWbool _glfwRawMouseMotionSupportedWayland(void);
@@ -665,6 +698,7 @@ void _glfwDestroyCursorWayland(_GLFWcursor* cursor);
 void _glfwSetCursorWayland(_GLFWwindow* window, _GLFWcursor* cursor);
 void _glfwSetClipboardStringWayland(const char* string);
 const char* _glfwGetClipboardStringWayland(void);
+void _glfwRequestClipboardStringWayland(void);
 
 EGLenum _glfwGetEGLPlatformWayland(EGLint** attribs);
 EGLNativeDisplayType _glfwGetEGLNativeDisplayWayland(void);
@@ -40,6 +40,7 @@
 #include <sys/mman.h>
 #include <sys/timerfd.h>
 #include <poll.h>
+#include <time.h>
 #include <linux/input-event-codes.h>
 
 #include "wayland-client-protocol.h"
@@ -51,6 +52,8 @@
 #include "xdg-activation-v1-client-protocol.h"
 #include "idle-inhibit-unstable-v1-client-protocol.h"
 #include "fractional-scale-v1-client-protocol.h"
+#include "presentation-time-client-protocol.h"
+#include "tearing-control-v1-client-protocol.h"
 
 #define GLFW_BORDER_SIZE    4
 #define GLFW_CAPTION_HEIGHT 24
@@ -170,17 +173,7 @@ static struct wl_buffer* createShmBuffer(const GLFWimage* image)
 
     close(fd);
 
-    unsigned char* source = (unsigned char*) image->pixels;
-    unsigned char* target = data;
-    for (int i = 0;  i < image->width * image->height;  i++, source += 4)
-    {
-        unsigned int alpha = source[3];
-
-        *target++ = (unsigned char) ((source[2] * alpha) / 255);
-        *target++ = (unsigned char) ((source[1] * alpha) / 255);
-        *target++ = (unsigned char) ((source[0] * alpha) / 255);
-        *target++ = (unsigned char) alpha;
-    }
+    _glfwConvertImageARGB(data, image, GLFW_TRUE);
 
     struct wl_buffer* buffer =
         wl_shm_pool_create_buffer(pool, 0,
@@ -496,6 +489,35 @@ static void setIdleInhibitor(_GLFWwindow* window, GLFWbool enable)
     }
 }
 
+// Asks the compositor to present the window with asynchronous page flips
+// The tearing control object only exists while it is wanted, as destroying it
+// reverts the surface to vsync presentation
+//
+static void setTearingControl(_GLFWwindow* window, GLFWbool enable)
+{
+    if (enable && !window->wl.tearingControl && _glfw.wl.tearingControlManager)
+    {
+        window->wl.tearingControl =
+            wp_tearing_control_manager_v1_get_tearing_control(
+                _glfw.wl.tearingControlManager, window->wl.surface);
+        if (!window->wl.tearingControl)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "Wayland: Failed to create tearing control");
+            return;
+        }
+
+        wp_tearing_control_v1_set_presentation_hint(
+            window->wl.tearingControl,
+            WP_TEARING_CONTROL_V1_PRESENTATION_HINT_ASYNC);
+    }
+    else if (!enable && window->wl.tearingControl)
+    {
+        wp_tearing_control_v1_destroy(window->wl.tearingControl);
+        window->wl.tearingControl = NULL;
+    }
+}
+
 // Make the specified window and its video mode active on its monitor
 //
 static void acquireMonitor(_GLFWwindow* window)
@@ -512,6 +534,7 @@ static void acquireMonitor(_GLFWwindow* window)
     }
 
     setIdleInhibitor(window, GLFW_TRUE);
+    setTearingControl(window, window->exclusiveFullscreen);
 
     if (window->wl.fallback.decorations)
         destroyFallbackDecorations(window);
@@ -527,6 +550,7 @@ static void releaseMonitor(_GLFWwindow* window)
         xdg_toplevel_unset_fullscreen(window->wl.xdg.toplevel);
 
     setIdleInhibitor(window, GLFW_FALSE);
+    setTearingControl(window, GLFW_FALSE);
 
     if (!window->wl.libdecor.frame &&
         window->wl.xdg.decorationMode != ZXDG_TOPLEVEL_DECORATION_V1_MODE_SERVER_SIDE)
@@ -567,6 +591,7 @@ static void xdgToplevelHandleConfigure(void* userData,
     window->wl.pending.activated  = GLFW_FALSE;
     window->wl.pending.maximized  = GLFW_FALSE;
     window->wl.pending.fullscreen = GLFW_FALSE;
+    window->wl.pending.suspended  = GLFW_FALSE;
 
     wl_array_for_each(state, states)
     {
@@ -583,6 +608,9 @@ static void xdgToplevelHandleConfigure(void* userData,
             case XDG_TOPLEVEL_STATE_ACTIVATED:
                 window->wl.pending.activated = GLFW_TRUE;
                 break;
+            case XDG_TOPLEVEL_STATE_SUSPENDED:
+                window->wl.pending.suspended = GLFW_TRUE;
+                break;
         }
     }
 
@@ -614,10 +642,25 @@ static void xdgToplevelHandleClose(void* userData,
     _glfwInputWindowCloseRequest(window);
 }
 
+static void xdgToplevelHandleConfigureBounds(void* userData,
+                                             struct xdg_toplevel* toplevel,
+                                             int32_t width,
+                                             int32_t height)
+{
+}
+
+static void xdgToplevelHandleWmCapabilities(void* userData,
+                                            struct xdg_toplevel* toplevel,
+                                            struct wl_array* capabilities)
+{
+}
+
 static const struct xdg_toplevel_listener xdgToplevelListener =
 {
     xdgToplevelHandleConfigure,
-    xdgToplevelHandleClose
+    xdgToplevelHandleClose,
+    xdgToplevelHandleConfigureBounds,
+    xdgToplevelHandleWmCapabilities
 };
 
 static void xdgSurfaceHandleConfigure(void* userData,
@@ -646,6 +689,14 @@ static void xdgSurfaceHandleConfigure(void* userData,
 
     window->wl.fullscreen = window->wl.pending.fullscreen;
 
+    // The compositor suspends windows it will not show, for example when they
+    // are minimized, fully covered or on another workspace
+    if (window->wl.suspended != window->wl.pending.suspended)
+    {
+        window->wl.suspended = window->wl.pending.suspended;
+        _glfwInputWindowOcclusion(window, window->wl.suspended);
+    }
+
     int width  = window->wl.pending.width;
     int height = window->wl.pending.height;
 
@@ -695,19 +746,21 @@ void libdecorFrameHandleConfigure(struct libdecor_frame* frame,
     int width, height;
 
     enum libdecor_window_state windowState;
-    GLFWbool fullscreen, activated, maximized;
+    GLFWbool fullscreen, activated, maximized, suspended;
 
     if (libdecor_configuration_get_window_state(config, &windowState))
     {
         fullscreen = (windowState & LIBDECOR_WINDOW_STATE_FULLSCREEN) != 0;
         activated = (windowState & LIBDECOR_WINDOW_STATE_ACTIVE) != 0;
         maximized = (windowState & LIBDECOR_WINDOW_STATE_MAXIMIZED) != 0;
+        suspended = (windowState & LIBDECOR_WINDOW_STATE_SUSPENDED) != 0;
     }
     else
     {
         fullscreen = window->wl.fullscreen;
         activated = window->wl.activated;
         maximized = window->wl.maximized;
+        suspended = window->wl.suspended;
     }
 
     if (!libdecor_configuration_get_content_size(config, frame, &width, &height))
@@ -733,6 +786,12 @@ void libdecorFrameHandleConfigure(struct libdecor_frame* frame,
     libdecor_frame_commit(frame, frameState, config);
     libdecor_state_free(frameState);
 
+    if (window->wl.suspended != suspended)
+    {
+        window->wl.suspended = suspended;
+        _glfwInputWindowOcclusion(window, suspended);
+    }
+
     if (window->wl.activated != activated)
     {
         window->wl.activated = activated;
@@ -851,6 +910,7 @@ static GLFWbool createLibdecorFrame(_GLFWwindow* window)
         libdecor_frame_set_fullscreen(window->wl.libdecor.frame,
                                       window->monitor->wl.output);
         setIdleInhibitor(window, GLFW_TRUE);
+        setTearingControl(window, window->exclusiveFullscreen);
     }
     else
     {
@@ -944,6 +1004,7 @@ static GLFWbool createXdgShellObjects(_GLFWwindow* window)
     {
         xdg_toplevel_set_fullscreen(window->wl.xdg.toplevel, window->monitor->wl.output);
         setIdleInhibitor(window, GLFW_TRUE);
+        setTearingControl(window, window->exclusiveFullscreen);
     }
     else
     {
@@ -1202,25 +1263,152 @@ static void inputText(_GLFWwindow* window, uint32_t scancode)
     }
 }
 
+// Reads from a data offer pipe into a growing string until the pipe would block
+// or reaches end of file
+//
+// Returns 1 at end of file, 0 if the pipe would block and -1 on error or if the
+// string exceeds the clipboard size limit
+//
+static int readDataOfferPipe(int fd, char** string, size_t* length, size_t* size,
+                             GLFWbool limited)
+{
+    for (;;)
+    {
+        const size_t readSize = 65536;
+        const size_t requiredSize = *length + readSize + 1;
+        if (requiredSize > *size)
+        {
+            // Grow geometrically so that large transfers are not copied over
+            // and over again
+            size_t newSize = *size ? *size : requiredSize;
+            while (newSize < requiredSize)
+                newSize *= 2;
+
+            char* longer = _glfw_realloc(*string, newSize);
+            if (!longer)
+            {
+                _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+                return -1;
+            }
+
+            *string = longer;
+            *size = newSize;
+        }
+
+        const ssize_t result = read(fd, *string + *length, readSize);
+        if (result == 0)
+        {
+            (*string)[*length] = '\0';
+            return 1;
+        }
+        else if (result == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return 0;
+
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "Wayland: Failed to read from data offer pipe: %s",
+                            strerror(errno));
+            return -1;
+        }
+
+        *length += result;
+
+        if (limited && !_glfwCheckClipboardSize(*length))
+            return -1;
+    }
+}
+
+// Reads the specified data offer as the specified MIME type
+//
+static char* readDataOfferAsString(struct wl_data_offer* offer,
+                                   const char* mimeType,
+                                   GLFWbool limited)
+{
+    int fds[2];
+
+    if (pipe2(fds, O_CLOEXEC) == -1)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Wayland: Failed to create pipe for data offer: %s",
+                        strerror(errno));
+        return NULL;
+    }
+
+    wl_data_offer_receive(offer, mimeType, fds[1]);
+    flushDisplay();
+    close(fds[1]);
+
+    char* string = NULL;
+    size_t size = 0;
+    size_t length = 0;
+
+    // The pipe is blocking, so this returns only at end of file or on error
+    const int result = readDataOfferPipe(fds[0], &string, &length, &size, limited);
+    close(fds[0]);
+
+    if (result != 1)
+    {
+        _glfw_free(string);
+        return NULL;
+    }
+
+    return string;
+}
+
+// Reads what has arrived of the clipboard transfer and passes the contents to
+// the windows waiting for them once it is complete
+//
+static GLFWbool continueClipboardTransfer(void)
+{
+    const int result = readDataOfferPipe(_glfw.wl.transfer.fd,
+                                         &_glfw.wl.transfer.data,
+                                         &_glfw.wl.transfer.length,
+                                         &_glfw.wl.transfer.capacity,
+                                         GLFW_TRUE);
+    if (result == 0)
+        return GLFW_FALSE;
+
+    _glfwUnwatchPollFDPOSIX(_glfw.wl.transfer.fd);
+    close(_glfw.wl.transfer.fd);
+    _glfw.wl.transfer.fd = -1;
+    _glfw.wl.transfer.length = 0;
+
+    // If this client took over the clipboard during the transfer then the
+    // clipboard string is what is being served to others and must be kept
+    if (result == 1 && !_glfw.wl.selectionSource)
+    {
+        _glfw_free(_glfw.wl.clipboardString);
+        _glfw.wl.clipboardString = _glfw.wl.transfer.data;
+        _glfw.wl.transfer.data = NULL;
+        _glfw.wl.transfer.capacity = 0;
+    }
+
+    if (result == 1 || _glfw.wl.selectionSource)
+        _glfwInputClipboardString(_glfw.wl.clipboardString);
+    else
+        _glfwInputClipboardString(NULL);
+
+    return GLFW_TRUE;
+}
+
 static void handleEvents(double* timeout)
 {
 #if defined(GLFW_BUILD_LINUX_JOYSTICK)
     if (_glfw.joysticksInitialized)
-        _glfwDetectJoystickConnectionLinux();
+    {
+        // Joysticks are initialized on first use, after the display
+        const int fd = _glfwGetJoystickFDLinux();
+        if (fd > 0)
+            _glfwWatchPollFDPOSIX(fd, _GLFW_POLL_JOYSTICK);
+
+        _glfwProcessJoystickEventsLinux();
+    }
 #endif
 
     GLFWbool event = GLFW_FALSE;
-    enum { DISPLAY_FD, KEYREPEAT_FD, CURSOR_FD, LIBDECOR_FD };
-    struct pollfd fds[] =
-    {
-        [DISPLAY_FD] = { wl_display_get_fd(_glfw.wl.display), POLLIN },
-        [KEYREPEAT_FD] = { _glfw.wl.keyRepeatTimerfd, POLLIN },
-        [CURSOR_FD] = { _glfw.wl.cursorTimerfd, POLLIN },
-        [LIBDECOR_FD] = { -1, POLLIN }
-    };
-
-    if (_glfw.wl.libdecor.context)
-        fds[LIBDECOR_FD].fd = libdecor_get_fd(_glfw.wl.libdecor.context);
 
     while (!event)
     {
@@ -1246,13 +1434,14 @@ static void handleEvents(double* timeout)
             return;
         }
 
-        if (!_glfwPollPOSIX(fds, sizeof(fds) / sizeof(fds[0]), timeout))
+        const unsigned int ready = _glfwWaitPollSetPOSIX(timeout);
+        if (!ready)
         {
             wl_display_cancel_read(_glfw.wl.display);
             return;
         }
 
-        if (fds[DISPLAY_FD].revents & POLLIN)
+        if (ready & _GLFW_POLL_DISPLAY)
         {
             wl_display_read_events(_glfw.wl.display);
             if (wl_display_dispatch_pending(_glfw.wl.display) > 0)
@@ -1261,7 +1450,7 @@ static void handleEvents(double* timeout)
         else
             wl_display_cancel_read(_glfw.wl.display);
 
-        if (fds[KEYREPEAT_FD].revents & POLLIN)
+        if (ready & _GLFW_POLL_KEY_REPEAT)
         {
             uint64_t repeats;
 
@@ -1281,7 +1470,7 @@ static void handleEvents(double* timeout)
             }
         }
 
-        if (fds[CURSOR_FD].revents & POLLIN)
+        if (ready & _GLFW_POLL_CURSOR)
         {
             uint64_t repeats;
 
@@ -1289,76 +1478,35 @@ static void handleEvents(double* timeout)
                 incrementCursorImage(_glfw.wl.pointerFocus);
         }
 
-        if (fds[LIBDECOR_FD].revents & POLLIN)
+        if (ready & _GLFW_POLL_LIBDECOR)
         {
             if (libdecor_dispatch(_glfw.wl.libdecor.context, 0) > 0)
                 event = GLFW_TRUE;
         }
-    }
-}
-
-// Reads the specified data offer as the specified MIME type
-//
-static char* readDataOfferAsString(struct wl_data_offer* offer, const char* mimeType)
-{
-    int fds[2];
-
-    if (pipe2(fds, O_CLOEXEC) == -1)
-    {
-        _glfwInputError(GLFW_PLATFORM_ERROR,
-                        "Wayland: Failed to create pipe for data offer: %s",
-                        strerror(errno));
-        return NULL;
-    }
-
-    wl_data_offer_receive(offer, mimeType, fds[1]);
-    flushDisplay();
-    close(fds[1]);
 
-    char* string = NULL;
-    size_t size = 0;
-    size_t length = 0;
-
-    for (;;)
-    {
-        const size_t readSize = 4096;
-        const size_t requiredSize = length + readSize + 1;
-        if (requiredSize > size)
+        if (ready & _GLFW_POLL_CLIPBOARD)
         {
-            char* longer = _glfw_realloc(string, requiredSize);
-            if (!longer)
-            {
-                _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
-                close(fds[0]);
-                return NULL;
-            }
-
-            string = longer;
-            size = requiredSize;
+            if (continueClipboardTransfer())
+                event = GLFW_TRUE;
         }
 
-        const ssize_t result = read(fds[0], string + length, readSize);
-        if (result == 0)
-            break;
-        else if (result == -1)
+        if (ready & _GLFW_POLL_EMPTY_EVENT)
         {
-            if (errno == EINTR)
-                continue;
-
-            _glfwInputError(GLFW_PLATFORM_ERROR,
-                            "Wayland: Failed to read from data offer pipe: %s",
-                            strerror(errno));
-            close(fds[0]);
-            return NULL;
+            _glfwDrainEmptyEventsPOSIX();
+            event = GLFW_TRUE;
         }
 
-        length += result;
-    }
-
-    close(fds[0]);
+        if (ready & _GLFW_POLL_USER)
+            event = GLFW_TRUE;
 
-    string[length] = '\0';
-    return string;
+#if defined(GLFW_BUILD_LINUX_JOYSTICK)
+        if (ready & _GLFW_POLL_JOYSTICK)
+        {
+            _glfwProcessJoystickEventsLinux();
+            event = GLFW_TRUE;
+        }
+#endif
+    }
 }
 
 static void pointerHandleEnter(void* userData,
@@ -2036,7 +2184,7 @@ static void dataDeviceHandleDrop(void* userData,
     if (!_glfw.wl.dragOffer)
         return;
 
-    char* string = readDataOfferAsString(_glfw.wl.dragOffer, "text/uri-list");
+    char* string = readDataOfferAsString(_glfw.wl.dragOffer, "text/uri-list", GLFW_FALSE);
     if (string)
     {
         int count;
@@ -2119,6 +2267,122 @@ void _glfwAddDataDeviceListenerWayland(struct wl_data_device* device)
 }
 
 
+// Returns whether the window is still alive after calling user callbacks
+//
+static GLFWbool windowExists(_GLFWwindow* window)
+{
+    for (_GLFWwindow* w = _glfw.windowListHead;  w;  w = w->next)
+    {
+        if (w == window)
+            return GLFW_TRUE;
+    }
+
+    return GLFW_FALSE;
+}
+
+static void surfaceHandleFrameDone(void* userData,
+                                   struct wl_callback* callback,
+                                   uint32_t time)
+{
+    _GLFWwindow* window = userData;
+
+    wl_callback_destroy(callback);
+    window->wl.frameCallback = NULL;
+
+    _glfwInputWindowFrame(window);
+
+    // The callback may have destroyed the window or cleared the callback
+    if (windowExists(window))
+        _glfwRequestFrameEventsWayland(window);
+}
+
+static const struct wl_callback_listener frameCallbackListener =
+{
+    surfaceHandleFrameDone
+};
+
+// Converts a presentation clock timestamp to the glfwGetTime time base
+//
+static double presentationTimeToGLFW(uint64_t seconds, uint32_t nanoseconds)
+{
+    struct timespec ts;
+    if (clock_gettime(_glfw.wl.presentationClock, &ts) != 0)
+        return 0.0;
+
+    const double now =
+        (double) (_glfwPlatformGetTimerValue() - _glfw.timer.offset) /
+        _glfw.timer.frequency;
+    const double age = ((double) ts.tv_sec - (double) seconds) +
+                       ((double) ts.tv_nsec - (double) nanoseconds) / 1e9;
+
+    return now - age;
+}
+
+static void feedbackHandleSyncOutput(void* userData,
+                                     struct wp_presentation_feedback* feedback,
+                                     struct wl_output* output)
+{
+}
+
+static void feedbackHandlePresented(void* userData,
+                                    struct wp_presentation_feedback* feedback,
+                                    uint32_t secondsHi,
+                                    uint32_t secondsLo,
+                                    uint32_t nanoseconds,
+                                    uint32_t refresh,
+                                    uint32_t sequenceHi,
+                                    uint32_t sequenceLo,
+                                    uint32_t flags)
+{
+    _GLFWwindow* window = userData;
+    GLFWpresentation presentation = { GLFW_TRUE };
+
+    wp_presentation_feedback_destroy(feedback);
+    window->wl.presentationFeedback = NULL;
+
+    presentation.time =
+        presentationTimeToGLFW(((uint64_t) secondsHi << 32) | secondsLo,
+                               nanoseconds);
+    presentation.refreshInterval = refresh / 1e9;
+    presentation.sequence = ((uint64_t) sequenceHi << 32) | sequenceLo;
+
+    if (flags & WP_PRESENTATION_FEEDBACK_KIND_VSYNC)
+        presentation.flags |= GLFW_PRESENTATION_VSYNC;
+    if (flags & WP_PRESENTATION_FEEDBACK_KIND_HW_CLOCK)
+        presentation.flags |= GLFW_PRESENTATION_HW_CLOCK;
+    if (flags & WP_PRESENTATION_FEEDBACK_KIND_HW_COMPLETION)
+        presentation.flags |= GLFW_PRESENTATION_HW_COMPLETION;
+    if (flags & WP_PRESENTATION_FEEDBACK_KIND_ZERO_COPY)
+        presentation.flags |= GLFW_PRESENTATION_ZERO_COPY;
+
+    _glfwInputWindowPresentation(window, &presentation);
+
+    if (windowExists(window))
+        _glfwRequestFrameEventsWayland(window);
+}
+
+static void feedbackHandleDiscarded(void* userData,
+                                    struct wp_presentation_feedback* feedback)
+{
+    _GLFWwindow* window = userData;
+    const GLFWpresentation presentation = { GLFW_FALSE };
+
+    wp_presentation_feedback_destroy(feedback);
+    window->wl.presentationFeedback = NULL;
+
+    _glfwInputWindowPresentation(window, &presentation);
+
+    if (windowExists(window))
+        _glfwRequestFrameEventsWayland(window);
+}
+
+static const struct wp_presentation_feedback_listener feedbackListener =
+{
+    feedbackHandleSyncOutput,
+    feedbackHandlePresented,
+    feedbackHandleDiscarded
+};
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
 //////////////////////////////////////////////////////////////////////////
@@ -2189,6 +2453,9 @@ void _glfwDestroyWindowWayland(_GLFWwindow* window)
     if (window->wl.idleInhibitor)
         zwp_idle_inhibitor_v1_destroy(window->wl.idleInhibitor);
 
+    if (window->wl.tearingControl)
+        wp_tearing_control_v1_destroy(window->wl.tearingControl);
+
     if (window->wl.relativePointer)
         zwp_relative_pointer_v1_destroy(window->wl.relativePointer);
 
@@ -2198,6 +2465,12 @@ void _glfwDestroyWindowWayland(_GLFWwindow* window)
     if (window->wl.confinedPointer)
         zwp_confined_pointer_v1_destroy(window->wl.confinedPointer);
 
+    if (window->wl.frameCallback)
+        wl_callback_destroy(window->wl.frameCallback);
+
+    if (window->wl.presentationFeedback)
+        wp_presentation_feedback_destroy(window->wl.presentationFeedback);
+
     if (window->context.destroy)
         window->context.destroy(window);
 
@@ -2614,6 +2887,36 @@ void _glfwSetWindowMousePassthroughWayland(_GLFWwindow* window, GLFWbool enabled
         wl_surface_set_input_region(window->wl.surface, NULL);
 }
 
+void _glfwSetWindowExclusiveFullscreenWayland(_GLFWwindow* window, GLFWbool enabled)
+{
+    if (window->monitor)
+        setTearingControl(window, enabled);
+}
+
+void _glfwRequestFrameEventsWayland(_GLFWwindow* window)
+{
+    // Both requests apply to the next commit, which is normally the one made
+    // by the next buffer swap or swapchain present
+    if (window->callbacks.frame && !window->wl.frameCallback)
+    {
+        window->wl.frameCallback = wl_surface_frame(window->wl.surface);
+        wl_callback_add_listener(window->wl.frameCallback,
+                                 &frameCallbackListener,
+                                 window);
+    }
+
+    if (window->callbacks.present &&
+        !window->wl.presentationFeedback &&
+        _glfw.wl.presentation)
+    {
+        window->wl.presentationFeedback =
+            wp_presentation_feedback(_glfw.wl.presentation, window->wl.surface);
+        wp_presentation_feedback_add_listener(window->wl.presentationFeedback,
+                                              &feedbackListener,
+                                              window);
+    }
+}
+
 float _glfwGetWindowOpacityWayland(_GLFWwindow* window)
 {
     return 1.f;
@@ -2639,22 +2942,24 @@ void _glfwPollEventsWayland(void)
 {
     double timeout = 0.0;
     handleEvents(&timeout);
+    _glfwDispatchEventSourcesPOSIX();
 }
 
 void _glfwWaitEventsWayland(void)
 {
     handleEvents(NULL);
+    _glfwDispatchEventSourcesPOSIX();
 }
 
 void _glfwWaitEventsTimeoutWayland(double timeout)
 {
     handleEvents(&timeout);
+    _glfwDispatchEventSourcesPOSIX();
 }
 
 void _glfwPostEmptyEventWayland(void)
 {
-    wl_display_sync(_glfw.wl.display);
-    flushDisplay();
+    _glfwPostEmptyEventPOSIX();
 }
 
 void _glfwGetCursorPosWayland(_GLFWwindow* window, double* xpos, double* ypos)
@@ -2742,9 +3047,17 @@ GLFWbool _glfwCreateCursorWayland(_GLFWcursor* cursor,
                                   const GLFWimage* image,
                                   int xhot, int yhot)
 {
-    cursor->wl.buffer = createShmBuffer(image);
+    cursor->wl.buffer =
+        (struct wl_buffer*) _glfwAcquireCachedImage(&_glfw.wl.cursorCache, image, 0);
     if (!cursor->wl.buffer)
-        return GLFW_FALSE;
+    {
+        cursor->wl.buffer = createShmBuffer(image);
+        if (!cursor->wl.buffer)
+            return GLFW_FALSE;
+
+        _glfwInsertCachedImage(&_glfw.wl.cursorCache, image, 0,
+                               (uintptr_t) cursor->wl.buffer);
+    }
 
     cursor->wl.width = image->width;
     cursor->wl.height = image->height;
@@ -2860,7 +3173,10 @@ void _glfwDestroyCursorWayland(_GLFWcursor* cursor)
     if (cursor->wl.cursor)
         return;
 
-    if (cursor->wl.buffer)
+    if (!cursor->wl.buffer)
+        return;
+
+    if (!_glfwReleaseCachedImage(&_glfw.wl.cursorCache, (uintptr_t) cursor->wl.buffer))
         wl_buffer_destroy(cursor->wl.buffer);
 }
 
@@ -3185,10 +3501,49 @@ const char* _glfwGetClipboardStringWayland(void)
 
     _glfw_free(_glfw.wl.clipboardString);
     _glfw.wl.clipboardString =
-        readDataOfferAsString(_glfw.wl.selectionOffer, "text/plain;charset=utf-8");
+        readDataOfferAsString(_glfw.wl.selectionOffer, "text/plain;charset=utf-8", GLFW_TRUE);
     return _glfw.wl.clipboardString;
 }
 
+void _glfwRequestClipboardStringWayland(void)
+{
+    if (!_glfw.wl.selectionOffer)
+    {
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "Wayland: No clipboard data available");
+        _glfwInputClipboardString(NULL);
+        return;
+    }
+
+    if (_glfw.wl.selectionSource)
+    {
+        _glfwInputClipboardString(_glfw.wl.clipboardString);
+        return;
+    }
+
+    // A transfer in progress will answer this request as well
+    if (_glfw.wl.transfer.fd != -1)
+        return;
+
+    int fds[2];
+
+    if (pipe2(fds, O_CLOEXEC | O_NONBLOCK) == -1)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Wayland: Failed to create pipe for data offer: %s",
+                        strerror(errno));
+        _glfwInputClipboardString(NULL);
+        return;
+    }
+
+    wl_data_offer_receive(_glfw.wl.selectionOffer, "text/plain;charset=utf-8", fds[1]);
+    flushDisplay();
+    close(fds[1]);
+
+    _glfw.wl.transfer.fd = fds[0];
+    _glfwWatchPollFDPOSIX(fds[0], _GLFW_POLL_CLIPBOARD);
+}
+
 EGLenum _glfwGetEGLPlatformWayland(EGLint** attribs)
 {
     if (_glfw.egl.EXT_platform_base && _glfw.egl.EXT_platform_wayland)
@@ -492,14 +492,53 @@ static void inputMethodInstantiateCallback(Display* display,
     }
 }
 
+// An atom to intern and where to store its ID
+//
+typedef struct AtomRequest
+{
+    const char* name;
+    Atom*       atom;
+} AtomRequest;
+
+// Intern the specified atoms with a single round-trip
+//
+static void internAtoms(const AtomRequest* requests, int count)
+{
+    char** names = _glfw_calloc(count, sizeof(char*));
+    Atom* atoms = _glfw_calloc(count, sizeof(Atom));
+
+    if (!names || !atoms)
+    {
+        // Slower, but the atoms are still needed
+        for (int i = 0;  i < count;  i++)
+        {
+            *requests[i].atom =
+                XInternAtom(_glfw.x11.display, requests[i].name, False);
+        }
+
+        _glfw_free(names);
+        _glfw_free(atoms);
+        return;
+    }
+
+    for (int i = 0;  i < count;  i++)
+        names[i] = (char*) requests[i].name;
+
+    XInternAtoms(_glfw.x11.display, names, count, False, atoms);
+
+    for (int i = 0;  i < count;  i++)
+        *requests[i].atom = atoms[i];
+
+    _glfw_free(names);
+    _glfw_free(atoms);
+}
+
 // Return the atom ID only if it is listed in the specified array
 //
 static Atom getAtomIfSupported(Atom* supportedAtoms,
                                unsigned long atomCount,
-                               const char* atomName)
+                               Atom atom)
 {
-    const Atom atom = XInternAtom(_glfw.x11.display, atomName, False);
-
     for (unsigned long i = 0;  i < atomCount;  i++)
     {
         if (supportedAtoms[i] == atom)
@@ -567,239 +606,42 @@ static void detectEWMH(void)
 
     // See which of the atoms we support that are supported by the WM
 
-    _glfw.x11.NET_WM_STATE =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE");
-    _glfw.x11.NET_WM_STATE_ABOVE =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_ABOVE");
-    _glfw.x11.NET_WM_STATE_FULLSCREEN =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_FULLSCREEN");
-    _glfw.x11.NET_WM_STATE_MAXIMIZED_VERT =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_MAXIMIZED_VERT");
-    _glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_MAXIMIZED_HORZ");
-    _glfw.x11.NET_WM_STATE_DEMANDS_ATTENTION =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_DEMANDS_ATTENTION");
-    _glfw.x11.NET_WM_FULLSCREEN_MONITORS =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_FULLSCREEN_MONITORS");
-    _glfw.x11.NET_WM_WINDOW_TYPE =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_WINDOW_TYPE");
-    _glfw.x11.NET_WM_WINDOW_TYPE_NORMAL =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_WINDOW_TYPE_NORMAL");
-    _glfw.x11.NET_WORKAREA =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WORKAREA");
-    _glfw.x11.NET_CURRENT_DESKTOP =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_CURRENT_DESKTOP");
-    _glfw.x11.NET_ACTIVE_WINDOW =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_ACTIVE_WINDOW");
-    _glfw.x11.NET_FRAME_EXTENTS =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_FRAME_EXTENTS");
-    _glfw.x11.NET_REQUEST_FRAME_EXTENTS =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_REQUEST_FRAME_EXTENTS");
+    const AtomRequest requests[] =
+    {
+        { "_NET_WM_STATE", &_glfw.x11.NET_WM_STATE },
+        { "_NET_WM_STATE_ABOVE", &_glfw.x11.NET_WM_STATE_ABOVE },
+        { "_NET_WM_STATE_FULLSCREEN", &_glfw.x11.NET_WM_STATE_FULLSCREEN },
+        { "_NET_WM_STATE_MAXIMIZED_VERT", &_glfw.x11.NET_WM_STATE_MAXIMIZED_VERT },
+        { "_NET_WM_STATE_MAXIMIZED_HORZ", &_glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ },
+        { "_NET_WM_STATE_DEMANDS_ATTENTION", &_glfw.x11.NET_WM_STATE_DEMANDS_ATTENTION },
+        { "_NET_WM_FULLSCREEN_MONITORS", &_glfw.x11.NET_WM_FULLSCREEN_MONITORS },
+        { "_NET_WM_WINDOW_TYPE", &_glfw.x11.NET_WM_WINDOW_TYPE },
+        { "_NET_WM_WINDOW_TYPE_NORMAL", &_glfw.x11.NET_WM_WINDOW_TYPE_NORMAL },
+        { "_NET_WORKAREA", &_glfw.x11.NET_WORKAREA },
+        { "_NET_CURRENT_DESKTOP", &_glfw.x11.NET_CURRENT_DESKTOP },
+        { "_NET_ACTIVE_WINDOW", &_glfw.x11.NET_ACTIVE_WINDOW },
+        { "_NET_FRAME_EXTENTS", &_glfw.x11.NET_FRAME_EXTENTS },
+        { "_NET_REQUEST_FRAME_EXTENTS", &_glfw.x11.NET_REQUEST_FRAME_EXTENTS }
+    };
+
+    const int count = sizeof(requests) / sizeof(requests[0]);
+    internAtoms(requests, count);
+
+    for (int i = 0;  i < count;  i++)
+    {
+        *requests[i].atom =
+            getAtomIfSupported(supportedAtoms, atomCount, *requests[i].atom);
+    }
 
     if (supportedAtoms)
         XFree(supportedAtoms);
 }
 
-// Look for and initialize supported X11 extensions
+// Initialize the X11 extensions needed at all times and intern atoms
+// The optional extension libraries are loaded when first used
 //
 static GLFWbool initExtensions(void)
 {
-#if defined(__OpenBSD__) || defined(__NetBSD__)
-    _glfw.x11.vidmode.handle = _glfwPlatformLoadModule("libXxf86vm.so");
-#else
-    _glfw.x11.vidmode.handle = _glfwPlatformLoadModule("libXxf86vm.so.1");
-#endif
-    if (_glfw.x11.vidmode.handle)
-    {
-        _glfw.x11.vidmode.QueryExtension = (PFN_XF86VidModeQueryExtension)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.vidmode.handle, "XF86VidModeQueryExtension");
-        _glfw.x11.vidmode.GetGammaRamp = (PFN_XF86VidModeGetGammaRamp)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.vidmode.handle, "XF86VidModeGetGammaRamp");
-        _glfw.x11.vidmode.SetGammaRamp = (PFN_XF86VidModeSetGammaRamp)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.vidmode.handle, "XF86VidModeSetGammaRamp");
-        _glfw.x11.vidmode.GetGammaRampSize = (PFN_XF86VidModeGetGammaRampSize)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.vidmode.handle, "XF86VidModeGetGammaRampSize");
-
-        _glfw.x11.vidmode.available =
-            XF86VidModeQueryExtension(_glfw.x11.display,
-                                      &_glfw.x11.vidmode.eventBase,
-                                      &_glfw.x11.vidmode.errorBase);
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.xi.handle = _glfwPlatformLoadModule("libXi-6.so");
-#elif defined(__OpenBSD__) || defined(__NetBSD__)
-    _glfw.x11.xi.handle = _glfwPlatformLoadModule("libXi.so");
-#else
-    _glfw.x11.xi.handle = _glfwPlatformLoadModule("libXi.so.6");
-#endif
-    if (_glfw.x11.xi.handle)
-    {
-        _glfw.x11.xi.QueryVersion = (PFN_XIQueryVersion)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xi.handle, "XIQueryVersion");
-        _glfw.x11.xi.SelectEvents = (PFN_XISelectEvents)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xi.handle, "XISelectEvents");
-
-        if (XQueryExtension(_glfw.x11.display,
-                            "XInputExtension",
-                            &_glfw.x11.xi.majorOpcode,
-                            &_glfw.x11.xi.eventBase,
-                            &_glfw.x11.xi.errorBase))
-        {
-            _glfw.x11.xi.major = 2;
-            _glfw.x11.xi.minor = 0;
-
-            if (XIQueryVersion(_glfw.x11.display,
-                               &_glfw.x11.xi.major,
-                               &_glfw.x11.xi.minor) == Success)
-            {
-                _glfw.x11.xi.available = GLFW_TRUE;
-            }
-        }
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.randr.handle = _glfwPlatformLoadModule("libXrandr-2.so");
-#elif defined(__OpenBSD__) || defined(__NetBSD__)
-    _glfw.x11.randr.handle = _glfwPlatformLoadModule("libXrandr.so");
-#else
-    _glfw.x11.randr.handle = _glfwPlatformLoadModule("libXrandr.so.2");
-#endif
-    if (_glfw.x11.randr.handle)
-    {
-        _glfw.x11.randr.AllocGamma = (PFN_XRRAllocGamma)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRAllocGamma");
-        _glfw.x11.randr.FreeGamma = (PFN_XRRFreeGamma)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeGamma");
-        _glfw.x11.randr.FreeCrtcInfo = (PFN_XRRFreeCrtcInfo)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeCrtcInfo");
-        _glfw.x11.randr.FreeGamma = (PFN_XRRFreeGamma)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeGamma");
-        _glfw.x11.randr.FreeOutputInfo = (PFN_XRRFreeOutputInfo)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeOutputInfo");
-        _glfw.x11.randr.FreeScreenResources = (PFN_XRRFreeScreenResources)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeScreenResources");
-        _glfw.x11.randr.GetCrtcGamma = (PFN_XRRGetCrtcGamma)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetCrtcGamma");
-        _glfw.x11.randr.GetCrtcGammaSize = (PFN_XRRGetCrtcGammaSize)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetCrtcGammaSize");
-        _glfw.x11.randr.GetCrtcInfo = (PFN_XRRGetCrtcInfo)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetCrtcInfo");
-        _glfw.x11.randr.GetOutputInfo = (PFN_XRRGetOutputInfo)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetOutputInfo");
-        _glfw.x11.randr.GetOutputPrimary = (PFN_XRRGetOutputPrimary)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetOutputPrimary");
-        _glfw.x11.randr.GetScreenResourcesCurrent = (PFN_XRRGetScreenResourcesCurrent)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetScreenResourcesCurrent");
-        _glfw.x11.randr.QueryExtension = (PFN_XRRQueryExtension)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRQueryExtension");
-        _glfw.x11.randr.QueryVersion = (PFN_XRRQueryVersion)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRQueryVersion");
-        _glfw.x11.randr.SelectInput = (PFN_XRRSelectInput)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRSelectInput");
-        _glfw.x11.randr.SetCrtcConfig = (PFN_XRRSetCrtcConfig)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRSetCrtcConfig");
-        _glfw.x11.randr.SetCrtcGamma = (PFN_XRRSetCrtcGamma)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRSetCrtcGamma");
-        _glfw.x11.randr.UpdateConfiguration = (PFN_XRRUpdateConfiguration)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRUpdateConfiguration");
-
-        if (XRRQueryExtension(_glfw.x11.display,
-                              &_glfw.x11.randr.eventBase,
-                              &_glfw.x11.randr.errorBase))
-        {
-            if (XRRQueryVersion(_glfw.x11.display,
-                                &_glfw.x11.randr.major,
-                                &_glfw.x11.randr.minor))
-            {
-                // The GLFW RandR path requires at least version 1.3
-                if (_glfw.x11.randr.major > 1 || _glfw.x11.randr.minor >= 3)
-                    _glfw.x11.randr.available = GLFW_TRUE;
-            }
-            else
-            {
-                _glfwInputError(GLFW_PLATFORM_ERROR,
-                                "X11: Failed to query RandR version");
-            }
-        }
-    }
-
-    if (_glfw.x11.randr.available)
-    {
-        XRRScreenResources* sr = XRRGetScreenResourcesCurrent(_glfw.x11.display,
-                                                              _glfw.x11.root);
-
-        if (!sr->ncrtc || !XRRGetCrtcGammaSize(_glfw.x11.display, sr->crtcs[0]))
-        {
-            // This is likely an older Nvidia driver with broken gamma support
-            // Flag it as useless and fall back to xf86vm gamma, if available
-            _glfw.x11.randr.gammaBroken = GLFW_TRUE;
-        }
-
-        if (!sr->ncrtc)
-        {
-            // A system without CRTCs is likely a system with broken RandR
-            // Disable the RandR monitor path and fall back to core functions
-            _glfw.x11.randr.monitorBroken = GLFW_TRUE;
-        }
-
-        XRRFreeScreenResources(sr);
-    }
-
-    if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
-    {
-        XRRSelectInput(_glfw.x11.display, _glfw.x11.root,
-                       RROutputChangeNotifyMask);
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.xcursor.handle = _glfwPlatformLoadModule("libXcursor-1.so");
-#elif defined(__OpenBSD__) || defined(__NetBSD__)
-    _glfw.x11.xcursor.handle = _glfwPlatformLoadModule("libXcursor.so");
-#else
-    _glfw.x11.xcursor.handle = _glfwPlatformLoadModule("libXcursor.so.1");
-#endif
-    if (_glfw.x11.xcursor.handle)
-    {
-        _glfw.x11.xcursor.ImageCreate = (PFN_XcursorImageCreate)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorImageCreate");
-        _glfw.x11.xcursor.ImageDestroy = (PFN_XcursorImageDestroy)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorImageDestroy");
-        _glfw.x11.xcursor.ImageLoadCursor = (PFN_XcursorImageLoadCursor)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorImageLoadCursor");
-        _glfw.x11.xcursor.GetTheme = (PFN_XcursorGetTheme)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorGetTheme");
-        _glfw.x11.xcursor.GetDefaultSize = (PFN_XcursorGetDefaultSize)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorGetDefaultSize");
-        _glfw.x11.xcursor.LibraryLoadImage = (PFN_XcursorLibraryLoadImage)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorLibraryLoadImage");
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.xinerama.handle = _glfwPlatformLoadModule("libXinerama-1.so");
-#elif defined(__OpenBSD__) || defined(__NetBSD__)
-    _glfw.x11.xinerama.handle = _glfwPlatformLoadModule("libXinerama.so");
-#else
-    _glfw.x11.xinerama.handle = _glfwPlatformLoadModule("libXinerama.so.1");
-#endif
-    if (_glfw.x11.xinerama.handle)
-    {
-        _glfw.x11.xinerama.IsActive = (PFN_XineramaIsActive)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xinerama.handle, "XineramaIsActive");
-        _glfw.x11.xinerama.QueryExtension = (PFN_XineramaQueryExtension)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xinerama.handle, "XineramaQueryExtension");
-        _glfw.x11.xinerama.QueryScreens = (PFN_XineramaQueryScreens)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xinerama.handle, "XineramaQueryScreens");
-
-        if (XineramaQueryExtension(_glfw.x11.display,
-                                   &_glfw.x11.xinerama.major,
-                                   &_glfw.x11.xinerama.minor))
-        {
-            if (XineramaIsActive(_glfw.x11.display))
-                _glfw.x11.xinerama.available = GLFW_TRUE;
-        }
-    }
-
     _glfw.x11.xkb.major = 1;
     _glfw.x11.xkb.minor = 0;
     _glfw.x11.xkb.available =
@@ -828,158 +670,69 @@ static GLFWbool initExtensions(void)
                               XkbGroupStateMask, XkbGroupStateMask);
     }
 
-    if (_glfw.hints.init.x11.xcbVulkanSurface)
-    {
-#if defined(__CYGWIN__)
-        _glfw.x11.x11xcb.handle = _glfwPlatformLoadModule("libX11-xcb-1.so");
-#elif defined(__OpenBSD__) || defined(__NetBSD__)
-        _glfw.x11.x11xcb.handle = _glfwPlatformLoadModule("libX11-xcb.so");
-#else
-        _glfw.x11.x11xcb.handle = _glfwPlatformLoadModule("libX11-xcb.so.1");
-#endif
-    }
-
-    if (_glfw.x11.x11xcb.handle)
-    {
-        _glfw.x11.x11xcb.GetXCBConnection = (PFN_XGetXCBConnection)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.x11xcb.handle, "XGetXCBConnection");
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.xrender.handle = _glfwPlatformLoadModule("libXrender-1.so");
-#elif defined(__OpenBSD__) || defined(__NetBSD__)
-    _glfw.x11.xrender.handle = _glfwPlatformLoadModule("libXrender.so");
-#else
-    _glfw.x11.xrender.handle = _glfwPlatformLoadModule("libXrender.so.1");
-#endif
-    if (_glfw.x11.xrender.handle)
-    {
-        _glfw.x11.xrender.QueryExtension = (PFN_XRenderQueryExtension)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xrender.handle, "XRenderQueryExtension");
-        _glfw.x11.xrender.QueryVersion = (PFN_XRenderQueryVersion)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xrender.handle, "XRenderQueryVersion");
-        _glfw.x11.xrender.FindVisualFormat = (PFN_XRenderFindVisualFormat)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xrender.handle, "XRenderFindVisualFormat");
-
-        if (XRenderQueryExtension(_glfw.x11.display,
-                                  &_glfw.x11.xrender.errorBase,
-                                  &_glfw.x11.xrender.eventBase))
-        {
-            if (XRenderQueryVersion(_glfw.x11.display,
-                                    &_glfw.x11.xrender.major,
-                                    &_glfw.x11.xrender.minor))
-            {
-                _glfw.x11.xrender.available = GLFW_TRUE;
-            }
-        }
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.xshape.handle = _glfwPlatformLoadModule("libXext-6.so");
-#elif defined(__OpenBSD__) || defined(__NetBSD__)
-    _glfw.x11.xshape.handle = _glfwPlatformLoadModule("libXext.so");
-#else
-    _glfw.x11.xshape.handle = _glfwPlatformLoadModule("libXext.so.6");
-#endif
-    if (_glfw.x11.xshape.handle)
-    {
-        _glfw.x11.xshape.QueryExtension = (PFN_XShapeQueryExtension)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xshape.handle, "XShapeQueryExtension");
-        _glfw.x11.xshape.ShapeCombineRegion = (PFN_XShapeCombineRegion)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xshape.handle, "XShapeCombineRegion");
-        _glfw.x11.xshape.QueryVersion = (PFN_XShapeQueryVersion)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xshape.handle, "XShapeQueryVersion");
-        _glfw.x11.xshape.ShapeCombineMask = (PFN_XShapeCombineMask)
-            _glfwPlatformGetModuleSymbol(_glfw.x11.xshape.handle, "XShapeCombineMask");
-
-        if (XShapeQueryExtension(_glfw.x11.display,
-            &_glfw.x11.xshape.errorBase,
-            &_glfw.x11.xshape.eventBase))
-        {
-            if (XShapeQueryVersion(_glfw.x11.display,
-                &_glfw.x11.xshape.major,
-                &_glfw.x11.xshape.minor))
-            {
-                _glfw.x11.xshape.available = GLFW_TRUE;
-            }
-        }
-    }
-
     // Update the key code LUT
     // FIXME: We should listen to XkbMapNotify events to track changes to
     // the keyboard mapping.
     createKeyTables();
 
-    // String format atoms
-    _glfw.x11.NULL_ = XInternAtom(_glfw.x11.display, "NULL", False);
-    _glfw.x11.UTF8_STRING = XInternAtom(_glfw.x11.display, "UTF8_STRING", False);
-    _glfw.x11.ATOM_PAIR = XInternAtom(_glfw.x11.display, "ATOM_PAIR", False);
-
-    // Custom selection property atom
-    _glfw.x11.GLFW_SELECTION =
-        XInternAtom(_glfw.x11.display, "GLFW_SELECTION", False);
-
-    // ICCCM standard clipboard atoms
-    _glfw.x11.TARGETS = XInternAtom(_glfw.x11.display, "TARGETS", False);
-    _glfw.x11.MULTIPLE = XInternAtom(_glfw.x11.display, "MULTIPLE", False);
-    _glfw.x11.PRIMARY = XInternAtom(_glfw.x11.display, "PRIMARY", False);
-    _glfw.x11.INCR = XInternAtom(_glfw.x11.display, "INCR", False);
-    _glfw.x11.CLIPBOARD = XInternAtom(_glfw.x11.display, "CLIPBOARD", False);
-
-    // Clipboard manager atoms
-    _glfw.x11.CLIPBOARD_MANAGER =
-        XInternAtom(_glfw.x11.display, "CLIPBOARD_MANAGER", False);
-    _glfw.x11.SAVE_TARGETS =
-        XInternAtom(_glfw.x11.display, "SAVE_TARGETS", False);
-
-    // Xdnd (drag and drop) atoms
-    _glfw.x11.XdndAware = XInternAtom(_glfw.x11.display, "XdndAware", False);
-    _glfw.x11.XdndEnter = XInternAtom(_glfw.x11.display, "XdndEnter", False);
-    _glfw.x11.XdndPosition = XInternAtom(_glfw.x11.display, "XdndPosition", False);
-    _glfw.x11.XdndStatus = XInternAtom(_glfw.x11.display, "XdndStatus", False);
-    _glfw.x11.XdndActionCopy = XInternAtom(_glfw.x11.display, "XdndActionCopy", False);
-    _glfw.x11.XdndDrop = XInternAtom(_glfw.x11.display, "XdndDrop", False);
-    _glfw.x11.XdndFinished = XInternAtom(_glfw.x11.display, "XdndFinished", False);
-    _glfw.x11.XdndSelection = XInternAtom(_glfw.x11.display, "XdndSelection", False);
-    _glfw.x11.XdndTypeList = XInternAtom(_glfw.x11.display, "XdndTypeList", False);
-    _glfw.x11.text_uri_list = XInternAtom(_glfw.x11.display, "text/uri-list", False);
-
-    // ICCCM, EWMH and Motif window property atoms
-    // These can be set safely even without WM support
-    // The EWMH atoms that require WM support are handled in detectEWMH
-    _glfw.x11.WM_PROTOCOLS =
-        XInternAtom(_glfw.x11.display, "WM_PROTOCOLS", False);
-    _glfw.x11.WM_STATE =
-        XInternAtom(_glfw.x11.display, "WM_STATE", False);
-    _glfw.x11.WM_DELETE_WINDOW =
-        XInternAtom(_glfw.x11.display, "WM_DELETE_WINDOW", False);
-    _glfw.x11.NET_SUPPORTED =
-        XInternAtom(_glfw.x11.display, "_NET_SUPPORTED", False);
-    _glfw.x11.NET_SUPPORTING_WM_CHECK =
-        XInternAtom(_glfw.x11.display, "_NET_SUPPORTING_WM_CHECK", False);
-    _glfw.x11.NET_WM_ICON =
-        XInternAtom(_glfw.x11.display, "_NET_WM_ICON", False);
-    _glfw.x11.NET_WM_PING =
-        XInternAtom(_glfw.x11.display, "_NET_WM_PING", False);
-    _glfw.x11.NET_WM_PID =
-        XInternAtom(_glfw.x11.display, "_NET_WM_PID", False);
-    _glfw.x11.NET_WM_NAME =
-        XInternAtom(_glfw.x11.display, "_NET_WM_NAME", False);
-    _glfw.x11.NET_WM_ICON_NAME =
-        XInternAtom(_glfw.x11.display, "_NET_WM_ICON_NAME", False);
-    _glfw.x11.NET_WM_BYPASS_COMPOSITOR =
-        XInternAtom(_glfw.x11.display, "_NET_WM_BYPASS_COMPOSITOR", False);
-    _glfw.x11.NET_WM_WINDOW_OPACITY =
-        XInternAtom(_glfw.x11.display, "_NET_WM_WINDOW_OPACITY", False);
-    _glfw.x11.MOTIF_WM_HINTS =
-        XInternAtom(_glfw.x11.display, "_MOTIF_WM_HINTS", False);
-
     // The compositing manager selection name contains the screen number
+    char cmName[32];
+    snprintf(cmName, sizeof(cmName), "_NET_WM_CM_S%u", _glfw.x11.screen);
+
+    // All atoms are interned with a single round-trip
+    const AtomRequest requests[] =
     {
-        char name[32];
-        snprintf(name, sizeof(name), "_NET_WM_CM_S%u", _glfw.x11.screen);
-        _glfw.x11.NET_WM_CM_Sx = XInternAtom(_glfw.x11.display, name, False);
-    }
+        // String format atoms
+        { "NULL", &_glfw.x11.NULL_ },
+        { "UTF8_STRING", &_glfw.x11.UTF8_STRING },
+        { "ATOM_PAIR", &_glfw.x11.ATOM_PAIR },
+
+        // Custom selection property atom
+        { "GLFW_SELECTION", &_glfw.x11.GLFW_SELECTION },
+
+        // ICCCM standard clipboard atoms
+        { "TARGETS", &_glfw.x11.TARGETS },
+        { "MULTIPLE", &_glfw.x11.MULTIPLE },
+        { "PRIMARY", &_glfw.x11.PRIMARY },
+        { "INCR", &_glfw.x11.INCR },
+        { "CLIPBOARD", &_glfw.x11.CLIPBOARD },
+
+        // Clipboard manager atoms
+        { "CLIPBOARD_MANAGER", &_glfw.x11.CLIPBOARD_MANAGER },
+        { "SAVE_TARGETS", &_glfw.x11.SAVE_TARGETS },
+
+        // Xdnd (drag and drop) atoms
+        { "XdndAware", &_glfw.x11.XdndAware },
+        { "XdndEnter", &_glfw.x11.XdndEnter },
+        { "XdndPosition", &_glfw.x11.XdndPosition },
+        { "XdndStatus", &_glfw.x11.XdndStatus },
+        { "XdndActionCopy", &_glfw.x11.XdndActionCopy },
+        { "XdndDrop", &_glfw.x11.XdndDrop },
+        { "XdndFinished", &_glfw.x11.XdndFinished },
+        { "XdndSelection", &_glfw.x11.XdndSelection },
+        { "XdndTypeList", &_glfw.x11.XdndTypeList },
+        { "text/uri-list", &_glfw.x11.text_uri_list },
+
+        // ICCCM, EWMH and Motif window property atoms
+        // These can be set safely even without WM support
+        // The EWMH atoms that require WM support are handled in detectEWMH
+        { "WM_PROTOCOLS", &_glfw.x11.WM_PROTOCOLS },
+        { "WM_STATE", &_glfw.x11.WM_STATE },
+        { "WM_DELETE_WINDOW", &_glfw.x11.WM_DELETE_WINDOW },
+        { "_NET_SUPPORTED", &_glfw.x11.NET_SUPPORTED },
+        { "_NET_SUPPORTING_WM_CHECK", &_glfw.x11.NET_SUPPORTING_WM_CHECK },
+        { "_NET_WM_ICON", &_glfw.x11.NET_WM_ICON },
+        { "_NET_WM_PING", &_glfw.x11.NET_WM_PING },
+        { "_NET_WM_PID", &_glfw.x11.NET_WM_PID },
+        { "_NET_WM_NAME", &_glfw.x11.NET_WM_NAME },
+        { "_NET_WM_ICON_NAME", &_glfw.x11.NET_WM_ICON_NAME },
+        { "_NET_WM_BYPASS_COMPOSITOR", &_glfw.x11.NET_WM_BYPASS_COMPOSITOR },
+        { "_NET_WM_WINDOW_OPACITY", &_glfw.x11.NET_WM_WINDOW_OPACITY },
+        { "_MOTIF_WM_HINTS", &_glfw.x11.MOTIF_WM_HINTS },
+        { cmName, &_glfw.x11.NET_WM_CM_Sx }
+    };
+
+    internAtoms(requests, sizeof(requests) / sizeof(requests[0]));
 
     // Detect whether an EWMH-conformant window manager is running
     detectEWMH();
@@ -1022,13 +775,11 @@ static void getSystemContentScale(float* xscale, float* yscale)
     *yscale = ydpi / 96.f;
 }
 
-// Create a blank cursor for hidden and disabled cursor modes
+// Frees a custom cursor evicted from the cursor cache
 //
-static Cursor createHiddenCursor(void)
+static void destroyCachedCursor(uintptr_t handle)
 {
-    unsigned char pixels[16 * 16 * 4] = { 0 };
-    GLFWimage image = { 16, 16, pixels };
-    return _glfwCreateNativeCursorX11(&image, 0, 0);
+    XFreeCursor(_glfw.x11.display, (Cursor) handle);
 }
 
 // Create a helper window for IPC
@@ -1045,37 +796,6 @@ static Window createHelperWindow(void)
                          CWEventMask, &wa);
 }
 
-// Create the pipe for empty events without assumuing the OS has pipe2(2)
-//
-static GLFWbool createEmptyEventPipe(void)
-{
-    if (pipe(_glfw.x11.emptyEventPipe) != 0)
-    {
-        _glfwInputError(GLFW_PLATFORM_ERROR,
-                        "X11: Failed to create empty event pipe: %s",
-                        strerror(errno));
-        return GLFW_FALSE;
-    }
-
-    for (int i = 0; i < 2; i++)
-    {
-        const int sf = fcntl(_glfw.x11.emptyEventPipe[i], F_GETFL, 0);
-        const int df = fcntl(_glfw.x11.emptyEventPipe[i], F_GETFD, 0);
-
-        if (sf == -1 || df == -1 ||
-            fcntl(_glfw.x11.emptyEventPipe[i], F_SETFL, sf | O_NONBLOCK) == -1 ||
-            fcntl(_glfw.x11.emptyEventPipe[i], F_SETFD, df | FD_CLOEXEC) == -1)
-        {
-            _glfwInputError(GLFW_PLATFORM_ERROR,
-                            "X11: Failed to set flags for empty event pipe: %s",
-                            strerror(errno));
-            return GLFW_FALSE;
-        }
-    }
-
-    return GLFW_TRUE;
-}
-
 // X error handler
 //
 static int errorHandler(Display *display, XErrorEvent* event)
@@ -1122,13 +842,403 @@ void _glfwInputErrorX11(int error, const char* message)
     _glfwInputError(error, "%s: %s", message, buffer);
 }
 
+// Loads the XFree86-VidModeExtension library on first use and returns whether
+// the extension is available
+//
+GLFWbool _glfwLoadVidmodeX11(void)
+{
+    if (_glfw.x11.vidmode.loaded)
+        return _glfw.x11.vidmode.available;
+
+    _glfw.x11.vidmode.loaded = GLFW_TRUE;
+
+#if defined(__OpenBSD__) || defined(__NetBSD__)
+    _glfw.x11.vidmode.handle = _glfwPlatformLoadModule("libXxf86vm.so");
+#else
+    _glfw.x11.vidmode.handle = _glfwPlatformLoadModule("libXxf86vm.so.1");
+#endif
+    if (!_glfw.x11.vidmode.handle)
+        return GLFW_FALSE;
+
+    _glfw.x11.vidmode.QueryExtension = (PFN_XF86VidModeQueryExtension)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.vidmode.handle, "XF86VidModeQueryExtension");
+    _glfw.x11.vidmode.GetGammaRamp = (PFN_XF86VidModeGetGammaRamp)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.vidmode.handle, "XF86VidModeGetGammaRamp");
+    _glfw.x11.vidmode.SetGammaRamp = (PFN_XF86VidModeSetGammaRamp)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.vidmode.handle, "XF86VidModeSetGammaRamp");
+    _glfw.x11.vidmode.GetGammaRampSize = (PFN_XF86VidModeGetGammaRampSize)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.vidmode.handle, "XF86VidModeGetGammaRampSize");
+
+    _glfw.x11.vidmode.available =
+        XF86VidModeQueryExtension(_glfw.x11.display,
+                                  &_glfw.x11.vidmode.eventBase,
+                                  &_glfw.x11.vidmode.errorBase);
+
+    return _glfw.x11.vidmode.available;
+}
+
+// Loads the XInput library on first use and returns whether XInput 2.0 is
+// available
+//
+GLFWbool _glfwLoadXiX11(void)
+{
+    if (_glfw.x11.xi.loaded)
+        return _glfw.x11.xi.available;
+
+    _glfw.x11.xi.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xi.handle = _glfwPlatformLoadModule("libXi-6.so");
+#elif defined(__OpenBSD__) || defined(__NetBSD__)
+    _glfw.x11.xi.handle = _glfwPlatformLoadModule("libXi.so");
+#else
+    _glfw.x11.xi.handle = _glfwPlatformLoadModule("libXi.so.6");
+#endif
+    if (!_glfw.x11.xi.handle)
+        return GLFW_FALSE;
+
+    _glfw.x11.xi.QueryVersion = (PFN_XIQueryVersion)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xi.handle, "XIQueryVersion");
+    _glfw.x11.xi.SelectEvents = (PFN_XISelectEvents)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xi.handle, "XISelectEvents");
+
+    if (XQueryExtension(_glfw.x11.display,
+                        "XInputExtension",
+                        &_glfw.x11.xi.majorOpcode,
+                        &_glfw.x11.xi.eventBase,
+                        &_glfw.x11.xi.errorBase))
+    {
+        _glfw.x11.xi.major = 2;
+        _glfw.x11.xi.minor = 0;
+
+        if (XIQueryVersion(_glfw.x11.display,
+                           &_glfw.x11.xi.major,
+                           &_glfw.x11.xi.minor) == Success)
+        {
+            _glfw.x11.xi.available = GLFW_TRUE;
+        }
+    }
+
+    return _glfw.x11.xi.available;
+}
+
+// Loads the RandR library on first use, starts listening for output changes
+// and returns whether RandR 1.3 is available
+//
+GLFWbool _glfwLoadRandRX11(void)
+{
+    if (_glfw.x11.randr.loaded)
+        return _glfw.x11.randr.available;
+
+    _glfw.x11.randr.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.randr.handle = _glfwPlatformLoadModule("libXrandr-2.so");
+#elif defined(__OpenBSD__) || defined(__NetBSD__)
+    _glfw.x11.randr.handle = _glfwPlatformLoadModule("libXrandr.so");
+#else
+    _glfw.x11.randr.handle = _glfwPlatformLoadModule("libXrandr.so.2");
+#endif
+    if (!_glfw.x11.randr.handle)
+        return GLFW_FALSE;
+
+    _glfw.x11.randr.AllocGamma = (PFN_XRRAllocGamma)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRAllocGamma");
+    _glfw.x11.randr.FreeGamma = (PFN_XRRFreeGamma)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeGamma");
+    _glfw.x11.randr.FreeCrtcInfo = (PFN_XRRFreeCrtcInfo)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeCrtcInfo");
+    _glfw.x11.randr.FreeGamma = (PFN_XRRFreeGamma)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeGamma");
+    _glfw.x11.randr.FreeOutputInfo = (PFN_XRRFreeOutputInfo)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeOutputInfo");
+    _glfw.x11.randr.FreeScreenResources = (PFN_XRRFreeScreenResources)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRFreeScreenResources");
+    _glfw.x11.randr.GetCrtcGamma = (PFN_XRRGetCrtcGamma)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetCrtcGamma");
+    _glfw.x11.randr.GetCrtcGammaSize = (PFN_XRRGetCrtcGammaSize)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetCrtcGammaSize");
+    _glfw.x11.randr.GetCrtcInfo = (PFN_XRRGetCrtcInfo)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetCrtcInfo");
+    _glfw.x11.randr.GetOutputInfo = (PFN_XRRGetOutputInfo)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetOutputInfo");
+    _glfw.x11.randr.GetOutputPrimary = (PFN_XRRGetOutputPrimary)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetOutputPrimary");
+    _glfw.x11.randr.GetScreenResourcesCurrent = (PFN_XRRGetScreenResourcesCurrent)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRGetScreenResourcesCurrent");
+    _glfw.x11.randr.QueryExtension = (PFN_XRRQueryExtension)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRQueryExtension");
+    _glfw.x11.randr.QueryVersion = (PFN_XRRQueryVersion)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRQueryVersion");
+    _glfw.x11.randr.SelectInput = (PFN_XRRSelectInput)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRSelectInput");
+    _glfw.x11.randr.SetCrtcConfig = (PFN_XRRSetCrtcConfig)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRSetCrtcConfig");
+    _glfw.x11.randr.SetCrtcGamma = (PFN_XRRSetCrtcGamma)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRSetCrtcGamma");
+    _glfw.x11.randr.UpdateConfiguration = (PFN_XRRUpdateConfiguration)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.randr.handle, "XRRUpdateConfiguration");
+
+    if (XRRQueryExtension(_glfw.x11.display,
+                          &_glfw.x11.randr.eventBase,
+                          &_glfw.x11.randr.errorBase))
+    {
+        if (XRRQueryVersion(_glfw.x11.display,
+                            &_glfw.x11.randr.major,
+                            &_glfw.x11.randr.minor))
+        {
+            // The GLFW RandR path requires at least version 1.3
+            if (_glfw.x11.randr.major > 1 || _glfw.x11.randr.minor >= 3)
+                _glfw.x11.randr.available = GLFW_TRUE;
+        }
+        else
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to query RandR version");
+        }
+    }
+
+    if (!_glfw.x11.randr.available)
+        return GLFW_FALSE;
+
+    XRRScreenResources* sr = XRRGetScreenResourcesCurrent(_glfw.x11.display,
+                                                          _glfw.x11.root);
+
+    if (!sr->ncrtc || !XRRGetCrtcGammaSize(_glfw.x11.display, sr->crtcs[0]))
+    {
+        // This is likely an older Nvidia driver with broken gamma support
+        // Flag it as useless and fall back to xf86vm gamma, if available
+        _glfw.x11.randr.gammaBroken = GLFW_TRUE;
+    }
+
+    if (!sr->ncrtc)
+    {
+        // A system without CRTCs is likely a system with broken RandR
+        // Disable the RandR monitor path and fall back to core functions
+        _glfw.x11.randr.monitorBroken = GLFW_TRUE;
+    }
+
+    XRRFreeScreenResources(sr);
+
+    if (!_glfw.x11.randr.monitorBroken)
+    {
+        XRRSelectInput(_glfw.x11.display, _glfw.x11.root,
+                       RROutputChangeNotifyMask);
+    }
+
+    return GLFW_TRUE;
+}
+
+// Loads the Xcursor library on first use and returns whether it was found
+//
+GLFWbool _glfwLoadXcursorX11(void)
+{
+    if (_glfw.x11.xcursor.loaded)
+        return _glfw.x11.xcursor.handle != NULL;
+
+    _glfw.x11.xcursor.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xcursor.handle = _glfwPlatformLoadModule("libXcursor-1.so");
+#elif defined(__OpenBSD__) || defined(__NetBSD__)
+    _glfw.x11.xcursor.handle = _glfwPlatformLoadModule("libXcursor.so");
+#else
+    _glfw.x11.xcursor.handle = _glfwPlatformLoadModule("libXcursor.so.1");
+#endif
+    if (!_glfw.x11.xcursor.handle)
+        return GLFW_FALSE;
+
+    _glfw.x11.xcursor.ImageCreate = (PFN_XcursorImageCreate)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorImageCreate");
+    _glfw.x11.xcursor.ImageDestroy = (PFN_XcursorImageDestroy)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorImageDestroy");
+    _glfw.x11.xcursor.ImageLoadCursor = (PFN_XcursorImageLoadCursor)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorImageLoadCursor");
+    _glfw.x11.xcursor.GetTheme = (PFN_XcursorGetTheme)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorGetTheme");
+    _glfw.x11.xcursor.GetDefaultSize = (PFN_XcursorGetDefaultSize)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorGetDefaultSize");
+    _glfw.x11.xcursor.LibraryLoadImage = (PFN_XcursorLibraryLoadImage)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xcursor.handle, "XcursorLibraryLoadImage");
+
+    return GLFW_TRUE;
+}
+
+// Loads the Xinerama library on first use and returns whether Xinerama is
+// active
+//
+GLFWbool _glfwLoadXineramaX11(void)
+{
+    if (_glfw.x11.xinerama.loaded)
+        return _glfw.x11.xinerama.available;
+
+    _glfw.x11.xinerama.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xinerama.handle = _glfwPlatformLoadModule("libXinerama-1.so");
+#elif defined(__OpenBSD__) || defined(__NetBSD__)
+    _glfw.x11.xinerama.handle = _glfwPlatformLoadModule("libXinerama.so");
+#else
+    _glfw.x11.xinerama.handle = _glfwPlatformLoadModule("libXinerama.so.1");
+#endif
+    if (!_glfw.x11.xinerama.handle)
+        return GLFW_FALSE;
+
+    _glfw.x11.xinerama.IsActive = (PFN_XineramaIsActive)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xinerama.handle, "XineramaIsActive");
+    _glfw.x11.xinerama.QueryExtension = (PFN_XineramaQueryExtension)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xinerama.handle, "XineramaQueryExtension");
+    _glfw.x11.xinerama.QueryScreens = (PFN_XineramaQueryScreens)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xinerama.handle, "XineramaQueryScreens");
+
+    if (XineramaQueryExtension(_glfw.x11.display,
+                               &_glfw.x11.xinerama.major,
+                               &_glfw.x11.xinerama.minor))
+    {
+        if (XineramaIsActive(_glfw.x11.display))
+            _glfw.x11.xinerama.available = GLFW_TRUE;
+    }
+
+    return _glfw.x11.xinerama.available;
+}
+
+// Loads the X11-xcb library on first use if the XCB Vulkan surface path is
+// enabled and returns whether it was found
+//
+GLFWbool _glfwLoadX11XCBX11(void)
+{
+    if (_glfw.x11.x11xcb.loaded)
+        return _glfw.x11.x11xcb.handle != NULL;
+
+    _glfw.x11.x11xcb.loaded = GLFW_TRUE;
+
+    if (!_glfw.hints.init.x11.xcbVulkanSurface)
+        return GLFW_FALSE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.x11xcb.handle = _glfwPlatformLoadModule("libX11-xcb-1.so");
+#elif defined(__OpenBSD__) || defined(__NetBSD__)
+    _glfw.x11.x11xcb.handle = _glfwPlatformLoadModule("libX11-xcb.so");
+#else
+    _glfw.x11.x11xcb.handle = _glfwPlatformLoadModule("libX11-xcb.so.1");
+#endif
+    if (!_glfw.x11.x11xcb.handle)
+        return GLFW_FALSE;
+
+    _glfw.x11.x11xcb.GetXCBConnection = (PFN_XGetXCBConnection)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.x11xcb.handle, "XGetXCBConnection");
+
+    return GLFW_TRUE;
+}
+
+// Loads the Xrender library on first use and returns whether the extension is
+// available
+//
+GLFWbool _glfwLoadXrenderX11(void)
+{
+    if (_glfw.x11.xrender.loaded)
+        return _glfw.x11.xrender.available;
+
+    _glfw.x11.xrender.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xrender.handle = _glfwPlatformLoadModule("libXrender-1.so");
+#elif defined(__OpenBSD__) || defined(__NetBSD__)
+    _glfw.x11.xrender.handle = _glfwPlatformLoadModule("libXrender.so");
+#else
+    _glfw.x11.xrender.handle = _glfwPlatformLoadModule("libXrender.so.1");
+#endif
+    if (!_glfw.x11.xrender.handle)
+        return GLFW_FALSE;
+
+    _glfw.x11.xrender.QueryExtension = (PFN_XRenderQueryExtension)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xrender.handle, "XRenderQueryExtension");
+    _glfw.x11.xrender.QueryVersion = (PFN_XRenderQueryVersion)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xrender.handle, "XRenderQueryVersion");
+    _glfw.x11.xrender.FindVisualFormat = (PFN_XRenderFindVisualFormat)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xrender.handle, "XRenderFindVisualFormat");
+
+    if (XRenderQueryExtension(_glfw.x11.display,
+                              &_glfw.x11.xrender.errorBase,
+                              &_glfw.x11.xrender.eventBase))
+    {
+        if (XRenderQueryVersion(_glfw.x11.display,
+                                &_glfw.x11.xrender.major,
+                                &_glfw.x11.xrender.minor))
+        {
+            _glfw.x11.xrender.available = GLFW_TRUE;
+        }
+    }
+
+    return _glfw.x11.xrender.available;
+}
+
+// Loads the Xext library on first use and returns whether the Shape extension
+// is available
+//
+GLFWbool _glfwLoadXShapeX11(void)
+{
+    if (_glfw.x11.xshape.loaded)
+        return _glfw.x11.xshape.available;
+
+    _glfw.x11.xshape.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xshape.handle = _glfwPlatformLoadModule("libXext-6.so");
+#elif defined(__OpenBSD__) || defined(__NetBSD__)
+    _glfw.x11.xshape.handle = _glfwPlatformLoadModule("libXext.so");
+#else
+    _glfw.x11.xshape.handle = _glfwPlatformLoadModule("libXext.so.6");
+#endif
+    if (!_glfw.x11.xshape.handle)
+        return GLFW_FALSE;
+
+    _glfw.x11.xshape.QueryExtension = (PFN_XShapeQueryExtension)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xshape.handle, "XShapeQueryExtension");
+    _glfw.x11.xshape.ShapeCombineRegion = (PFN_XShapeCombineRegion)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xshape.handle, "XShapeCombineRegion");
+    _glfw.x11.xshape.QueryVersion = (PFN_XShapeQueryVersion)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xshape.handle, "XShapeQueryVersion");
+    _glfw.x11.xshape.ShapeCombineMask = (PFN_XShapeCombineMask)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xshape.handle, "XShapeCombineMask");
+
+    if (XShapeQueryExtension(_glfw.x11.display,
+        &_glfw.x11.xshape.errorBase,
+        &_glfw.x11.xshape.eventBase))
+    {
+        if (XShapeQueryVersion(_glfw.x11.display,
+            &_glfw.x11.xshape.major,
+            &_glfw.x11.xshape.minor))
+        {
+            _glfw.x11.xshape.available = GLFW_TRUE;
+        }
+    }
+
+    return _glfw.x11.xshape.available;
+}
+
+// Returns the blank cursor for hidden and disabled cursor modes, creating it
+// on first use
+//
+Cursor _glfwGetHiddenCursorX11(void)
+{
+    if (!_glfw.x11.hiddenCursorHandle)
+    {
+        unsigned char pixels[16 * 16 * 4] = { 0 };
+        GLFWimage image = { 16, 16, pixels };
+        _glfw.x11.hiddenCursorHandle = _glfwCreateNativeCursorX11(&image, 0, 0);
+    }
+
+    return _glfw.x11.hiddenCursorHandle;
+}
+
 // Creates a native cursor object from the specified image and hotspot
 //
 Cursor _glfwCreateNativeCursorX11(const GLFWimage* image, int xhot, int yhot)
 {
     Cursor cursor;
 
-    if (!_glfw.x11.xcursor.handle)
+    if (!_glfwLoadXcursorX11())
         return None;
 
     XcursorImage* native = XcursorImageCreate(image->width, image->height);
@@ -1138,18 +1248,7 @@ Cursor _glfwCreateNativeCursorX11(const GLFWimage* image, int xhot, int yhot)
     native->xhot = xhot;
     native->yhot = yhot;
 
-    unsigned char* source = (unsigned char*) image->pixels;
-    XcursorPixel* target = native->pixels;
-
-    for (int i = 0;  i < image->width * image->height;  i++, target++, source += 4)
-    {
-        unsigned int alpha = source[3];
-
-        *target = (alpha << 24) |
-                  ((unsigned char) ((source[0] * alpha) / 255) << 16) |
-                  ((unsigned char) ((source[1] * alpha) / 255) <<  8) |
-                  ((unsigned char) ((source[2] * alpha) / 255) <<  0);
-    }
+    _glfwConvertImageARGB((uint32_t*) native->pixels, image, GLFW_TRUE);
 
     cursor = XcursorImageLoadCursor(_glfw.x11.display, native);
     XcursorImageDestroy(native);
@@ -1182,6 +1281,7 @@ GLFWbool _glfwConnectX11(int platformID, _GLFWplatform* platform)
         .getKeyScancode = _glfwGetKeyScancodeX11,
         .setClipboardString = _glfwSetClipboardStringX11,
         .getClipboardString = _glfwGetClipboardStringX11,
+        .requestClipboardString = _glfwRequestClipboardStringX11,
 #if defined(GLFW_BUILD_LINUX_JOYSTICK)
         .initJoysticks = _glfwInitJoysticksLinux,
         .terminateJoysticks = _glfwTerminateJoysticksLinux,
@@ -1195,6 +1295,7 @@ GLFWbool _glfwConnectX11(int platformID, _GLFWplatform* platform)
         .getMappingName = _glfwGetMappingNameNull,
         .updateGamepadGUID = _glfwUpdateGamepadGUIDNull,
 #endif
+        .pollMonitors = _glfwPollMonitorsX11,
         .freeMonitor = _glfwFreeMonitorX11,
         .getMonitorPos = _glfwGetMonitorPosX11,
         .getMonitorContentScale = _glfwGetMonitorContentScaleX11,
@@ -1236,10 +1337,13 @@ GLFWbool _glfwConnectX11(int platformID, _GLFWplatform* platform)
         .setWindowFloating = _glfwSetWindowFloatingX11,
         .setWindowOpacity = _glfwSetWindowOpacityX11,
         .setWindowMousePassthrough = _glfwSetWindowMousePassthroughX11,
+        .setWindowExclusiveFullscreen = _glfwSetWindowExclusiveFullscreenX11,
         .pollEvents = _glfwPollEventsX11,
         .waitEvents = _glfwWaitEventsX11,
         .waitEventsTimeout = _glfwWaitEventsTimeoutX11,
         .postEmptyEvent = _glfwPostEmptyEventX11,
+        .addEventSource = _glfwAddEventSourcePOSIX,
+        .removeEventSource = _glfwRemoveEventSourcePOSIX,
         .getEGLPlatform = _glfwGetEGLPlatformX11,
         .getEGLNativeDisplay = _glfwGetEGLNativeDisplayX11,
         .getEGLNativeWindow = _glfwGetEGLNativeWindowX11,
@@ -1409,6 +1513,8 @@ int _glfwInitX11(void)
         _glfwPlatformGetModuleSymbol(_glfw.x11.xlib.handle, "XIconifyWindow");
     _glfw.x11.xlib.InternAtom = (PFN_XInternAtom)
         _glfwPlatformGetModuleSymbol(_glfw.x11.xlib.handle, "XInternAtom");
+    _glfw.x11.xlib.InternAtoms = (PFN_XInternAtoms)
+        _glfwPlatformGetModuleSymbol(_glfw.x11.xlib.handle, "XInternAtoms");
     _glfw.x11.xlib.LookupString = (PFN_XLookupString)
         _glfwPlatformGetModuleSymbol(_glfw.x11.xlib.handle, "XLookupString");
     _glfw.x11.xlib.MapRaised = (PFN_XMapRaised)
@@ -1524,17 +1630,23 @@ int _glfwInitX11(void)
     _glfw.x11.screen = DefaultScreen(_glfw.x11.display);
     _glfw.x11.root = RootWindow(_glfw.x11.display, _glfw.x11.screen);
     _glfw.x11.context = XUniqueContext();
+    _glfw.x11.cursorCache.destroy = destroyCachedCursor;
 
     getSystemContentScale(&_glfw.x11.contentScaleX, &_glfw.x11.contentScaleY);
 
-    if (!createEmptyEventPipe())
+    if (!_glfwInitPollSetPOSIX())
         return GLFW_FALSE;
 
+    if (!_glfwWatchPollFDPOSIX(ConnectionNumber(_glfw.x11.display),
+                               _GLFW_POLL_DISPLAY))
+    {
+        return GLFW_FALSE;
+    }
+
     if (!initExtensions())
         return GLFW_FALSE;
 
     _glfw.x11.helperWindowHandle = createHelperWindow();
-    _glfw.x11.hiddenCursorHandle = createHiddenCursor();
 
     if (XSupportsLocale() && _glfw.x11.xlib.utf8)
     {
@@ -1547,7 +1659,7 @@ int _glfwInitX11(void)
                                        NULL);
     }
 
-    _glfwPollMonitorsX11();
+    // Monitors are enumerated when first needed
     return GLFW_TRUE;
 }
 
@@ -1571,8 +1683,11 @@ void _glfwTerminateX11(void)
         _glfw.x11.hiddenCursorHandle = (Cursor) 0;
     }
 
+    _glfwClearImageCache(&_glfw.x11.cursorCache);
+
     _glfw_free(_glfw.x11.primarySelectionString);
     _glfw_free(_glfw.x11.clipboardString);
+    _glfw_free(_glfw.x11.transfer.data);
 
     XUnregisterIMInstantiateCallback(_glfw.x11.display,
                                      NULL, NULL, NULL,
@@ -1633,6 +1748,12 @@ void _glfwTerminateX11(void)
         _glfw.x11.xi.handle = NULL;
     }
 
+    if (_glfw.x11.xshape.handle)
+    {
+        _glfwPlatformFreeModule(_glfw.x11.xshape.handle);
+        _glfw.x11.xshape.handle = NULL;
+    }
+
     _glfwTerminateOSMesa();
     // NOTE: These need to be unloaded after XCloseDisplay, as they register
     //       cleanup callbacks that get called by that function
@@ -1645,11 +1766,7 @@ void _glfwTerminateX11(void)
         _glfw.x11.xlib.handle = NULL;
     }
 
-    if (_glfw.x11.emptyEventPipe[0] || _glfw.x11.emptyEventPipe[1])
-    {
-        close(_glfw.x11.emptyEventPipe[0]);
-        close(_glfw.x11.emptyEventPipe[1]);
-    }
+    _glfwTerminatePollSetPOSIX();
 }
 
 #endif // _GLFW_X11
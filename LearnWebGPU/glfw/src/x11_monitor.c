@@ -91,6 +91,117 @@ static GLFWvidmode vidmodeFromModeInfo(const XRRModeInfo* mi,
     return mode;
 }
 
+// Returns the index of the Xinerama screen covering the specified CRTC, or zero
+// if there is none
+//
+static int getScreenIndex(const XRRCrtcInfo* ci,
+                          const XineramaScreenInfo* screens,
+                          int screenCount)
+{
+    for (int i = 0;  i < screenCount;  i++)
+    {
+        if (screens[i].x_org == ci->x &&
+            screens[i].y_org == ci->y &&
+            screens[i].width == ci->width &&
+            screens[i].height == ci->height)
+        {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+// Creates a monitor object for a connected RandR output and reports it
+//
+static void connectOutput(XRRScreenResources* sr,
+                          RROutput output,
+                          const XRROutputInfo* oi,
+                          RROutput primary,
+                          const XineramaScreenInfo* screens,
+                          int screenCount)
+{
+    int type, widthMM, heightMM;
+
+    XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, oi->crtc);
+    if (ci->rotation == RR_Rotate_90 || ci->rotation == RR_Rotate_270)
+    {
+        widthMM  = oi->mm_height;
+        heightMM = oi->mm_width;
+    }
+    else
+    {
+        widthMM  = oi->mm_width;
+        heightMM = oi->mm_height;
+    }
+
+    if (widthMM <= 0 || heightMM <= 0)
+    {
+        // HACK: If RandR does not provide a physical size, assume the
+        //       X11 default 96 DPI and calculate from the CRTC viewport
+        // NOTE: These members are affected by rotation, unlike the mode
+        //       info and output info members
+        widthMM  = (int) (ci->width * 25.4f / 96.f);
+        heightMM = (int) (ci->height * 25.4f / 96.f);
+    }
+
+    _GLFWmonitor* monitor = _glfwAllocMonitor(oi->name, widthMM, heightMM);
+    monitor->x11.output = output;
+    monitor->x11.crtc   = oi->crtc;
+    monitor->x11.index  = getScreenIndex(ci, screens, screenCount);
+
+    if (monitor->x11.output == primary)
+        type = _GLFW_INSERT_FIRST;
+    else
+        type = _GLFW_INSERT_LAST;
+
+    _glfwInputMonitor(monitor, GLFW_CONNECTED, type);
+
+    XRRFreeCrtcInfo(ci);
+}
+
+// Updates the Xinerama index of every known output and moves the primary one
+// to the front of the monitor list, as both may change after a hotplug
+//
+static void refreshOutputs(XRRScreenResources* sr,
+                           RROutput primary,
+                           const XineramaScreenInfo* screens,
+                           int screenCount)
+{
+    for (int i = 0;  i < _glfw.monitorCount;  i++)
+    {
+        _GLFWmonitor* monitor = _glfw.monitors[i];
+
+        XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
+        if (ci)
+        {
+            monitor->x11.index = getScreenIndex(ci, screens, screenCount);
+            XRRFreeCrtcInfo(ci);
+        }
+
+        if (monitor->x11.output == primary && i > 0)
+        {
+            memmove(_glfw.monitors + 1,
+                    _glfw.monitors,
+                    i * sizeof(_GLFWmonitor*));
+            _glfw.monitors[0] = monitor;
+        }
+    }
+}
+
+// Returns the monitor object of a RandR output, if any
+//
+static _GLFWmonitor* findOutputMonitor(RROutput output)
+{
+    for (int i = 0;  i < _glfw.monitorCount;  i++)
+    {
+        if (_glfw.monitors[i]->x11.output == output)
+            return _glfw.monitors[i];
+    }
+
+    return NULL;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
@@ -100,6 +211,10 @@ static GLFWvidmode vidmodeFromModeInfo(const XRRModeInfo* mi,
 //
 void _glfwPollMonitorsX11(void)
 {
+    // The monitor extensions are only loaded once monitors are needed
+    _glfwLoadRandRX11();
+    _glfwLoadXineramaX11();
+
     if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
     {
         int disconnectedCount, screenCount = 0;
@@ -124,7 +239,7 @@ void _glfwPollMonitorsX11(void)
 
         for (int i = 0;  i < sr->noutput;  i++)
         {
-            int j, type, widthMM, heightMM;
+            int j;
 
             XRROutputInfo* oi = XRRGetOutputInfo(_glfw.x11.display, sr, sr->outputs[i]);
             if (oi->connection != RR_Connected || oi->crtc == None)
@@ -149,60 +264,10 @@ void _glfwPollMonitorsX11(void)
                 continue;
             }
 
-            XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, oi->crtc);
-            if (ci->rotation == RR_Rotate_90 || ci->rotation == RR_Rotate_270)
-            {
-                widthMM  = oi->mm_height;
-                heightMM = oi->mm_width;
-            }
-            else
-            {
-                widthMM  = oi->mm_width;
-                heightMM = oi->mm_height;
-            }
-
-            if (widthMM <= 0 || heightMM <= 0)
-            {
-                // HACK: If RandR does not provide a physical size, assume the
-                //       X11 default 96 DPI and calculate from the CRTC viewport
-                // NOTE: These members are affected by rotation, unlike the mode
-                //       info and output info members
-                widthMM  = (int) (ci->width * 25.4f / 96.f);
-                heightMM = (int) (ci->height * 25.4f / 96.f);
-            }
-
-            _GLFWmonitor* monitor = _glfwAllocMonitor(oi->name, widthMM, heightMM);
-            monitor->x11.output = sr->outputs[i];
-            monitor->x11.crtc   = oi->crtc;
-
-            for (j = 0;  j < screenCount;  j++)
-            {
-                if (screens[j].x_org == ci->x &&
-                    screens[j].y_org == ci->y &&
-                    screens[j].width == ci->width &&
-                    screens[j].height == ci->height)
-                {
-                    monitor->x11.index = j;
-                    break;
-                }
-            }
-
-            if (monitor->x11.output == primary)
-                type = _GLFW_INSERT_FIRST;
-            else
-                type = _GLFW_INSERT_LAST;
-
-            _glfwInputMonitor(monitor, GLFW_CONNECTED, type);
-
+            connectOutput(sr, sr->outputs[i], oi, primary, screens, screenCount);
             XRRFreeOutputInfo(oi);
-            XRRFreeCrtcInfo(ci);
         }
 
-        XRRFreeScreenResources(sr);
-
-        if (screens)
-            XFree(screens);
-
         for (int i = 0;  i < disconnectedCount;  i++)
         {
             if (disconnected[i])
@@ -210,6 +275,14 @@ void _glfwPollMonitorsX11(void)
         }
 
         _glfw_free(disconnected);
+
+        // Outputs that stayed connected may have moved or lost the primary role
+        refreshOutputs(sr, primary, screens, screenCount);
+
+        XRRFreeScreenResources(sr);
+
+        if (screens)
+            XFree(screens);
     }
     else
     {
@@ -222,6 +295,60 @@ void _glfwPollMonitorsX11(void)
     }
 }
 
+// Applies a change to a single RandR output to the monitor list
+//
+void _glfwUpdateOutputX11(const XRROutputChangeNotifyEvent* event)
+{
+    _GLFWmonitor* monitor;
+
+    // The monitor list reflects this change when it is first polled
+    if (!_glfw.monitorsPolled)
+        return;
+
+    int screenCount = 0;
+    XineramaScreenInfo* screens = NULL;
+    XRRScreenResources* sr = XRRGetScreenResourcesCurrent(_glfw.x11.display,
+                                                          _glfw.x11.root);
+    const RROutput primary = XRRGetOutputPrimary(_glfw.x11.display,
+                                                 _glfw.x11.root);
+
+    if (_glfw.x11.xinerama.available)
+        screens = XineramaQueryScreens(_glfw.x11.display, &screenCount);
+
+    monitor = findOutputMonitor(event->output);
+
+    if (event->connection != RR_Connected || event->crtc == None)
+    {
+        if (monitor)
+            _glfwInputMonitor(monitor, GLFW_DISCONNECTED, 0);
+    }
+    else if (monitor)
+    {
+        // The mode list of the output may have changed
+        monitor->x11.crtc = event->crtc;
+        monitor->modesStale = GLFW_TRUE;
+    }
+    else
+    {
+        XRROutputInfo* oi = XRRGetOutputInfo(_glfw.x11.display, sr, event->output);
+        if (oi)
+        {
+            if (oi->connection == RR_Connected && oi->crtc != None)
+                connectOutput(sr, event->output, oi, primary, screens, screenCount);
+
+            XRRFreeOutputInfo(oi);
+        }
+    }
+
+    // The other outputs may have moved too, like the full poll finds out
+    refreshOutputs(sr, primary, screens, screenCount);
+
+    if (screens)
+        XFree(screens);
+
+    XRRFreeScreenResources(sr);
+}
+
 // Set the current video mode for the specified monitor
 //
 void _glfwSetVideoModeX11(_GLFWmonitor* monitor, const GLFWvidmode* desired)
@@ -548,7 +675,7 @@ GLFWbool _glfwGetGammaRampX11(_GLFWmonitor* monitor, GLFWgammaramp* ramp)
         XRRFreeGamma(gamma);
         return GLFW_TRUE;
     }
-    else if (_glfw.x11.vidmode.available)
+    else if (_glfwLoadVidmodeX11())
     {
         int size;
         XF86VidModeGetGammaRampSize(_glfw.x11.display, _glfw.x11.screen, &size);
@@ -588,7 +715,7 @@ void _glfwSetGammaRampX11(_GLFWmonitor* monitor, const GLFWgammaramp* ramp)
         XRRSetCrtcGamma(_glfw.x11.display, monitor->x11.crtc, gamma);
         XRRFreeGamma(gamma);
     }
-    else if (_glfw.x11.vidmode.available)
+    else if (_glfwLoadVidmodeX11())
     {
         XF86VidModeSetGammaRamp(_glfw.x11.display,
                                 _glfw.x11.screen,
@@ -143,6 +143,7 @@ typedef int (* PFN_XGrabPointer)(Display*,Window,Bool,unsigned int,int,int,Windo
 typedef Status (* PFN_XIconifyWindow)(Display*,Window,int);
 typedef Status (* PFN_XInitThreads)(void);
 typedef Atom (* PFN_XInternAtom)(Display*,const char*,Bool);
+typedef Status (* PFN_XInternAtoms)(Display*,char**,int,Bool,Atom*);
 typedef int (* PFN_XLookupString)(XKeyEvent*,char*,int,KeySym*,XComposeStatus*);
 typedef int (* PFN_XMapRaised)(Display*,Window);
 typedef int (* PFN_XMapWindow)(Display*,Window);
@@ -244,6 +245,7 @@ typedef void (* PFN_Xutf8SetWMProperties)(Display*,Window,const char*,const char
 #define XGrabPointer _glfw.x11.xlib.GrabPointer
 #define XIconifyWindow _glfw.x11.xlib.IconifyWindow
 #define XInternAtom _glfw.x11.xlib.InternAtom
+#define XInternAtoms _glfw.x11.xlib.InternAtoms
 #define XLookupString _glfw.x11.xlib.LookupString
 #define XMapRaised _glfw.x11.xlib.MapRaised
 #define XMapWindow _glfw.x11.xlib.MapWindow
@@ -453,7 +455,6 @@ typedef VkResult (APIENTRY *PFN_vkCreateXcbSurfaceKHR)(VkInstance,const VkXcbSur
 typedef VkBool32 (APIENTRY *PFN_vkGetPhysicalDeviceXcbPresentationSupportKHR)(VkPhysicalDevice,uint32_t,xcb_connection_t*,xcb_visualid_t);
 
 #include "xkb_unicode.h"
-#include "posix_poll.h"
 
 #define GLFW_X11_WINDOW_STATE           _GLFWwindowX11 x11;
 #define GLFW_X11_LIBRARY_WINDOW_STATE   _GLFWlibraryX11 x11;
@@ -531,17 +532,33 @@ typedef struct _GLFWwindowX11
     GLFWbool        iconified;
     GLFWbool        maximized;
 
+    // Window state tracked from events so it can be queried without a
+    // round-trip to the server
+    GLFWbool        mapped;
+    GLFWbool        focused;
+    GLFWbool        hovered;
+
     // Whether the visual supports framebuffer transparency
     GLFWbool        transparent;
 
+    // Copy of the images of the current icon and their hash, to skip setting
+    // the same icon again
+    GLFWimage*      icon;
+    int             iconCount;
+    uint64_t        iconHash;
+
     // Cached position and size used to filter out duplicate events
     int             width, height;
     int             xpos, ypos;
 
     // The last received cursor position, regardless of source
     int             lastCursorPosX, lastCursorPosY;
+    // Whether the last received cursor position is still current
+    GLFWbool        cursorPosKnown;
     // The last position the cursor was warped to by GLFW
     int             warpCursorPosX, warpCursorPosY;
+    // Whether the event for the last warp has yet to arrive
+    GLFWbool        warpPending;
 
     // The time of the last KeyPress event per keycode, for discarding
     // duplicate key events generated for some keys by ibus
@@ -562,6 +579,8 @@ typedef struct _GLFWlibraryX11
     Window          helperWindowHandle;
     // Invisible cursor for hidden cursor mode
     Cursor          hiddenCursorHandle;
+    // Custom cursors by image and hotspot, for reuse by identical cursors
+    _GLFWimagecache cursorCache;
     // Context for mapping window XIDs to _GLFWwindow pointers
     XContext        context;
     // XIM input method
@@ -574,6 +593,19 @@ typedef struct _GLFWlibraryX11
     char*           primarySelectionString;
     // Clipboard string (while the selection is owned)
     char*           clipboardString;
+    // Selection transfer from another client, received as events arrive
+    struct {
+        // The selection being received, or None if there is no transfer
+        Atom        selection;
+        // Index of the target being requested, see getTransferTarget
+        int         target;
+        GLFWbool    incremental;
+        char*       data;
+        size_t      length;
+        size_t      capacity;
+        // Timer value when the owner last made progress
+        uint64_t    activity;
+    } transfer;
     // Key name string
     char            keynames[GLFW_KEY_LAST + 1][5];
     // X11 keycode to GLFW key LUT
@@ -584,7 +616,6 @@ typedef struct _GLFWlibraryX11
     double          restoreCursorPosX, restoreCursorPosY;
     // The window whose disabled cursor mode is active
     _GLFWwindow*    disabledCursorWindow;
-    int             emptyEventPipe[2];
 
     // Window manager atoms
     Atom            NET_SUPPORTED;
@@ -690,6 +721,7 @@ typedef struct _GLFWlibraryX11
         PFN_XGrabPointer GrabPointer;
         PFN_XIconifyWindow IconifyWindow;
         PFN_XInternAtom InternAtom;
+        PFN_XInternAtoms InternAtoms;
         PFN_XLookupString LookupString;
         PFN_XMapRaised MapRaised;
         PFN_XMapWindow MapWindow;
@@ -741,6 +773,7 @@ typedef struct _GLFWlibraryX11
     } xrm;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         eventBase;
@@ -803,6 +836,7 @@ typedef struct _GLFWlibraryX11
     } xdnd;
 
     struct {
+        GLFWbool    loaded;
         void*       handle;
         PFN_XcursorImageCreate ImageCreate;
         PFN_XcursorImageDestroy ImageDestroy;
@@ -813,6 +847,7 @@ typedef struct _GLFWlibraryX11
     } xcursor;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         major;
@@ -823,11 +858,13 @@ typedef struct _GLFWlibraryX11
     } xinerama;
 
     struct {
+        GLFWbool    loaded;
         void*       handle;
         PFN_XGetXCBConnection GetXCBConnection;
     } x11xcb;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         eventBase;
@@ -839,6 +876,7 @@ typedef struct _GLFWlibraryX11
     } vidmode;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         majorOpcode;
@@ -851,6 +889,7 @@ typedef struct _GLFWlibraryX11
     } xi;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         major;
@@ -863,6 +902,7 @@ typedef struct _GLFWlibraryX11
     } xrender;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         major;
@@ -934,6 +974,7 @@ void _glfwSetWindowFloatingX11(_GLFWwindow* window, GLFWbool enabled);
 float _glfwGetWindowOpacityX11(_GLFWwindow* window);
 void _glfwSetWindowOpacityX11(_GLFWwindow* window, float opacity);
 void _glfwSetWindowMousePassthroughX11(_GLFWwindow* window, GLFWbool enabled);
+void _glfwSetWindowExclusiveFullscreenX11(_GLFWwindow* window, GLFWbool enabled);
 
 void _glfwSetRawMouseMotionX11(_GLFWwindow *window, GLFWbool enabled);
 GLFWbool _glfwRawMouseMotionSupportedX11(void);
@@ -954,6 +995,7 @@ void _glfwDestroyCursorX11(_GLFWcursor* cursor);
 void _glfwSetCursorX11(_GLFWwindow* window, _GLFWcursor* cursor);
 void _glfwSetClipboardStringX11(const char* string);
 const char* _glfwGetClipboardStringX11(void);
+void _glfwRequestClipboardStringX11(void);
 
 EGLenum _glfwGetEGLPlatformX11(EGLint** attribs);
 EGLNativeDisplayType _glfwGetEGLNativeDisplayX11(void);
@@ -973,9 +1015,19 @@ GLFWbool _glfwGetGammaRampX11(_GLFWmonitor* monitor, GLFWgammaramp* ramp);
 void _glfwSetGammaRampX11(_GLFWmonitor* monitor, const GLFWgammaramp* ramp);
 
 void _glfwPollMonitorsX11(void);
+void _glfwUpdateOutputX11(const XRROutputChangeNotifyEvent* event);
 void _glfwSetVideoModeX11(_GLFWmonitor* monitor, const GLFWvidmode* desired);
 void _glfwRestoreVideoModeX11(_GLFWmonitor* monitor);
 
+GLFWbool _glfwLoadVidmodeX11(void);
+GLFWbool _glfwLoadXiX11(void);
+GLFWbool _glfwLoadRandRX11(void);
+GLFWbool _glfwLoadXcursorX11(void);
+GLFWbool _glfwLoadXineramaX11(void);
+GLFWbool _glfwLoadX11XCBX11(void);
+GLFWbool _glfwLoadXrenderX11(void);
+GLFWbool _glfwLoadXShapeX11(void);
+Cursor _glfwGetHiddenCursorX11(void);
 Cursor _glfwCreateNativeCursorX11(const GLFWimage* image, int xhot, int yhot);
 
 unsigned long _glfwGetWindowPropertyX11(Window window,
@@ -56,6 +56,10 @@
 
 #define _GLFW_XDND_VERSION 5
 
+// Seconds a selection owner may go without sending anything before its
+// transfer is abandoned
+#define _GLFW_X11_TRANSFER_TIMEOUT 5.0
+
 // Wait for event data to arrive on the X11 display socket
 // This avoids blocking other threads via the per-display Xlib lock that also
 // covers GLX functions
@@ -79,77 +83,48 @@ static GLFWbool waitForX11Event(double* timeout)
 //
 static GLFWbool waitForAnyEvent(double* timeout)
 {
-    enum { XLIB_FD, PIPE_FD, INOTIFY_FD };
-    struct pollfd fds[] =
-    {
-        [XLIB_FD] = { ConnectionNumber(_glfw.x11.display), POLLIN },
-        [PIPE_FD] = { _glfw.x11.emptyEventPipe[0], POLLIN },
-        [INOTIFY_FD] = { -1, POLLIN }
-    };
-
 #if defined(GLFW_BUILD_LINUX_JOYSTICK)
+    // Joysticks are initialized on first use, after the display
     if (_glfw.joysticksInitialized)
-        fds[INOTIFY_FD].fd = _glfw.linjs.inotify;
+    {
+        const int fd = _glfwGetJoystickFDLinux();
+        if (fd > 0)
+            _glfwWatchPollFDPOSIX(fd, _GLFW_POLL_JOYSTICK);
+    }
 #endif
 
     while (!XPending(_glfw.x11.display))
     {
-        if (!_glfwPollPOSIX(fds, sizeof(fds) / sizeof(fds[0]), timeout))
+        const unsigned int ready = _glfwWaitPollSetPOSIX(timeout);
+        if (!ready)
             return GLFW_FALSE;
 
-        for (int i = 1; i < sizeof(fds) / sizeof(fds[0]); i++)
-        {
-            if (fds[i].revents & POLLIN)
-                return GLFW_TRUE;
-        }
+        if (ready & ~_GLFW_POLL_DISPLAY)
+            return GLFW_TRUE;
     }
 
     return GLFW_TRUE;
 }
 
-// Writes a byte to the empty event pipe
-//
-static void writeEmptyEvent(void)
-{
-    for (;;)
-    {
-        const char byte = 0;
-        const ssize_t result = write(_glfw.x11.emptyEventPipe[1], &byte, 1);
-        if (result == 1 || (result == -1 && errno != EINTR))
-            break;
-    }
-}
-
-// Drains available data from the empty event pipe
-//
-static void drainEmptyEvents(void)
-{
-    for (;;)
-    {
-        char dummy[64];
-        const ssize_t result = read(_glfw.x11.emptyEventPipe[0], dummy, sizeof(dummy));
-        if (result == -1 && errno != EINTR)
-            break;
-    }
-}
-
 // Waits until a VisibilityNotify event arrives for the specified window or the
 // timeout period elapses (ICCCM section 4.2.2)
 //
 static GLFWbool waitForVisibilityNotify(_GLFWwindow* window)
 {
-    XEvent dummy;
+    XEvent event;
     double timeout = 0.1;
 
     while (!XCheckTypedWindowEvent(_glfw.x11.display,
                                    window->x11.handle,
                                    VisibilityNotify,
-                                   &dummy))
+                                   &event))
     {
         if (!waitForX11Event(&timeout))
             return GLFW_FALSE;
     }
 
+    _glfwInputWindowOcclusion(window,
+                              event.xvisibility.state == VisibilityFullyObscured);
     return GLFW_TRUE;
 }
 
@@ -177,6 +152,42 @@ static int getWindowState(_GLFWwindow* window)
     return result;
 }
 
+// Reads whether the window manager has maximized the window
+//
+static GLFWbool getWindowMaximized(_GLFWwindow* window)
+{
+    Atom* states;
+    GLFWbool maximized = GLFW_FALSE;
+
+    if (!_glfw.x11.NET_WM_STATE ||
+        !_glfw.x11.NET_WM_STATE_MAXIMIZED_VERT ||
+        !_glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ)
+    {
+        return maximized;
+    }
+
+    const unsigned long count =
+        _glfwGetWindowPropertyX11(window->x11.handle,
+                                  _glfw.x11.NET_WM_STATE,
+                                  XA_ATOM,
+                                  (unsigned char**) &states);
+
+    for (unsigned long i = 0;  i < count;  i++)
+    {
+        if (states[i] == _glfw.x11.NET_WM_STATE_MAXIMIZED_VERT ||
+            states[i] == _glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ)
+        {
+            maximized = GLFW_TRUE;
+            break;
+        }
+    }
+
+    if (states)
+        XFree(states);
+
+    return maximized;
+}
+
 // Returns whether the event is a selection event
 //
 static Bool isSelectionEvent(Display* display, XEvent* event, XPointer pointer)
@@ -200,17 +211,6 @@ static Bool isFrameExtentsEvent(Display* display, XEvent* event, XPointer pointe
            event->xproperty.atom == _glfw.x11.NET_FRAME_EXTENTS;
 }
 
-// Returns whether it is a property event for the specified selection transfer
-//
-static Bool isSelPropNewValueNotify(Display* display, XEvent* event, XPointer pointer)
-{
-    XEvent* notification = (XEvent*) pointer;
-    return event->type == PropertyNotify &&
-           event->xproperty.state == PropertyNewValue &&
-           event->xproperty.window == notification->xselection.requestor &&
-           event->xproperty.atom == notification->xselection.property;
-}
-
 // Translates an X event modifier state mask
 //
 static int translateState(int state)
@@ -316,6 +316,28 @@ static void updateNormalHints(_GLFWwindow* window, int width, int height)
     XFree(hints);
 }
 
+// Updates the compositor bypass hint of the window
+//
+static void updateCompositorBypass(_GLFWwindow* window)
+{
+    // Transparent full screen windows normally keep compositing so that their
+    // alpha is honored, unless the application asked for exclusive presentation
+    if (window->monitor &&
+        (window->exclusiveFullscreen || !window->x11.transparent))
+    {
+        const unsigned long value = 1;
+
+        XChangeProperty(_glfw.x11.display,  window->x11.handle,
+                        _glfw.x11.NET_WM_BYPASS_COMPOSITOR, XA_CARDINAL, 32,
+                        PropModeReplace, (unsigned char*) &value, 1);
+    }
+    else
+    {
+        XDeleteProperty(_glfw.x11.display, window->x11.handle,
+                        _glfw.x11.NET_WM_BYPASS_COMPOSITOR);
+    }
+}
+
 // Updates the full screen status of the window
 //
 static void updateWindowMode(_GLFWwindow* window)
@@ -362,15 +384,6 @@ static void updateWindowMode(_GLFWwindow* window)
             window->x11.overrideRedirect = GLFW_TRUE;
         }
 
-        // Enable compositor bypass
-        if (!window->x11.transparent)
-        {
-            const unsigned long value = 1;
-
-            XChangeProperty(_glfw.x11.display,  window->x11.handle,
-                            _glfw.x11.NET_WM_BYPASS_COMPOSITOR, XA_CARDINAL, 32,
-                            PropModeReplace, (unsigned char*) &value, 1);
-        }
     }
     else
     {
@@ -400,14 +413,9 @@ static void updateWindowMode(_GLFWwindow* window)
 
             window->x11.overrideRedirect = GLFW_FALSE;
         }
-
-        // Disable compositor bypass
-        if (!window->x11.transparent)
-        {
-            XDeleteProperty(_glfw.x11.display, window->x11.handle,
-                            _glfw.x11.NET_WM_BYPASS_COMPOSITOR);
-        }
     }
+
+    updateCompositorBypass(window);
 }
 
 // Decode a Unicode code point from a UTF-8 stream
@@ -470,7 +478,7 @@ static void updateCursorImage(_GLFWwindow* window)
     else
     {
         XDefineCursor(_glfw.x11.display, window->x11.handle,
-                      _glfw.x11.hiddenCursorHandle);
+                      _glfwGetHiddenCursorX11());
     }
 }
 
@@ -781,8 +789,13 @@ static GLFWbool createNativeWindow(_GLFWwindow* window,
         _glfwCreateInputContextX11(window);
 
     _glfwSetWindowTitleX11(window, wndconfig->title);
-    _glfwGetWindowPosX11(window, &window->x11.xpos, &window->x11.ypos);
-    _glfwGetWindowSizeX11(window, &window->x11.width, &window->x11.height);
+
+    // The window is not yet reparented, so its creation geometry is current
+    // until the first ConfigureNotify
+    window->x11.xpos = xpos;
+    window->x11.ypos = ypos;
+    window->x11.width = width;
+    window->x11.height = height;
 
     return GLFW_TRUE;
 }
@@ -936,146 +949,336 @@ static void handleSelectionRequest(XEvent* event)
     XSendEvent(_glfw.x11.display, request->requestor, False, 0, &reply);
 }
 
-static const char* getSelectionString(Atom selection)
+// Returns the string target to request at the specified step of a transfer,
+// or None if there are no targets left to try
+//
+static Atom getTransferTarget(int index)
+{
+    if (index == 0)
+        return _glfw.x11.UTF8_STRING;
+    else if (index == 1)
+        return XA_STRING;
+    else
+        return None;
+}
+
+// Asks the selection owner to convert the selection to the current target
+//
+static void requestTransferTarget(void)
 {
+    XConvertSelection(_glfw.x11.display,
+                      _glfw.x11.transfer.selection,
+                      getTransferTarget(_glfw.x11.transfer.target),
+                      _glfw.x11.GLFW_SELECTION,
+                      _glfw.x11.helperWindowHandle,
+                      CurrentTime);
+    XFlush(_glfw.x11.display);
+}
+
+// Starts receiving the specified selection from its owner
+//
+static void beginTransfer(Atom selection)
+{
+    _glfw.x11.transfer.selection = selection;
+    _glfw.x11.transfer.target = 0;
+    _glfw.x11.transfer.incremental = GLFW_FALSE;
+    _glfw.x11.transfer.length = 0;
+    _glfw.x11.transfer.activity = _glfwPlatformGetTimerValue();
+
+    requestTransferTarget();
+}
+
+// Returns whether the selection owner has stopped responding to the transfer
+//
+static GLFWbool isTransferStalled(void)
+{
+    const uint64_t elapsed =
+        _glfwPlatformGetTimerValue() - _glfw.x11.transfer.activity;
+    return elapsed >= _GLFW_X11_TRANSFER_TIMEOUT * _glfwPlatformGetTimerFrequency();
+}
+
+// Returns whether a transfer is in progress, and if so the time left before its
+// owner is considered to have stopped responding
+//
+static GLFWbool getTransferTimeout(double* timeout)
+{
+    if (_glfw.x11.transfer.selection == None)
+        return GLFW_FALSE;
+
+    const double elapsed =
+        (double) (_glfwPlatformGetTimerValue() - _glfw.x11.transfer.activity) /
+        _glfwPlatformGetTimerFrequency();
+
+    *timeout = _GLFW_X11_TRANSFER_TIMEOUT - elapsed;
+    if (*timeout < 0.0)
+        *timeout = 0.0;
+
+    return GLFW_TRUE;
+}
+
+// Ends the current transfer and passes the result to any windows waiting for
+// the clipboard
+//
+static void endTransfer(GLFWbool received)
+{
+    const Atom selection = _glfw.x11.transfer.selection;
     char** selectionString = NULL;
-    const Atom targets[] = { _glfw.x11.UTF8_STRING, XA_STRING };
-    const size_t targetCount = sizeof(targets) / sizeof(targets[0]);
 
     if (selection == _glfw.x11.PRIMARY)
         selectionString = &_glfw.x11.primarySelectionString;
     else
         selectionString = &_glfw.x11.clipboardString;
 
-    if (XGetSelectionOwner(_glfw.x11.display, selection) ==
-        _glfw.x11.helperWindowHandle)
+    _glfw_free(*selectionString);
+    *selectionString = NULL;
+
+    if (received)
     {
-        // Instead of doing a large number of X round-trips just to put this
-        // string into a window property and then read it back, just return it
-        return *selectionString;
+        if (getTransferTarget(_glfw.x11.transfer.target) == XA_STRING)
+            *selectionString = convertLatin1toUTF8(_glfw.x11.transfer.data);
+        else
+        {
+            // Hand the buffer over instead of copying it
+            *selectionString = _glfw.x11.transfer.data;
+            _glfw.x11.transfer.data = NULL;
+            _glfw.x11.transfer.capacity = 0;
+        }
     }
 
-    _glfw_free(*selectionString);
-    *selectionString = NULL;
+    _glfw.x11.transfer.selection = None;
+    _glfw.x11.transfer.length = 0;
+
+    if (selection == _glfw.x11.CLIPBOARD)
+        _glfwInputClipboardString(*selectionString);
+}
 
-    for (size_t i = 0;  i < targetCount;  i++)
+// Abandons the current transfer if its owner has stopped responding
+//
+static void checkTransferStalled(void)
+{
+    if (_glfw.x11.transfer.selection != None && isTransferStalled())
     {
-        char* data;
-        Atom actualType;
-        int actualFormat;
-        unsigned long itemCount, bytesAfter;
-        XEvent notification, dummy;
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Selection owner stopped responding");
+        endTransfer(GLFW_FALSE);
+    }
+}
 
-        XConvertSelection(_glfw.x11.display,
-                          selection,
-                          targets[i],
-                          _glfw.x11.GLFW_SELECTION,
-                          _glfw.x11.helperWindowHandle,
-                          CurrentTime);
+// Moves on to the next target after the owner failed to convert to the current
+// one, or ends the transfer if there are none left
+//
+static void retryTransfer(void)
+{
+    _glfw.x11.transfer.target++;
 
-        while (!XCheckTypedWindowEvent(_glfw.x11.display,
-                                       _glfw.x11.helperWindowHandle,
-                                       SelectionNotify,
-                                       &notification))
-        {
-            waitForX11Event(NULL);
-        }
+    if (getTransferTarget(_glfw.x11.transfer.target) == None)
+    {
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "X11: Failed to convert selection to string");
+        endTransfer(GLFW_FALSE);
+        return;
+    }
+
+    requestTransferTarget();
+}
+
+// Appends received data to the current transfer
+//
+static GLFWbool appendTransferData(const char* data, size_t count)
+{
+    const size_t length = _glfw.x11.transfer.length;
+
+    if (!_glfwCheckClipboardSize(length + count))
+        return GLFW_FALSE;
 
-        if (notification.xselection.property == None)
-            continue;
+    if (length + count + 1 > _glfw.x11.transfer.capacity)
+    {
+        size_t capacity = _glfw.x11.transfer.capacity ? _glfw.x11.transfer.capacity : 4096;
+        while (capacity < length + count + 1)
+            capacity *= 2;
+
+        char* resized = _glfw_realloc(_glfw.x11.transfer.data, capacity);
+        if (!resized)
+            return GLFW_FALSE;
+
+        _glfw.x11.transfer.data = resized;
+        _glfw.x11.transfer.capacity = capacity;
+    }
+
+    if (count)
+        memcpy(_glfw.x11.transfer.data + length, data, count);
+    _glfw.x11.transfer.length = length + count;
+    _glfw.x11.transfer.data[_glfw.x11.transfer.length] = '\0';
+    return GLFW_TRUE;
+}
 
-        XCheckIfEvent(_glfw.x11.display,
-                      &dummy,
-                      isSelPropNewValueNotify,
-                      (XPointer) &notification);
+// Reads and deletes the transfer property, which prompts an owner doing an INCR
+// transfer to send the next chunk
+// Returns whether the property could be read
+//
+static GLFWbool readTransferProperty(Atom* type, char** data, unsigned long* itemCount)
+{
+    int actualFormat;
+    unsigned long bytesAfter;
 
-        XGetWindowProperty(_glfw.x11.display,
-                           notification.xselection.requestor,
-                           notification.xselection.property,
+    *type = None;
+    *data = NULL;
+    *itemCount = 0;
+
+    if (XGetWindowProperty(_glfw.x11.display,
+                           _glfw.x11.helperWindowHandle,
+                           _glfw.x11.GLFW_SELECTION,
                            0,
                            LONG_MAX,
                            True,
                            AnyPropertyType,
-                           &actualType,
+                           type,
                            &actualFormat,
-                           &itemCount,
+                           itemCount,
                            &bytesAfter,
-                           (unsigned char**) &data);
+                           (unsigned char**) data) != Success)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to read selection property");
+        return GLFW_FALSE;
+    }
 
-        if (actualType == _glfw.x11.INCR)
-        {
-            size_t size = 1;
-            char* string = NULL;
+    return GLFW_TRUE;
+}
 
-            for (;;)
-            {
-                while (!XCheckIfEvent(_glfw.x11.display,
-                                      &dummy,
-                                      isSelPropNewValueNotify,
-                                      (XPointer) &notification))
-                {
-                    waitForX11Event(NULL);
-                }
+// Advances the current transfer on a selection or property event for the
+// helper window
+//
+// The owner either writes the whole string to the property before replying,
+// or replies with an INCR property holding a lower bound on the size and then
+// writes the string in chunks, each after GLFW deletes the previous one
+// (ICCCM section 2.7.2)
+//
+static void handleTransferEvent(const XEvent* event)
+{
+    if (_glfw.x11.transfer.selection == None)
+        return;
 
-                XFree(data);
-                XGetWindowProperty(_glfw.x11.display,
-                                   notification.xselection.requestor,
-                                   notification.xselection.property,
-                                   0,
-                                   LONG_MAX,
-                                   True,
-                                   AnyPropertyType,
-                                   &actualType,
-                                   &actualFormat,
-                                   &itemCount,
-                                   &bytesAfter,
-                                   (unsigned char**) &data);
-
-                if (itemCount)
-                {
-                    size += itemCount;
-                    string = _glfw_realloc(string, size);
-                    string[size - itemCount - 1] = '\0';
-                    strcat(string, data);
-                }
+    char* data = NULL;
+    Atom actualType;
+    unsigned long itemCount;
 
-                if (!itemCount)
-                {
-                    if (string)
-                    {
-                        if (targets[i] == XA_STRING)
-                        {
-                            *selectionString = convertLatin1toUTF8(string);
-                            _glfw_free(string);
-                        }
-                        else
-                            *selectionString = string;
-                    }
+    if (event->type == SelectionNotify)
+    {
+        if (event->xselection.selection != _glfw.x11.transfer.selection ||
+            event->xselection.target != getTransferTarget(_glfw.x11.transfer.target))
+        {
+            // This is the late reply to an abandoned transfer
+            return;
+        }
 
-                    break;
-                }
-            }
+        if (event->xselection.property == None)
+        {
+            retryTransfer();
+            return;
+        }
+
+        _glfw.x11.transfer.activity = _glfwPlatformGetTimerValue();
+
+        if (!readTransferProperty(&actualType, &data, &itemCount))
+        {
+            endTransfer(GLFW_FALSE);
+            return;
         }
-        else if (actualType == targets[i])
+
+        if (actualType == _glfw.x11.INCR)
         {
-            if (targets[i] == XA_STRING)
-                *selectionString = convertLatin1toUTF8(data);
+            if (itemCount && !_glfwCheckClipboardSize(*(unsigned long*) data))
+                endTransfer(GLFW_FALSE);
             else
-                *selectionString = _glfw_strdup(data);
+                _glfw.x11.transfer.incremental = GLFW_TRUE;
+        }
+        else if (actualType == getTransferTarget(_glfw.x11.transfer.target))
+            endTransfer(appendTransferData(data, itemCount));
+        else
+            retryTransfer();
+    }
+    else if (event->type == PropertyNotify)
+    {
+        if (!_glfw.x11.transfer.incremental ||
+            event->xproperty.state != PropertyNewValue ||
+            event->xproperty.atom != _glfw.x11.GLFW_SELECTION)
+        {
+            return;
         }
 
+        _glfw.x11.transfer.activity = _glfwPlatformGetTimerValue();
+
+        if (!readTransferProperty(&actualType, &data, &itemCount))
+        {
+            endTransfer(GLFW_FALSE);
+            return;
+        }
+
+        // An empty chunk marks the end of the transfer, which may have had no
+        // data at all
+        if (!itemCount)
+            endTransfer(appendTransferData("", 0));
+        else if (!appendTransferData(data, itemCount))
+            endTransfer(GLFW_FALSE);
+    }
+
+    if (data)
         XFree(data);
+}
 
-        if (*selectionString)
-            break;
+// Returns whether it is an event for a selection transfer
+//
+static Bool isTransferEvent(Display* display, XEvent* event, XPointer pointer)
+{
+    return event->xany.window == _glfw.x11.helperWindowHandle &&
+           (event->type == SelectionNotify || event->type == PropertyNotify);
+}
+
+// Processes only transfer events until the current transfer ends or the owner
+// stops responding
+//
+static void waitForTransfer(void)
+{
+    while (_glfw.x11.transfer.selection != None)
+    {
+        XEvent event;
+        double timeout;
+
+        if (XCheckIfEvent(_glfw.x11.display, &event, isTransferEvent, NULL))
+            handleTransferEvent(&event);
+        else if (getTransferTimeout(&timeout) && timeout > 0.0)
+            waitForX11Event(&timeout);
+        else
+            checkTransferStalled();
     }
+}
+
+static const char* getSelectionString(Atom selection)
+{
+    char** selectionString = NULL;
 
-    if (!*selectionString)
+    if (selection == _glfw.x11.PRIMARY)
+        selectionString = &_glfw.x11.primarySelectionString;
+    else
+        selectionString = &_glfw.x11.clipboardString;
+
+    if (XGetSelectionOwner(_glfw.x11.display, selection) ==
+        _glfw.x11.helperWindowHandle)
     {
-        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
-                        "X11: Failed to convert selection to string");
+        // Instead of doing a large number of X round-trips just to put this
+        // string into a window property and then read it back, just return it
+        return *selectionString;
     }
 
+    // Both selections are received through the same property, so let any
+    // transfer of the other one finish first, or join a transfer of this one
+    if (_glfw.x11.transfer.selection != selection)
+        waitForTransfer();
+    if (_glfw.x11.transfer.selection == None)
+        beginTransfer(selection);
+
+    waitForTransfer();
     return *selectionString;
 }
 
@@ -1141,6 +1344,22 @@ static void releaseMonitor(_GLFWwindow* window)
     }
 }
 
+// Marks the last received cursor position as current, unless it may come from
+// an event queued before the last warp
+//
+static void updateCursorPosKnown(_GLFWwindow* window, int x, int y)
+{
+    if (window->x11.warpPending)
+    {
+        if (x != window->x11.warpCursorPosX || y != window->x11.warpCursorPosY)
+            return;
+
+        window->x11.warpPending = GLFW_FALSE;
+    }
+
+    window->x11.cursorPosKnown = GLFW_TRUE;
+}
+
 // Process the specified X event
 //
 static void processEvent(XEvent *event)
@@ -1159,7 +1378,10 @@ static void processEvent(XEvent *event)
         if (event->type == _glfw.x11.randr.eventBase + RRNotify)
         {
             XRRUpdateConfiguration(event);
-            _glfwPollMonitorsX11();
+
+            if (((XRRNotifyEvent*) event)->subtype == RRNotify_OutputChange)
+                _glfwUpdateOutputX11((XRROutputChangeNotifyEvent*) event);
+
             return;
         }
     }
@@ -1222,6 +1444,12 @@ static void processEvent(XEvent *event)
         return;
     }
 
+    if (isTransferEvent(_glfw.x11.display, event, NULL))
+    {
+        handleTransferEvent(event);
+        return;
+    }
+
     _GLFWwindow* window = NULL;
     if (XFindContext(_glfw.x11.display,
                      event->xany.window,
@@ -1439,21 +1667,47 @@ static void processEvent(XEvent *event)
             _glfwInputCursorEnter(window, GLFW_TRUE);
             _glfwInputCursorPos(window, x, y);
 
+            window->x11.hovered = GLFW_TRUE;
             window->x11.lastCursorPosX = x;
             window->x11.lastCursorPosY = y;
+            updateCursorPosKnown(window, x, y);
             return;
         }
 
         case LeaveNotify:
         {
+            window->x11.hovered = GLFW_FALSE;
+            window->x11.cursorPosKnown = GLFW_FALSE;
             _glfwInputCursorEnter(window, GLFW_FALSE);
             return;
         }
 
         case MotionNotify:
         {
-            const int x = event->xmotion.x;
-            const int y = event->xmotion.y;
+            int x = event->xmotion.x;
+            int y = event->xmotion.y;
+
+            if (_glfw.hints.init.coalesceMotion &&
+                window->cursorMode != GLFW_CURSOR_DISABLED)
+            {
+                // Skip to the last of the motion events already queued for
+                // this window, as only the latest position gets reported
+                XEvent next;
+
+                while (XEventsQueued(_glfw.x11.display, QueuedAlready))
+                {
+                    XPeekEvent(_glfw.x11.display, &next);
+                    if (next.type != MotionNotify ||
+                        next.xmotion.window != event->xmotion.window)
+                    {
+                        break;
+                    }
+
+                    XNextEvent(_glfw.x11.display, &next);
+                    x = next.xmotion.x;
+                    y = next.xmotion.y;
+                }
+            }
 
             if (x != window->x11.warpCursorPosX ||
                 y != window->x11.warpCursorPosY)
@@ -1480,6 +1734,7 @@ static void processEvent(XEvent *event)
 
             window->x11.lastCursorPosX = x;
             window->x11.lastCursorPosY = y;
+            updateCursorPosKnown(window, x, y);
             return;
         }
 
@@ -1746,6 +2001,8 @@ static void processEvent(XEvent *event)
                 return;
             }
 
+            window->x11.focused = GLFW_TRUE;
+
             if (window->cursorMode == GLFW_CURSOR_DISABLED)
                 disableCursor(window);
             else if (window->cursorMode == GLFW_CURSOR_CAPTURED)
@@ -1768,6 +2025,8 @@ static void processEvent(XEvent *event)
                 return;
             }
 
+            window->x11.focused = GLFW_FALSE;
+
             if (window->cursorMode == GLFW_CURSOR_DISABLED)
                 enableCursor(window);
             else if (window->cursorMode == GLFW_CURSOR_CAPTURED)
@@ -1789,6 +2048,24 @@ static void processEvent(XEvent *event)
             return;
         }
 
+        case VisibilityNotify:
+        {
+            _glfwInputWindowOcclusion(window,
+                                      event->xvisibility.state == VisibilityFullyObscured);
+            return;
+        }
+
+        case MapNotify:
+        case UnmapNotify:
+        {
+            // Most window managers unmap the windows of other workspaces
+            // without iconifying them, so an unmapped window counts as
+            // covered until it is mapped again
+            window->x11.mapped = (event->type == MapNotify);
+            _glfwInputWindowOcclusion(window, event->type == UnmapNotify);
+            return;
+        }
+
         case PropertyNotify:
         {
             if (event->xproperty.state != PropertyNewValue)
@@ -1817,7 +2094,7 @@ static void processEvent(XEvent *event)
             }
             else if (event->xproperty.atom == _glfw.x11.NET_WM_STATE)
             {
-                const GLFWbool maximized = _glfwWindowMaximizedX11(window);
+                const GLFWbool maximized = getWindowMaximized(window);
                 if (window->x11.maximized != maximized)
                 {
                     window->x11.maximized = maximized;
@@ -1868,7 +2145,7 @@ unsigned long _glfwGetWindowPropertyX11(Window window,
 
 GLFWbool _glfwIsVisualTransparentX11(Visual* visual)
 {
-    if (!_glfw.x11.xrender.available)
+    if (!_glfwLoadXrenderX11())
         return GLFW_FALSE;
 
     XRenderPictFormat* pf = XRenderFindVisualFormat(_glfw.x11.display, visual);
@@ -2075,6 +2352,9 @@ void _glfwDestroyWindowX11(_GLFWwindow* window)
         window->x11.colormap = (Colormap) 0;
     }
 
+    _glfw_free(window->x11.icon);
+    window->x11.icon = NULL;
+
     XFlush(_glfw.x11.display);
 }
 
@@ -2106,12 +2386,30 @@ void _glfwSetWindowIconX11(_GLFWwindow* window, int count, const GLFWimage* imag
 {
     if (count)
     {
-        int longCount = 0;
+        // Skip the conversion and upload when the same icon is set again, as
+        // when an application updates a status icon every frame
+        uint64_t hash = (uint64_t) count;
+        for (int i = 0;  i < count;  i++)
+            hash = _glfwHashImage(&images[i], hash);
+
+        if (hash == window->x11.iconHash &&
+            count == window->x11.iconCount &&
+            _glfwEqualImages(count, images, window->x11.icon))
+        {
+            return;
+        }
+
+        int longCount = 0, maxPixelCount = 0;
 
         for (int i = 0;  i < count;  i++)
-            longCount += 2 + images[i].width * images[i].height;
+        {
+            const int pixelCount = images[i].width * images[i].height;
+            longCount += 2 + pixelCount;
+            maxPixelCount = _glfw_max(maxPixelCount, pixelCount);
+        }
 
         unsigned long* icon = _glfw_calloc(longCount, sizeof(unsigned long));
+        uint32_t* pixels = _glfw_calloc(maxPixelCount, sizeof(uint32_t));
         unsigned long* target = icon;
 
         for (int i = 0;  i < count;  i++)
@@ -2119,13 +2417,10 @@ void _glfwSetWindowIconX11(_GLFWwindow* window, int count, const GLFWimage* imag
             *target++ = images[i].width;
             *target++ = images[i].height;
 
+            _glfwConvertImageARGB(pixels, &images[i], GLFW_FALSE);
+
             for (int j = 0;  j < images[i].width * images[i].height;  j++)
-            {
-                *target++ = (((unsigned long) images[i].pixels[j * 4 + 0]) << 16) |
-                            (((unsigned long) images[i].pixels[j * 4 + 1]) <<  8) |
-                            (((unsigned long) images[i].pixels[j * 4 + 2]) <<  0) |
-                            (((unsigned long) images[i].pixels[j * 4 + 3]) << 24);
-            }
+                *target++ = pixels[j];
         }
 
         // NOTE: XChangeProperty expects 32-bit values like the image data above to be
@@ -2141,12 +2436,24 @@ void _glfwSetWindowIconX11(_GLFWwindow* window, int count, const GLFWimage* imag
                         (unsigned char*) icon,
                         longCount);
 
+        _glfw_free(pixels);
         _glfw_free(icon);
+
+        // Without a copy to compare with, the next icon is always uploaded
+        _glfw_free(window->x11.icon);
+        window->x11.icon = _glfwCopyImages(count, images);
+        window->x11.iconCount = window->x11.icon ? count : 0;
+        window->x11.iconHash = hash;
     }
     else
     {
         XDeleteProperty(_glfw.x11.display, window->x11.handle,
                         _glfw.x11.NET_WM_ICON);
+
+        _glfw_free(window->x11.icon);
+        window->x11.icon = NULL;
+        window->x11.iconCount = 0;
+        window->x11.iconHash = 0;
     }
 
     XFlush(_glfw.x11.display);
@@ -2154,16 +2461,12 @@ void _glfwSetWindowIconX11(_GLFWwindow* window, int count, const GLFWimage* imag
 
 void _glfwGetWindowPosX11(_GLFWwindow* window, int* xpos, int* ypos)
 {
-    Window dummy;
-    int x, y;
-
-    XTranslateCoordinates(_glfw.x11.display, window->x11.handle, _glfw.x11.root,
-                          0, 0, &x, &y, &dummy);
-
+    // The position is kept current by ConfigureNotify, including the synthetic
+    // ones sent by the window manager when it moves the frame
     if (xpos)
-        *xpos = x;
+        *xpos = window->x11.xpos;
     if (ypos)
-        *ypos = y;
+        *ypos = window->x11.ypos;
 }
 
 void _glfwSetWindowPosX11(_GLFWwindow* window, int xpos, int ypos)
@@ -2192,13 +2495,10 @@ void _glfwSetWindowPosX11(_GLFWwindow* window, int xpos, int ypos)
 
 void _glfwGetWindowSizeX11(_GLFWwindow* window, int* width, int* height)
 {
-    XWindowAttributes attribs;
-    XGetWindowAttributes(_glfw.x11.display, window->x11.handle, &attribs);
-
     if (width)
-        *width = attribs.width;
+        *width = window->x11.width;
     if (height)
-        *height = attribs.height;
+        *height = window->x11.height;
 }
 
 void _glfwSetWindowSizeX11(_GLFWwindow* window, int width, int height)
@@ -2431,12 +2731,14 @@ void _glfwShowWindowX11(_GLFWwindow* window)
         return;
 
     XMapWindow(_glfw.x11.display, window->x11.handle);
+    window->x11.mapped = GLFW_TRUE;
     waitForVisibilityNotify(window);
 }
 
 void _glfwHideWindowX11(_GLFWwindow* window)
 {
     XUnmapWindow(_glfw.x11.display, window->x11.handle);
+    window->x11.mapped = GLFW_FALSE;
     XFlush(_glfw.x11.display);
 }
 
@@ -2525,85 +2827,27 @@ void _glfwSetWindowMonitorX11(_GLFWwindow* window,
 
 GLFWbool _glfwWindowFocusedX11(_GLFWwindow* window)
 {
-    Window focused;
-    int state;
-
-    XGetInputFocus(_glfw.x11.display, &focused, &state);
-    return window->x11.handle == focused;
+    return window->x11.focused;
 }
 
 GLFWbool _glfwWindowIconifiedX11(_GLFWwindow* window)
 {
-    return getWindowState(window) == IconicState;
+    return window->x11.iconified;
 }
 
 GLFWbool _glfwWindowVisibleX11(_GLFWwindow* window)
 {
-    XWindowAttributes wa;
-    XGetWindowAttributes(_glfw.x11.display, window->x11.handle, &wa);
-    return wa.map_state == IsViewable;
+    return window->x11.mapped;
 }
 
 GLFWbool _glfwWindowMaximizedX11(_GLFWwindow* window)
 {
-    Atom* states;
-    GLFWbool maximized = GLFW_FALSE;
-
-    if (!_glfw.x11.NET_WM_STATE ||
-        !_glfw.x11.NET_WM_STATE_MAXIMIZED_VERT ||
-        !_glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ)
-    {
-        return maximized;
-    }
-
-    const unsigned long count =
-        _glfwGetWindowPropertyX11(window->x11.handle,
-                                  _glfw.x11.NET_WM_STATE,
-                                  XA_ATOM,
-                                  (unsigned char**) &states);
-
-    for (unsigned long i = 0;  i < count;  i++)
-    {
-        if (states[i] == _glfw.x11.NET_WM_STATE_MAXIMIZED_VERT ||
-            states[i] == _glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ)
-        {
-            maximized = GLFW_TRUE;
-            break;
-        }
-    }
-
-    if (states)
-        XFree(states);
-
-    return maximized;
+    return window->x11.maximized;
 }
 
 GLFWbool _glfwWindowHoveredX11(_GLFWwindow* window)
 {
-    Window w = _glfw.x11.root;
-    while (w)
-    {
-        Window root;
-        int rootX, rootY, childX, childY;
-        unsigned int mask;
-
-        _glfwGrabErrorHandlerX11();
-
-        const Bool result = XQueryPointer(_glfw.x11.display, w,
-                                          &root, &w, &rootX, &rootY,
-                                          &childX, &childY, &mask);
-
-        _glfwReleaseErrorHandlerX11();
-
-        if (_glfw.x11.errorCode == BadWindow)
-            w = _glfw.x11.root;
-        else if (!result)
-            return GLFW_FALSE;
-        else if (w == window->x11.handle)
-            return GLFW_TRUE;
-    }
-
-    return GLFW_FALSE;
+    return window->x11.hovered;
 }
 
 GLFWbool _glfwFramebufferTransparentX11(_GLFWwindow* window)
@@ -2712,7 +2956,7 @@ void _glfwSetWindowFloatingX11(_GLFWwindow* window, GLFWbool enabled)
 
 void _glfwSetWindowMousePassthroughX11(_GLFWwindow* window, GLFWbool enabled)
 {
-    if (!_glfw.x11.xshape.available)
+    if (!_glfwLoadXShapeX11())
         return;
 
     if (enabled)
@@ -2729,6 +2973,12 @@ void _glfwSetWindowMousePassthroughX11(_GLFWwindow* window, GLFWbool enabled)
     }
 }
 
+void _glfwSetWindowExclusiveFullscreenX11(_GLFWwindow* window, GLFWbool enabled)
+{
+    updateCompositorBypass(window);
+    XFlush(_glfw.x11.display);
+}
+
 float _glfwGetWindowOpacityX11(_GLFWwindow* window)
 {
     float opacity = 1.f;
@@ -2762,7 +3012,7 @@ void _glfwSetWindowOpacityX11(_GLFWwindow* window, float opacity)
 
 void _glfwSetRawMouseMotionX11(_GLFWwindow *window, GLFWbool enabled)
 {
-    if (!_glfw.x11.xi.available)
+    if (!_glfwLoadXiX11())
         return;
 
     if (_glfw.x11.disabledCursorWindow != window)
@@ -2776,16 +3026,17 @@ void _glfwSetRawMouseMotionX11(_GLFWwindow *window, GLFWbool enabled)
 
 GLFWbool _glfwRawMouseMotionSupportedX11(void)
 {
-    return _glfw.x11.xi.available;
+    return _glfwLoadXiX11();
 }
 
 void _glfwPollEventsX11(void)
 {
-    drainEmptyEvents();
+    _glfwDrainEmptyEventsPOSIX();
+    _glfwDispatchEventSourcesPOSIX();
 
 #if defined(GLFW_BUILD_LINUX_JOYSTICK)
     if (_glfw.joysticksInitialized)
-        _glfwDetectJoystickConnectionLinux();
+        _glfwProcessJoystickEventsLinux();
 #endif
     XPending(_glfw.x11.display);
 
@@ -2811,28 +3062,62 @@ void _glfwPollEventsX11(void)
         }
     }
 
+    // An asynchronous transfer has no one waiting on it to notice that its
+    // owner went quiet
+    checkTransferStalled();
+
     XFlush(_glfw.x11.display);
 }
 
 void _glfwWaitEventsX11(void)
 {
+    double timeout;
+
+    // The wait ends in time to abandon a transfer whose owner went quiet, as
+    // no event may ever come to end it otherwise
+    while (getTransferTimeout(&timeout))
+    {
+        if (waitForAnyEvent(&timeout) || isTransferStalled())
+        {
+            _glfwPollEventsX11();
+            return;
+        }
+    }
+
     waitForAnyEvent(NULL);
     _glfwPollEventsX11();
 }
 
 void _glfwWaitEventsTimeoutX11(double timeout)
 {
+    double transferTimeout;
+
+    if (getTransferTimeout(&transferTimeout) && transferTimeout < timeout)
+        timeout = transferTimeout;
+
     waitForAnyEvent(&timeout);
     _glfwPollEventsX11();
 }
 
 void _glfwPostEmptyEventX11(void)
 {
-    writeEmptyEvent();
+    _glfwPostEmptyEventPOSIX();
 }
 
 void _glfwGetCursorPosX11(_GLFWwindow* window, double* xpos, double* ypos)
 {
+    // While the cursor is over the window every move is reported by an event,
+    // so only a cursor elsewhere needs a round-trip to the server
+    if (window->x11.cursorPosKnown)
+    {
+        if (xpos)
+            *xpos = window->x11.lastCursorPosX;
+        if (ypos)
+            *ypos = window->x11.lastCursorPosY;
+
+        return;
+    }
+
     Window root, child;
     int rootX, rootY, childX, childY;
     unsigned int mask;
@@ -2853,6 +3138,9 @@ void _glfwSetCursorPosX11(_GLFWwindow* window, double x, double y)
     // Store the new position so it can be recognized later
     window->x11.warpCursorPosX = (int) x;
     window->x11.warpCursorPosY = (int) y;
+    // Query the server until the motion event for the warp has arrived
+    window->x11.warpPending = GLFW_TRUE;
+    window->x11.cursorPosKnown = GLFW_FALSE;
 
     XWarpPointer(_glfw.x11.display, None, window->x11.handle,
                  0,0,0,0, (int) x, (int) y);
@@ -2939,16 +3227,24 @@ GLFWbool _glfwCreateCursorX11(_GLFWcursor* cursor,
                               const GLFWimage* image,
                               int xhot, int yhot)
 {
+    const uint64_t hotspot = ((uint64_t) (uint32_t) xhot << 32) | (uint32_t) yhot;
+
+    cursor->x11.handle =
+        (Cursor) _glfwAcquireCachedImage(&_glfw.x11.cursorCache, image, hotspot);
+    if (cursor->x11.handle)
+        return GLFW_TRUE;
+
     cursor->x11.handle = _glfwCreateNativeCursorX11(image, xhot, yhot);
     if (!cursor->x11.handle)
         return GLFW_FALSE;
 
+    _glfwInsertCachedImage(&_glfw.x11.cursorCache, image, hotspot, cursor->x11.handle);
     return GLFW_TRUE;
 }
 
 GLFWbool _glfwCreateStandardCursorX11(_GLFWcursor* cursor, int shape)
 {
-    if (_glfw.x11.xcursor.handle)
+    if (_glfwLoadXcursorX11())
     {
         char* theme = XcursorGetTheme(_glfw.x11.display);
         if (theme)
@@ -3046,7 +3342,10 @@ GLFWbool _glfwCreateStandardCursorX11(_GLFWcursor* cursor, int shape)
 
 void _glfwDestroyCursorX11(_GLFWcursor* cursor)
 {
-    if (cursor->x11.handle)
+    if (!cursor->x11.handle)
+        return;
+
+    if (!_glfwReleaseCachedImage(&_glfw.x11.cursorCache, cursor->x11.handle))
         XFreeCursor(_glfw.x11.display, cursor->x11.handle);
 }
 
@@ -3084,6 +3383,23 @@ const char* _glfwGetClipboardStringX11(void)
     return getSelectionString(_glfw.x11.CLIPBOARD);
 }
 
+void _glfwRequestClipboardStringX11(void)
+{
+    if (XGetSelectionOwner(_glfw.x11.display, _glfw.x11.CLIPBOARD) ==
+        _glfw.x11.helperWindowHandle)
+    {
+        _glfwInputClipboardString(_glfw.x11.clipboardString);
+        return;
+    }
+
+    // A transfer in progress will answer this request as well, unless its
+    // owner has gone quiet
+    if (_glfw.x11.transfer.selection != None && !isTransferStalled())
+        return;
+
+    beginTransfer(_glfw.x11.CLIPBOARD);
+}
+
 EGLenum _glfwGetEGLPlatformX11(EGLint** attribs)
 {
     if (_glfw.egl.ANGLE_platform_angle)
@@ -3138,7 +3454,7 @@ void _glfwGetRequiredInstanceExtensionsX11(char** extensions)
     if (!_glfw.vk.KHR_surface)
         return;
 
-    if (!_glfw.vk.KHR_xcb_surface || !_glfw.x11.x11xcb.handle)
+    if (!_glfw.vk.KHR_xcb_surface || !_glfwLoadX11XCBX11())
     {
         if (!_glfw.vk.KHR_xlib_surface)
             return;
@@ -3148,7 +3464,7 @@ void _glfwGetRequiredInstanceExtensionsX11(char** extensions)
 
     // NOTE: VK_KHR_xcb_surface is preferred due to some early ICDs exposing but
     //       not correctly implementing VK_KHR_xlib_surface
-    if (_glfw.vk.KHR_xcb_surface && _glfw.x11.x11xcb.handle)
+    if (_glfw.vk.KHR_xcb_surface && _glfwLoadX11XCBX11())
         extensions[1] = "VK_KHR_xcb_surface";
     else
         extensions[1] = "VK_KHR_xlib_surface";
@@ -3161,7 +3477,7 @@ GLFWbool _glfwGetPhysicalDevicePresentationSupportX11(VkInstance instance,
     VisualID visualID = XVisualIDFromVisual(DefaultVisual(_glfw.x11.display,
                                                           _glfw.x11.screen));
 
-    if (_glfw.vk.KHR_xcb_surface && _glfw.x11.x11xcb.handle)
+    if (_glfw.vk.KHR_xcb_surface && _glfwLoadX11XCBX11())
     {
         PFN_vkGetPhysicalDeviceXcbPresentationSupportKHR
             vkGetPhysicalDeviceXcbPresentationSupportKHR =
@@ -3212,7 +3528,7 @@ VkResult _glfwCreateWindowSurfaceX11(VkInstance instance,
                                      const VkAllocationCallbacks* allocator,
                                      VkSurfaceKHR* surface)
 {
-    if (_glfw.vk.KHR_xcb_surface && _glfw.x11.x11xcb.handle)
+    if (_glfw.vk.KHR_xcb_surface && _glfwLoadX11XCBX11())
     {
         VkResult err;
         VkXcbSurfaceCreateInfoKHR sci;
@@ -0,0 +1,624 @@
+#include "gpu-primitives.h"
+
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+#include <cstring>
+
+namespace
+{
+    // These must match SCAN_ITEMS, HISTOGRAM_ITEMS and RADIX_BITS in WGSL.
+    // Values scanned by each invocation of the scan kernels
+    constexpr uint32_t kScanItems = 4;
+    // Values counted by each invocation of the histogram kernel
+    constexpr uint32_t kHistogramItems = 4;
+    // Bits of the key sorted by each radix sort pass
+    constexpr uint32_t kRadixBits = 4;
+    constexpr uint32_t kRadix = 1u << kRadixBits;
+    // Size of the parameter buffers, enough for the largest WGSL params struct
+    constexpr uint64_t kParamsSize = 32;
+
+    uint32_t divideRoundUp(uint32_t value, uint32_t divisor)
+    {
+        return (value + divisor - 1) / divisor;
+    }
+
+    // Shared by all the kernels below. Kernels that process blocks of the
+    // input derive the block index from the (possibly folded) workgroup grid.
+    char const* const kCommonSource = R"(
+const SCAN_ITEMS: u32 = 4u;
+const HISTOGRAM_ITEMS: u32 = 4u;
+const RADIX_BITS: u32 = 4u;
+const RADIX: u32 = 16u;
+
+var<workgroup> scan_temp: array<u32, WORKGROUP_SIZE_X>;
+
+fn block_index(workgroup_id: vec3<u32>, num_workgroups: vec3<u32>) -> u32 {
+    return workgroup_id.y * num_workgroups.x + workgroup_id.x;
+}
+
+// Inclusive prefix sum of `value` over the invocations of the workgroup. The
+// total is left in scan_temp[WORKGROUP_SIZE_X - 1u]; a barrier is needed
+// before scan_temp is written again. Must be called in uniform control flow.
+fn workgroup_inclusive_scan(local_index: u32, value: u32) -> u32 {
+    scan_temp[local_index] = value;
+    workgroupBarrier();
+    for (var offset = 1u; offset < WORKGROUP_SIZE_X; offset = offset * 2u) {
+        var addend = 0u;
+        if (local_index >= offset) {
+            addend = scan_temp[local_index - offset];
+        }
+        workgroupBarrier();
+        scan_temp[local_index] = scan_temp[local_index] + addend;
+        workgroupBarrier();
+    }
+    return scan_temp[local_index];
+}
+)";
+
+    char const* const kScanSource = R"(
+struct ScanParams {
+    count: u32,
+    num_blocks: u32,
+    use_prefix: u32,
+    value: u32,
+}
+
+@group(0) @binding(0) var<uniform> params: ScanParams;
+@group(0) @binding(1) var<storage, read_write> data: array<u32>;
+@group(0) @binding(2) var<storage, read_write> block_sums: array<u32>;
+
+// Sum of each block of WORKGROUP_SIZE_X * SCAN_ITEMS values
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn scan_reduce(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+               @builtin(num_workgroups) num_workgroups: vec3<u32>,
+               @builtin(local_invocation_index) local_index: u32) {
+    let block = block_index(workgroup_id, num_workgroups);
+    if (block >= params.num_blocks) {
+        return;
+    }
+
+    // Strided loads so that neighbouring invocations read neighbouring values
+    let base = block * WORKGROUP_SIZE_X * SCAN_ITEMS + local_index;
+    var sum = 0u;
+    for (var i = 0u; i < SCAN_ITEMS; i = i + 1u) {
+        let index = base + i * WORKGROUP_SIZE_X;
+        if (index < params.count) {
+            sum = sum + data[index];
+        }
+    }
+
+    let total = workgroup_inclusive_scan(local_index, sum);
+    if (local_index == WORKGROUP_SIZE_X - 1u) {
+        block_sums[block] = total;
+    }
+}
+
+// Exclusive scan of each block, offset by the scanned sum of the previous
+// blocks when use_prefix is set
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn scan_add(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+            @builtin(num_workgroups) num_workgroups: vec3<u32>,
+            @builtin(local_invocation_index) local_index: u32) {
+    let block = block_index(workgroup_id, num_workgroups);
+    if (block >= params.num_blocks) {
+        return;
+    }
+
+    let base = (block * WORKGROUP_SIZE_X + local_index) * SCAN_ITEMS;
+    var items: array<u32, SCAN_ITEMS>;
+    var sum = 0u;
+    for (var i = 0u; i < SCAN_ITEMS; i = i + 1u) {
+        let index = base + i;
+        items[i] = sum;
+        if (index < params.count) {
+            sum = sum + data[index];
+        }
+    }
+
+    var prefix = workgroup_inclusive_scan(local_index, sum) - sum;
+    if (params.use_prefix != 0u) {
+        prefix = prefix + block_sums[block];
+    }
+
+    for (var i = 0u; i < SCAN_ITEMS; i = i + 1u) {
+        let index = base + i;
+        if (index < params.count) {
+            data[index] = prefix + items[i];
+        }
+    }
+}
+
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn fill(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+        @builtin(num_workgroups) num_workgroups: vec3<u32>,
+        @builtin(local_invocation_index) local_index: u32) {
+    let index = global_index_1d(workgroup_id, local_index, num_workgroups);
+    if (index < params.count) {
+        data[index] = params.value;
+    }
+}
+)";
+
+    char const* const kHistogramSource = R"(
+struct HistogramParams {
+    count: u32,
+    num_blocks: u32,
+    shift: u32,
+    bin_mask: u32,
+}
+
+@group(0) @binding(0) var<uniform> params: HistogramParams;
+@group(0) @binding(1) var<storage, read> values: array<u32>;
+@group(0) @binding(2) var<storage, read_write> bins: array<atomic<u32>>;
+
+var<workgroup> local_bins: array<atomic<u32>, 256>;
+
+// Count in workgroup memory first, so that global atomics are only issued
+// once per bin and per workgroup
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn histogram(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+             @builtin(num_workgroups) num_workgroups: vec3<u32>,
+             @builtin(local_invocation_index) local_index: u32) {
+    let block = block_index(workgroup_id, num_workgroups);
+    if (block >= params.num_blocks) {
+        return;
+    }
+
+    for (var bin = local_index; bin <= params.bin_mask; bin = bin + WORKGROUP_SIZE_X) {
+        atomicStore(&local_bins[bin], 0u);
+    }
+    workgroupBarrier();
+
+    let base = block * WORKGROUP_SIZE_X * HISTOGRAM_ITEMS + local_index;
+    for (var i = 0u; i < HISTOGRAM_ITEMS; i = i + 1u) {
+        let index = base + i * WORKGROUP_SIZE_X;
+        if (index < params.count) {
+            atomicAdd(&local_bins[(values[index] >> params.shift) & params.bin_mask], 1u);
+        }
+    }
+    workgroupBarrier();
+
+    for (var bin = local_index; bin <= params.bin_mask; bin = bin + WORKGROUP_SIZE_X) {
+        let local_count = atomicLoad(&local_bins[bin]);
+        if (local_count != 0u) {
+            atomicAdd(&bins[bin], local_count);
+        }
+    }
+}
+)";
+
+    char const* const kCompactSource = R"(
+struct CompactParams {
+    count: u32,
+    num_blocks: u32,
+    unused0: u32,
+    unused1: u32,
+}
+
+@group(0) @binding(0) var<uniform> params: CompactParams;
+@group(0) @binding(1) var<storage, read> flags: array<u32>;
+@group(0) @binding(2) var<storage, read_write> offsets: array<u32>;
+@group(0) @binding(3) var<storage, read> input: array<u32>;
+@group(0) @binding(4) var<storage, read_write> output: array<u32>;
+@group(0) @binding(5) var<storage, read_write> output_count: array<u32>;
+
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn compact_flags(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+                 @builtin(num_workgroups) num_workgroups: vec3<u32>,
+                 @builtin(local_invocation_index) local_index: u32) {
+    let index = global_index_1d(workgroup_id, local_index, num_workgroups);
+    if (index < params.count) {
+        offsets[index] = select(0u, 1u, flags[index] != 0u);
+    }
+}
+
+// `offsets` holds the exclusive scan of the flags at this point
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn compact_scatter(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+                   @builtin(num_workgroups) num_workgroups: vec3<u32>,
+                   @builtin(local_invocation_index) local_index: u32) {
+    let index = global_index_1d(workgroup_id, local_index, num_workgroups);
+    if (index >= params.count) {
+        return;
+    }
+
+    let keep = flags[index] != 0u;
+    if (keep) {
+        output[offsets[index]] = input[index];
+    }
+    if (index == params.count - 1u) {
+        output_count[0] = offsets[index] + select(0u, 1u, keep);
+    }
+}
+)";
+
+    char const* const kRadixSortSource = R"(
+struct RadixParams {
+    count: u32,
+    num_blocks: u32,
+    shift: u32,
+    key_words: u32,
+    has_payload: u32,
+    unused0: u32,
+    unused1: u32,
+    unused2: u32,
+}
+
+@group(0) @binding(0) var<uniform> params: RadixParams;
+@group(0) @binding(1) var<storage, read> keys_in: array<u32>;
+@group(0) @binding(2) var<storage, read_write> histograms: array<u32>;
+@group(0) @binding(3) var<storage, read_write> keys_out: array<u32>;
+@group(0) @binding(4) var<storage, read> payload_in: array<u32>;
+@group(0) @binding(5) var<storage, read_write> payload_out: array<u32>;
+
+var<workgroup> digit_counts: array<atomic<u32>, RADIX>;
+var<workgroup> local_digits: array<u32, WORKGROUP_SIZE_X>;
+var<workgroup> local_sources: array<u32, WORKGROUP_SIZE_X>;
+var<workgroup> digit_starts: array<u32, RADIX>;
+
+fn key_digit(index: u32) -> u32 {
+    let word = keys_in[index * params.key_words + params.shift / 32u];
+    return (word >> (params.shift % 32u)) & (RADIX - 1u);
+}
+
+// Count the digits of each block. Counts are stored digit-major, so that
+// once scanned they give the output offset of each digit of each block.
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn radix_histogram(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+                   @builtin(num_workgroups) num_workgroups: vec3<u32>,
+                   @builtin(local_invocation_index) local_index: u32) {
+    let block = block_index(workgroup_id, num_workgroups);
+    if (block >= params.num_blocks) {
+        return;
+    }
+
+    if (local_index < RADIX) {
+        atomicStore(&digit_counts[local_index], 0u);
+    }
+    workgroupBarrier();
+
+    let index = block * WORKGROUP_SIZE_X + local_index;
+    if (index < params.count) {
+        atomicAdd(&digit_counts[key_digit(index)], 1u);
+    }
+    workgroupBarrier();
+
+    if (local_index < RADIX) {
+        histograms[local_index * params.num_blocks + block] = atomicLoad(&digit_counts[local_index]);
+    }
+}
+
+// Sort each block by digit in workgroup memory (one stable split per bit of
+// the digit), then write every key at its block's offset for its digit plus
+// its rank among the keys of the block sharing that digit.
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn radix_scatter(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+                 @builtin(num_workgroups) num_workgroups: vec3<u32>,
+                 @builtin(local_invocation_index) local_index: u32) {
+    let block = block_index(workgroup_id, num_workgroups);
+    if (block >= params.num_blocks) {
+        return;
+    }
+
+    // Invocations past the end carry the last digit, so that they end up
+    // after every valid key of the block and do not change their ranks.
+    var source = block * WORKGROUP_SIZE_X + local_index;
+    var digit = RADIX - 1u;
+    if (source < params.count) {
+        digit = key_digit(source);
+    }
+
+    for (var bit = 0u; bit < RADIX_BITS; bit = bit + 1u) {
+        let is_set = (digit >> bit) & 1u;
+        let ones_before = workgroup_inclusive_scan(local_index, is_set) - is_set;
+        let total_zeros = WORKGROUP_SIZE_X - scan_temp[WORKGROUP_SIZE_X - 1u];
+
+        var position = local_index - ones_before;
+        if (is_set != 0u) {
+            position = total_zeros + ones_before;
+        }
+        workgroupBarrier();
+
+        local_digits[position] = digit;
+        local_sources[position] = source;
+        workgroupBarrier();
+
+        digit = local_digits[local_index];
+        source = local_sources[local_index];
+        workgroupBarrier();
+    }
+
+    if (local_index == 0u || local_digits[local_index - 1u] != digit) {
+        digit_starts[digit] = local_index;
+    }
+    workgroupBarrier();
+
+    if (source >= params.count) {
+        return;
+    }
+
+    let destination = histograms[digit * params.num_blocks + block] + local_index - digit_starts[digit];
+    for (var word = 0u; word < params.key_words; word = word + 1u) {
+        keys_out[destination * params.key_words + word] = keys_in[source * params.key_words + word];
+    }
+    if (params.has_payload != 0u) {
+        payload_out[destination] = payload_in[source];
+    }
+}
+)";
+}
+
+bool GpuPrimitives::Initialize(ComputeContext& compute)
+{
+    m_compute = &compute;
+
+    std::string scan_source = std::string(kCommonSource) + kScanSource;
+    std::string histogram_source = std::string(kCommonSource) + kHistogramSource;
+    std::string compact_source = std::string(kCommonSource) + kCompactSource;
+    std::string radix_sort_source = std::string(kCommonSource) + kRadixSortSource;
+
+    m_scan_reduce = compute.CreateKernel("Scan reduce", scan_source, "scan_reduce");
+    m_scan_add = compute.CreateKernel("Scan add", scan_source, "scan_add");
+    m_fill = compute.CreateKernel("Fill", scan_source, "fill");
+    m_histogram = compute.CreateKernel("Histogram", histogram_source, "histogram");
+    m_compact_flags = compute.CreateKernel("Compact flags", compact_source, "compact_flags");
+    m_compact_scatter = compute.CreateKernel("Compact scatter", compact_source, "compact_scatter");
+    m_radix_histogram = compute.CreateKernel("Radix histogram", radix_sort_source, "radix_histogram");
+    m_radix_scatter = compute.CreateKernel("Radix scatter", radix_sort_source, "radix_scatter");
+
+    if (!m_scan_reduce || !m_scan_add || !m_fill || !m_histogram || !m_compact_flags
+        || !m_compact_scatter || !m_radix_histogram || !m_radix_scatter)
+    {
+        std::cerr << "Could not create the GPU primitive kernels!" << std::endl;
+        return false;
+    }
+
+    // The radix kernels use one invocation per digit to clear and store counts
+    assert(m_radix_histogram->GetWorkgroupSize().x >= kRadix);
+
+    EnsureScratch(m_dummy, 16, "Primitives dummy buffer");
+
+    return true;
+}
+
+void GpuPrimitives::Terminate()
+{
+    for (WGPUBuffer& buffer : m_scan_levels)
+        wgpuBufferRelease(buffer);
+    m_scan_levels.clear();
+
+    for (WGPUBuffer& buffer : m_params)
+        wgpuBufferRelease(buffer);
+    m_params.clear();
+    m_params_used = 0;
+
+    for (WGPUBuffer* buffer : { &m_compact_offsets, &m_sort_keys, &m_sort_payload, &m_sort_histograms, &m_dummy })
+    {
+        if (*buffer)
+            wgpuBufferRelease(*buffer);
+        *buffer = nullptr;
+    }
+
+    // Kernels are owned by the compute context
+    m_compute = nullptr;
+}
+
+WGPUBuffer GpuPrimitives::AcquireParams(std::initializer_list<uint32_t> values)
+{
+    assert(values.size() * sizeof(uint32_t) <= kParamsSize);
+
+    // Once everything queued so far has been submitted, the writes below are
+    // ordered after the submission that read the previous values, so every
+    // buffer can be used again. Work that is only encoded still reads them
+    // when it is submitted later.
+    if (!m_compute->HasUnsubmittedDispatches())
+        m_params_used = 0;
+
+    if (m_params_used == m_params.size())
+    {
+        WGPUBufferDescriptor buffer_descriptor = {};
+        buffer_descriptor.nextInChain = nullptr;
+        buffer_descriptor.label = "Primitive parameters";
+        buffer_descriptor.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+        buffer_descriptor.size = kParamsSize;
+        buffer_descriptor.mappedAtCreation = false;
+        m_params.push_back(wgpuDeviceCreateBuffer(m_compute->GetDevice(), &buffer_descriptor));
+    }
+
+    uint32_t words[kParamsSize / sizeof(uint32_t)] = {};
+    std::copy(values.begin(), values.end(), words);
+
+    WGPUBuffer buffer = m_params[m_params_used++];
+    wgpuQueueWriteBuffer(m_compute->GetQueue(), buffer, 0, words, kParamsSize);
+    return buffer;
+}
+
+WGPUBuffer GpuPrimitives::EnsureScratch(WGPUBuffer& buffer, uint64_t size, char const* label)
+{
+    size = std::max<uint64_t>((size + 3) & ~uint64_t(3), 16);
+    if (buffer && wgpuBufferGetSize(buffer) >= size)
+        return buffer;
+
+    // Work already queued keeps the previous buffer alive through its bind groups
+    if (buffer)
+        wgpuBufferRelease(buffer);
+
+    WGPUBufferDescriptor buffer_descriptor = {};
+    buffer_descriptor.nextInChain = nullptr;
+    buffer_descriptor.label = label;
+    buffer_descriptor.usage = WGPUBufferUsage_Storage | WGPUBufferUsage_CopySrc | WGPUBufferUsage_CopyDst;
+    buffer_descriptor.size = size;
+    buffer_descriptor.mappedAtCreation = false;
+    buffer = wgpuDeviceCreateBuffer(m_compute->GetDevice(), &buffer_descriptor);
+
+    return buffer;
+}
+
+void GpuPrimitives::DispatchBlocks(ComputeKernel const& kernel, std::initializer_list<WGPUBuffer> buffers, uint32_t block_count)
+{
+    WGPUBindGroup bind_group = kernel.CreateBindGroup(0, buffers);
+    m_compute->Dispatch(kernel, { bind_group }, block_count * kernel.GetWorkgroupSize().x);
+    wgpuBindGroupRelease(bind_group);
+}
+
+void GpuPrimitives::Fill(WGPUBuffer data, uint32_t count, uint32_t value)
+{
+    if (count == 0)
+        return;
+
+    uint32_t block_count = divideRoundUp(count, m_fill->GetWorkgroupSize().x);
+    WGPUBuffer params = AcquireParams({ count, block_count, 0, value });
+    DispatchBlocks(*m_fill, { params, data }, block_count);
+}
+
+void GpuPrimitives::ScanLevel(WGPUBuffer data, uint32_t count, uint32_t level)
+{
+    uint32_t block_size = m_scan_add->GetWorkgroupSize().x * kScanItems;
+    uint32_t block_count = divideRoundUp(count, block_size);
+
+    if (block_count == 1)
+    {
+        // A single workgroup scans the whole level, no block sums needed
+        WGPUBuffer params = AcquireParams({ count, 1, 0, 0 });
+        DispatchBlocks(*m_scan_add, { params, data, m_dummy }, 1);
+        return;
+    }
+
+    if (m_scan_levels.size() <= level)
+        m_scan_levels.resize(level + 1, nullptr);
+    WGPUBuffer block_sums = EnsureScratch(m_scan_levels[level], uint64_t(block_count) * sizeof(uint32_t), "Scan block sums");
+
+    WGPUBuffer params = AcquireParams({ count, block_count, 1, 0 });
+    DispatchBlocks(*m_scan_reduce, { params, data, block_sums }, block_count);
+    ScanLevel(block_sums, block_count, level + 1);
+    DispatchBlocks(*m_scan_add, { params, data, block_sums }, block_count);
+}
+
+void GpuPrimitives::ExclusiveScan(WGPUBuffer data, uint32_t count)
+{
+    if (count == 0)
+        return;
+
+    ScanLevel(data, count, 0);
+}
+
+void GpuPrimitives::Histogram(WGPUBuffer values, uint32_t count, WGPUBuffer bins, uint32_t bin_count, uint32_t shift)
+{
+    assert(bin_count > 0 && bin_count <= 256 && (bin_count & (bin_count - 1)) == 0);
+
+    Fill(bins, bin_count, 0);
+    if (count == 0)
+        return;
+
+    uint32_t block_count = divideRoundUp(count, m_histogram->GetWorkgroupSize().x * kHistogramItems);
+    WGPUBuffer params = AcquireParams({ count, block_count, shift, bin_count - 1 });
+    DispatchBlocks(*m_histogram, { params, values, bins }, block_count);
+}
+
+void GpuPrimitives::Compact(WGPUBuffer input, WGPUBuffer flags, uint32_t count, WGPUBuffer output, WGPUBuffer output_count)
+{
+    if (count == 0)
+    {
+        Fill(output_count, 1, 0);
+        return;
+    }
+
+    WGPUBuffer offsets = EnsureScratch(m_compact_offsets, uint64_t(count) * sizeof(uint32_t), "Compaction offsets");
+    uint32_t block_count = divideRoundUp(count, m_compact_flags->GetWorkgroupSize().x);
+    WGPUBuffer params = AcquireParams({ count, block_count, 0, 0 });
+
+    DispatchBlocks(*m_compact_flags, { params, flags, offsets }, block_count);
+    ExclusiveScan(offsets, count);
+    DispatchBlocks(*m_compact_scatter, { params, flags, offsets, input, output, output_count }, block_count);
+}
+
+void GpuPrimitives::RadixSort(WGPUBuffer keys, WGPUBuffer payload, uint32_t count, SortKeyWidth key_width)
+{
+    if (count <= 1)
+        return;
+
+    uint32_t key_words = static_cast<uint32_t>(key_width);
+    uint32_t pass_count = 32 * key_words / kRadixBits;
+    uint32_t block_count = divideRoundUp(count, m_radix_scatter->GetWorkgroupSize().x);
+    uint32_t histogram_count = kRadix * block_count;
+
+    WGPUBuffer histograms = EnsureScratch(m_sort_histograms, uint64_t(histogram_count) * sizeof(uint32_t), "Radix sort histograms");
+
+    // Keys and payloads ping-pong between the caller's buffers and scratch
+    // buffers; the number of passes is even so the result ends up in place.
+    WGPUBuffer keys_in = keys;
+    WGPUBuffer keys_out = EnsureScratch(m_sort_keys, uint64_t(count) * key_words * sizeof(uint32_t), "Radix sort keys");
+    WGPUBuffer payload_in = payload ? payload : m_dummy;
+    WGPUBuffer payload_out = EnsureScratch(m_sort_payload, payload ? uint64_t(count) * sizeof(uint32_t) : 16, "Radix sort payload");
+
+    for (uint32_t pass = 0; pass < pass_count; ++pass)
+    {
+        WGPUBuffer params = AcquireParams({ count, block_count, pass * kRadixBits, key_words, payload ? 1u : 0u, 0, 0, 0 });
+
+        DispatchBlocks(*m_radix_histogram, { params, keys_in, histograms }, block_count);
+        ExclusiveScan(histograms, histogram_count);
+        DispatchBlocks(*m_radix_scatter, { params, keys_in, histograms, keys_out, payload_in, payload_out }, block_count);
+
+        std::swap(keys_in, keys_out);
+        if (payload)
+            std::swap(payload_in, payload_out);
+    }
+}
+
+void cpuExclusiveScan(std::vector<uint32_t>& data)
+{
+    std::exclusive_scan(data.begin(), data.end(), data.begin(), 0u);
+}
+
+void cpuRadixSort(std::vector<uint32_t>& keys, std::vector<uint32_t>* payload, SortKeyWidth key_width)
+{
+    size_t key_words = static_cast<size_t>(key_width);
+    size_t count = keys.size() / key_words;
+
+    auto keyAt = [&](size_t index)
+        {
+            uint64_t key = keys[index * key_words];
+            if (key_words == 2)
+                key |= uint64_t(keys[index * key_words + 1]) << 32;
+            return key;
+        };
+
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return keyAt(a) < keyAt(b); });
+
+    std::vector<uint32_t> sorted_keys(keys.size());
+    std::vector<uint32_t> sorted_payload(payload ? payload->size() : 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t word = 0; word < key_words; ++word)
+            sorted_keys[i * key_words + word] = keys[order[i] * key_words + word];
+        if (payload)
+            sorted_payload[i] = (*payload)[order[i]];
+    }
+
+    keys = std::move(sorted_keys);
+    if (payload)
+        *payload = std::move(sorted_payload);
+}
+
+std::vector<uint32_t> cpuCompact(std::vector<uint32_t> const& input, std::vector<uint32_t> const& flags)
+{
+    std::vector<uint32_t> output;
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        if (flags[i] != 0)
+            output.push_back(input[i]);
+    }
+    return output;
+}
+
+std::vector<uint32_t> cpuHistogram(std::vector<uint32_t> const& values, uint32_t bin_count, uint32_t shift)
+{
+    std::vector<uint32_t> bins(bin_count, 0);
+    for (uint32_t value : values)
+        ++bins[(value >> shift) & (bin_count - 1)];
+    return bins;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "compute.h"
+
+#include <webgpu/webgpu.h>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Width of the keys sorted by GpuPrimitives::RadixSort. 64-bit keys are
+ * stored as two consecutive u32 words, least significant word first.
+ */
+enum class SortKeyWidth
+{
+    Bits32 = 1,
+    Bits64 = 2,
+};
+
+/**
+ * Data-parallel building blocks written as WGSL compute kernels: prefix sum,
+ * radix sort, stream compaction and histogram.
+ *
+ * Every operation only queues dispatches on the ComputeContext, so a chain of
+ * primitives is recorded in a single compute pass and runs whenever the
+ * context is flushed (or with the next frame). All buffers must have the
+ * Storage usage and hold u32 values unless stated otherwise.
+ */
+class GpuPrimitives
+{
+public:
+    bool Initialize(ComputeContext& compute);
+    void Terminate();
+
+    // In-place exclusive prefix sum of the first `count` values of `data`,
+    // computed with a reduce-then-scan over blocks of the input.
+    void ExclusiveScan(WGPUBuffer data, uint32_t count);
+
+    // Stable in-place sort of `count` keys, 4 bits per pass, least significant
+    // digit first. `payload` (one u32 per key) may be null.
+    void RadixSort(WGPUBuffer keys, WGPUBuffer payload, uint32_t count, SortKeyWidth key_width = SortKeyWidth::Bits32);
+
+    // Copy the values of `input` whose flag is not zero to the front of
+    // `output`, in order, and write how many were kept to `output_count[0]`.
+    void Compact(WGPUBuffer input, WGPUBuffer flags, uint32_t count, WGPUBuffer output, WGPUBuffer output_count);
+
+    // Count the values of `values` falling in each of `bin_count` bins (a
+    // power of two up to 256), the bin being (value >> shift) & (bin_count - 1).
+    // The counts are written to `bins`, overwriting previous contents.
+    void Histogram(WGPUBuffer values, uint32_t count, WGPUBuffer bins, uint32_t bin_count, uint32_t shift = 0);
+
+    // Set the first `count` values of `data` to `value`
+    void Fill(WGPUBuffer data, uint32_t count, uint32_t value);
+
+private:
+    // Return a uniform buffer holding the parameters of one dispatch. The
+    // buffers are kept and reused once the dispatches using them are
+    // submitted, so they must not be released by the caller.
+    WGPUBuffer AcquireParams(std::initializer_list<uint32_t> values);
+
+    // Return a storage buffer of at least `size` bytes, reallocating `buffer`
+    // when it is too small.
+    WGPUBuffer EnsureScratch(WGPUBuffer& buffer, uint64_t size, char const* label);
+
+    void ScanLevel(WGPUBuffer data, uint32_t count, uint32_t level);
+    void DispatchBlocks(ComputeKernel const& kernel, std::initializer_list<WGPUBuffer> buffers, uint32_t block_count);
+
+    ComputeContext* m_compute = nullptr;
+
+    ComputeKernel* m_scan_reduce = nullptr;
+    ComputeKernel* m_scan_add = nullptr;
+    ComputeKernel* m_fill = nullptr;
+    ComputeKernel* m_histogram = nullptr;
+    ComputeKernel* m_compact_flags = nullptr;
+    ComputeKernel* m_compact_scatter = nullptr;
+    ComputeKernel* m_radix_histogram = nullptr;
+    ComputeKernel* m_radix_scatter = nullptr;
+
+    // Block sums of each level of the scan recursion
+    std::vector<WGPUBuffer> m_scan_levels;
+    WGPUBuffer m_compact_offsets = nullptr;
+    WGPUBuffer m_sort_keys = nullptr;
+    WGPUBuffer m_sort_payload = nullptr;
+    WGPUBuffer m_sort_histograms = nullptr;
+    // Parameter buffers, the first m_params_used of which are bound by
+    // dispatches not submitted yet
+    std::vector<WGPUBuffer> m_params;
+    size_t m_params_used = 0;
+    // Bound in place of optional buffers
+    WGPUBuffer m_dummy = nullptr;
+};
+
+/**
+ * CPU reference implementations, used to validate the GPU results.
+ */
+void cpuExclusiveScan(std::vector<uint32_t>& data);
+void cpuRadixSort(std::vector<uint32_t>& keys, std::vector<uint32_t>* payload, SortKeyWidth key_width = SortKeyWidth::Bits32);
+std::vector<uint32_t> cpuCompact(std::vector<uint32_t> const& input, std::vector<uint32_t> const& flags);
+std::vector<uint32_t> cpuHistogram(std::vector<uint32_t> const& values, uint32_t bin_count, uint32_t shift = 0);
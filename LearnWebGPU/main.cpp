@@ -1,12 +1,25 @@
 #include "application.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <string_view>
 
-int main()
+int main(int argc, char* argv[])
 {
     Application app;
 
-    if (!app.Initialize())
+    bool exclusive_fullscreen = false;
+    int window_count = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::string_view(argv[i]) == "--fullscreen")
+            exclusive_fullscreen = true;
+        else if (std::string_view(argv[i]) == "--windows" && i + 1 < argc)
+            window_count = std::max(1, std::atoi(argv[++i]));
+    }
+
+    if (!app.Initialize(exclusive_fullscreen, window_count))
     {
         return 1;
     }
@@ -21,12 +34,15 @@ int main()
     emscripten_set_main_loop_arg(callback, &app, 0, true);
 
 #else // __EMSCRIPTEN
-    
+
+    // This thread only handles window events, the scene is simulated and
+    // rendered on threads of their own
+    app.StartThreads();
     while (app.IsRunning())
     {
-        app.MainLoop();
-    
+        app.ProcessEvents();
     }
+    app.StopThreads();
 
 #endif // __EMSCRIPTEN__
 
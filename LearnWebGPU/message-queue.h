@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <semaphore>
+
+/**
+ * Queue of messages from one producer thread to one consumer thread.
+ *
+ * Push() and Pop() never lock: the messages live in a ring of fixed capacity,
+ * the producer only writes the tail index and the consumer only writes the
+ * head index. The consumer may also sleep in Wait() until the next Push(),
+ * which is the only use of the semaphore, so a producer is never blocked by
+ * a slow consumer.
+ */
+template <typename T, size_t Capacity>
+class MessageQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side, return false when the queue is full
+    bool Push(T const& message)
+    {
+        size_t const tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        m_messages[tail & (Capacity - 1)] = message;
+        m_tail.store(tail + 1, std::memory_order_release);
+        m_signal.release();
+        return true;
+    }
+
+    // Consumer side, return false when the queue is empty
+    bool Pop(T& message)
+    {
+        size_t const head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        message = m_messages[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, sleep until a message is pushed or `seconds` went by
+    void Wait(double seconds)
+    {
+        if (m_head.load(std::memory_order_relaxed) != m_tail.load(std::memory_order_acquire))
+            return;
+
+        if (m_signal.try_acquire_for(std::chrono::duration<double>(seconds)))
+        {
+            // One signal per push, the messages already popped left theirs
+            while (m_signal.try_acquire())
+            {
+            }
+        }
+    }
+
+private:
+    std::array<T, Capacity> m_messages = {};
+
+    // Kept on separate cache lines, as each is written by a different thread
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+
+    std::counting_semaphore<> m_signal{ 0 };
+};
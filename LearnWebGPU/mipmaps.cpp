@@ -0,0 +1,553 @@
+#include "mipmaps.h"
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Side of the square workgroup, and so of the tile reduced in workgroup
+    // memory; a 16x16 tile goes down by 4 levels before reaching one texel.
+    constexpr uint32_t kTileSize = 16;
+    constexpr uint32_t kMaxMipsPerDispatch = 4;
+
+    // WGSL name of the storage formats the compute path can write
+    char const* storageFormatName(WGPUTextureFormat format)
+    {
+        switch (format)
+        {
+        case WGPUTextureFormat_RGBA8Unorm: return "rgba8unorm";
+        case WGPUTextureFormat_RGBA8Snorm: return "rgba8snorm";
+        case WGPUTextureFormat_RGBA16Float: return "rgba16float";
+        case WGPUTextureFormat_RGBA32Float: return "rgba32float";
+        case WGPUTextureFormat_R32Float: return "r32float";
+        case WGPUTextureFormat_RG32Float: return "rg32float";
+        default: return nullptr;
+        }
+    }
+
+    bool isSrgbFormat(WGPUTextureFormat format)
+    {
+        return format == WGPUTextureFormat_RGBA8UnormSrgb || format == WGPUTextureFormat_BGRA8UnormSrgb;
+    }
+
+    bool isSnormFormat(WGPUTextureFormat format)
+    {
+        return format == WGPUTextureFormat_RGBA8Snorm;
+    }
+
+    // decode() turns a stored texel into the space it is filtered in,
+    // reduce4() filters four texels and encode() turns the result back.
+    // Texels of an snorm format already load in [-1, 1].
+    std::string filterSource(MipFilter filter, bool snorm)
+    {
+        std::string source;
+        switch (filter)
+        {
+        case MipFilter::Average:
+            source = R"(
+fn decode(texel: vec4<f32>) -> vec4<f32> { return texel; }
+fn encode(value: vec4<f32>) -> vec4<f32> { return value; }
+fn reduce4(a: vec4<f32>, b: vec4<f32>, c: vec4<f32>, d: vec4<f32>) -> vec4<f32> {
+    return (a + b + c + d) * 0.25;
+}
+)";
+            break;
+
+        case MipFilter::Srgb:
+            source = R"(
+fn decode(texel: vec4<f32>) -> vec4<f32> {
+    let c = texel.rgb;
+    let linear = select(pow((c + 0.055) / 1.055, vec3<f32>(2.4)), c / 12.92, c <= vec3<f32>(0.04045));
+    return vec4<f32>(linear, texel.a);
+}
+fn encode(value: vec4<f32>) -> vec4<f32> {
+    let c = max(value.rgb, vec3<f32>(0.0));
+    let srgb = select(1.055 * pow(c, vec3<f32>(1.0 / 2.4)) - 0.055, c * 12.92, c <= vec3<f32>(0.0031308));
+    return vec4<f32>(srgb, value.a);
+}
+fn reduce4(a: vec4<f32>, b: vec4<f32>, c: vec4<f32>, d: vec4<f32>) -> vec4<f32> {
+    return (a + b + c + d) * 0.25;
+}
+)";
+            break;
+
+        case MipFilter::NormalMap:
+            if (snorm)
+            {
+                source = R"(
+fn decode(texel: vec4<f32>) -> vec4<f32> { return texel; }
+fn encode(value: vec4<f32>) -> vec4<f32> { return value; }
+)";
+            }
+            else
+            {
+                source = R"(
+fn decode(texel: vec4<f32>) -> vec4<f32> { return vec4<f32>(texel.xyz * 2.0 - 1.0, texel.w); }
+fn encode(value: vec4<f32>) -> vec4<f32> { return vec4<f32>(value.xyz * 0.5 + 0.5, value.w); }
+)";
+            }
+            source += R"(
+fn reduce4(a: vec4<f32>, b: vec4<f32>, c: vec4<f32>, d: vec4<f32>) -> vec4<f32> {
+    let sum = a + b + c + d;
+    let length_squared = dot(sum.xyz, sum.xyz);
+    let normal = select(vec3<f32>(0.0, 0.0, 1.0), sum.xyz * inverseSqrt(length_squared), length_squared > 0.0);
+    return vec4<f32>(normal, sum.w * 0.25);
+}
+)";
+            break;
+
+        case MipFilter::DepthMin:
+            source = R"(
+fn decode(texel: vec4<f32>) -> vec4<f32> { return texel; }
+fn encode(value: vec4<f32>) -> vec4<f32> { return value; }
+fn reduce4(a: vec4<f32>, b: vec4<f32>, c: vec4<f32>, d: vec4<f32>) -> vec4<f32> {
+    return min(min(a, b), min(c, d));
+}
+)";
+            break;
+
+        case MipFilter::DepthMax:
+            source = R"(
+fn decode(texel: vec4<f32>) -> vec4<f32> { return texel; }
+fn encode(value: vec4<f32>) -> vec4<f32> { return value; }
+fn reduce4(a: vec4<f32>, b: vec4<f32>, c: vec4<f32>, d: vec4<f32>) -> vec4<f32> {
+    return max(max(a, b), max(c, d));
+}
+)";
+            break;
+        }
+
+        // Loads are clamped, so odd sizes repeat their last row and column
+        source += R"(
+@group(0) @binding(0) var source: texture_2d<f32>;
+
+fn load_source(coord: vec2<u32>) -> vec4<f32> {
+    let size = textureDimensions(source);
+    return decode(textureLoad(source, vec2<i32>(min(coord, size - 1u)), 0));
+}
+
+fn load_quad(coord: vec2<u32>) -> vec4<f32> {
+    return reduce4(load_source(coord), load_source(coord + vec2<u32>(1u, 0u)),
+                   load_source(coord + vec2<u32>(0u, 1u)), load_source(coord + vec2<u32>(1u, 1u)));
+}
+)";
+        return source;
+    }
+
+    // Kernel writing `mip_count` levels below its source level
+    std::string downsampleSource(WGPUTextureFormat format, MipFilter filter, uint32_t mip_count)
+    {
+        char const* format_name = storageFormatName(format);
+        std::string source = filterSource(filter, isSnormFormat(format));
+
+        for (uint32_t mip = 1; mip <= mip_count; ++mip)
+        {
+            source += "@group(0) @binding(" + std::to_string(mip) + ") var mip_" + std::to_string(mip)
+                + ": texture_storage_2d<" + format_name + ", write>;\n";
+        }
+
+        source += R"(
+var<workgroup> tile: array<vec4<f32>, 256>;
+
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn downsample(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+              @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let tile_index = local_id.y * 16u + local_id.x;
+    let coord_1 = workgroup_id.xy * 16u + local_id.xy;
+    var value = load_quad(coord_1 * 2u);
+    if (all(coord_1 < textureDimensions(mip_1))) {
+        textureStore(mip_1, vec2<i32>(coord_1), encode(value));
+    }
+    tile[tile_index] = value;
+)";
+
+        // Each further level halves the active part of the tile
+        for (uint32_t mip = 2; mip <= mip_count; ++mip)
+        {
+            std::string m = std::to_string(mip);
+            std::string size = std::to_string(kTileSize >> (mip - 1)) + "u";
+            source += R"(
+    workgroupBarrier();
+    let active_)" + m + " = local_id.x < " + size + " && local_id.y < " + size + R"(;
+    if (active_)" + m + R"() {
+        let t = local_id.xy * 2u;
+        value = reduce4(tile[t.y * 16u + t.x], tile[t.y * 16u + t.x + 1u],
+                        tile[(t.y + 1u) * 16u + t.x], tile[(t.y + 1u) * 16u + t.x + 1u]);
+    }
+    workgroupBarrier();
+    if (active_)" + m + R"() {
+        tile[tile_index] = value;
+        let coord = workgroup_id.xy * )" + size + R"( + local_id.xy;
+        if (all(coord < textureDimensions(mip_)" + m + R"())) {
+            textureStore(mip_)" + m + R"(, vec2<i32>(coord), encode(value));
+        }
+    }
+)";
+        }
+
+        source += "}\n";
+        return source;
+    }
+
+    std::string renderSource(WGPUTextureFormat format, MipFilter filter)
+    {
+        return filterSource(filter, isSnormFormat(format)) + R"(
+@vertex
+fn vs_main(@builtin(vertex_index) vertex_index: u32) -> @builtin(position) vec4<f32> {
+    // Fullscreen triangle
+    let uv = vec2<f32>(f32((vertex_index << 1u) & 2u), f32(vertex_index & 2u));
+    return vec4<f32>(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+
+@fragment
+fn fs_main(@builtin(position) position: vec4<f32>) -> @location(0) vec4<f32> {
+    return encode(load_quad(vec2<u32>(position.xy) * 2u));
+}
+)";
+    }
+
+    WGPUTextureView createMipView(WGPUTexture texture, uint32_t mip_level, char const* label)
+    {
+        WGPUTextureViewDescriptor view_descriptor = {};
+        view_descriptor.nextInChain = nullptr;
+        view_descriptor.label = label;
+        view_descriptor.format = wgpuTextureGetFormat(texture);
+        view_descriptor.dimension = WGPUTextureViewDimension_2D;
+        view_descriptor.baseMipLevel = mip_level;
+        view_descriptor.mipLevelCount = 1;
+        view_descriptor.baseArrayLayer = 0;
+        view_descriptor.arrayLayerCount = 1;
+        view_descriptor.aspect = WGPUTextureAspect_All;
+        return wgpuTextureCreateView(texture, &view_descriptor);
+    }
+}
+
+bool MipmapGenerator::Initialize(ComputeContext& compute)
+{
+    m_compute = &compute;
+    m_device = compute.GetDevice();
+
+    // Every level written by a dispatch is a storage texture binding
+    m_mips_per_dispatch = std::min(kMaxMipsPerDispatch, compute.GetLimits().maxStorageTexturesPerShaderStage);
+    if (m_mips_per_dispatch == 0)
+    {
+        std::cerr << "Storage textures are not supported, mipmaps will use render passes" << std::endl;
+    }
+
+    return true;
+}
+
+void MipmapGenerator::Terminate()
+{
+    for (auto& [key, pipeline] : m_render_pipelines)
+    {
+        if (pipeline)
+            wgpuRenderPipelineRelease(pipeline);
+    }
+    m_render_pipelines.clear();
+
+    // Kernels are owned by the compute context
+    m_kernels.clear();
+    m_compute = nullptr;
+}
+
+uint32_t MipmapGenerator::MipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t size = std::max(width, height);
+    uint32_t count = 1;
+    while (size > 1)
+    {
+        size /= 2;
+        ++count;
+    }
+    return count;
+}
+
+ComputeKernel* MipmapGenerator::GetKernel(WGPUTextureFormat format, MipFilter filter, uint32_t mip_count)
+{
+    auto key = std::make_tuple(format, filter, mip_count);
+    auto it = m_kernels.find(key);
+    if (it != m_kernels.end())
+        return it->second;
+
+    // The layout is explicit because the source may be an unfilterable
+    // format (r32float, rgba32float), which a deduced layout would not accept.
+    std::vector<WGPUBindGroupLayoutEntry> entries(mip_count + 1);
+    for (uint32_t binding = 0; binding <= mip_count; ++binding)
+    {
+        WGPUBindGroupLayoutEntry& entry = entries[binding];
+        entry = {};
+        entry.nextInChain = nullptr;
+        entry.binding = binding;
+        entry.visibility = WGPUShaderStage_Compute;
+        if (binding == 0)
+        {
+            entry.texture.sampleType = WGPUTextureSampleType_UnfilterableFloat;
+            entry.texture.viewDimension = WGPUTextureViewDimension_2D;
+            entry.texture.multisampled = false;
+        }
+        else
+        {
+            entry.storageTexture.access = WGPUStorageTextureAccess_WriteOnly;
+            entry.storageTexture.format = format;
+            entry.storageTexture.viewDimension = WGPUTextureViewDimension_2D;
+        }
+    }
+
+    WGPUBindGroupLayoutDescriptor bind_group_layout_descriptor = {};
+    bind_group_layout_descriptor.nextInChain = nullptr;
+    bind_group_layout_descriptor.label = "Mipmap bind group layout";
+    bind_group_layout_descriptor.entryCount = entries.size();
+    bind_group_layout_descriptor.entries = entries.data();
+    WGPUBindGroupLayout bind_group_layout = wgpuDeviceCreateBindGroupLayout(m_device, &bind_group_layout_descriptor);
+
+    WGPUPipelineLayoutDescriptor pipeline_layout_descriptor = {};
+    pipeline_layout_descriptor.nextInChain = nullptr;
+    pipeline_layout_descriptor.label = "Mipmap pipeline layout";
+    pipeline_layout_descriptor.bindGroupLayoutCount = 1;
+    pipeline_layout_descriptor.bindGroupLayouts = &bind_group_layout;
+    WGPUPipelineLayout pipeline_layout = wgpuDeviceCreatePipelineLayout(m_device, &pipeline_layout_descriptor);
+
+    ComputeKernel* kernel = m_compute->CreateKernel("Mipmap downsample", downsampleSource(format, filter, mip_count), "downsample", 2, pipeline_layout);
+
+    wgpuPipelineLayoutRelease(pipeline_layout);
+    wgpuBindGroupLayoutRelease(bind_group_layout);
+
+    // The tile logic assumes 16x16 workgroups, which every device supports
+    if (kernel && (kernel->GetWorkgroupSize().x != kTileSize || kernel->GetWorkgroupSize().y != kTileSize))
+        kernel = nullptr;
+
+    m_kernels[key] = kernel;
+    return kernel;
+}
+
+WGPURenderPipeline MipmapGenerator::GetRenderPipeline(WGPUTextureFormat format, MipFilter filter)
+{
+    auto key = std::make_tuple(format, filter);
+    auto it = m_render_pipelines.find(key);
+    if (it != m_render_pipelines.end())
+        return it->second;
+
+    std::string code = renderSource(format, filter);
+
+    WGPUShaderModuleWGSLDescriptor wgsl_descriptor = {};
+    wgsl_descriptor.chain.next = nullptr;
+    wgsl_descriptor.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+    wgsl_descriptor.code = code.c_str();
+
+    WGPUShaderModuleDescriptor shader_descriptor = {};
+    shader_descriptor.nextInChain = &wgsl_descriptor.chain;
+    shader_descriptor.label = "Mipmap render shader";
+#ifdef WEBGPU_BACKEND_WGPU
+    shader_descriptor.hintCount = 0;
+    shader_descriptor.hints = nullptr;
+#endif // WEBGPU_BACKEND_WGPU
+    WGPUShaderModule shader_module = wgpuDeviceCreateShaderModule(m_device, &shader_descriptor);
+
+    WGPUColorTargetState color_target = {};
+    color_target.nextInChain = nullptr;
+    color_target.format = format;
+    color_target.blend = nullptr;
+    color_target.writeMask = WGPUColorWriteMask_All;
+
+    WGPUFragmentState fragment_state = {};
+    fragment_state.nextInChain = nullptr;
+    fragment_state.module = shader_module;
+    fragment_state.entryPoint = "fs_main";
+    fragment_state.constantCount = 0;
+    fragment_state.constants = nullptr;
+    fragment_state.targetCount = 1;
+    fragment_state.targets = &color_target;
+
+    WGPURenderPipelineDescriptor pipeline_descriptor = {};
+    pipeline_descriptor.nextInChain = nullptr;
+    pipeline_descriptor.label = "Mipmap render pipeline";
+    pipeline_descriptor.layout = nullptr; // deduced from the shader
+    pipeline_descriptor.vertex.nextInChain = nullptr;
+    pipeline_descriptor.vertex.module = shader_module;
+    pipeline_descriptor.vertex.entryPoint = "vs_main";
+    pipeline_descriptor.vertex.constantCount = 0;
+    pipeline_descriptor.vertex.constants = nullptr;
+    pipeline_descriptor.vertex.bufferCount = 0;
+    pipeline_descriptor.vertex.buffers = nullptr;
+    pipeline_descriptor.primitive.nextInChain = nullptr;
+    pipeline_descriptor.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+    pipeline_descriptor.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+    pipeline_descriptor.primitive.frontFace = WGPUFrontFace_CCW;
+    pipeline_descriptor.primitive.cullMode = WGPUCullMode_None;
+    pipeline_descriptor.depthStencil = nullptr;
+    pipeline_descriptor.multisample.nextInChain = nullptr;
+    pipeline_descriptor.multisample.count = 1;
+    pipeline_descriptor.multisample.mask = ~0u;
+    pipeline_descriptor.multisample.alphaToCoverageEnabled = false;
+    pipeline_descriptor.fragment = &fragment_state;
+
+    WGPURenderPipeline pipeline = wgpuDeviceCreateRenderPipeline(m_device, &pipeline_descriptor);
+    wgpuShaderModuleRelease(shader_module);
+
+    m_render_pipelines[key] = pipeline;
+    return pipeline;
+}
+
+bool MipmapGenerator::Generate(WGPUTexture texture, MipFilter filter)
+{
+    if (wgpuTextureGetMipLevelCount(texture) < 2)
+        return true;
+
+    WGPUTextureFormat format = wgpuTextureGetFormat(texture);
+    WGPUTextureUsageFlags usage = wgpuTextureGetUsage(texture);
+
+    // Loads from an sRGB format return linear values and stores encode them
+    // back, so the shader already averages in linear space
+    if (filter == MipFilter::Srgb && isSrgbFormat(format))
+        filter = MipFilter::Average;
+
+    if (!(usage & WGPUTextureUsage_TextureBinding))
+    {
+        std::cerr << "Mipmaps need a texture with the TextureBinding usage" << std::endl;
+        return false;
+    }
+
+    bool const storage_capable = storageFormatName(format) != nullptr && m_mips_per_dispatch > 0;
+    if (storage_capable && (usage & WGPUTextureUsage_StorageBinding) && GetKernel(format, filter, 1))
+    {
+        GenerateCompute(texture, filter);
+        return true;
+    }
+
+    if (usage & WGPUTextureUsage_RenderAttachment)
+        return GenerateRender(texture, filter);
+
+    std::cerr << "Mipmaps need a texture with the StorageBinding or RenderAttachment usage" << std::endl;
+    return false;
+}
+
+void MipmapGenerator::GenerateCompute(WGPUTexture texture, MipFilter filter)
+{
+    WGPUTextureFormat format = wgpuTextureGetFormat(texture);
+    uint32_t const level_count = wgpuTextureGetMipLevelCount(texture);
+    uint32_t const width = wgpuTextureGetWidth(texture);
+    uint32_t const height = wgpuTextureGetHeight(texture);
+
+    // All the dispatches land in the same compute pass, each one reading the
+    // last level written by the previous one.
+    uint32_t mip_count = 0;
+    for (uint32_t source_level = 0; source_level + 1 < level_count; source_level += mip_count)
+    {
+        mip_count = std::min(m_mips_per_dispatch, level_count - 1 - source_level);
+        ComputeKernel* kernel = GetKernel(format, filter, mip_count);
+        if (!kernel)
+        {
+            // Generate() made sure the single level kernel exists
+            mip_count = 1;
+            kernel = GetKernel(format, filter, mip_count);
+        }
+
+        std::vector<WGPUTextureView> views;
+        std::vector<WGPUBindGroupEntry> entries;
+        for (uint32_t mip = 0; mip <= mip_count; ++mip)
+        {
+            views.push_back(createMipView(texture, source_level + mip, "Mipmap level view"));
+
+            WGPUBindGroupEntry entry = {};
+            entry.nextInChain = nullptr;
+            entry.binding = mip;
+            entry.textureView = views.back();
+            entries.push_back(entry);
+        }
+
+        WGPUBindGroupLayout layout = wgpuComputePipelineGetBindGroupLayout(kernel->GetPipeline(), 0);
+
+        WGPUBindGroupDescriptor bind_group_descriptor = {};
+        bind_group_descriptor.nextInChain = nullptr;
+        bind_group_descriptor.label = "Mipmap bind group";
+        bind_group_descriptor.layout = layout;
+        bind_group_descriptor.entryCount = entries.size();
+        bind_group_descriptor.entries = entries.data();
+        WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(m_device, &bind_group_descriptor);
+
+        // One invocation per texel of the first level written
+        uint32_t first_width = std::max(width >> (source_level + 1), 1u);
+        uint32_t first_height = std::max(height >> (source_level + 1), 1u);
+        m_compute->Dispatch(*kernel, { bind_group }, first_width, first_height);
+
+        wgpuBindGroupRelease(bind_group);
+        wgpuBindGroupLayoutRelease(layout);
+        for (WGPUTextureView view : views)
+            wgpuTextureViewRelease(view);
+    }
+}
+
+bool MipmapGenerator::GenerateRender(WGPUTexture texture, MipFilter filter)
+{
+    WGPURenderPipeline pipeline = GetRenderPipeline(wgpuTextureGetFormat(texture), filter);
+    if (!pipeline)
+    {
+        std::cerr << "Could not create mipmap render pipeline" << std::endl;
+        return false;
+    }
+    WGPUDevice device = m_device;
+
+    // Recorded with the other queued work, so the order with compute jobs
+    // that produce or consume the texture is preserved
+    wgpuTextureReference(texture);
+    m_compute->QueueCommands([device, pipeline, texture](WGPUCommandEncoder encoder)
+        {
+            WGPUBindGroupLayout layout = wgpuRenderPipelineGetBindGroupLayout(pipeline, 0);
+            uint32_t const level_count = wgpuTextureGetMipLevelCount(texture);
+
+            for (uint32_t level = 1; level < level_count; ++level)
+            {
+                WGPUTextureView source_view = createMipView(texture, level - 1, "Mipmap source view");
+                WGPUTextureView target_view = createMipView(texture, level, "Mipmap target view");
+
+                WGPUBindGroupEntry entry = {};
+                entry.nextInChain = nullptr;
+                entry.binding = 0;
+                entry.textureView = source_view;
+
+                WGPUBindGroupDescriptor bind_group_descriptor = {};
+                bind_group_descriptor.nextInChain = nullptr;
+                bind_group_descriptor.label = "Mipmap bind group";
+                bind_group_descriptor.layout = layout;
+                bind_group_descriptor.entryCount = 1;
+                bind_group_descriptor.entries = &entry;
+                WGPUBindGroup bind_group = wgpuDeviceCreateBindGroup(device, &bind_group_descriptor);
+
+                WGPURenderPassColorAttachment color_attachment = {};
+                color_attachment.view = target_view;
+                color_attachment.resolveTarget = nullptr;
+                color_attachment.loadOp = WGPULoadOp_Clear;
+                color_attachment.storeOp = WGPUStoreOp_Store;
+                color_attachment.clearValue = WGPUColor{ 0.0, 0.0, 0.0, 0.0 };
+#ifndef WEBGPU_BACKEND_WGPU
+                color_attachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+#endif // !WEBGPU_BACKEND_WGPU
+
+                WGPURenderPassDescriptor render_pass_descriptor = {};
+                render_pass_descriptor.nextInChain = nullptr;
+                render_pass_descriptor.label = "Mipmap render pass";
+                render_pass_descriptor.colorAttachmentCount = 1;
+                render_pass_descriptor.colorAttachments = &color_attachment;
+                render_pass_descriptor.depthStencilAttachment = nullptr;
+                render_pass_descriptor.timestampWrites = nullptr;
+
+                WGPURenderPassEncoder render_pass = wgpuCommandEncoderBeginRenderPass(encoder, &render_pass_descriptor);
+                wgpuRenderPassEncoderSetPipeline(render_pass, pipeline);
+                wgpuRenderPassEncoderSetBindGroup(render_pass, 0, bind_group, 0, nullptr);
+                wgpuRenderPassEncoderDraw(render_pass, 3, 1, 0, 0);
+                wgpuRenderPassEncoderEnd(render_pass);
+                wgpuRenderPassEncoderRelease(render_pass);
+
+                wgpuBindGroupRelease(bind_group);
+                wgpuTextureViewRelease(target_view);
+                wgpuTextureViewRelease(source_view);
+            }
+
+            wgpuBindGroupLayoutRelease(layout);
+            wgpuTextureRelease(texture);
+        });
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "compute.h"
+
+#include <webgpu/webgpu.h>
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+
+/**
+ * How texels are combined when going down one mip level.
+ */
+enum class MipFilter
+{
+    Average,    // box filter
+    Srgb,       // box filter in linear space, for sRGB data in a non-sRGB format
+    NormalMap,  // box filter of normals, renormalized; [0, 1] encoded in
+                // unorm formats, stored as is in snorm formats
+    DepthMin,   // minimum of the red channel, for Hi-Z pyramids
+    DepthMax,   // maximum of the red channel, for Hi-Z pyramids
+};
+
+/**
+ * Fill the mip chain of a 2D texture from its first level.
+ *
+ * Textures in a storage-capable format are downsampled in compute: each
+ * dispatch reads one level and writes up to four levels below it (bounded by
+ * maxStorageTexturesPerShaderStage), a 16x16 workgroup reducing its 32x32
+ * source tile in workgroup memory. All the dispatches of a chain are recorded
+ * in the same compute pass, so a 12 level chain takes 3 dispatches. Other
+ * formats (sRGB, BGRA8) fall back to one render pass per level.
+ *
+ * Work is queued on the ComputeContext like any other compute job.
+ */
+class MipmapGenerator
+{
+public:
+    bool Initialize(ComputeContext& compute);
+    void Terminate();
+
+    // Queue the generation of levels 1 and up of `texture`. The texture needs
+    // the TextureBinding usage, plus StorageBinding for the compute path or
+    // RenderAttachment for the fallback. Return false if it has neither, or
+    // if no pipeline could be created for it.
+    bool Generate(WGPUTexture texture, MipFilter filter = MipFilter::Average);
+
+    // Number of levels of a full mip chain for the given size
+    static uint32_t MipLevelCount(uint32_t width, uint32_t height);
+
+private:
+    ComputeKernel* GetKernel(WGPUTextureFormat format, MipFilter filter, uint32_t mip_count);
+    WGPURenderPipeline GetRenderPipeline(WGPUTextureFormat format, MipFilter filter);
+
+    void GenerateCompute(WGPUTexture texture, MipFilter filter);
+    bool GenerateRender(WGPUTexture texture, MipFilter filter);
+
+    ComputeContext* m_compute = nullptr;
+    WGPUDevice m_device = nullptr;
+
+    uint32_t m_mips_per_dispatch = 4;
+
+    // Kernels are owned by the compute context
+    std::map<std::tuple<WGPUTextureFormat, MipFilter, uint32_t>, ComputeKernel*> m_kernels;
+    std::map<std::tuple<WGPUTextureFormat, MipFilter>, WGPURenderPipeline> m_render_pipelines;
+};
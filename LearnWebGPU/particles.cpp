@@ -0,0 +1,480 @@
+#include "particles.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    char const* const kParticleSource = R"(
+struct Particle {
+    position: vec3<f32>,
+    age: f32,
+    velocity: vec3<f32>,
+    lifetime: f32,
+    color: vec4<f32>,
+}
+
+struct SimulationParams {
+    emitter: vec4<f32>,
+    gravity: vec4<f32>,
+    delta_time: f32,
+    time: f32,
+    emit_count: u32,
+    capacity: u32,
+    min_lifetime: f32,
+    max_lifetime: f32,
+    speed: f32,
+    frame: u32,
+}
+
+struct Camera {
+    eye: vec4<f32>,
+    look_at: vec4<f32>,
+    aspect_ratio: f32,
+    focal_length: f32,
+    particle_size: f32,
+    unused: f32,
+}
+
+fn hash(value: u32) -> u32 {
+    // PCG hash
+    let state = value * 747796405u + 2891336453u;
+    let word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+fn random_float(seed: ptr<function, u32>) -> f32 {
+    *seed = hash(*seed);
+    return f32(*seed) / 4294967295.0;
+}
+)";
+
+    char const* const kIntegrateSource = R"(
+@group(0) @binding(0) var<uniform> params: SimulationParams;
+@group(0) @binding(1) var<storage, read_write> particles: array<Particle>;
+@group(0) @binding(2) var<storage, read_write> alive_flags: array<u32>;
+@group(0) @binding(3) var<storage, read_write> dead_flags: array<u32>;
+
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn integrate(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+             @builtin(num_workgroups) num_workgroups: vec3<u32>,
+             @builtin(local_invocation_index) local_index: u32) {
+    let index = global_index_1d(workgroup_id, local_index, num_workgroups);
+    if (index >= params.capacity) {
+        return;
+    }
+
+    var particle = particles[index];
+    var alive = particle.age < particle.lifetime;
+    if (alive) {
+        let dt = params.delta_time;
+        particle.velocity = (particle.velocity + params.gravity.xyz * dt) * max(1.0 - params.gravity.w * dt, 0.0);
+        particle.position = particle.position + particle.velocity * dt;
+        particle.age = particle.age + dt;
+        particle.color.a = 1.0 - particle.age / particle.lifetime;
+        alive = particle.age < particle.lifetime;
+        particles[index] = particle;
+    }
+
+    alive_flags[index] = select(0u, 1u, alive);
+    dead_flags[index] = select(1u, 0u, alive);
+}
+)";
+
+    char const* const kEmitSource = R"(
+@group(0) @binding(0) var<uniform> params: SimulationParams;
+@group(0) @binding(1) var<storage, read_write> particles: array<Particle>;
+@group(0) @binding(2) var<storage, read_write> alive_flags: array<u32>;
+@group(0) @binding(3) var<storage, read> dead_slots: array<u32>;
+@group(0) @binding(4) var<storage, read> dead_count: array<u32>;
+
+// Respawn particles in the first emit_count dead slots (if there are enough)
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn emit(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+        @builtin(num_workgroups) num_workgroups: vec3<u32>,
+        @builtin(local_invocation_index) local_index: u32) {
+    let index = global_index_1d(workgroup_id, local_index, num_workgroups);
+    if (index >= params.emit_count || index >= dead_count[0]) {
+        return;
+    }
+
+    let slot = dead_slots[index];
+    var seed = hash(slot ^ hash(params.frame));
+
+    // Uniform direction in a cone around +y
+    let angle = random_float(&seed) * 6.2831853;
+    let height = mix(0.6, 1.0, random_float(&seed));
+    let radius = sqrt(1.0 - height * height);
+    let direction = vec3<f32>(radius * cos(angle), height, radius * sin(angle));
+    let offset = (vec3<f32>(random_float(&seed), random_float(&seed), random_float(&seed)) - 0.5) * params.emitter.w;
+
+    var particle: Particle;
+    particle.position = params.emitter.xyz + offset;
+    particle.velocity = direction * params.speed * mix(0.5, 1.0, random_float(&seed));
+    particle.age = 0.0;
+    particle.lifetime = mix(params.min_lifetime, params.max_lifetime, random_float(&seed));
+    particle.color = vec4<f32>(mix(vec3<f32>(1.0, 0.8, 0.3), vec3<f32>(0.3, 0.5, 1.0), random_float(&seed)), 1.0);
+
+    particles[slot] = particle;
+    alive_flags[slot] = 1u;
+}
+)";
+
+    char const* const kSortKeysSource = R"(
+@group(0) @binding(0) var<uniform> camera: Camera;
+@group(0) @binding(1) var<storage, read> particles: array<Particle>;
+@group(0) @binding(2) var<storage, read> alive_slots: array<u32>;
+@group(0) @binding(3) var<storage, read> alive_count: array<u32>;
+@group(0) @binding(4) var<storage, read_write> depth_keys: array<u32>;
+@group(0) @binding(5) var<storage, read_write> draw_order: array<u32>;
+
+// Keys sort far particles first. The live count is only known on the GPU, so
+// the whole capacity is sorted and unused entries get the largest key.
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn sort_keys(@builtin(workgroup_id) workgroup_id: vec3<u32>,
+             @builtin(num_workgroups) num_workgroups: vec3<u32>,
+             @builtin(local_invocation_index) local_index: u32) {
+    let index = global_index_1d(workgroup_id, local_index, num_workgroups);
+    if (index >= arrayLength(&depth_keys)) {
+        return;
+    }
+
+    if (index >= alive_count[0]) {
+        depth_keys[index] = 0xffffffffu;
+        draw_order[index] = 0u;
+        return;
+    }
+
+    let slot = alive_slots[index];
+    let forward = normalize(camera.look_at.xyz - camera.eye.xyz);
+    let depth = max(dot(particles[slot].position - camera.eye.xyz, forward), 0.0);
+    // Positive floats compare like their bit patterns
+    depth_keys[index] = 0xfffffffeu - bitcast<u32>(depth);
+    draw_order[index] = slot;
+}
+)";
+
+    char const* const kDrawArgsSource = R"(
+@group(0) @binding(0) var<storage, read> alive_count: array<u32>;
+@group(0) @binding(1) var<storage, read_write> draw_arguments: array<u32>;
+
+@compute @workgroup_size(WORKGROUP_SIZE_X, WORKGROUP_SIZE_Y, WORKGROUP_SIZE_Z)
+fn draw_args(@builtin(local_invocation_index) local_index: u32) {
+    if (local_index == 0u) {
+        draw_arguments[0] = 6u; // two triangles per particle
+        draw_arguments[1] = alive_count[0];
+        draw_arguments[2] = 0u;
+        draw_arguments[3] = 0u;
+    }
+}
+)";
+
+    char const* const kRenderSource = R"(
+@group(0) @binding(0) var<uniform> camera: Camera;
+@group(0) @binding(1) var<storage, read> particles: array<Particle>;
+@group(0) @binding(2) var<storage, read> draw_order: array<u32>;
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) color: vec4<f32>,
+    @location(1) corner: vec2<f32>,
+}
+
+@vertex
+fn vs_main(@builtin(vertex_index) vertex_index: u32, @builtin(instance_index) instance_index: u32) -> VertexOutput {
+    var corners = array<vec2<f32>, 6>(
+        vec2<f32>(-1.0, -1.0), vec2<f32>(1.0, -1.0), vec2<f32>(1.0, 1.0),
+        vec2<f32>(-1.0, -1.0), vec2<f32>(1.0, 1.0), vec2<f32>(-1.0, 1.0),
+    );
+    let corner = corners[vertex_index];
+    let particle = particles[draw_order[instance_index]];
+
+    // View space, then a perspective projection with depth in [0, 1]
+    let forward = normalize(camera.look_at.xyz - camera.eye.xyz);
+    let right = normalize(cross(forward, vec3<f32>(0.0, 1.0, 0.0)));
+    let up = cross(right, forward);
+    let relative = particle.position - camera.eye.xyz;
+    let view = vec3<f32>(dot(relative, right), dot(relative, up), dot(relative, forward))
+        + vec3<f32>(corner * camera.particle_size, 0.0);
+
+    let near = 0.05;
+    let far = 100.0;
+    var out: VertexOutput;
+    out.position = vec4<f32>(
+        view.x * camera.focal_length / camera.aspect_ratio,
+        view.y * camera.focal_length,
+        (view.z - near) * far / (far - near),
+        view.z);
+    out.color = particle.color;
+    out.corner = corner;
+    return out;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    let falloff = max(1.0 - dot(in.corner, in.corner), 0.0);
+    return vec4<f32>(in.color.rgb, in.color.a * falloff);
+}
+)";
+
+    WGPUShaderModule createShaderModule(WGPUDevice device, char const* label, std::string const& code)
+    {
+        WGPUShaderModuleWGSLDescriptor wgsl_descriptor = {};
+        wgsl_descriptor.chain.next = nullptr;
+        wgsl_descriptor.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+        wgsl_descriptor.code = code.c_str();
+
+        WGPUShaderModuleDescriptor shader_descriptor = {};
+        shader_descriptor.nextInChain = &wgsl_descriptor.chain;
+        shader_descriptor.label = label;
+#ifdef WEBGPU_BACKEND_WGPU
+        shader_descriptor.hintCount = 0;
+        shader_descriptor.hints = nullptr;
+#endif // WEBGPU_BACKEND_WGPU
+        return wgpuDeviceCreateShaderModule(device, &shader_descriptor);
+    }
+}
+
+bool ParticleSystem::Initialize(ComputeContext& compute, GpuPrimitives& primitives, WGPUTextureFormat target_format, uint32_t capacity, float aspect_ratio)
+{
+    m_compute = &compute;
+    m_primitives = &primitives;
+    m_device = compute.GetDevice();
+    m_capacity = std::max(capacity, 4u);
+
+    std::string common = kParticleSource;
+    m_integrate = compute.CreateKernel("Particle integrate", common + kIntegrateSource, "integrate");
+    m_emit = compute.CreateKernel("Particle emit", common + kEmitSource, "emit");
+    m_sort_keys = compute.CreateKernel("Particle sort keys", common + kSortKeysSource, "sort_keys");
+    m_draw_args = compute.CreateKernel("Particle draw arguments", common + kDrawArgsSource, "draw_args");
+
+    if (!m_integrate || !m_emit || !m_sort_keys || !m_draw_args)
+    {
+        std::cerr << "Could not create the particle kernels!" << std::endl;
+        return false;
+    }
+
+    constexpr WGPUBufferUsageFlags storage = WGPUBufferUsage_Storage;
+    uint64_t const slot_list_size = uint64_t(m_capacity) * sizeof(uint32_t);
+
+    m_simulation_params = CreateBuffer("Particle simulation parameters", WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst, sizeof(SimulationParams));
+    m_camera_params = CreateBuffer("Particle camera", WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst, sizeof(CameraParams));
+    m_particles = CreateBuffer("Particles", storage, uint64_t(m_capacity) * 48);
+    m_slot_ids = CreateBuffer("Particle slot ids", storage | WGPUBufferUsage_CopyDst, slot_list_size);
+    m_alive_flags = CreateBuffer("Particle alive flags", storage, slot_list_size);
+    m_dead_flags = CreateBuffer("Particle dead flags", storage, slot_list_size);
+    m_alive_slots = CreateBuffer("Live particle slots", storage, slot_list_size);
+    m_alive_count = CreateBuffer("Live particle count", storage, 16);
+    m_dead_slots = CreateBuffer("Dead particle slots", storage, slot_list_size);
+    m_dead_count = CreateBuffer("Dead particle count", storage, 16);
+    m_depth_keys = CreateBuffer("Particle depth keys", storage, slot_list_size);
+    m_draw_order = CreateBuffer("Particle draw order", storage, slot_list_size);
+    m_draw_arguments = CreateBuffer("Particle draw arguments", storage | WGPUBufferUsage_Indirect, 16);
+
+    // New buffers are zeroed, and a particle with a zero lifetime is dead
+    std::vector<uint32_t> slot_ids(m_capacity);
+    for (uint32_t i = 0; i < m_capacity; ++i)
+        slot_ids[i] = i;
+    wgpuQueueWriteBuffer(compute.GetQueue(), m_slot_ids, 0, slot_ids.data(), slot_list_size);
+
+    m_camera = {};
+    m_camera.eye[0] = 0.0f; m_camera.eye[1] = 1.5f; m_camera.eye[2] = -6.0f;
+    m_camera.look_at[0] = 0.0f; m_camera.look_at[1] = 1.5f; m_camera.look_at[2] = 0.0f;
+    m_camera.aspect_ratio = aspect_ratio;
+    m_camera.focal_length = 1.0f / std::tan(0.5f * 0.8f); // ~45 degrees vertical field of view
+    m_camera.particle_size = 0.01f;
+    wgpuQueueWriteBuffer(compute.GetQueue(), m_camera_params, 0, &m_camera, sizeof(CameraParams));
+
+    m_integrate_bind_group = m_integrate->CreateBindGroup(0, { m_simulation_params, m_particles, m_alive_flags, m_dead_flags });
+    m_emit_bind_group = m_emit->CreateBindGroup(0, { m_simulation_params, m_particles, m_alive_flags, m_dead_slots, m_dead_count });
+    m_sort_keys_bind_group = m_sort_keys->CreateBindGroup(0, { m_camera_params, m_particles, m_alive_slots, m_alive_count, m_depth_keys, m_draw_order });
+    m_draw_args_bind_group = m_draw_args->CreateBindGroup(0, { m_alive_count, m_draw_arguments });
+
+    return CreateRenderPipeline(target_format);
+}
+
+void ParticleSystem::Terminate()
+{
+    for (WGPUBindGroup* bind_group : { &m_integrate_bind_group, &m_emit_bind_group, &m_sort_keys_bind_group, &m_draw_args_bind_group, &m_render_bind_group })
+    {
+        if (*bind_group)
+            wgpuBindGroupRelease(*bind_group);
+        *bind_group = nullptr;
+    }
+
+    if (m_render_pipeline)
+        wgpuRenderPipelineRelease(m_render_pipeline);
+    m_render_pipeline = nullptr;
+
+    for (WGPUBuffer* buffer : { &m_simulation_params, &m_camera_params, &m_particles, &m_slot_ids, &m_alive_flags, &m_dead_flags,
+                                &m_alive_slots, &m_alive_count, &m_dead_slots, &m_dead_count, &m_depth_keys, &m_draw_order, &m_draw_arguments })
+    {
+        if (*buffer)
+            wgpuBufferRelease(*buffer);
+        *buffer = nullptr;
+    }
+
+    // Kernels are owned by the compute context
+}
+
+WGPUBuffer ParticleSystem::CreateBuffer(char const* label, WGPUBufferUsageFlags usage, uint64_t size)
+{
+    WGPUBufferDescriptor buffer_descriptor = {};
+    buffer_descriptor.nextInChain = nullptr;
+    buffer_descriptor.label = label;
+    buffer_descriptor.usage = usage;
+    buffer_descriptor.size = size;
+    buffer_descriptor.mappedAtCreation = false;
+    return wgpuDeviceCreateBuffer(m_device, &buffer_descriptor);
+}
+
+bool ParticleSystem::CreateRenderPipeline(WGPUTextureFormat target_format)
+{
+    WGPUShaderModule shader_module = createShaderModule(m_device, "Particle rendering", std::string(kParticleSource) + kRenderSource);
+
+    WGPUBlendState blend_state = {};
+    blend_state.color.srcFactor = WGPUBlendFactor_SrcAlpha;
+    blend_state.color.dstFactor = WGPUBlendFactor_OneMinusSrcAlpha;
+    blend_state.color.operation = WGPUBlendOperation_Add;
+    blend_state.alpha.srcFactor = WGPUBlendFactor_Zero;
+    blend_state.alpha.dstFactor = WGPUBlendFactor_One;
+    blend_state.alpha.operation = WGPUBlendOperation_Add;
+
+    WGPUColorTargetState color_target = {};
+    color_target.nextInChain = nullptr;
+    color_target.format = target_format;
+    color_target.blend = &blend_state;
+    color_target.writeMask = WGPUColorWriteMask_All;
+
+    WGPUFragmentState fragment_state = {};
+    fragment_state.nextInChain = nullptr;
+    fragment_state.module = shader_module;
+    fragment_state.entryPoint = "fs_main";
+    fragment_state.constantCount = 0;
+    fragment_state.constants = nullptr;
+    fragment_state.targetCount = 1;
+    fragment_state.targets = &color_target;
+
+    WGPURenderPipelineDescriptor pipeline_descriptor = {};
+    pipeline_descriptor.nextInChain = nullptr;
+    pipeline_descriptor.label = "Particle pipeline";
+    pipeline_descriptor.layout = nullptr; // deduced from the shader
+
+    // Quads are generated from the vertex and instance indices, no vertex buffer
+    pipeline_descriptor.vertex.nextInChain = nullptr;
+    pipeline_descriptor.vertex.module = shader_module;
+    pipeline_descriptor.vertex.entryPoint = "vs_main";
+    pipeline_descriptor.vertex.constantCount = 0;
+    pipeline_descriptor.vertex.constants = nullptr;
+    pipeline_descriptor.vertex.bufferCount = 0;
+    pipeline_descriptor.vertex.buffers = nullptr;
+
+    pipeline_descriptor.primitive.nextInChain = nullptr;
+    pipeline_descriptor.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+    pipeline_descriptor.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+    pipeline_descriptor.primitive.frontFace = WGPUFrontFace_CCW;
+    pipeline_descriptor.primitive.cullMode = WGPUCullMode_None;
+
+    pipeline_descriptor.depthStencil = nullptr;
+
+    pipeline_descriptor.multisample.nextInChain = nullptr;
+    pipeline_descriptor.multisample.count = 1;
+    pipeline_descriptor.multisample.mask = ~0u;
+    pipeline_descriptor.multisample.alphaToCoverageEnabled = false;
+
+    pipeline_descriptor.fragment = &fragment_state;
+
+    m_render_pipeline = wgpuDeviceCreateRenderPipeline(m_device, &pipeline_descriptor);
+    wgpuShaderModuleRelease(shader_module);
+
+    if (!m_render_pipeline)
+    {
+        std::cerr << "Could not create the particle pipeline!" << std::endl;
+        return false;
+    }
+
+    WGPUBindGroupLayout layout = wgpuRenderPipelineGetBindGroupLayout(m_render_pipeline, 0);
+
+    WGPUBindGroupEntry entries[3] = {};
+    WGPUBuffer const buffers[3] = { m_camera_params, m_particles, m_draw_order };
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        entries[i].nextInChain = nullptr;
+        entries[i].binding = i;
+        entries[i].buffer = buffers[i];
+        entries[i].offset = 0;
+        entries[i].size = wgpuBufferGetSize(buffers[i]);
+    }
+
+    WGPUBindGroupDescriptor bind_group_descriptor = {};
+    bind_group_descriptor.nextInChain = nullptr;
+    bind_group_descriptor.label = "Particle render bind group";
+    bind_group_descriptor.layout = layout;
+    bind_group_descriptor.entryCount = 3;
+    bind_group_descriptor.entries = entries;
+    m_render_bind_group = wgpuDeviceCreateBindGroup(m_device, &bind_group_descriptor);
+
+    wgpuBindGroupLayoutRelease(layout);
+
+    return true;
+}
+
+void ParticleSystem::Update(float delta_time)
+{
+    // Avoid a burst of particles after a long stall
+    delta_time = std::min(delta_time, 0.1f);
+    m_time += delta_time;
+    ++m_frame;
+
+    m_emission_accumulator += m_emission_rate * delta_time;
+    uint32_t emit_count = static_cast<uint32_t>(std::min(m_emission_accumulator, float(m_capacity)));
+    m_emission_accumulator -= float(emit_count);
+
+    SimulationParams params = {};
+    params.emitter[0] = m_emitter[0]; params.emitter[1] = m_emitter[1]; params.emitter[2] = m_emitter[2]; params.emitter[3] = 0.2f;
+    params.gravity[0] = 0.0f; params.gravity[1] = -2.0f; params.gravity[2] = 0.0f; params.gravity[3] = 0.1f;
+    params.delta_time = delta_time;
+    params.time = m_time;
+    params.emit_count = emit_count;
+    params.capacity = m_capacity;
+    params.min_lifetime = 2.0f;
+    params.max_lifetime = 5.0f;
+    params.speed = 4.0f;
+    params.frame = m_frame;
+    wgpuQueueWriteBuffer(m_compute->GetQueue(), m_simulation_params, 0, &params, sizeof(SimulationParams));
+
+    m_compute->Dispatch(*m_integrate, { m_integrate_bind_group }, m_capacity);
+    m_primitives->Compact(m_slot_ids, m_dead_flags, m_capacity, m_dead_slots, m_dead_count);
+    m_compute->Dispatch(*m_emit, { m_emit_bind_group }, emit_count);
+    m_primitives->Compact(m_slot_ids, m_alive_flags, m_capacity, m_alive_slots, m_alive_count);
+
+    m_compute->Dispatch(*m_sort_keys, { m_sort_keys_bind_group }, m_capacity);
+    m_primitives->RadixSort(m_depth_keys, m_draw_order, m_capacity);
+
+    m_compute->Dispatch(*m_draw_args, { m_draw_args_bind_group }, 1);
+}
+
+void ParticleSystem::SetEmitter(float const position[3])
+{
+    for (int i = 0; i < 3; ++i)
+        m_emitter[i] = position[i];
+}
+
+void ParticleSystem::SetCamera(float const eye[3], float const look_at[3])
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        m_camera.eye[i] = eye[i];
+        m_camera.look_at[i] = look_at[i];
+    }
+    wgpuQueueWriteBuffer(m_compute->GetQueue(), m_camera_params, 0, &m_camera, sizeof(CameraParams));
+}
+
+void ParticleSystem::Draw(WGPURenderPassEncoder render_pass)
+{
+    wgpuRenderPassEncoderSetPipeline(render_pass, m_render_pipeline);
+    wgpuRenderPassEncoderSetBindGroup(render_pass, 0, m_render_bind_group, 0, nullptr);
+    wgpuRenderPassEncoderDrawIndirect(render_pass, m_draw_arguments, 0);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "compute.h"
+#include "gpu-primitives.h"
+
+#include <webgpu/webgpu.h>
+
+#include <cstdint>
+
+/**
+ * Particles simulated and drawn without any CPU readback.
+ *
+ * Every frame, Update() queues on the compute context:
+ *  - integrate: move live particles and flag them alive or dead,
+ *  - compaction of the dead slots, then emit: respawn particles there,
+ *  - compaction of the live slots,
+ *  - back-to-front radix sort of the live particles by view depth,
+ *  - the indirect draw arguments, sized by the live particle count.
+ * Draw() then issues a single indirect draw of camera-facing quads.
+ */
+class ParticleSystem
+{
+public:
+    // `target_format` is the format of the render pass Draw() is called in
+    bool Initialize(ComputeContext& compute, GpuPrimitives& primitives, WGPUTextureFormat target_format, uint32_t capacity, float aspect_ratio);
+    void Terminate();
+
+    // Queue the simulation of one step of `delta_time` seconds
+    void Update(float delta_time);
+
+    // Record the particle draw call in `render_pass`
+    void Draw(WGPURenderPassEncoder render_pass);
+
+    // Number of new particles per second
+    void SetEmissionRate(float particles_per_second) { m_emission_rate = particles_per_second; }
+
+    // Where new particles are emitted, from the next Update()
+    void SetEmitter(float const position[3]);
+
+    // Point of view of the particles, sorted and drawn from the next Update()
+    void SetCamera(float const eye[3], float const look_at[3]);
+
+private:
+    // Layout of SimulationParams in WGSL
+    struct SimulationParams
+    {
+        float emitter[4];   // xyz: position, w: spread radius
+        float gravity[4];   // xyz: acceleration, w: drag
+        float delta_time;
+        float time;
+        uint32_t emit_count;
+        uint32_t capacity;
+        float min_lifetime;
+        float max_lifetime;
+        float speed;
+        uint32_t frame;
+    };
+
+    // Layout of Camera in WGSL
+    struct CameraParams
+    {
+        float eye[4];
+        float look_at[4];
+        float aspect_ratio;
+        float focal_length;
+        float particle_size;
+        float unused;
+    };
+
+    WGPUBuffer CreateBuffer(char const* label, WGPUBufferUsageFlags usage, uint64_t size);
+    bool CreateRenderPipeline(WGPUTextureFormat target_format);
+
+    ComputeContext* m_compute = nullptr;
+    GpuPrimitives* m_primitives = nullptr;
+    WGPUDevice m_device = nullptr;
+    uint32_t m_capacity = 0;
+
+    float m_emission_rate = 200000.0f;
+    float m_emitter[3] = { 0.0f, 0.0f, 0.0f };
+    CameraParams m_camera = {};
+    float m_emission_accumulator = 0.0f;
+    float m_time = 0.0f;
+    uint32_t m_frame = 0;
+
+    ComputeKernel* m_integrate = nullptr;
+    ComputeKernel* m_emit = nullptr;
+    ComputeKernel* m_sort_keys = nullptr;
+    ComputeKernel* m_draw_args = nullptr;
+
+    WGPUBindGroup m_integrate_bind_group = nullptr;
+    WGPUBindGroup m_emit_bind_group = nullptr;
+    WGPUBindGroup m_sort_keys_bind_group = nullptr;
+    WGPUBindGroup m_draw_args_bind_group = nullptr;
+    WGPUBindGroup m_render_bind_group = nullptr;
+
+    WGPURenderPipeline m_render_pipeline = nullptr;
+
+    WGPUBuffer m_simulation_params = nullptr;
+    WGPUBuffer m_camera_params = nullptr;
+    WGPUBuffer m_particles = nullptr;
+    // Identity mapping 0..capacity-1, compacted into the slot lists
+    WGPUBuffer m_slot_ids = nullptr;
+    WGPUBuffer m_alive_flags = nullptr;
+    WGPUBuffer m_dead_flags = nullptr;
+    WGPUBuffer m_alive_slots = nullptr;
+    WGPUBuffer m_alive_count = nullptr;
+    WGPUBuffer m_dead_slots = nullptr;
+    WGPUBuffer m_dead_count = nullptr;
+    WGPUBuffer m_depth_keys = nullptr;
+    // Live particle slots in drawing order once sorted
+    WGPUBuffer m_draw_order = nullptr;
+    WGPUBuffer m_draw_arguments = nullptr;
+};
@@ -0,0 +1,526 @@
+#include "resolution-scaler.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Fullscreen triangle sampling the scaled part of the scene, followed by
+    // a contrast adaptive sharpening: neighbours are subtracted with a weight
+    // that fades out where the local contrast is already high, so edges get
+    // crisper without ringing.
+    char const* kUpscaleShaderSource = R"(
+struct UpscaleParams {
+    uv_scale: vec2<f32>,
+    texel_size: vec2<f32>,
+    sharpness: f32,
+}
+
+@group(0) @binding(0) var scene: texture_2d<f32>;
+@group(0) @binding(1) var scene_sampler: sampler;
+@group(0) @binding(2) var<uniform> params: UpscaleParams;
+
+struct VertexOutput {
+    @builtin(position) position: vec4<f32>,
+    @location(0) uv: vec2<f32>,
+}
+
+@vertex
+fn vs_main(@builtin(vertex_index) vertex_index: u32) -> VertexOutput {
+    let uv = vec2<f32>(f32((vertex_index << 1u) & 2u), f32(vertex_index & 2u));
+    var out: VertexOutput;
+    out.position = vec4<f32>(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, 0.0, 1.0);
+    out.uv = uv;
+    return out;
+}
+
+fn sample_scene(uv: vec2<f32>) -> vec3<f32> {
+    // Stay half a texel inside the scaled region, which is not at the border of the texture
+    let clamped = clamp(uv, params.texel_size * 0.5, params.uv_scale - params.texel_size * 0.5);
+    return textureSampleLevel(scene, scene_sampler, clamped, 0.0).rgb;
+}
+
+@fragment
+fn fs_main(in: VertexOutput) -> @location(0) vec4<f32> {
+    let uv = in.uv * params.uv_scale;
+    let d = params.texel_size;
+
+    let c = sample_scene(uv);
+    let n = sample_scene(uv - vec2<f32>(0.0, d.y));
+    let s = sample_scene(uv + vec2<f32>(0.0, d.y));
+    let w = sample_scene(uv - vec2<f32>(d.x, 0.0));
+    let e = sample_scene(uv + vec2<f32>(d.x, 0.0));
+
+    let lowest = min(c, min(min(n, s), min(w, e)));
+    let highest = max(c, max(max(n, s), max(w, e)));
+    let amplitude = sqrt(clamp(min(lowest, 1.0 - highest) / max(highest, vec3<f32>(1e-4)), vec3<f32>(0.0), vec3<f32>(1.0)));
+    let weight = amplitude * (-1.0 / mix(8.0, 5.0, params.sharpness));
+
+    let color = (c + (n + s + w + e) * weight) / (1.0 + 4.0 * weight);
+    return vec4<f32>(clamp(color, vec3<f32>(0.0), vec3<f32>(1.0)), 1.0);
+}
+)";
+}
+
+void FramePacer::FramePresented()
+{
+    Clock::time_point now = Clock::now();
+    if (m_has_presented)
+    {
+        std::chrono::duration<double> interval = now - m_last_present;
+        m_frame_interval = m_frame_interval == 0.0 ? interval.count() : m_frame_interval * 0.9 + interval.count() * 0.1;
+    }
+    m_last_present = now;
+    m_has_presented = true;
+    m_frame_requested = false;
+}
+
+void FramePacer::FrameSubmitted(double time)
+{
+    if (!m_presentation_feedback)
+        return;
+
+    DropUnobservedPresents();
+
+    // The oldest present is the one whose feedback comes next, while the
+    // feedback request that follows it may not be known yet
+    if (m_pending_presents.size() == kMaxPendingPresents)
+        m_pending_presents.erase(m_pending_presents.begin() + 1);
+    m_pending_presents.push_back(time);
+}
+
+void FramePacer::FrameDisplayed(bool presented, double time, double refresh_interval, double feedback_request_time)
+{
+    // The feedback is that of the first present after it was requested, the
+    // presents in between got none
+    DropUnobservedPresents();
+    m_feedback_request_time = feedback_request_time;
+
+    if (m_pending_presents.empty())
+        return;
+    double submit_time = m_pending_presents.front();
+    m_pending_presents.pop_front();
+
+    if (!presented)
+        return;
+
+    double latency = time - submit_time;
+    if (latency >= 0.0)
+        m_display_latency = m_display_latency == 0.0 ? latency : m_display_latency * 0.9 + latency * 0.1;
+
+    // The compositor knows the refresh rate of the output the window is on
+    if (refresh_interval > 0.0)
+        m_target_frame_time = refresh_interval;
+}
+
+void FramePacer::DropUnobservedPresents()
+{
+    while (!m_pending_presents.empty() && m_pending_presents.front() < m_feedback_request_time)
+        m_pending_presents.pop_front();
+}
+
+bool ResolutionScaler::Initialize(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat format, uint32_t width, uint32_t height)
+{
+    m_device = device;
+    m_queue = queue;
+    m_width = width;
+    m_height = height;
+    m_format = format;
+
+    WGPUSamplerDescriptor sampler_descriptor = {};
+    sampler_descriptor.nextInChain = nullptr;
+    sampler_descriptor.label = "Upscale sampler";
+    sampler_descriptor.addressModeU = WGPUAddressMode_ClampToEdge;
+    sampler_descriptor.addressModeV = WGPUAddressMode_ClampToEdge;
+    sampler_descriptor.addressModeW = WGPUAddressMode_ClampToEdge;
+    sampler_descriptor.magFilter = WGPUFilterMode_Linear;
+    sampler_descriptor.minFilter = WGPUFilterMode_Linear;
+    sampler_descriptor.mipmapFilter = WGPUMipmapFilterMode_Nearest;
+    sampler_descriptor.lodMinClamp = 0.0f;
+    sampler_descriptor.lodMaxClamp = 1.0f;
+    sampler_descriptor.compare = WGPUCompareFunction_Undefined;
+    sampler_descriptor.maxAnisotropy = 1;
+    m_sampler = wgpuDeviceCreateSampler(m_device, &sampler_descriptor);
+
+    WGPUBufferDescriptor buffer_descriptor = {};
+    buffer_descriptor.nextInChain = nullptr;
+    buffer_descriptor.label = "Upscale params";
+    buffer_descriptor.usage = WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst;
+    buffer_descriptor.size = sizeof(UpscaleParams);
+    buffer_descriptor.mappedAtCreation = false;
+    m_params = wgpuDeviceCreateBuffer(m_device, &buffer_descriptor);
+
+    if (!CreateUpscalePipeline(format))
+        return false;
+
+    if (!CreateSceneTarget(format))
+        return false;
+
+    // Timestamps are optional, the submit to completion time is used otherwise.
+    // wgpu-native resolves them in GPU ticks (e.g. 52 ns on some Vulkan
+    // drivers) and its C API does not report the tick period, so they are
+    // only used with the backends that resolve them in nanoseconds.
+#ifdef WEBGPU_BACKEND_WGPU
+    bool const use_timestamps = false;
+#else
+    bool const use_timestamps = wgpuDeviceHasFeature(m_device, WGPUFeatureName_TimestampQuery);
+#endif // WEBGPU_BACKEND_WGPU
+    if (use_timestamps)
+    {
+        WGPUQuerySetDescriptor query_set_descriptor = {};
+        query_set_descriptor.nextInChain = nullptr;
+        query_set_descriptor.label = "Frame timestamps";
+        query_set_descriptor.type = WGPUQueryType_Timestamp;
+        query_set_descriptor.count = kQueryCount;
+        m_query_set = wgpuDeviceCreateQuerySet(m_device, &query_set_descriptor);
+
+        buffer_descriptor.label = "Timestamp resolve buffer";
+        buffer_descriptor.usage = WGPUBufferUsage_QueryResolve | WGPUBufferUsage_CopySrc;
+        buffer_descriptor.size = kQueryCount * sizeof(uint64_t);
+        m_resolve_buffer = wgpuDeviceCreateBuffer(m_device, &buffer_descriptor);
+
+        // A few readback buffers, so that timing never waits on the GPU
+        buffer_descriptor.label = "Timestamp readback buffer";
+        buffer_descriptor.usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst;
+        for (TimestampReadback& readback : m_readbacks)
+        {
+            readback.owner = this;
+            readback.buffer = wgpuDeviceCreateBuffer(m_device, &buffer_descriptor);
+            readback.in_flight = false;
+        }
+
+        m_scene_timestamp_writes.querySet = m_query_set;
+        m_scene_timestamp_writes.beginningOfPassWriteIndex = 0;
+        m_scene_timestamp_writes.endOfPassWriteIndex = 1;
+        m_upscale_timestamp_writes.querySet = m_query_set;
+        m_upscale_timestamp_writes.beginningOfPassWriteIndex = 2;
+        m_upscale_timestamp_writes.endOfPassWriteIndex = 3;
+    }
+    else
+    {
+        std::cout << "No timestamp queries, dynamic resolution uses submission timings" << std::endl;
+    }
+
+    return true;
+}
+
+void ResolutionScaler::Terminate()
+{
+    for (TimestampReadback& readback : m_readbacks)
+    {
+        if (readback.buffer)
+            wgpuBufferRelease(readback.buffer);
+        readback.buffer = nullptr;
+    }
+    if (m_resolve_buffer)
+        wgpuBufferRelease(m_resolve_buffer);
+    if (m_query_set)
+        wgpuQuerySetRelease(m_query_set);
+    m_resolve_buffer = nullptr;
+    m_query_set = nullptr;
+
+    wgpuBindGroupRelease(m_bind_group);
+    wgpuRenderPipelineRelease(m_upscale_pipeline);
+    wgpuBufferRelease(m_params);
+    wgpuSamplerRelease(m_sampler);
+    wgpuTextureViewRelease(m_scene_view);
+    wgpuTextureDestroy(m_scene_texture);
+    wgpuTextureRelease(m_scene_texture);
+}
+
+bool ResolutionScaler::CreateSceneTarget(WGPUTextureFormat format)
+{
+    WGPUTextureDescriptor texture_descriptor = {};
+    texture_descriptor.nextInChain = nullptr;
+    texture_descriptor.label = "Scaled scene texture";
+    texture_descriptor.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding;
+    texture_descriptor.dimension = WGPUTextureDimension_2D;
+    texture_descriptor.size = { m_width, m_height, 1 };
+    texture_descriptor.format = format;
+    texture_descriptor.mipLevelCount = 1;
+    texture_descriptor.sampleCount = 1;
+    texture_descriptor.viewFormatCount = 0;
+    texture_descriptor.viewFormats = nullptr;
+    m_scene_texture = wgpuDeviceCreateTexture(m_device, &texture_descriptor);
+    m_scene_view = wgpuTextureCreateView(m_scene_texture, nullptr);
+
+    WGPUBindGroupEntry entries[3] = {};
+    entries[0].nextInChain = nullptr;
+    entries[0].binding = 0;
+    entries[0].textureView = m_scene_view;
+    entries[1].nextInChain = nullptr;
+    entries[1].binding = 1;
+    entries[1].sampler = m_sampler;
+    entries[2].nextInChain = nullptr;
+    entries[2].binding = 2;
+    entries[2].buffer = m_params;
+    entries[2].offset = 0;
+    entries[2].size = sizeof(UpscaleParams);
+
+    WGPUBindGroupLayout layout = wgpuRenderPipelineGetBindGroupLayout(m_upscale_pipeline, 0);
+    WGPUBindGroupDescriptor bind_group_descriptor = {};
+    bind_group_descriptor.nextInChain = nullptr;
+    bind_group_descriptor.label = "Upscale bind group";
+    bind_group_descriptor.layout = layout;
+    bind_group_descriptor.entryCount = 3;
+    bind_group_descriptor.entries = entries;
+    m_bind_group = wgpuDeviceCreateBindGroup(m_device, &bind_group_descriptor);
+    wgpuBindGroupLayoutRelease(layout);
+    return m_bind_group != nullptr;
+}
+
+bool ResolutionScaler::CreateUpscalePipeline(WGPUTextureFormat format)
+{
+    WGPUShaderModuleWGSLDescriptor wgsl_descriptor = {};
+    wgsl_descriptor.chain.next = nullptr;
+    wgsl_descriptor.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
+    wgsl_descriptor.code = kUpscaleShaderSource;
+
+    WGPUShaderModuleDescriptor shader_descriptor = {};
+    shader_descriptor.nextInChain = &wgsl_descriptor.chain;
+    shader_descriptor.label = "Upscale shader";
+#ifdef WEBGPU_BACKEND_WGPU
+    shader_descriptor.hintCount = 0;
+    shader_descriptor.hints = nullptr;
+#endif // WEBGPU_BACKEND_WGPU
+    WGPUShaderModule shader_module = wgpuDeviceCreateShaderModule(m_device, &shader_descriptor);
+
+    WGPUColorTargetState color_target = {};
+    color_target.nextInChain = nullptr;
+    color_target.format = format;
+    color_target.blend = nullptr;
+    color_target.writeMask = WGPUColorWriteMask_All;
+
+    WGPUFragmentState fragment_state = {};
+    fragment_state.nextInChain = nullptr;
+    fragment_state.module = shader_module;
+    fragment_state.entryPoint = "fs_main";
+    fragment_state.constantCount = 0;
+    fragment_state.constants = nullptr;
+    fragment_state.targetCount = 1;
+    fragment_state.targets = &color_target;
+
+    WGPURenderPipelineDescriptor pipeline_descriptor = {};
+    pipeline_descriptor.nextInChain = nullptr;
+    pipeline_descriptor.label = "Upscale pipeline";
+    pipeline_descriptor.layout = nullptr; // deduced from the shader
+    pipeline_descriptor.vertex.nextInChain = nullptr;
+    pipeline_descriptor.vertex.module = shader_module;
+    pipeline_descriptor.vertex.entryPoint = "vs_main";
+    pipeline_descriptor.vertex.constantCount = 0;
+    pipeline_descriptor.vertex.constants = nullptr;
+    pipeline_descriptor.vertex.bufferCount = 0;
+    pipeline_descriptor.vertex.buffers = nullptr;
+    pipeline_descriptor.primitive.nextInChain = nullptr;
+    pipeline_descriptor.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+    pipeline_descriptor.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+    pipeline_descriptor.primitive.frontFace = WGPUFrontFace_CCW;
+    pipeline_descriptor.primitive.cullMode = WGPUCullMode_None;
+    pipeline_descriptor.depthStencil = nullptr;
+    pipeline_descriptor.multisample.nextInChain = nullptr;
+    pipeline_descriptor.multisample.count = 1;
+    pipeline_descriptor.multisample.mask = ~0u;
+    pipeline_descriptor.multisample.alphaToCoverageEnabled = false;
+    pipeline_descriptor.fragment = &fragment_state;
+
+    m_upscale_pipeline = wgpuDeviceCreateRenderPipeline(m_device, &pipeline_descriptor);
+    wgpuShaderModuleRelease(shader_module);
+
+    if (!m_upscale_pipeline)
+    {
+        std::cerr << "Could not create upscale pipeline" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ResolutionScaler::AddGpuTimeSample(double seconds)
+{
+    m_latest_gpu_time = seconds;
+    m_gpu_time = m_gpu_time == 0.0 ? seconds : m_gpu_time * 0.8 + seconds * 0.2;
+    m_has_new_sample = true;
+}
+
+void ResolutionScaler::BeginFrame(FramePacer const& pacer)
+{
+    if (m_has_new_sample)
+    {
+        m_has_new_sample = false;
+        double const budget = pacer.GetTargetFrameTime() * kBudgetRatio * m_budget_share;
+        // React to spikes on the latest sample, but grow on the average
+        double const cost = std::max(m_latest_gpu_time, m_gpu_time);
+
+        if (cost > budget)
+        {
+            // GPU time goes roughly with the pixel count, so with the square of the scale
+            m_scale = std::max(kMinScale, m_scale * float(std::sqrt(budget / cost)));
+            m_frames_with_headroom = 0;
+        }
+        else if (m_gpu_time < budget * 0.75 && pacer.GetFrameInterval() <= pacer.GetTargetFrameTime() * 1.1)
+        {
+            if (++m_frames_with_headroom >= kFramesBeforeUpscale)
+            {
+                float const affordable = m_scale * float(std::sqrt(budget / std::max(m_gpu_time, 1e-6)));
+                m_scale = std::min({ kMaxScale, m_scale * 1.05f, affordable });
+                m_frames_with_headroom = 0;
+            }
+        }
+        else
+        {
+            m_frames_with_headroom = 0;
+        }
+    }
+
+    // Sharpen harder as the scale goes down
+    float const scale_sharpness = std::clamp(m_sharpness + (1.0f - m_scale), 0.0f, 1.0f);
+
+    UpscaleParams params = {};
+    params.uv_scale[0] = float(std::max(1u, uint32_t(m_width * m_scale))) / float(m_width);
+    params.uv_scale[1] = float(std::max(1u, uint32_t(m_height * m_scale))) / float(m_height);
+    params.texel_size[0] = 1.0f / float(m_width);
+    params.texel_size[1] = 1.0f / float(m_height);
+    params.sharpness = scale_sharpness;
+    wgpuQueueWriteBuffer(m_queue, m_params, 0, &params, sizeof(params));
+
+    // Time this frame if a readback buffer is free, otherwise skip it
+    m_frame_readback = nullptr;
+    if (m_query_set)
+    {
+        for (TimestampReadback& readback : m_readbacks)
+        {
+            if (!readback.in_flight)
+            {
+                m_frame_readback = &readback;
+                break;
+            }
+        }
+    }
+}
+
+WGPURenderPassTimestampWrites const* ResolutionScaler::GetSceneTimestampWrites()
+{
+    return m_frame_readback ? &m_scene_timestamp_writes : nullptr;
+}
+
+void ResolutionScaler::SetSceneViewport(WGPURenderPassEncoder render_pass) const
+{
+    uint32_t const width = std::max(1u, uint32_t(m_width * m_scale));
+    uint32_t const height = std::max(1u, uint32_t(m_height * m_scale));
+    wgpuRenderPassEncoderSetViewport(render_pass, 0.0f, 0.0f, float(width), float(height), 0.0f, 1.0f);
+    wgpuRenderPassEncoderSetScissorRect(render_pass, 0, 0, width, height);
+}
+
+void ResolutionScaler::Upscale(WGPUCommandEncoder encoder, WGPUTextureView target_view)
+{
+    WGPURenderPassColorAttachment color_attachment = {};
+    color_attachment.view = target_view;
+    color_attachment.resolveTarget = nullptr;
+    color_attachment.loadOp = WGPULoadOp_Clear;
+    color_attachment.storeOp = WGPUStoreOp_Store;
+    color_attachment.clearValue = WGPUColor{ 0.0, 0.0, 0.0, 1.0 };
+#ifndef WEBGPU_BACKEND_WGPU
+    color_attachment.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+#endif // !WEBGPU_BACKEND_WGPU
+
+    WGPURenderPassDescriptor render_pass_descriptor = {};
+    render_pass_descriptor.nextInChain = nullptr;
+    render_pass_descriptor.label = "Upscale render pass";
+    render_pass_descriptor.colorAttachmentCount = 1;
+    render_pass_descriptor.colorAttachments = &color_attachment;
+    render_pass_descriptor.depthStencilAttachment = nullptr;
+    render_pass_descriptor.timestampWrites = m_frame_readback ? &m_upscale_timestamp_writes : nullptr;
+
+    WGPURenderPassEncoder render_pass = wgpuCommandEncoderBeginRenderPass(encoder, &render_pass_descriptor);
+    wgpuRenderPassEncoderSetPipeline(render_pass, m_upscale_pipeline);
+    wgpuRenderPassEncoderSetBindGroup(render_pass, 0, m_bind_group, 0, nullptr);
+    wgpuRenderPassEncoderDraw(render_pass, 3, 1, 0, 0);
+    wgpuRenderPassEncoderEnd(render_pass);
+    wgpuRenderPassEncoderRelease(render_pass);
+
+    if (m_frame_readback)
+    {
+        wgpuCommandEncoderResolveQuerySet(encoder, m_query_set, 0, kQueryCount, m_resolve_buffer, 0);
+        wgpuCommandEncoderCopyBufferToBuffer(encoder, m_resolve_buffer, 0, m_frame_readback->buffer, 0, kQueryCount * sizeof(uint64_t));
+    }
+}
+
+bool ResolutionScaler::Resize(uint32_t width, uint32_t height)
+{
+    if (width == m_width && height == m_height)
+        return true;
+
+    // Work already submitted with the previous target finishes before it is freed
+    wgpuBindGroupRelease(m_bind_group);
+    wgpuTextureViewRelease(m_scene_view);
+    wgpuTextureDestroy(m_scene_texture);
+    wgpuTextureRelease(m_scene_texture);
+
+    m_width = width;
+    m_height = height;
+    return CreateSceneTarget(m_format);
+}
+
+bool ResolutionScaler::IsTimingPending() const
+{
+    if (m_work_done_pending)
+        return true;
+    for (TimestampReadback const& readback : m_readbacks)
+    {
+        if (readback.in_flight)
+            return true;
+    }
+    return false;
+}
+
+void ResolutionScaler::EndFrame()
+{
+    if (m_frame_readback)
+    {
+        // Called by wgpuBufferMapAsync once the timestamps of the frame are readable
+        auto onTimestampsMapped = [](WGPUBufferMapAsyncStatus status, void* user_data)
+            {
+                TimestampReadback* readback = reinterpret_cast<TimestampReadback*>(user_data);
+                readback->in_flight = false;
+                if (status != WGPUBufferMapAsyncStatus_Success)
+                    return;
+
+                uint64_t const* timestamps = reinterpret_cast<uint64_t const*>(wgpuBufferGetConstMappedRange(readback->buffer, 0, kQueryCount * sizeof(uint64_t)));
+                // Dawn and browsers resolve timestamps in nanoseconds, as the
+                // WebGPU spec requires. They may go backwards on some drivers.
+                if (timestamps[1] >= timestamps[0] && timestamps[3] >= timestamps[2])
+                {
+                    uint64_t const nanoseconds = (timestamps[1] - timestamps[0]) + (timestamps[3] - timestamps[2]);
+                    readback->owner->AddGpuTimeSample(double(nanoseconds) * 1e-9);
+                }
+                wgpuBufferUnmap(readback->buffer);
+            };
+
+        m_frame_readback->in_flight = true;
+        wgpuBufferMapAsync(m_frame_readback->buffer, WGPUMapMode_Read, 0, kQueryCount * sizeof(uint64_t), onTimestampsMapped, m_frame_readback);
+        m_frame_readback = nullptr;
+    }
+    else if (!m_query_set && !m_work_done_pending)
+    {
+        // Submit to completion is an upper bound of the GPU time, as it
+        // includes the time the frame waited behind earlier work. It also
+        // covers the work of every surface of the frame, so only this
+        // scaler's share of it is counted, to compare with its share of the
+        // budget.
+        auto onWorkDone = [](WGPUQueueWorkDoneStatus status, void* user_data)
+            {
+                ResolutionScaler* scaler = reinterpret_cast<ResolutionScaler*>(user_data);
+                scaler->m_work_done_pending = false;
+                if (status != WGPUQueueWorkDoneStatus_Success)
+                    return;
+
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - scaler->m_submit_time;
+                scaler->AddGpuTimeSample(elapsed.count() * scaler->m_submit_budget_share);
+            };
+
+        m_submit_time = std::chrono::steady_clock::now();
+        m_submit_budget_share = m_budget_share;
+        m_work_done_pending = true;
+        wgpuQueueOnSubmittedWorkDone(m_queue, onWorkDone, this);
+    }
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <webgpu/webgpu.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+/**
+ * Measure the interval between presented frames, smoothed over a few frames.
+ * This is the CPU side view of the frame rate, used to pick the frame time
+ * budget and as a last resort timing when the GPU cannot be timed.
+ */
+class FramePacer
+{
+public:
+    // Call once per frame, right after presenting
+    void FramePresented();
+
+    // Smoothed interval between the last presented frames, in seconds
+    double GetFrameInterval() const { return m_frame_interval; }
+
+    // Time budget of one frame, from the display refresh rate
+    void SetTargetFrameTime(double seconds) { m_target_frame_time = seconds; }
+    double GetTargetFrameTime() const { return m_target_frame_time; }
+
+    // With frame callbacks, only render once the compositor asks for a frame,
+    // so that nothing is rendered while the window is occluded
+    void SetFrameCallbacks(bool enabled) { m_frame_callbacks = enabled; }
+    void FrameRequested() { m_frame_requested = true; }
+    bool IsFrameWanted() const { return !m_frame_callbacks || m_frame_requested; }
+
+    // With presentation feedback, presents are matched with the time they
+    // reached the display. Only one present at a time gets feedback: the first
+    // one made after `feedback_request_time` of the previous feedback. Times
+    // are in seconds on the glfwGetTime clock.
+    void SetPresentationFeedback(bool enabled) { m_presentation_feedback = enabled; }
+    void FrameSubmitted(double time);
+    void FrameDisplayed(bool presented, double time, double refresh_interval, double feedback_request_time);
+
+    // Smoothed time from present to display, 0 until first measured
+    double GetDisplayLatency() const { return m_display_latency; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Forget the presents made before feedback was last requested
+    void DropUnobservedPresents();
+
+    // Presents that may be the one feedback was requested for, the oldest
+    // being kept when there are more
+    static constexpr size_t kMaxPendingPresents = 8;
+
+    Clock::time_point m_last_present = {};
+    bool m_has_presented = false;
+    double m_frame_interval = 0.0;
+    double m_target_frame_time = 1.0 / 60.0;
+
+    bool m_frame_callbacks = false;
+    bool m_frame_requested = true;
+
+    bool m_presentation_feedback = false;
+    std::deque<double> m_pending_presents;
+    // The first present from then on gets feedback
+    double m_feedback_request_time = 0.0;
+    double m_display_latency = 0.0;
+};
+
+/**
+ * Dynamic resolution: render the scene at a fraction of the surface size and
+ * upscale it to the surface with a sharpening filter.
+ *
+ * The scene target is allocated once at the full surface size and the scene
+ * renders into its top-left corner, so changing the scale never reallocates.
+ * The scale goes between 50% and 100% of the surface size on each axis. It
+ * is picked from the GPU time of the scene and upscale passes, measured with
+ * timestamp queries when the device has the TimestampQuery feature (except
+ * with wgpu-native, whose timestamps are not in nanoseconds), or from the
+ * submit to completion time otherwise.
+ *
+ * The scale drops as soon as the GPU goes over budget, and rises slowly
+ * after a run of frames with enough headroom, so that a load spike costs
+ * resolution rather than a dropped frame.
+ *
+ * Per frame:
+ *   BeginFrame()
+ *   render pass on GetSceneView() with GetSceneTimestampWrites(), then
+ *   SetSceneViewport() before drawing
+ *   Upscale(encoder, surface_view)
+ *   submit, then EndFrame()
+ */
+class ResolutionScaler
+{
+public:
+    // `width` and `height` are the size of the surface, `format` its format
+    bool Initialize(WGPUDevice device, WGPUQueue queue, WGPUTextureFormat format, uint32_t width, uint32_t height);
+    void Terminate();
+
+    // Follow a new size of the surface, the current scale is kept
+    bool Resize(uint32_t width, uint32_t height);
+
+    // Pick the scale of the frame from the latest timings and the pacer
+    void BeginFrame(FramePacer const& pacer);
+
+    // Color target of the scene, at full surface size
+    WGPUTextureView GetSceneView() const { return m_scene_view; }
+
+    // Timestamp writes of the scene render pass, nullptr without timestamps
+    WGPURenderPassTimestampWrites const* GetSceneTimestampWrites();
+
+    // Restrict the scene render pass to the scaled part of the target
+    void SetSceneViewport(WGPURenderPassEncoder render_pass) const;
+
+    // Record the sharpening upscale of the scene into `target_view`
+    void Upscale(WGPUCommandEncoder encoder, WGPUTextureView target_view);
+
+    // Call after the frame is submitted to collect its timings
+    void EndFrame();
+
+    // Current scale, in ]0, 1] of the surface size on each axis
+    float GetScale() const { return m_scale; }
+
+    // Strength of the sharpening, from 0 (none) to 1
+    void SetSharpness(float sharpness) { m_sharpness = sharpness; }
+
+    // Part of the frame budget left to this scaler, when several surfaces are
+    // rendered within the same frame
+    void SetBudgetShare(double share) { m_budget_share = share; }
+
+    // Smoothed GPU time of the frame in seconds, 0 until first measured
+    double GetGpuTime() const { return m_gpu_time; }
+
+    // True while timings are on their way back from the GPU, whose callbacks
+    // need the scaler to still exist
+    bool IsTimingPending() const;
+
+private:
+    // Layout of UpscaleParams in WGSL
+    struct UpscaleParams
+    {
+        float uv_scale[2];
+        float texel_size[2];
+        float sharpness;
+        float unused[3];
+    };
+
+    // One buffer of timestamps on its way back to the CPU
+    struct TimestampReadback
+    {
+        ResolutionScaler* owner = nullptr;
+        WGPUBuffer buffer = nullptr;
+        bool in_flight = false;
+    };
+
+    bool CreateSceneTarget(WGPUTextureFormat format);
+    bool CreateUpscalePipeline(WGPUTextureFormat format);
+    void AddGpuTimeSample(double seconds);
+
+    static constexpr float kMinScale = 0.5f;
+    static constexpr float kMaxScale = 1.0f;
+    // Share of the frame budget the GPU should stay under
+    static constexpr double kBudgetRatio = 0.9;
+    // Frames with headroom needed before the scale goes up
+    static constexpr uint32_t kFramesBeforeUpscale = 30;
+    static constexpr uint32_t kQueryCount = 4;
+
+    WGPUDevice m_device = nullptr;
+    WGPUQueue m_queue = nullptr;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    WGPUTextureFormat m_format = WGPUTextureFormat_Undefined;
+
+    float m_scale = 1.0f;
+    float m_sharpness = 0.5f;
+    double m_budget_share = 1.0;
+    double m_gpu_time = 0.0;
+    double m_latest_gpu_time = 0.0;
+    bool m_has_new_sample = false;
+    uint32_t m_frames_with_headroom = 0;
+
+    WGPUTexture m_scene_texture = nullptr;
+    WGPUTextureView m_scene_view = nullptr;
+    WGPUSampler m_sampler = nullptr;
+    WGPUBuffer m_params = nullptr;
+    WGPUBindGroup m_bind_group = nullptr;
+    WGPURenderPipeline m_upscale_pipeline = nullptr;
+
+    // Timestamp queries: scene pass begin/end, upscale pass begin/end
+    WGPUQuerySet m_query_set = nullptr;
+    WGPUBuffer m_resolve_buffer = nullptr;
+    std::array<TimestampReadback, 3> m_readbacks;
+    TimestampReadback* m_frame_readback = nullptr;
+    WGPURenderPassTimestampWrites m_scene_timestamp_writes = {};
+    WGPURenderPassTimestampWrites m_upscale_timestamp_writes = {};
+
+    // Fallback timing from submission to completion
+    std::chrono::steady_clock::time_point m_submit_time = {};
+    // Budget share of the frame being timed, as the whole queue is measured
+    double m_submit_budget_share = 1.0;
+    bool m_work_done_pending = false;
+};
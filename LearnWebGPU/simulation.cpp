@@ -0,0 +1,102 @@
+#include "simulation.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+SceneState Interpolate(SceneState const& from, SceneState const& to, float t)
+{
+    SceneState state;
+    for (int i = 0; i < 3; ++i)
+    {
+        state.emitter[i] = from.emitter[i] + (to.emitter[i] - from.emitter[i]) * t;
+        state.camera_eye[i] = from.camera_eye[i] + (to.camera_eye[i] - from.camera_eye[i]) * t;
+        state.camera_look_at[i] = from.camera_look_at[i] + (to.camera_look_at[i] - from.camera_look_at[i]) * t;
+    }
+    return state;
+}
+
+void SimulationScheduler::Initialize(double tick_rate, SceneState const& initial_state, StepFunction step)
+{
+    m_step = std::move(step);
+    m_frequency = double(glfwGetTimerFrequency());
+    m_period = m_frequency / tick_rate;
+    m_next_tick = double(glfwGetTimerValue()) + m_period;
+    m_tick_count = 0;
+    m_state = initial_state;
+
+    for (Snapshot& snapshot : m_snapshots)
+    {
+        snapshot.previous = initial_state;
+        snapshot.current = initial_state;
+        snapshot.time = m_next_tick - m_period;
+    }
+}
+
+void SimulationScheduler::StartThread()
+{
+    m_running = true;
+    m_thread = std::thread([this]()
+        {
+            while (m_running)
+            {
+                RunDueTicks(glfwGetTimerValue());
+
+                double const wait = (m_next_tick - double(glfwGetTimerValue())) / m_frequency;
+                if (wait > 0.0)
+                    std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+            }
+        });
+}
+
+void SimulationScheduler::StopThread()
+{
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void SimulationScheduler::RunDueTicks(uint64_t now)
+{
+    int ticks = 0;
+    while (m_next_tick <= double(now))
+    {
+        if (ticks++ == kMaxCatchUpTicks)
+        {
+            // Too far behind to catch up, let the simulation slow down
+            // rather than spend all its time catching up
+            m_next_tick = double(now) + m_period;
+            break;
+        }
+
+        SceneState const previous = m_state;
+        double const time = double(m_tick_count + 1) * m_period / m_frequency;
+        m_step(m_state, m_period / m_frequency, time);
+        ++m_tick_count;
+
+        Publish(previous, m_next_tick);
+        m_next_tick += m_period;
+    }
+}
+
+SceneState SimulationScheduler::Sample(uint64_t now)
+{
+    if (m_middle.load(std::memory_order_acquire) & kFreshBit)
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+
+    Snapshot const& snapshot = m_snapshots[m_front];
+    double const t = (double(now) - snapshot.time) / m_period;
+    return Interpolate(snapshot.previous, snapshot.current, float(std::clamp(t, 0.0, 1.0)));
+}
+
+void SimulationScheduler::Publish(SceneState const& previous, double time)
+{
+    Snapshot& snapshot = m_snapshots[m_back];
+    snapshot.previous = previous;
+    snapshot.current = m_state;
+    snapshot.time = time;
+
+    m_back = m_middle.exchange(m_back | kFreshBit, std::memory_order_acq_rel) & kIndexMask;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+/**
+ * State of the scene after a simulation tick, which is all the renderer
+ * needs from the simulation.
+ */
+struct SceneState
+{
+    float emitter[3] = { 0.0f, 0.0f, 0.0f };
+    float camera_eye[3] = { 0.0f, 1.5f, -6.0f };
+    float camera_look_at[3] = { 0.0f, 1.5f, 0.0f };
+};
+
+// Blend two states, `t` going from 0 (`from`) to 1 (`to`)
+SceneState Interpolate(SceneState const& from, SceneState const& to, float t);
+
+/**
+ * Run the scene logic at a fixed tick rate, independently of the frame rate.
+ *
+ * Ticks run on a thread of their own, so that a slow frame never delays the
+ * simulation and a slow tick never delays a frame. After each tick the two
+ * latest states are published through a triple buffer, without locks: the
+ * simulation always has a free snapshot to write to, and the renderer always
+ * reads the latest complete one. The renderer draws the state interpolated
+ * between the two, one tick behind the simulation, so that motion is smooth
+ * whatever the ratio of the frame rate to the tick rate.
+ *
+ * Times are timer values of glfwGetTimerValue(), which may be read from any
+ * thread.
+ */
+class SimulationScheduler
+{
+public:
+    // Advance `state` by one tick of `step` seconds, `time` being the time
+    // of the tick in seconds since the start of the simulation
+    using StepFunction = std::function<void(SceneState& state, double step, double time)>;
+
+    void Initialize(double tick_rate, SceneState const& initial_state, StepFunction step);
+
+    // Run the ticks on a thread of their own, until StopThread()
+    void StartThread();
+    void StopThread();
+
+    // Without a thread, run the ticks that are due at `now` on the calling thread
+    void RunDueTicks(uint64_t now);
+
+    // State to draw at `now`, only called from a single thread
+    SceneState Sample(uint64_t now);
+
+private:
+    // A tick and the one before, to interpolate between
+    struct Snapshot
+    {
+        SceneState previous;
+        SceneState current;
+        // Timer value the current state was scheduled for
+        double time = 0.0;
+    };
+
+    void Publish(SceneState const& previous, double time);
+
+    // Ticks run at once to catch up after a stall, before skipping ahead
+    static constexpr int kMaxCatchUpTicks = 5;
+    static constexpr uint32_t kIndexMask = 3;
+    static constexpr uint32_t kFreshBit = 4;
+
+    StepFunction m_step;
+    double m_frequency = 0.0;
+    // Length of a tick, in timer units
+    double m_period = 0.0;
+    double m_next_tick = 0.0;
+    uint64_t m_tick_count = 0;
+    SceneState m_state;
+
+    // Triple buffer: the simulation writes to m_back and the renderer reads
+    // m_front, m_middle holds the latest published snapshot
+    std::array<Snapshot, 3> m_snapshots;
+    uint32_t m_back = 0;
+    std::atomic<uint32_t> m_middle = 1;
+    uint32_t m_front = 2;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running = false;
+};
@@ -178,6 +178,23 @@ void inspectAdapter(WGPUAdapter adapter)
 #endif // !WEBGPU_BACKEND_WGPU
 }
 
+bool getDeviceLimits(WGPUDevice device, WGPULimits& limits)
+{
+    WGPUSupportedLimits supported_limits = {};
+    supported_limits.nextInChain = nullptr;
+
+#ifdef WEBGPU_BACKEND_DAWN
+    bool success = wgpuDeviceGetLimits(device, &supported_limits) == WGPUStatus_Success;
+#else
+    bool success = wgpuDeviceGetLimits(device, &supported_limits);
+#endif
+
+    if (success)
+        limits = supported_limits.limits;
+
+    return success;
+}
+
 void inspectDevice(WGPUDevice device)
 {
     std::vector<WGPUFeatureName> features;
@@ -196,13 +213,7 @@ void inspectDevice(WGPUDevice device)
     WGPUSupportedLimits limits = {};
     limits.nextInChain = nullptr;
 
-#ifdef WEBGPU_BACKEND_DAWN
-    bool success = wgpuDeviceGetLimits(device, &limits) == WGPUStatus_Success;
-#else
-    bool success = wgpuDeviceGetLimits(device, &limits);
-#endif
-
-    if (success)
+    if (getDeviceLimits(device, limits.limits))
     {
         std::cout << "Device limits:" << std::endl;
         std::cout << " - maxTextureDimension1D: "                     << limits.limits.maxTextureDimension1D                     << std::endl;
@@ -25,6 +25,13 @@ WGPUDevice requestDeviceSync(WGPUAdapter adapter, WGPUDeviceDescriptor const* de
  */
 void inspectAdapter(WGPUAdapter adapter);
 
+/**
+ * Fill `limits` with the limits of the device, so that other modules do not
+ * have to deal with the differences between backends. Return false if the
+ * limits could not be retrieved.
+ */
+bool getDeviceLimits(WGPUDevice device, WGPULimits& limits);
+
 /**
  * Display information about a device
  */
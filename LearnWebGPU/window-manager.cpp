@@ -0,0 +1,426 @@
+#include "window-manager.h"
+
+#include <glfw3webgpu.h>
+
+#ifdef WEBGPU_BACKEND_WGPU
+#include <webgpu/wgpu.h>
+#endif // WEBGPU_BACKEND_WGPU
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif // __EMSCRIPTEN__
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+#ifndef __EMSCRIPTEN__
+// Prefer presenting without waiting for vertical blank, then without blocking
+WGPUPresentMode ChooseLowLatencyPresentMode(WGPUSurface surface, WGPUAdapter adapter)
+{
+    WGPUSurfaceCapabilities capabilities = {};
+    wgpuSurfaceGetCapabilities(surface, adapter, &capabilities);
+
+    WGPUPresentMode present_mode = WGPUPresentMode_Fifo;
+    for (size_t i = 0; i < capabilities.presentModeCount; ++i)
+    {
+        if (capabilities.presentModes[i] == WGPUPresentMode_Immediate)
+        {
+            present_mode = WGPUPresentMode_Immediate;
+            break;
+        }
+        if (capabilities.presentModes[i] == WGPUPresentMode_Mailbox)
+            present_mode = WGPUPresentMode_Mailbox;
+    }
+
+    wgpuSurfaceCapabilitiesFreeMembers(capabilities);
+    return present_mode;
+}
+#endif // !__EMSCRIPTEN__
+
+} // namespace
+
+GLFWwindow* WindowManager::OpenWindow(int width, int height, char const* title, bool exclusive_fullscreen)
+{
+    auto window = std::make_unique<Window>();
+
+    // A full screen window takes the current video mode of the primary monitor
+    // so that no mode switch is needed and the compositor can scan it out as is
+    GLFWmonitor* monitor = nullptr;
+    if (exclusive_fullscreen)
+    {
+        monitor = glfwGetPrimaryMonitor();
+        GLFWvidmode const* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+        if (mode)
+        {
+            width = mode->width;
+            height = mode->height;
+            glfwWindowHint(GLFW_REFRESH_RATE, mode->refreshRate);
+        }
+        else
+        {
+            monitor = nullptr;
+            exclusive_fullscreen = false;
+        }
+    }
+
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); // <-- extra info for glfwCreateWindow
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+#ifndef __EMSCRIPTEN__
+    glfwWindowHint(GLFW_EXCLUSIVE_FULLSCREEN, exclusive_fullscreen);
+#endif // !__EMSCRIPTEN__
+
+    window->window = glfwCreateWindow(width, height, title, monitor, nullptr);
+    glfwWindowHint(GLFW_REFRESH_RATE, GLFW_DONT_CARE);
+    if (!window->window)
+        return nullptr;
+
+    window->exclusive_fullscreen = exclusive_fullscreen;
+
+    // Aim at the refresh rate of the display the window opens on
+    GLFWvidmode const* video_mode = glfwGetVideoMode(monitor ? monitor : glfwGetPrimaryMonitor());
+    if (video_mode && video_mode->refreshRate > 0)
+        window->pacer.SetTargetFrameTime(1.0 / video_mode->refreshRate);
+
+#ifndef __EMSCRIPTEN__
+    // Only Wayland tells when the compositor wants a frame and when it was shown
+    if (glfwGetPlatform() == GLFW_PLATFORM_WAYLAND)
+    {
+        window->pacer.SetFrameCallbacks(true);
+        window->pacer.SetPresentationFeedback(true);
+    }
+#endif // !__EMSCRIPTEN__
+
+    GLFWwindow* handle = window->window;
+    m_windows.push_back(std::move(window));
+#ifndef __EMSCRIPTEN__
+    OnVisibilityChanged(handle, glfwGetWindowVisibility(handle));
+#endif // !__EMSCRIPTEN__
+    return handle;
+}
+
+bool WindowManager::Initialize(WGPUInstance instance, WGPUAdapter adapter, WGPUDevice device, WGPUQueue queue)
+{
+    m_device = device;
+    m_queue = queue;
+
+    for (auto& window : m_windows)
+    {
+        window->surface = glfwGetWGPUSurface(instance, window->window);
+        if (!window->surface)
+        {
+            std::cerr << "Could not create window surface" << std::endl;
+            return false;
+        }
+    }
+
+    if (m_windows.empty())
+        return false;
+    m_format = wgpuSurfaceGetPreferredFormat(m_windows.front()->surface, adapter);
+
+    for (auto& window : m_windows)
+    {
+        if (!ConfigureSurface(*window, adapter))
+            return false;
+    }
+    return true;
+}
+
+void WindowManager::Terminate()
+{
+    for (auto& window : m_windows)
+    {
+        ReleaseSurface(*window);
+        glfwDestroyWindow(window->window);
+        m_closed_windows.push_back(std::move(window));
+    }
+    m_windows.clear();
+    ReleaseClosedWindows(true);
+    m_device = nullptr;
+    m_queue = nullptr;
+}
+
+uint32_t WindowManager::GetMainWidth() const
+{
+    return m_windows.empty() ? 0 : m_windows.front()->config.width;
+}
+
+uint32_t WindowManager::GetMainHeight() const
+{
+    return m_windows.empty() ? 0 : m_windows.front()->config.height;
+}
+
+void WindowManager::OnFramebufferResized(GLFWwindow* handle, int width, int height)
+{
+    Window* window = FindWindow(handle);
+    if (!window || !window->configured)
+        return;
+
+    window->config.width = uint32_t(std::max(width, 0));
+    window->config.height = uint32_t(std::max(height, 0));
+
+    // Nothing is presented to an empty surface, until it grows back
+    if (window->config.width == 0 || window->config.height == 0)
+        return;
+
+    wgpuSurfaceConfigure(window->surface, &window->config);
+    window->scaler.Resize(window->config.width, window->config.height);
+}
+
+void WindowManager::OnVisibilityChanged(GLFWwindow* handle, [[maybe_unused]] int visibility)
+{
+    Window* window = FindWindow(handle);
+    if (!window)
+        return;
+
+#ifndef __EMSCRIPTEN__
+    window->hidden = visibility == GLFW_VISIBILITY_HIDDEN || visibility == GLFW_VISIBILITY_ICONIFIED;
+    window->occluded = visibility == GLFW_VISIBILITY_OCCLUDED;
+#endif // !__EMSCRIPTEN__
+}
+
+void WindowManager::OnFrameRequested(GLFWwindow* handle)
+{
+    if (Window* window = FindWindow(handle))
+        window->pacer.FrameRequested();
+}
+
+void WindowManager::OnFramePresented(GLFWwindow* handle, bool presented, double time, double refresh_interval, double feedback_request_time)
+{
+    if (Window* window = FindWindow(handle))
+        window->pacer.FrameDisplayed(presented, time, refresh_interval, feedback_request_time);
+}
+
+bool WindowManager::ReleaseWindow(GLFWwindow* handle)
+{
+    auto it = std::find_if(m_windows.begin(), m_windows.end(),
+        [handle](std::unique_ptr<Window> const& window) { return window->window == handle; });
+    if (it == m_windows.end())
+        return false;
+
+    ReleaseSurface(**it);
+    (*it)->window = nullptr;
+    m_closed_windows.push_back(std::move(*it));
+    m_windows.erase(it);
+
+    ReleaseClosedWindows(false);
+    return true;
+}
+
+bool WindowManager::GetTimeUntilFrame(double& wait) const
+{
+    bool any_visible = false;
+    double const now = glfwGetTime();
+    wait = kHiddenWaitTime;
+
+    for (auto const& window : m_windows)
+    {
+        if (window->hidden)
+            continue;
+        any_visible = true;
+
+        if (window->occluded)
+            wait = std::min(wait, window->last_present_time + kOccludedFrameTime - now);
+        else if (window->pacer.IsFrameWanted())
+            wait = 0.0;
+        else
+            wait = std::min(wait, window->pacer.GetTargetFrameTime());
+    }
+
+    wait = std::max(wait, 0.0);
+    return any_visible;
+}
+
+size_t WindowManager::AcquireTargets()
+{
+    double const now = glfwGetTime();
+    std::vector<Window*> targets;
+
+    for (auto& window : m_windows)
+    {
+        if (!IsFrameDue(*window, now))
+            continue;
+
+        WGPUSurfaceTexture surface_texture;
+        wgpuSurfaceGetCurrentTexture(window->surface, &surface_texture);
+        if (surface_texture.status != WGPUSurfaceGetCurrentTextureStatus_Success)
+            continue;
+
+        WGPUTextureViewDescriptor view_descriptor;
+        view_descriptor.nextInChain = nullptr;
+        view_descriptor.label = "Surface texture view";
+        view_descriptor.format = wgpuTextureGetFormat(surface_texture.texture);
+        view_descriptor.dimension = WGPUTextureViewDimension_2D;
+        view_descriptor.baseMipLevel = 0;
+        view_descriptor.mipLevelCount = 1;
+        view_descriptor.baseArrayLayer = 0;
+        view_descriptor.arrayLayerCount = 1;
+        view_descriptor.aspect = WGPUTextureAspect_All;
+        window->target_view = wgpuTextureCreateView(surface_texture.texture, &view_descriptor);
+
+#ifdef WEBGPU_BACKEND_WGPU
+        // With wgpu-native, surface textures must be released after the call to wgpuSurfacePresent
+        window->target_texture = surface_texture.texture;
+#else
+        // We no longer need the texture, only its view
+        wgpuTextureRelease(surface_texture.texture);
+#endif // WEBGPU_BACKEND_WGPU
+
+        targets.push_back(window.get());
+    }
+
+    // The windows of a frame share the GPU time of that frame
+    for (Window* window : targets)
+        window->scaler.SetBudgetShare(1.0 / double(targets.size()));
+
+    return targets.size();
+}
+
+void WindowManager::RecordFrame(WGPUCommandEncoder encoder, RecordFunction const& record)
+{
+    for (auto& window : m_windows)
+    {
+        if (!window->target_view)
+            continue;
+
+        window->scaler.BeginFrame(window->pacer);
+        record(encoder, window->scaler);
+        window->scaler.Upscale(encoder, window->target_view);
+    }
+}
+
+void WindowManager::Present()
+{
+    // Free the closed windows whose last timings came back meanwhile
+    ReleaseClosedWindows(false);
+
+    size_t const count = m_windows.size();
+    if (count == 0)
+        return;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        Window& window = *m_windows[(m_first_present + i) % count];
+        if (!window.target_view)
+            continue;
+
+        window.scaler.EndFrame();
+
+        wgpuTextureViewRelease(window.target_view);
+        window.target_view = nullptr;
+#ifndef __EMSCRIPTEN__
+        wgpuSurfacePresent(window.surface);
+#endif // !__EMSCRIPTEN__
+        if (window.target_texture)
+        {
+            wgpuTextureRelease(window.target_texture);
+            window.target_texture = nullptr;
+        }
+
+        window.last_present_time = glfwGetTime();
+        window.pacer.FramePresented();
+        window.pacer.FrameSubmitted(window.last_present_time);
+    }
+
+    m_first_present = (m_first_present + 1) % count;
+}
+
+WindowManager::Window* WindowManager::FindWindow(GLFWwindow* handle)
+{
+    for (auto& window : m_windows)
+    {
+        if (window->window == handle)
+            return window.get();
+    }
+    return nullptr;
+}
+
+bool WindowManager::ConfigureSurface(Window& window, [[maybe_unused]] WGPUAdapter adapter)
+{
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(window.window, &width, &height);
+
+    WGPUSurfaceConfiguration& config = window.config;
+    config.nextInChain = nullptr;
+    config.width = uint32_t(width);
+    config.height = uint32_t(height);
+    config.format = m_format;
+    config.viewFormatCount = 0;
+    config.viewFormats = nullptr;
+    config.usage = WGPUTextureUsage_RenderAttachment;
+    config.device = m_device;
+    config.presentMode = WGPUPresentMode_Fifo;
+#ifndef __EMSCRIPTEN__
+    if (window.exclusive_fullscreen)
+        config.presentMode = ChooseLowLatencyPresentMode(window.surface, adapter);
+#endif // !__EMSCRIPTEN__
+    config.alphaMode = WGPUCompositeAlphaMode_Auto;
+
+    wgpuSurfaceConfigure(window.surface, &config);
+
+    window.configured = window.scaler.Initialize(m_device, m_queue, m_format, config.width, config.height);
+    return window.configured;
+}
+
+bool WindowManager::IsFrameDue(Window const& window, double now) const
+{
+    if (window.hidden || window.config.width == 0 || window.config.height == 0)
+        return false;
+    if (window.occluded)
+        return now >= window.last_present_time + kOccludedFrameTime;
+    return window.pacer.IsFrameWanted();
+}
+
+void WindowManager::ReleaseSurface(Window& window)
+{
+    if (window.target_view)
+        wgpuTextureViewRelease(window.target_view);
+    if (window.target_texture)
+        wgpuTextureRelease(window.target_texture);
+    window.target_view = nullptr;
+    window.target_texture = nullptr;
+
+    if (window.surface)
+    {
+        if (window.configured)
+            wgpuSurfaceUnconfigure(window.surface);
+        wgpuSurfaceRelease(window.surface);
+        window.surface = nullptr;
+    }
+}
+
+void WindowManager::ReleaseClosedWindows(bool wait)
+{
+    // The timing callbacks of a scaler write to it, even when they report an
+    // error because the device goes away, so a scaler is only freed once they
+    // all came back
+    auto timing_pending = [](std::unique_ptr<Window> const& window)
+        {
+            return window->scaler.IsTimingPending();
+        };
+    while (wait && std::any_of(m_closed_windows.begin(), m_closed_windows.end(), timing_pending))
+        PollDevice();
+
+    std::erase_if(m_closed_windows, [](std::unique_ptr<Window> const& window)
+        {
+            if (window->scaler.IsTimingPending())
+                return false;
+            if (window->configured)
+                window->scaler.Terminate();
+            return true;
+        });
+}
+
+void WindowManager::PollDevice()
+{
+#if defined(WEBGPU_BACKEND_DAWN)
+    wgpuDeviceTick(m_device);
+#elif defined(WEBGPU_BACKEND_WGPU)
+    wgpuDevicePoll(m_device, true, nullptr);
+#elif defined(__EMSCRIPTEN__)
+    // Callbacks are run by the browser, give it a chance to do so
+    emscripten_sleep(1);
+#endif
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <webgpu/webgpu.h>
+
+#include "resolution-scaler.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * Windows that all render with a single device and queue.
+ *
+ * Each window has its own surface, configured at its own size and present
+ * mode, and its own frame pacing and dynamic resolution. The work of every
+ * window that wants a frame is recorded into one command encoder, so a frame
+ * goes out in a single queue submission whatever the number of windows. The
+ * surfaces are then presented one after the other, starting from a different
+ * window each frame so that no window is always the last one to flip.
+ *
+ * Windows are opened and destroyed on the GLFW main thread, everything else
+ * may run on a render thread. The manager never reads the state of a GLFW
+ * window after Initialize(): resizes, visibility changes and frame callbacks
+ * are handed to it by whoever receives the window events.
+ *
+ * Setup, on the main thread:
+ *   OpenWindow() for each window, then Initialize() once the device exists
+ * Per frame:
+ *   handle the window events, then GetTimeUntilFrame() and wait that long
+ *   AcquireTargets(), then RecordFrame(encoder, ...) if any was acquired
+ *   submit the encoder, then Present()
+ * Closing a window:
+ *   ReleaseWindow() releases its surface, then the main thread destroys it
+ */
+class WindowManager
+{
+public:
+    // Called for each window of the frame to render its scene. The scene goes
+    // to scaler.GetSceneView(), which is then upscaled to the surface.
+    using RecordFunction = std::function<void(WGPUCommandEncoder encoder, ResolutionScaler& scaler)>;
+
+    // Open a window, its surface is created by Initialize(). A full screen
+    // window takes the video mode of the primary monitor. On Wayland the frame
+    // and present callbacks of the window must be forwarded to
+    // OnFrameRequested() and OnFramePresented().
+    GLFWwindow* OpenWindow(int width, int height, char const* title, bool exclusive_fullscreen = false);
+
+    // Create and configure the surfaces of the open windows. They all share
+    // the preferred format of the first one.
+    bool Initialize(WGPUInstance instance, WGPUAdapter adapter, WGPUDevice device, WGPUQueue queue);
+
+    // Release the windows left and destroy them, on the main thread. Waits
+    // for their timings in flight, so call it before releasing the device.
+    void Terminate();
+
+    // Format of all the surfaces, valid after Initialize()
+    WGPUTextureFormat GetSurfaceFormat() const { return m_format; }
+
+    // Size of the surface of the first window, valid after Initialize()
+    uint32_t GetMainWidth() const;
+    uint32_t GetMainHeight() const;
+
+    size_t GetWindowCount() const { return m_windows.size(); }
+
+    // Window events, from whichever thread renders
+    void OnFramebufferResized(GLFWwindow* handle, int width, int height);
+    void OnVisibilityChanged(GLFWwindow* handle, int visibility);
+    void OnFrameRequested(GLFWwindow* handle);
+    void OnFramePresented(GLFWwindow* handle, bool presented, double time, double refresh_interval, double feedback_request_time);
+
+    // Stop rendering to a window and release its surface. The GLFW window is
+    // left for the main thread to destroy. Return false for an unknown window.
+    bool ReleaseWindow(GLFWwindow* handle);
+
+    // Time to wait before a window wants a frame, 0 if one already does.
+    // Return false when no window can be seen at all.
+    bool GetTimeUntilFrame(double& wait) const;
+
+    // Get the surface texture of each window that is due for a frame, and
+    // return how many were acquired
+    size_t AcquireTargets();
+
+    // Record the frame of each window acquired by AcquireTargets()
+    void RecordFrame(WGPUCommandEncoder encoder, RecordFunction const& record);
+
+    // Call once the frame is submitted: present every acquired surface, and
+    // free the closed windows whose timings came back
+    void Present();
+
+private:
+    struct Window
+    {
+        GLFWwindow* window = nullptr;
+        bool exclusive_fullscreen = false;
+        bool hidden = false;
+        bool occluded = false;
+        WGPUSurface surface = nullptr;
+        WGPUSurfaceConfiguration config = {};
+
+        FramePacer pacer;
+        ResolutionScaler scaler;
+        bool configured = false;
+
+        // Surface texture of the current frame, nullptr when not acquired
+        WGPUTexture target_texture = nullptr;
+        WGPUTextureView target_view = nullptr;
+
+        double last_present_time = 0.0;
+    };
+
+    Window* FindWindow(GLFWwindow* handle);
+    bool ConfigureSurface(Window& window, WGPUAdapter adapter);
+    bool IsFrameDue(Window const& window, double now) const;
+    void ReleaseSurface(Window& window);
+    // Free the closed windows whose timings came back, or wait for all of them
+    void ReleaseClosedWindows(bool wait);
+    // Run the callbacks of the device, waiting for the work in flight
+    void PollDevice();
+
+    // While a window cannot be seen nothing is rendered to it, and while it
+    // is covered by other windows it is rendered at a low rate
+    static constexpr double kHiddenWaitTime = 0.5;
+    static constexpr double kOccludedFrameTime = 0.25;
+
+    WGPUDevice m_device = nullptr;
+    WGPUQueue m_queue = nullptr;
+    WGPUTextureFormat m_format = WGPUTextureFormat_Undefined;
+
+    std::vector<std::unique_ptr<Window>> m_windows;
+
+    // Released windows, kept until the GPU is done with their timings
+    std::vector<std::unique_ptr<Window>> m_closed_windows;
+
+    // Window presented first in the next frame
+    size_t m_first_present = 0;
+};